@@ -0,0 +1,391 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/driver_benchmark.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Medição, no host, das APIs de c_common_uart.c, c_common_i2c.c e c_io_rx24f.c.
+  *
+  * Os drivers são compilados sem alteração contra os periféricos simulados (ver sim_stm32.h): USART e
+  * DMA, a I2C1 com dois escravos de registradores (um a 100 kHz e outro a 400 kHz) e, para o RX-24F, um
+  * servo que responde a cada pacote de instrução com um pacote de status. Para cada API são impressos:
+  *
+  *  - bytes/s: bytes no fio (enviados e recebidos) pelo tempo simulado entre o início da primeira chamada
+  *    e o fim da última transferência;
+  *  - ciclos/byte: tempo de CPU do firmware (task e interrupções, sem as esperas em semáforos) do início
+  *    de cada chamada ao fim da sua transferência, em ciclos de 168 MHz, por byte; mediana das chamadas;
+  *  - ISR/quadro: entradas em tratadores de interrupção por chamada (pacote, transação ou rajada);
+  *  - bloqueio máx.: maior tempo de retorno de uma chamada;
+  *  - acessos/byte: acessos a registradores por byte.
+  *
+  * Ao fim, são listados os contadores da I2C (c_common_i2c_stats()) e os probes do próprio firmware
+  * (c_common_perf_snapshot()).
+  *
+  * Limitações: os ciclos são do código compilado com -O0 para o host, e não do Cortex-M4, e variam
+  * entre execuções; dão a ordem de grandeza e separam APIs de custos bem distintos (ex.: espera ativa em
+  * flush contra DMA), mas não servem como orçamento de CPU no alvo. Bytes/s,
+  * interrupções, acessos e tempos de bloqueio dominados pelo barramento independem do processador.
+  * Trechos curtos podem aparecer com quase zero ciclos: o custo descontado de cada acesso simulado é uma
+  * mediana. Pela mesma razão, uma pausa do host pode atrasar uma interrupção da USART além de um byte,
+  * ou esgotar a espera pelo STOP anterior da I2C (dois períodos de SCL, 5 us a 400 kHz), que então conta
+  * um timeout e uma recuperação (ver a linha "I2C:"). Rajadas da USART perdidas assim (overrun) são
+  * contadas à parte, e não entram na mediana nem no pior caso.
+  *
+  * Uso:
+  * \code
+  *   make benchmark
+  * \endcode
+  * Termina com código diferente de zero se alguma transferência falhar ou trouxer dados errados.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_common_uart.h"
+#include "c_common_i2c.h"
+#include "c_common_perf.h"
+#include "c_io_rx24f.h"
+#include "sim_stm32.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ITERATIONS			50
+#define NS_PER_US			1000ull
+#define TICKS_MS(ms)		((ms) / portTICK_RATE_MS)
+
+#define IMU_ADDRESS			0x68		//!< Escravo a 100 kHz.
+#define MAG_ADDRESS			0x1E		//!< Escravo a 400 kHz.
+#define SERVO_ID			1
+#define SERVO_BAUDRATE		1000000
+#define SERVO_DELAY_NS		(20 * NS_PER_US)	//!< Atraso de resposta do servo simulado.
+#define SERVO_READ_DATA		0x02		//!< Instrução de leitura (AX_READ_DATA).
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Medição de uma API. */
+typedef struct {
+	const char* 	api;
+	uint32_t 		frames;		//!< Chamadas medidas.
+	uint32_t 		bytes;		//!< Bytes no fio.
+	uint64_t 		worst;		//!< Maior tempo de retorno de uma chamada, em ns.
+	uint64_t 		start;		//!< Início da medição.
+	uint64_t 		idle;		//!< sim_idle_time() no início.
+	uint32_t 		irqs;		//!< sim_irq_total() no início.
+	uint64_t 		accesses;	//!< sim_accesses() no início.
+	uint64_t 		callStart;	//!< Início da chamada em curso.
+	uint64_t 		callIdle;	//!< sim_idle_time() no início da chamada em curso.
+	uint64_t 		callBlocked;//!< Tempo de retorno da chamada em curso.
+	uint32_t 		callBytes;	//!< Bytes da chamada em curso.
+	float 			cycles[ITERATIONS];	//!< Ciclos por byte de cada chamada.
+	int 			samples;	//!< Chamadas em \b cycles.
+	uint32_t 		discarded;	//!< Chamadas descartadas (overrun causado pelo host).
+} Row;
+
+/* Private variables ---------------------------------------------------------*/
+static int failures = 0;
+static uint8_t imu_registers[128];
+static uint8_t mag_registers[16];
+static int servo_replies = 0;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void prv_row_begin(Row* row, const char* api) {
+	memset(row, 0, sizeof(*row));
+	row->api 		= api;
+	row->start 		= sim_now();
+	row->idle 		= sim_idle_time();
+	row->irqs 		= sim_irq_total();
+	row->accesses 	= sim_accesses();
+}
+
+static void prv_call_begin(Row* row) {
+	row->callStart = sim_now();
+	row->callIdle = sim_idle_time();
+}
+
+/** \brief Retorno da chamada, que envolve \b bytes bytes no fio. */
+static void prv_call_end(Row* row, uint32_t bytes) {
+	row->callBlocked = sim_now() - row->callStart;
+	row->callBytes = bytes;
+	row->frames++;
+	row->bytes += bytes;
+}
+
+/** \brief Fim da transferência da chamada; \b valid é falso se ela foi perdida por um overrun causado pelo host. */
+static void prv_sample_end(Row* row, bool valid) {
+	uint64_t busy = (sim_now() - row->callStart) - (sim_idle_time() - row->callIdle);
+
+	if(!valid) {
+		row->discarded++;
+		return;
+	}
+	if(row->callBlocked > row->worst)
+		row->worst = row->callBlocked;
+	if(row->callBytes && row->samples < ITERATIONS)
+		row->cycles[row->samples++] = busy * (SIM_CORE_CLOCK / 1e9f) / row->callBytes;
+}
+
+static int prv_compare(const void* a, const void* b) {
+	float x = *(const float*)a, y = *(const float*)b;
+	return (x > y) - (x < y);
+}
+
+/** \brief Encerra a medição (após o fim da última transferência) e imprime a linha. */
+static void prv_row_end(Row* row) {
+	uint64_t elapsed = sim_now() - row->start;
+	double bytes = row->bytes ? row->bytes : 1;
+
+	qsort(row->cycles, row->samples, sizeof(row->cycles[0]), prv_compare);
+	printf("%-36s %9.0f %11.0f %10.2f %14.1f %12.1f\n", row->api,
+		   elapsed ? row->bytes * 1e9 / elapsed : 0.0,
+		   row->samples ? row->cycles[row->samples / 2] : 0.0f,
+		   (double)(sim_irq_total() - row->irqs) / (row->frames ? row->frames : 1),
+		   row->worst / 1e3,
+		   (sim_accesses() - row->accesses) / bytes);
+	if(row->discarded)
+		printf("  (%u chamadas descartadas: overrun causado por uma pausa do host)\n", (unsigned)row->discarded);
+}
+
+static void prv_fail(const char* api, const char* what) {
+	printf("FALHA  %s: %s\n", api, what);
+	failures++;
+}
+
+/** \brief Servo simulado: responde a cada pacote de instrução com um pacote de status (com a posição,
+  * para leituras), SERVO_DELAY_NS após o stop bit do checksum.
+  */
+static void prv_servo_listener(USART_TypeDef* usart, const SimUsartByte* byte, void* context) {
+	static uint8_t packet[16];
+	static int length = 0;
+	(void)context;
+
+	if(length < 2 && byte->value != 0xFF) {
+		length = 0;
+		return;
+	}
+	packet[length++] = byte->value;
+	if(length >= 4 && length == packet[3] + 4) {
+		uint8_t reply[8] = { 0xFF, 0xFF, packet[2], 2, 0 };
+		int n = 5;
+		if(packet[4] == SERVO_READ_DATA) {
+			reply[3] = 4;
+			reply[n++] = 0x00;
+			reply[n++] = 0x02;
+		}
+		unsigned int sum = 0;
+		for(int i = 2; i < n; i++)
+			sum += reply[i];
+		reply[n++] = ~sum & 0xFF;
+		sim_usart_inject_at(usart, reply, n, byte->end + SERVO_DELAY_NS);
+		servo_replies++;
+		length = 0;
+	}
+	else if(length == (int)sizeof(packet)) {
+		length = 0;
+	}
+}
+
+/** \brief Envio copiado: o bloqueio é o de write; a task espera ociosa pelo fim do último byte, para que
+  * os ciclos sejam os de write e das interrupções, e não os da espera ativa de flush.
+  */
+static void bench_usart_write(void) {
+	static uint8_t data[64];
+	Row row;
+
+	for(unsigned i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)i;
+	prv_row_begin(&row, "USART2 write 64 B");
+	for(int i = 0; i < ITERATIONS; i++) {
+		prv_call_begin(&row);
+		int accepted = c_common_usart_write(USART2, data, sizeof(data));
+		prv_call_end(&row, accepted);
+		if(accepted != (int)sizeof(data))
+			prv_fail(row.api, "bloco recusado");
+		sim_wait(accepted * sim_usart_frame_ns(USART2));
+		c_common_usart_flush(USART2, portMAX_DELAY);
+		prv_sample_end(&row, true);
+	}
+	prv_row_end(&row);
+}
+
+/** \brief Segmentos sem cópia, enviados e aguardados como um pacote do RX-24F. */
+static void bench_usart_queue(void) {
+	static const uint8_t header[2] = { 0xFF, 0xFF };
+	uint8_t body[6] = { 1, 5, 3, 30, 0, 2 };
+	uint8_t checksum = 0xD8;
+	Row row;
+
+	prv_row_begin(&row, "USART2 queue 3 seg. + flush (9 B)");
+	for(int i = 0; i < ITERATIONS; i++) {
+		USARTTxSegment packet[] = { { header, 2, 0, 0 }, { body, 6, 0, 0 }, { &checksum, 1, 0, 0 } };
+		prv_call_begin(&row);
+		bool queued = c_common_usart_queue(USART2, packet, 3);
+		c_common_usart_flush(USART2, portMAX_DELAY);
+		prv_call_end(&row, queued ? 9 : 0);
+		prv_sample_end(&row, true);
+		if(!queued)
+			prv_fail(row.api, "pacote recusado");
+	}
+	prv_row_end(&row);
+}
+
+/** \brief Recebimento de uma rajada de \b length bytes, aguardada com read_timeout. */
+static void bench_usart_rx(USART_TypeDef* usart, const char* api, int length) {
+	uint8_t frame[64], buf[64];
+	Row row;
+
+	for(int i = 0; i < length; i++)
+		frame[i] = (uint8_t)(0x30 + i);
+	c_common_usart_set_rx_terminator(usart, USART_NO_TERMINATOR);
+	prv_row_begin(&row, api);
+	for(int i = 0; i < ITERATIONS; i++) {
+		uint32_t dropped = c_common_usart_dropped(usart);
+		prv_call_begin(&row);
+		sim_usart_inject(usart, frame, length);
+		int n = c_common_usart_read_timeout(usart, buf, length, TICKS_MS(5));
+		prv_call_end(&row, n);
+		bool intact = (n == length && !memcmp(buf, frame, length));
+		prv_sample_end(&row, intact);
+		if(!intact && c_common_usart_dropped(usart) == dropped)
+			prv_fail(api, "rajada incompleta ou corrompida");
+	}
+	prv_row_end(&row);
+}
+
+/** \brief Transações bloqueantes com um registrador de \b device. */
+static void bench_i2c_transfer(const char* api, uint8_t device, uint8_t* registers, uint16_t txLength, uint16_t rxLength) {
+	uint8_t tx[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+	uint8_t rx[16];
+	Row row;
+
+	prv_row_begin(&row, api);
+	for(int i = 0; i < ITERATIONS; i++) {
+		I2CTransfer transfer = { device, 2, tx, txLength, rx, rxLength, 0, 0, 0, I2C_RESULT_PENDING };
+		memset(rx, 0, sizeof(rx));
+		prv_call_begin(&row);
+		I2CResult result = c_common_i2c_transfer(&transfer);
+		prv_call_end(&row, 2 + txLength + (rxLength ? 1 + rxLength : 0));
+		prv_sample_end(&row, true);
+		if(result != I2C_RESULT_OK)
+			prv_fail(api, "transação não concluída");
+		else if(rxLength && memcmp(rx, registers + 2 + txLength, rxLength))
+			prv_fail(api, "dados lidos diferentes dos registradores do escravo");
+		else if(txLength && memcmp(registers + 2, tx, txLength))
+			prv_fail(api, "dados escritos diferentes dos registradores do escravo");
+	}
+	prv_row_end(&row);
+}
+
+/** \brief Transações submetidas sem bloquear; o bloqueio é o de submit. */
+static void bench_i2c_submit(const char* api, uint8_t device, uint16_t rxLength) {
+	uint8_t rx[16];
+	Row row;
+
+	prv_row_begin(&row, api);
+	for(int i = 0; i < ITERATIONS; i++) {
+		I2CTransfer transfer = { device, 0, 0, 0, rx, rxLength, 0, 0, 0, I2C_RESULT_PENDING };
+		prv_call_begin(&row);
+		bool accepted = c_common_i2c_submit(&transfer);
+		prv_call_end(&row, 3 + rxLength);
+		if(!accepted) {
+			prv_fail(api, "transação recusada");
+			continue;
+		}
+		while(transfer.result == I2C_RESULT_PENDING)
+			sim_wait(10 * NS_PER_US);
+		prv_sample_end(&row, true);
+		if(transfer.result != I2C_RESULT_OK)
+			prv_fail(api, "transação não concluída");
+	}
+	prv_row_end(&row);
+}
+
+/** \brief Comandos ao servo: o bloqueio é o da API; o intervalo inclui o pacote de status. */
+static void bench_rx24f(const char* api, int (*command)(void), int command_bytes, int reply_bytes) {
+	uint8_t reply[16];
+	Row row;
+
+	prv_row_begin(&row, api);
+	for(int i = 0; i < ITERATIONS; i++) {
+		int replies = servo_replies;
+		prv_call_begin(&row);
+		int status = command();
+		prv_call_end(&row, command_bytes + reply_bytes);
+		int n = c_common_usart_read_timeout(USART6, reply, reply_bytes, TICKS_MS(5));
+		prv_sample_end(&row, true);
+		if(status <= 0 || servo_replies != replies + 1 || n != reply_bytes)
+			prv_fail(api, "comando ou resposta perdidos");
+	}
+	prv_row_end(&row);
+}
+
+static int prv_servo_move(void) 	{ return c_io_rx24f_move(SERVO_ID, 150); }
+static int prv_servo_led(void) 		{ return c_io_rx24f_setLed(SERVO_ID, 1); }
+static int prv_servo_position(void) { return c_io_rx24f_readPosition(SERVO_ID); }
+
+/** \brief Lista os probes do firmware (ciclos do host; ver a nota no início do arquivo). */
+static void prv_print_probes(void) {
+	PerfProbe probe;
+
+	printf("\n%-24s %8s %9s %8s %12s %12s\n", "probe", "execuções", "bytes", "quadros", "ciclos/exec.", "máx. ciclos");
+	for(int i = 0; i < c_common_perf_probe_count(); i++) {
+		if(!c_common_perf_snapshot(i, &probe, false) || !probe.count)
+			continue;
+		char name[32];
+		snprintf(name, sizeof(name), "%s %s", probe.owner, probe.name);
+		printf("%-24s %8u %9u %8u %12u %12u\n", name, (unsigned)probe.count, (unsigned)probe.bytes,
+			   (unsigned)probe.frames, (unsigned)(probe.cycles / probe.count), (unsigned)probe.max);
+	}
+}
+
+static void prv_task(void) {
+	for(unsigned i = 0; i < sizeof(imu_registers); i++)
+		imu_registers[i] = (uint8_t)(0xA0 + i);
+	for(unsigned i = 0; i < sizeof(mag_registers); i++)
+		mag_registers[i] = (uint8_t)(0x50 + i);
+	sim_i2c_slave(IMU_ADDRESS, imu_registers, sizeof(imu_registers));
+	sim_i2c_slave(MAG_ADDRESS, mag_registers, sizeof(mag_registers));
+	sim_usart_set_listener(USART6, prv_servo_listener, 0);
+
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
+	c_common_usart_init(USART2, 115200);
+	c_io_rx24f_init(SERVO_BAUDRATE);
+	c_common_i2c_init();
+	c_common_i2c_set_device_speed(MAG_ADDRESS, I2C_SPEED_FAST);
+
+	printf("%-36s %9s %11s %10s %14s %12s\n", "API", "bytes/s", "ciclos/byte", "ISR/quadro", "bloqueio (us)", "acessos/byte");
+
+	bench_usart_write();
+	bench_usart_queue();
+	bench_usart_rx(USART2, "USART2 read_timeout 20 B (IRQ)", 20);
+	bench_usart_rx(USART6, "USART6 read_timeout 20 B (DMA)", 20);
+
+	bench_i2c_transfer("I2C transfer lê 1 B, 100 kHz", IMU_ADDRESS, imu_registers, 0, 1);
+	bench_i2c_transfer("I2C transfer lê 2 B, 100 kHz", IMU_ADDRESS, imu_registers, 0, 2);
+	bench_i2c_transfer("I2C transfer lê 3 B, 100 kHz", IMU_ADDRESS, imu_registers, 0, 3);
+	bench_i2c_transfer("I2C transfer lê 6 B, 100 kHz", IMU_ADDRESS, imu_registers, 0, 6);
+	bench_i2c_transfer("I2C transfer escreve 1 B, 100 kHz", IMU_ADDRESS, imu_registers, 1, 0);
+	bench_i2c_transfer("I2C transfer escreve 4 B, 100 kHz", IMU_ADDRESS, imu_registers, 4, 0);
+	bench_i2c_transfer("I2C transfer lê 6 B, 400 kHz", MAG_ADDRESS, mag_registers, 0, 6);
+	bench_i2c_submit("I2C submit lê 6 B, 400 kHz", MAG_ADDRESS, 6);
+
+	bench_rx24f("RX24F move", prv_servo_move, 9, 6);
+	bench_rx24f("RX24F setLed", prv_servo_led, 8, 6);
+	bench_rx24f("RX24F readPosition", prv_servo_position, 8, 8);
+
+	I2CStats stats = c_common_i2c_stats();
+	printf("\nI2C: %u transações, %u NACKs, %u erros, %u timeouts, %u recuperações\n", (unsigned)stats.transfers,
+		   (unsigned)stats.nacks, (unsigned)stats.errors, (unsigned)stats.timeouts, (unsigned)stats.recoveries);
+	prv_print_probes();
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(void) {
+	sim_init();
+	sim_run(prv_task);
+	if(failures)
+		printf("%d falhas\n", failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/host/FreeRTOS.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Subconjunto da API do FreeRTOS usado pelos drivers, para o host.
+  *
+  * Há uma única task (a thread da simulação); os semáforos são contadores liberados pelos tratadores
+  * de interrupção simulados, e as esperas são ativas. O tick é de 1 ms, medido no relógio do host.
+  ******************************************************************************/
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long 		portBASE_TYPE;
+typedef uint32_t 	portTickType;
+
+#define pdTRUE				((portBASE_TYPE)1)
+#define pdFALSE				((portBASE_TYPE)0)
+#define pdPASS				pdTRUE
+#define pdFAIL				pdFALSE
+
+#define portMAX_DELAY		((portTickType)0xFFFFFFFF)
+#define portTICK_RATE_MS	((portTickType)1)
+
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY		(5 << 4)
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY	5
+
+void sim_rtos_yield_from_isr(portBASE_TYPE woken);
+#define portEND_SWITCHING_ISR(woken)	sim_rtos_yield_from_isr(woken)
+
+#endif /* INC_FREERTOS_H */
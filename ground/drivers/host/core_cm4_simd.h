@@ -0,0 +1,12 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/host/core_cm4_simd.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Intrínsecos SIMD do Cortex-M4 para o host: nenhum é usado pelos drivers.
+  ******************************************************************************/
+
+#ifndef __CORE_CM4_SIMD_H
+#define __CORE_CM4_SIMD_H
+#endif /* __CORE_CM4_SIMD_H */
@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/host/core_cmFunc.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Registradores especiais do Cortex-M para o host (substitui o core_cmFunc.h do CMSIS).
+  *
+  * PRIMASK é emulado pela simulação (sim_stm32.c): enquanto ligado, as interrupções simuladas ficam
+  * pendentes, e são atendidas ao desligá-lo, como no hardware.
+  ******************************************************************************/
+
+#ifndef __CORE_CMFUNC_H
+#define __CORE_CMFUNC_H
+
+#include <stdint.h>
+
+uint32_t sim_get_primask(void);
+void     sim_set_primask(uint32_t primask);
+
+static inline uint32_t __get_PRIMASK(void) 				{ return sim_get_primask(); }
+static inline void     __set_PRIMASK(uint32_t primask) 	{ sim_set_primask(primask); }
+static inline void     __disable_irq(void) 				{ sim_set_primask(1); }
+static inline void     __enable_irq(void) 				{ sim_set_primask(0); }
+
+#endif /* __CORE_CMFUNC_H */
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/host/core_cmInstr.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Instruções do Cortex-M para o host (substitui o core_cmInstr.h do CMSIS).
+  *
+  * As barreiras viram barreiras do compilador e do host; as demais instruções usadas pelos
+  * drivers não têm efeito na simulação.
+  ******************************************************************************/
+
+#ifndef __CORE_CMINSTR_H
+#define __CORE_CMINSTR_H
+
+#include <stdint.h>
+
+#define __NOP()		((void)0)
+#define __WFI()		((void)0)
+#define __WFE()		((void)0)
+#define __SEV()		((void)0)
+#define __ISB()		__sync_synchronize()
+#define __DSB()		__sync_synchronize()
+#define __DMB()		__sync_synchronize()
+
+static inline uint32_t __REV(uint32_t value) 	{ return __builtin_bswap32(value); }
+static inline uint32_t __REV16(uint32_t value) 	{ return ((value & 0xFF00FF00) >> 8) | ((value & 0x00FF00FF) << 8); }
+static inline int32_t  __REVSH(int32_t value) 	{ return (int16_t)__builtin_bswap16((uint16_t)value); }
+static inline uint8_t  __CLZ(uint32_t value) 	{ return value ? (uint8_t)__builtin_clz(value) : 32; }
+
+#endif /* __CORE_CMINSTR_H */
@@ -0,0 +1,25 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/host/semphr.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Semáforos do FreeRTOS para o host (ver FreeRTOS.h).
+  ******************************************************************************/
+
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "FreeRTOS.h"
+
+typedef struct SimSemaphore* xSemaphoreHandle;
+
+xSemaphoreHandle sim_rtos_semaphore(uint32_t max, uint32_t initial);
+portBASE_TYPE    xSemaphoreTake(xSemaphoreHandle semaphore, portTickType ticks);
+portBASE_TYPE    xSemaphoreGive(xSemaphoreHandle semaphore);
+portBASE_TYPE    xSemaphoreGiveFromISR(xSemaphoreHandle semaphore, portBASE_TYPE* woken);
+
+#define vSemaphoreCreateBinary(semaphore)		((semaphore) = sim_rtos_semaphore(1, 1))
+#define xSemaphoreCreateCounting(max, initial)	sim_rtos_semaphore((max), (initial))
+
+#endif /* SEMAPHORE_H */
@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/host/task.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Funções de task do FreeRTOS para o host (ver FreeRTOS.h).
+  ******************************************************************************/
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+#define taskSCHEDULER_NOT_STARTED	0
+#define taskSCHEDULER_RUNNING		1
+#define taskSCHEDULER_SUSPENDED		2
+
+void sim_rtos_enter_critical(void);
+void sim_rtos_exit_critical(void);
+
+#define taskENTER_CRITICAL()		sim_rtos_enter_critical()
+#define taskEXIT_CRITICAL()			sim_rtos_exit_critical()
+#define taskYIELD()					((void)0)
+
+portTickType  xTaskGetTickCount(void);
+void 		  vTaskDelay(portTickType ticks);
+portBASE_TYPE xTaskGetSchedulerState(void);
+
+#endif /* INC_TASK_H */
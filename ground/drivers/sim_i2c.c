@@ -0,0 +1,429 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/sim_i2c.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Modelo da I2C1 do STM32F4 como mestre, com escravos de registradores e requisições de DMA.
+  *
+  * Cada fase ocupa o barramento pelo tempo dado por CCR (Sm, ou Fm com DUTY 0 ou 1) e PCLK1: START e
+  * STOP, um período de SCL; endereço e bytes, nove (o último é o ACK). Ao fim de cada fase os flags de
+  * SR1 e SR2 são atualizados como no RM0090, e o barramento fica parado (clock stretching) enquanto
+  * SB, ADDR ou BTF aguardam o software. As sequências de limpeza são as do hardware: SB por leitura de
+  * SR1 e escrita de DR; ADDR por leitura de SR1 e de SR2; BTF por leitura de SR1 e acesso a DR, ou por
+  * START/STOP; TXE e BTF também por START e STOP; erros escrevendo 0 em SR1.
+  *
+  * Na recepção, o ACK de cada byte é o de CR1 ao fim dele; com POS, o do fim do byte anterior (o
+  * primeiro é confirmado). Com DMAEN, cada byte vai direto para a memória pelo stream apontado para DR,
+  * e com LAST o byte que completa o stream recebe NACK. Um byte recebido com DR cheio fica no
+  * registrador de deslocamento, com BTF. START e STOP pedidos durante um byte são gerados ao fim dele.
+  *
+  * Os escravos (sim_i2c_slave()) são memórias de registradores: o primeiro byte de uma escrita é o
+  * ponteiro, e leituras e escritas o incrementam. Endereços sem escravo recebem NACK (AF).
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "sim_internal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_SLAVES			8
+#define REG_CR1				0x00
+#define REG_CR2				0x04
+#define REG_DR				0x10
+#define REG_SR1				0x14
+#define REG_SR2				0x18
+#define REG_CCR				0x1C
+#define SR1_ERRORS			(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR)
+#define SR1_EVENTS			(I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_BTF | I2C_SR1_STOPF | I2C_SR1_ADD10)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Fase em curso no barramento. */
+typedef enum {
+	PHASE_NONE = 0,		//!< Livre, ou parado à espera do software.
+	PHASE_START,		//!< Gerando START.
+	PHASE_ADDRESS,		//!< Enviando o endereço.
+	PHASE_TX,			//!< Enviando um byte.
+	PHASE_RX,			//!< Recebendo um byte.
+	PHASE_STOP			//!< Gerando STOP.
+} BusPhase;
+
+/** \brief Escravo simulado. */
+typedef struct {
+	uint8_t 	address;	//!< Endereço de 7 bits.
+	uint8_t* 	memory;		//!< Registradores.
+	int 		size;		//!< Quantidade de registradores.
+	int 		pointer;	//!< Próximo registrador acessado.
+} Slave;
+
+/** \brief Estado da I2C1 simulada. */
+typedef struct {
+	SimDevice 	device;
+
+	BusPhase 	phase;
+	uint64_t 	phaseEnd;		//!< Fim da fase em curso.
+	uint64_t 	now;			//!< Instante do acesso ou do fim de fase sendo tratado.
+	uint8_t 	shift;			//!< Byte em envio (endereço ou dado).
+	bool 		startPending;	//!< START pedido durante um byte.
+	bool 		stopPending;	//!< STOP pedido durante um byte.
+
+	Slave* 		slave;			//!< Escravo endereçado, ou 0.
+	bool 		read;			//!< Direção da transação atual.
+	bool 		pointerNext;	//!< O próximo byte escrito é o ponteiro do escravo.
+	bool 		drFull;			//!< Envio: há um byte em DR (TXE = 0).
+	uint8_t 	dr;				//!< DR (envio: próximo byte; recepção: byte recebido).
+	bool 		held;			//!< Recepção: byte no registrador de deslocamento, com DR cheio (BTF).
+	uint8_t 	heldByte;
+	bool 		heldAck;		//!< ACK enviado com o byte retido.
+	int 		received;		//!< Bytes recebidos desde ADDR.
+	bool 		lastAck;		//!< ACK de CR1 ao fim do último byte (para POS).
+
+	bool 		srRead;			//!< O último acesso foi uma leitura de SR1 (sequências de limpeza).
+	uint16_t 	srSeen;			//!< Valor lido de SR1.
+
+	Slave 		slaves[MAX_SLAVES];
+	int 		slaveCount;
+} I2cState;
+
+/* Private variables ---------------------------------------------------------*/
+static I2cState i2c;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint16_t prv_reg(uint32_t offset) {
+	return (uint16_t)sim_load(I2C1_BASE + offset, 2);
+}
+
+static void prv_set(uint32_t offset, uint16_t set, uint16_t clear) {
+	sim_store(I2C1_BASE + offset, 2, (prv_reg(offset) | set) & ~clear);
+}
+
+/** \brief Período de SCL programado em CCR, em ns. */
+static uint64_t prv_period(void) {
+	uint16_t ccr = prv_reg(REG_CCR);
+	uint64_t ticks = (ccr & I2C_CCR_FS) ? ((ccr & I2C_CCR_DUTY) ? 25 : 3) * (ccr & 0xFFF) : 2 * (ccr & 0xFFF);
+	if(!ticks)
+		return 10000;	// CCR ainda não programado: 100 kHz
+	return ticks * 1000000000ull / sim_pclk(I2C1_BASE);
+}
+
+static void prv_begin(BusPhase phase, int bits) {
+	i2c.phase = phase;
+	i2c.phaseEnd = i2c.now + bits * prv_period();
+}
+
+/** \brief Gera START ou STOP pedidos, se houver; senão, continua a recepção, se o último byte foi confirmado. */
+static void prv_next_phase(bool ack) {
+	if(i2c.stopPending) {
+		i2c.stopPending = false;
+		prv_begin(PHASE_STOP, 1);
+	}
+	else if(i2c.startPending) {
+		i2c.startPending = false;
+		prv_begin(PHASE_START, 1);
+	}
+	else if(i2c.read && ack && (prv_reg(REG_SR2) & I2C_SR2_MSL)) {
+		prv_begin(PHASE_RX, 9);
+	}
+}
+
+static Slave* prv_slave(uint8_t address) {
+	for(int i = 0; i < i2c.slaveCount; i++)
+		if(i2c.slaves[i].address == address)
+			return &i2c.slaves[i];
+	return 0;
+}
+
+/** \brief Entrega um byte recebido a DR (e ao DMA, com DMAEN). */
+static void prv_deliver(uint8_t byte) {
+	i2c.dr = byte;
+	if(prv_reg(REG_CR2) & I2C_CR2_DMAEN) {
+		if(sim_dma_to_memory(sim_dma_stream(I2C1_BASE + REG_DR, true), byte))
+			return;
+	}
+	prv_set(REG_SR1, I2C_SR1_RXNE, 0);
+}
+
+/** \brief Fim de uma fase. */
+static void prv_phase_done(void) {
+	BusPhase phase = i2c.phase;
+	i2c.phase = PHASE_NONE;
+
+	switch(phase) {
+	case PHASE_START:
+		prv_set(REG_CR1, 0, I2C_CR1_START);
+		prv_set(REG_SR1, I2C_SR1_SB, I2C_SR1_BTF | I2C_SR1_TXE);
+		prv_set(REG_SR2, I2C_SR2_MSL | I2C_SR2_BUSY, I2C_SR2_TRA);
+		i2c.drFull = false;
+		i2c.held = false;
+		break;
+
+	case PHASE_ADDRESS:
+		i2c.read = i2c.shift & 1;
+		i2c.slave = prv_slave(i2c.shift >> 1);
+		if(!i2c.slave) {
+			prv_set(REG_SR1, I2C_SR1_AF, 0);
+			prv_next_phase(false);
+			break;
+		}
+		i2c.pointerNext = !i2c.read;
+		prv_set(REG_SR1, I2C_SR1_ADDR, 0);
+		prv_set(REG_SR2, i2c.read ? 0 : I2C_SR2_TRA, i2c.read ? I2C_SR2_TRA : 0);
+		break;
+
+	case PHASE_TX:
+		if(i2c.pointerNext) {
+			i2c.slave->pointer = i2c.shift % i2c.slave->size;
+			i2c.pointerNext = false;
+		}
+		else {
+			i2c.slave->memory[i2c.slave->pointer] = i2c.shift;
+			i2c.slave->pointer = (i2c.slave->pointer + 1) % i2c.slave->size;
+		}
+		if(i2c.stopPending || i2c.startPending) {
+			prv_next_phase(true);
+		}
+		else if(i2c.drFull) {
+			i2c.shift = i2c.dr;
+			i2c.drFull = false;
+			prv_set(REG_SR1, I2C_SR1_TXE, 0);
+			prv_begin(PHASE_TX, 9);
+		}
+		else {
+			prv_set(REG_SR1, I2C_SR1_BTF | I2C_SR1_TXE, 0);
+		}
+		break;
+
+	case PHASE_RX: {
+		uint8_t byte = i2c.slave->memory[i2c.slave->pointer];
+		uint16_t cr1 = prv_reg(REG_CR1);
+		SimDmaStream* dma = sim_dma_stream(I2C1_BASE + REG_DR, true);
+		bool ack;
+
+		i2c.slave->pointer = (i2c.slave->pointer + 1) % i2c.slave->size;
+		if((prv_reg(REG_CR2) & (I2C_CR2_DMAEN | I2C_CR2_LAST)) == (I2C_CR2_DMAEN | I2C_CR2_LAST)
+		   && sim_dma_remaining(dma) == 1)
+			ack = false;
+		else if(cr1 & I2C_CR1_POS)
+			ack = i2c.received ? i2c.lastAck : true;
+		else
+			ack = (cr1 & I2C_CR1_ACK) != 0;
+		i2c.lastAck = (cr1 & I2C_CR1_ACK) != 0;
+		i2c.received++;
+
+		if(prv_reg(REG_SR1) & I2C_SR1_RXNE) {
+			// DR cheio: o byte fica no registrador de deslocamento, e o barramento para
+			i2c.held = true;
+			i2c.heldByte = byte;
+			i2c.heldAck = ack;
+			prv_set(REG_SR1, I2C_SR1_BTF, 0);
+			break;
+		}
+		prv_deliver(byte);
+		prv_next_phase(ack);
+		break;
+	}
+
+	case PHASE_STOP:
+		prv_set(REG_CR1, 0, I2C_CR1_STOP);
+		prv_set(REG_SR1, 0, I2C_SR1_BTF | I2C_SR1_TXE);
+		prv_set(REG_SR2, 0, I2C_SR2_MSL | I2C_SR2_BUSY | I2C_SR2_TRA);
+		i2c.slave = 0;
+		i2c.read = false;
+		i2c.drFull = false;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/** \brief ADDR limpo pelo software: o barramento volta a andar. */
+static void prv_addr_cleared(void) {
+	prv_set(REG_SR1, 0, I2C_SR1_ADDR);
+	if(i2c.read) {
+		i2c.received = 0;
+		prv_begin(PHASE_RX, 9);
+	}
+	else {
+		prv_set(REG_SR1, I2C_SR1_TXE, 0);
+	}
+}
+
+/** \brief Leitura de DR: na recepção, o byte retido passa a DR e o barramento volta a andar. */
+static uint8_t prv_read_dr(void) {
+	uint8_t value = i2c.dr;
+
+	prv_set(REG_SR1, 0, I2C_SR1_RXNE);
+	if(i2c.srRead && (i2c.srSeen & I2C_SR1_BTF) && !i2c.held)
+		prv_set(REG_SR1, 0, I2C_SR1_BTF);
+	if(i2c.held) {
+		i2c.held = false;
+		prv_set(REG_SR1, 0, I2C_SR1_BTF);
+		prv_deliver(i2c.heldByte);
+		if(i2c.phase == PHASE_NONE)
+			prv_next_phase(i2c.heldAck);
+	}
+	return value;
+}
+
+static void prv_write_dr(uint8_t value) {
+	uint16_t sr1 = prv_reg(REG_SR1);
+
+	if(i2c.srRead && (i2c.srSeen & I2C_SR1_SB) && (sr1 & I2C_SR1_SB)) {
+		prv_set(REG_SR1, 0, I2C_SR1_SB);
+		i2c.shift = value;
+		prv_begin(PHASE_ADDRESS, 9);
+		return;
+	}
+	if(i2c.srRead && (i2c.srSeen & I2C_SR1_BTF))
+		prv_set(REG_SR1, 0, I2C_SR1_BTF);
+	if(!(prv_reg(REG_SR2) & I2C_SR2_TRA) || (prv_reg(REG_SR1) & I2C_SR1_ADDR))
+		return;
+	if(i2c.phase == PHASE_NONE) {
+		i2c.shift = value;
+		prv_set(REG_SR1, I2C_SR1_TXE, I2C_SR1_BTF);
+		prv_begin(PHASE_TX, 9);
+	}
+	else {
+		i2c.dr = value;
+		i2c.drFull = true;
+		prv_set(REG_SR1, 0, I2C_SR1_TXE);
+	}
+}
+
+static void prv_reset(void) {
+	i2c.phase = PHASE_NONE;
+	i2c.phaseEnd = SIM_NEVER;
+	i2c.startPending = i2c.stopPending = false;
+	i2c.slave = 0;
+	i2c.read = false;
+	i2c.drFull = i2c.held = false;
+	i2c.srRead = false;
+	sim_store(I2C1_BASE + REG_SR1, 2, 0);
+	sim_store(I2C1_BASE + REG_SR2, 2, 0);
+}
+
+static void prv_write_cr1(uint16_t value) {
+	uint16_t old = prv_reg(REG_CR1);
+
+	if(value & I2C_CR1_SWRST) {
+		for(uint32_t offset = 0; offset < 0x28; offset += 4)
+			sim_store(I2C1_BASE + offset, 2, 0);
+		sim_store(I2C1_BASE + REG_CR1, 2, I2C_CR1_SWRST);
+		prv_reset();
+		return;
+	}
+	sim_store(I2C1_BASE + REG_CR1, 2, value);
+	if(!(value & I2C_CR1_PE)) {
+		prv_reset();
+		sim_store(I2C1_BASE + REG_CR1, 2, value & ~(I2C_CR1_START | I2C_CR1_STOP));
+		return;
+	}
+
+	// START e STOP: gerados já, com o barramento parado, ou ao fim do byte em curso
+	if((value & I2C_CR1_START) && !(old & I2C_CR1_START)) {
+		if(i2c.phase == PHASE_NONE)
+			prv_begin(PHASE_START, 1);
+		else
+			i2c.startPending = true;
+	}
+	if((value & I2C_CR1_STOP) && !(old & I2C_CR1_STOP) && (prv_reg(REG_SR2) & I2C_SR2_MSL)) {
+		if(i2c.phase == PHASE_NONE)
+			prv_begin(PHASE_STOP, 1);	// um byte retido continua disponível em DR
+		else
+			i2c.stopPending = true;
+	}
+}
+
+static uint64_t prv_next(SimDevice* dev) {
+	(void)dev;
+	return (i2c.phase == PHASE_NONE) ? SIM_NEVER : i2c.phaseEnd;
+}
+
+static void prv_advance(SimDevice* dev, uint64_t t) {
+	(void)dev;
+	// fases encadeadas começam no fim da anterior, e não no instante do avanço
+	while(i2c.phase != PHASE_NONE && i2c.phaseEnd <= t) {
+		i2c.now = i2c.phaseEnd;
+		prv_phase_done();
+	}
+}
+
+static uint32_t prv_read(SimDevice* dev, uint32_t offset, int size) {
+	i2c.now = sim_model_time();
+	if(offset == REG_SR1) {
+		i2c.srRead = true;
+		i2c.srSeen = prv_reg(REG_SR1);
+		return i2c.srSeen;
+	}
+	if(offset == REG_SR2) {
+		uint16_t sr2 = prv_reg(REG_SR2);
+		if(i2c.srRead && (i2c.srSeen & I2C_SR1_ADDR) && (prv_reg(REG_SR1) & I2C_SR1_ADDR))
+			prv_addr_cleared();
+		i2c.srRead = false;
+		return sr2;
+	}
+	if(offset == REG_DR) {
+		uint8_t value = prv_read_dr();
+		i2c.srRead = false;
+		return value;
+	}
+	return sim_load(dev->base + offset, size);
+}
+
+static void prv_write(SimDevice* dev, uint32_t offset, int size, uint32_t value) {
+	i2c.now = sim_model_time();
+	if(offset == REG_CR1) {
+		prv_write_cr1((uint16_t)value);
+		return;
+	}
+	if(offset == REG_DR) {
+		prv_write_dr((uint8_t)value);
+		i2c.srRead = false;
+		return;
+	}
+	if(offset == REG_SR1) {
+		uint16_t sr1 = prv_reg(REG_SR1);
+		sim_store(dev->base + offset, 2, (sr1 & ~SR1_ERRORS) | (sr1 & value & SR1_ERRORS));
+		return;
+	}
+	if(offset == REG_SR2)
+		return;	// apenas leitura
+	sim_store(dev->base + offset, size, value);
+}
+
+static bool prv_event_level(void* context) {
+	uint16_t sr1 = prv_reg(REG_SR1), cr2 = prv_reg(REG_CR2);
+	(void)context;
+
+	if(!(cr2 & I2C_CR2_ITEVTEN))
+		return false;
+	return (sr1 & SR1_EVENTS) || ((cr2 & I2C_CR2_ITBUFEN) && (sr1 & (I2C_SR1_TXE | I2C_SR1_RXNE)));
+}
+
+static bool prv_error_level(void* context) {
+	(void)context;
+	return (prv_reg(REG_CR2) & I2C_CR2_ITERREN) && (prv_reg(REG_SR1) & SR1_ERRORS);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void sim_i2c_init(void) {
+	memset(&i2c, 0, sizeof(i2c));
+	i2c.device = (SimDevice){ I2C1_BASE, 0x400, &i2c, prv_read, prv_write, prv_next, prv_advance };
+	prv_reset();
+	sim_device_add(&i2c.device);
+	sim_irq_source(I2C1_EV_IRQn, prv_event_level, &i2c);
+	sim_irq_source(I2C1_ER_IRQn, prv_error_level, &i2c);
+}
+
+/** \brief Liga um escravo ao barramento, com \b size registradores em \b memory (mantida por quem chama). */
+void sim_i2c_slave(uint8_t address, uint8_t* memory, int size) {
+	sim_lock();
+	if(i2c.slaveCount < MAX_SLAVES && size > 0)
+		i2c.slaves[i2c.slaveCount++] = (Slave){ address, memory, size, 0 };
+	sim_unlock();
+}
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/sim_internal.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Interface entre o núcleo da simulação (sim_stm32.c) e os modelos de periféricos.
+  *
+  * Cada periférico modelado é um SimDevice: uma faixa de endereços com funções de leitura e escrita,
+  * chamadas a cada acesso do firmware, e funções de avanço no tempo. Registradores sem modelo se
+  * comportam como memória. Todas as funções aqui executam dentro da simulação (tratadores de sinal),
+  * e não devem acessar os registradores pelos endereços reais: usam sim_load()/sim_store().
+  ******************************************************************************/
+
+#ifndef SIM_INTERNAL_H
+#define SIM_INTERNAL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_stm32.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Periférico modelado. */
+typedef struct SimDevice {
+	uint32_t 	base;		//!< Primeiro endereço.
+	uint32_t 	size;		//!< Tamanho da faixa.
+	void* 		context;	//!< Estado do modelo.
+	uint32_t 	(*read)(struct SimDevice* dev, uint32_t offset, int size);					//!< Opcional.
+	void 		(*write)(struct SimDevice* dev, uint32_t offset, int size, uint32_t value);	//!< Opcional.
+	uint64_t 	(*next)(struct SimDevice* dev);					//!< Próximo evento (UINT64_MAX: nenhum). Opcional.
+	void 		(*advance)(struct SimDevice* dev, uint64_t t);	//!< Processa eventos até \b t. Opcional.
+} SimDevice;
+
+/** \brief Stream de DMA (ver sim_dma_*()). */
+typedef struct SimDmaStream SimDmaStream;
+
+/* Exported constants --------------------------------------------------------*/
+#define SIM_NEVER		UINT64_MAX
+
+/* Exported functions ------------------------------------------------------- */
+uint32_t sim_load(uint32_t address, int size);
+void 	 sim_store(uint32_t address, int size, uint32_t value);
+void 	 sim_device_add(SimDevice* dev);
+void 	 sim_irq_source(IRQn_Type irq, bool (*level)(void* context), void* context);
+void 	 sim_lock(void);
+void 	 sim_unlock(void);
+uint64_t sim_idle(uint64_t until);
+void 	 sim_set_basepri(uint32_t priority);
+uint64_t sim_model_time(void);
+uint32_t sim_pclk(uint32_t address);
+
+SimDmaStream* sim_dma_stream(uint32_t peripheral, bool toMemory);
+bool sim_dma_to_memory(SimDmaStream* stream, uint32_t value);
+bool sim_dma_from_memory(SimDmaStream* stream, uint32_t* value);
+uint16_t sim_dma_remaining(SimDmaStream* stream);
+
+void sim_usart_init(void);
+void sim_i2c_init(void);
+void sim_rtos_init(void);
+
+#endif /* SIM_INTERNAL_H */
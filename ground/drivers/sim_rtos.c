@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/sim_rtos.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Subconjunto do FreeRTOS usado pelos drivers, sobre a simulação (ver host/FreeRTOS.h).
+  *
+  * Há uma única task. Bloquear em um semáforo salta o tempo simulado de evento em evento (sim_idle()),
+  * atendendo as interrupções, até o contador ser incrementado ou o prazo vencer; o tick é de 1 ms de
+  * tempo simulado. As seções críticas
+  * mascaram as interrupções de prioridade configMAX_SYSCALL_INTERRUPT_PRIORITY ou menor, como o port do
+  * Cortex-M4 (BASEPRI).
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "sim_internal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_SEMAPHORES		32
+#define TICK_NS				1000000ull
+
+/* Private typedef -----------------------------------------------------------*/
+struct SimSemaphore {
+	volatile uint32_t 	count;
+	uint32_t 			max;
+	volatile bool 		waiting;	//!< A task está bloqueada nele.
+};
+
+/* Private variables ---------------------------------------------------------*/
+static struct SimSemaphore semaphores[MAX_SEMAPHORES];
+static int semaphore_count = 0;
+static int critical_nesting = 0;
+static uint32_t switches = 0;
+
+/* Exported functions --------------------------------------------------------*/
+
+void sim_rtos_init(void) {
+	semaphore_count = 0;
+	critical_nesting = 0;
+}
+
+xSemaphoreHandle sim_rtos_semaphore(uint32_t max, uint32_t initial) {
+	if(semaphore_count == MAX_SEMAPHORES)
+		return 0;
+	struct SimSemaphore* s = &semaphores[semaphore_count++];
+	s->count = initial;
+	s->max = max;
+	s->waiting = false;
+	return s;
+}
+
+portBASE_TYPE xSemaphoreTake(xSemaphoreHandle semaphore, portTickType ticks) {
+	uint64_t start = sim_now();
+	portBASE_TYPE taken = pdFALSE;
+
+	semaphore->waiting = true;
+	for(;;) {
+		if(semaphore->count) {
+			sim_lock();
+			if(semaphore->count) {
+				semaphore->count--;
+				taken = pdTRUE;
+			}
+			sim_unlock();
+			if(taken)
+				break;
+		}
+		if(ticks != portMAX_DELAY && sim_now() - start >= ticks * TICK_NS)
+			break;
+		sim_idle((ticks == portMAX_DELAY) ? SIM_NEVER : start + ticks * TICK_NS);
+	}
+	semaphore->waiting = false;
+	return taken;
+}
+
+portBASE_TYPE xSemaphoreGive(xSemaphoreHandle semaphore) {
+	portBASE_TYPE given = pdFALSE;
+
+	sim_lock();
+	if(semaphore->count < semaphore->max) {
+		semaphore->count++;
+		given = pdTRUE;
+	}
+	sim_unlock();
+	return given;
+}
+
+portBASE_TYPE xSemaphoreGiveFromISR(xSemaphoreHandle semaphore, portBASE_TYPE* woken) {
+	if(semaphore->count >= semaphore->max)
+		return pdFALSE;
+	semaphore->count++;
+	if(semaphore->waiting && woken)
+		*woken = pdTRUE;
+	return pdTRUE;
+}
+
+void sim_rtos_yield_from_isr(portBASE_TYPE woken) {
+	if(woken)
+		switches++;
+}
+
+void sim_rtos_enter_critical(void) {
+	if(critical_nesting++ == 0)
+		sim_set_basepri(configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY);
+}
+
+void sim_rtos_exit_critical(void) {
+	if(--critical_nesting == 0)
+		sim_set_basepri(0);
+}
+
+portTickType xTaskGetTickCount(void) {
+	return (portTickType)(sim_now() / TICK_NS);
+}
+
+void vTaskDelay(portTickType ticks) {
+	sim_wait(ticks * TICK_NS);
+}
+
+portBASE_TYPE xTaskGetSchedulerState(void) {
+	return taskSCHEDULER_RUNNING;
+}
@@ -0,0 +1,1137 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/sim_stm32.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Núcleo da simulação: acessos a registradores, tempo, NVIC, DMA, GPIO e RCC.
+  *
+  * As faixas de periféricos (0x40000000) e do núcleo (0xE0000000) são reservadas sem permissão de
+  * acesso, e o conteúdo dos registradores fica em memória comum (periph_mem, core_mem). Um acesso do
+  * firmware gera um SIGSEGV: prv_decode() identifica a instrução (mov, movzx ou movsx, as únicas usadas
+  * com -O0), o acesso é repassado ao SimDevice da faixa, e a execução segue na instrução seguinte.
+  *
+  * O tempo simulado segue o tempo de CPU da task no host, e não o relógio de parede: a preempção do
+  * processo pelo sistema operacional não faz o tempo simulado andar. Ele é congelado enquanto a simulação
+  * executa (sim_enter()/sim_leave()), e todo esse tempo, somado ao custo de entrada e saída de cada sinal
+  * (medido em sim_init()), é descontado. Após cada acesso os modelos avançam até o instante atual, e as
+  * interrupções pendentes são atendidas (prv_dispatch()). Eventos futuros dos modelos (ex.: fim de um
+  * byte na USART) armam um timer POSIX, cujo sinal (SIGALRM) interrompe a task como uma interrupção de
+  * hardware. Esperas da task pelo RTOS (sim_idle()) saltam de evento em evento, sem depender do timer.
+  ******************************************************************************/
+
+#define _GNU_SOURCE
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+
+#include "sim_internal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PERIPH_START		0x40000000u		//!< Periféricos (APB1, APB2 e AHB1).
+#define PERIPH_SIZE			0x00080000u
+#define CORE_START			0xE0000000u		//!< Periféricos do Cortex-M4 (DWT, NVIC, SCB).
+#define CORE_SIZE			0x00100000u
+
+#define MAX_DEVICES			24
+#define TASK_STACK_SIZE		(8 * 1024 * 1024)
+#define STORM_LIMIT			1000000			//!< Entradas seguidas em interrupções sem a task voltar a executar.
+#define CALIBRATION_ROUNDS	9
+#define CALIBRATION_TRAPS	2000
+#define ALARM_SLACK			5000			//!< Antecipação máxima de um evento pelo timer, em ns.
+#define POLL_QUANTUM		1000			//!< Avanço de uma espera ativa sem evento pendente, em ns.
+#define DWT_CYCCNT_ADDRESS	0xE0001004u
+
+#define NVIC_ISER			0x100			//!< Deslocamentos a partir de 0xE000E000.
+#define NVIC_ICER			0x180
+#define NVIC_ISPR			0x200
+#define NVIC_ICPR			0x280
+#define NVIC_IP				0x400
+#define SCB_AIRCR			0xD0C
+
+#define DMA_FLAG_FEIF		0x01
+#define DMA_FLAG_DMEIF		0x04
+#define DMA_FLAG_TEIF		0x08
+#define DMA_FLAG_HTIF		0x10
+#define DMA_FLAG_TCIF		0x20
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Acesso a memória decodificado de uma instrução. */
+typedef struct {
+	bool 		store;		//!< Escrita (senão, leitura).
+	int 		size;		//!< Bytes acessados na memória.
+	int 		destSize;	//!< Bytes escritos no registrador de destino (leituras).
+	int 		extend;		//!< 0: nenhuma, 1: com zeros, 2: com sinal (movzx/movsx).
+	int 		reg;		//!< Registrador (campo reg do ModRM, com REX.R).
+	bool 		rex;		//!< Prefixo REX presente (muda o significado dos registradores de 8 bits).
+	bool 		immediate;	//!< Escrita de uma constante (\b value).
+	uint64_t 	value;		//!< Constante escrita.
+	int 		length;		//!< Tamanho da instrução.
+} Access;
+
+/** \brief Estado de um stream de DMA. */
+struct SimDmaStream {
+	uint32_t 	base;		//!< Endereço dos registradores do stream.
+	uint32_t 	isr;		//!< LISR ou HISR.
+	uint32_t 	shift;		//!< Posição dos flags do stream.
+	IRQn_Type 	irq;		//!< Canal de interrupção.
+	bool 		active;		//!< Habilitado (EN).
+	bool 		toMemory;	//!< Periférico para memória.
+	bool 		circular;	//!< Modo circular.
+	bool 		increment;	//!< Incremento na memória.
+	uint32_t 	peripheral;	//!< PAR no instante da habilitação.
+	uint32_t 	memory;		//!< M0AR no instante da habilitação.
+	uint16_t 	reload;		//!< NDTR no instante da habilitação.
+	uint16_t 	remaining;	//!< Transferências restantes.
+	uint32_t 	index;		//!< Posição na memória.
+};
+
+/** \brief Estado de uma porta de GPIO. */
+typedef struct {
+	uint16_t 	inputs;		//!< Nível dos pinos de entrada (ver sim_gpio_set_input()).
+} GpioState;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t periph_mem[PERIPH_SIZE];
+static uint8_t core_mem[CORE_SIZE];
+
+static SimDevice* devices[MAX_DEVICES];
+static int device_count = 0;
+
+/* tempo */
+static uint64_t origin;				//!< Relógio do host no início da simulação.
+static volatile uint64_t overhead;	//!< Tempo gasto na simulação, descontado do relógio.
+static uint64_t trap_cost;			//!< Custo de entrada e saída de um sinal, medido em sim_init().
+static uint64_t last_time;			//!< Último instante simulado (o tempo não retrocede).
+static uint64_t model_time;			//!< Instante congelado enquanto a simulação executa.
+static uint64_t enter_real;
+static volatile int depth = 0;
+static uint64_t warp = 0;			//!< Tempo saltado por esperas ativas em registradores (ver prv_poll()).
+static uint64_t idle_time = 0;		//!< Tempo saltado pela task ociosa (ver sim_idle()).
+
+/* espera ativa */
+static uint32_t poll_address;
+static uint32_t poll_value;
+static int poll_repeats = 0;
+static int cycle_reads = 0;			//!< Leituras seguidas de DWT_CYCCNT, sem outros acessos.
+
+/* interrupções */
+static struct { bool (*level)(void*); void* context; } sources[SIM_IRQ_COUNT];
+static uint32_t irq_enabled[3];
+static uint32_t irq_soft[3];
+static uint32_t irq_counts[SIM_IRQ_COUNT];
+static volatile uint32_t primask = 0;
+static volatile uint32_t basepri = 0;
+static int running = 256;			//!< Prioridade em execução (256: task).
+static volatile bool alarm_pending = false;
+static uint64_t accesses = 0;
+
+/* timer */
+static timer_t timer;
+static bool timer_ready = false;
+static uint64_t timer_armed = SIM_NEVER;	//!< Evento para o qual o timer está armado.
+
+/* DWT */
+static uint32_t cycle_offset = 0;
+
+/* DMA e GPIO */
+static SimDmaStream dma_streams[2][8];
+static GpioState gpio_ports[9];
+static SimGpioEdge gpio_edges[SIM_GPIO_EDGES];
+static volatile int gpio_edge_count = 0;
+
+/* Tratadores de interrupção do firmware (fracos: ausentes valem 0) */
+#define SIM_HANDLER(name)	extern void name(void) __attribute__((weak));
+SIM_HANDLER(EXTI0_IRQHandler) 		SIM_HANDLER(EXTI1_IRQHandler) 		SIM_HANDLER(EXTI2_IRQHandler)
+SIM_HANDLER(EXTI3_IRQHandler) 		SIM_HANDLER(EXTI4_IRQHandler) 		SIM_HANDLER(EXTI9_5_IRQHandler)
+SIM_HANDLER(EXTI15_10_IRQHandler)
+SIM_HANDLER(DMA1_Stream0_IRQHandler) SIM_HANDLER(DMA1_Stream1_IRQHandler) SIM_HANDLER(DMA1_Stream2_IRQHandler)
+SIM_HANDLER(DMA1_Stream3_IRQHandler) SIM_HANDLER(DMA1_Stream4_IRQHandler) SIM_HANDLER(DMA1_Stream5_IRQHandler)
+SIM_HANDLER(DMA1_Stream6_IRQHandler) SIM_HANDLER(DMA1_Stream7_IRQHandler)
+SIM_HANDLER(DMA2_Stream0_IRQHandler) SIM_HANDLER(DMA2_Stream1_IRQHandler) SIM_HANDLER(DMA2_Stream2_IRQHandler)
+SIM_HANDLER(DMA2_Stream3_IRQHandler) SIM_HANDLER(DMA2_Stream4_IRQHandler) SIM_HANDLER(DMA2_Stream5_IRQHandler)
+SIM_HANDLER(DMA2_Stream6_IRQHandler) SIM_HANDLER(DMA2_Stream7_IRQHandler)
+SIM_HANDLER(TIM2_IRQHandler) 		SIM_HANDLER(TIM3_IRQHandler) 		SIM_HANDLER(TIM4_IRQHandler)
+SIM_HANDLER(TIM5_IRQHandler)
+SIM_HANDLER(I2C1_EV_IRQHandler) 	SIM_HANDLER(I2C1_ER_IRQHandler)
+SIM_HANDLER(USART1_IRQHandler) 		SIM_HANDLER(USART2_IRQHandler) 		SIM_HANDLER(USART3_IRQHandler)
+SIM_HANDLER(USART6_IRQHandler)
+
+static void (* const handlers[SIM_IRQ_COUNT])(void) = {
+	[EXTI0_IRQn] = EXTI0_IRQHandler, [EXTI1_IRQn] = EXTI1_IRQHandler, [EXTI2_IRQn] = EXTI2_IRQHandler,
+	[EXTI3_IRQn] = EXTI3_IRQHandler, [EXTI4_IRQn] = EXTI4_IRQHandler, [EXTI9_5_IRQn] = EXTI9_5_IRQHandler,
+	[EXTI15_10_IRQn] = EXTI15_10_IRQHandler,
+	[DMA1_Stream0_IRQn] = DMA1_Stream0_IRQHandler, [DMA1_Stream1_IRQn] = DMA1_Stream1_IRQHandler,
+	[DMA1_Stream2_IRQn] = DMA1_Stream2_IRQHandler, [DMA1_Stream3_IRQn] = DMA1_Stream3_IRQHandler,
+	[DMA1_Stream4_IRQn] = DMA1_Stream4_IRQHandler, [DMA1_Stream5_IRQn] = DMA1_Stream5_IRQHandler,
+	[DMA1_Stream6_IRQn] = DMA1_Stream6_IRQHandler, [DMA1_Stream7_IRQn] = DMA1_Stream7_IRQHandler,
+	[DMA2_Stream0_IRQn] = DMA2_Stream0_IRQHandler, [DMA2_Stream1_IRQn] = DMA2_Stream1_IRQHandler,
+	[DMA2_Stream2_IRQn] = DMA2_Stream2_IRQHandler, [DMA2_Stream3_IRQn] = DMA2_Stream3_IRQHandler,
+	[DMA2_Stream4_IRQn] = DMA2_Stream4_IRQHandler, [DMA2_Stream5_IRQn] = DMA2_Stream5_IRQHandler,
+	[DMA2_Stream6_IRQn] = DMA2_Stream6_IRQHandler, [DMA2_Stream7_IRQn] = DMA2_Stream7_IRQHandler,
+	[TIM2_IRQn] = TIM2_IRQHandler, [TIM3_IRQn] = TIM3_IRQHandler, [TIM4_IRQn] = TIM4_IRQHandler,
+	[TIM5_IRQn] = TIM5_IRQHandler,
+	[I2C1_EV_IRQn] = I2C1_EV_IRQHandler, [I2C1_ER_IRQn] = I2C1_ER_IRQHandler,
+	[USART1_IRQn] = USART1_IRQHandler, [USART2_IRQn] = USART2_IRQHandler, [USART3_IRQn] = USART3_IRQHandler,
+	[USART6_IRQn] = USART6_IRQHandler,
+};
+
+/** Registradores gerais do host, na ordem da codificação x86-64. */
+static const int greg_index[16] = {
+	REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+	REG_R8,  REG_R9,  REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15
+};
+
+/** Variável do firmware (system_stm32f4xx.c, não compilado no host). */
+uint32_t SystemCoreClock = SIM_CORE_CLOCK;
+
+/* Private function prototypes -----------------------------------------------*/
+static void prv_advance(uint64_t t);
+static void prv_dispatch(void);
+static void prv_arm_timer(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Tempo de CPU da thread em execução, em ns. */
+static uint64_t prv_real(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void prv_fatal(const char* message, uint64_t value) {
+	static const char hex[] = "0123456789abcdef";
+	char text[20] = " 0x";
+	for(int i = 0; i < 16; i++)
+		text[3 + i] = hex[(value >> (60 - 4 * i)) & 0xF];
+	if(write(2, "sim: ", 5) < 0 || write(2, message, strlen(message)) < 0 || write(2, text, 19) < 0)
+		_exit(3);
+	if(write(2, "\n", 1) < 0)
+		_exit(3);
+	_exit(2);
+}
+
+/** \brief Entra na simulação: congela o tempo simulado.
+  * @param signal O custo de um sinal deve ser descontado (entrada por SIGSEGV ou SIGALRM).
+  */
+static void sim_enter(bool signal) {
+	if(depth++)
+		return;
+	enter_real = prv_real();
+	if(signal)
+		overhead += trap_cost;
+	uint64_t t = enter_real - origin - overhead + warp;
+	if((int64_t)t < (int64_t)last_time)
+		t = last_time;
+	last_time = model_time = t;
+}
+
+/** \brief Sai da simulação, descontando o tempo gasto nela. */
+static void sim_leave(void) {
+	if(--depth)
+		return;
+	overhead += prv_real() - enter_real;
+}
+
+/** \brief Instante do próximo evento dos modelos (SIM_NEVER: nenhum). */
+static uint64_t prv_next_event(void) {
+	uint64_t next = SIM_NEVER;
+	for(int i = 0; i < device_count; i++)
+		if(devices[i]->next) {
+			uint64_t e = devices[i]->next(devices[i]);
+			if(e < next)
+				next = e;
+		}
+	return next;
+}
+
+static uint8_t* prv_backing(uint32_t address) {
+	if(address - PERIPH_START < PERIPH_SIZE)
+		return &periph_mem[address - PERIPH_START];
+	if(address - CORE_START < CORE_SIZE)
+		return &core_mem[address - CORE_START];
+	return 0;
+}
+
+static SimDevice* prv_device(uint32_t address) {
+	for(int i = 0; i < device_count; i++)
+		if(address - devices[i]->base < devices[i]->size)
+			return devices[i];
+	return 0;
+}
+
+static uint32_t prv_read(uint32_t address, int size) {
+	SimDevice* dev = prv_device(address);
+	if(dev && dev->read)
+		return dev->read(dev, address - dev->base, size);
+	return sim_load(address, size);
+}
+
+static void prv_write(uint32_t address, int size, uint32_t value) {
+	SimDevice* dev = prv_device(address);
+	if(dev && dev->write)
+		dev->write(dev, address - dev->base, size, value);
+	else
+		sim_store(address, size, value);
+}
+
+/** \brief Decodifica a instrução que acessou um registrador.
+  * Aceita apenas as formas geradas pelo gcc com -O0 para acessos a ponteiros voláteis: mov (88, 89, 8A,
+  * 8B, C6, C7), movzx/movsx (0F B6, B7, BE, BF) e movsxd (63), com prefixos 66 e REX.
+  */
+static bool prv_decode(const uint8_t* code, Access* a) {
+	const uint8_t* p = code;
+	bool opsize = false;
+	uint8_t rex = 0;
+
+	memset(a, 0, sizeof(*a));
+	while(*p == 0x66 || *p == 0x2E || *p == 0x3E || *p == 0x26 || *p == 0x36) {
+		if(*p == 0x66)
+			opsize = true;
+		p++;
+	}
+	if((*p & 0xF0) == 0x40)
+		rex = *p++;
+	a->rex = (rex != 0);
+
+	int full = (rex & 0x08) ? 8 : (opsize ? 2 : 4);
+	uint8_t op = *p++;
+	int immediate = 0;
+
+	switch(op) {
+	case 0x88: a->store = true;  a->size = 1;    break;
+	case 0x89: a->store = true;  a->size = full; break;
+	case 0x8A: a->size = a->destSize = 1;        break;
+	case 0x8B: a->size = a->destSize = full;     break;
+	case 0xC6: a->store = a->immediate = true; a->size = 1; immediate = 1; break;
+	case 0xC7: a->store = a->immediate = true; a->size = full; immediate = (full == 2) ? 2 : 4; break;
+	case 0x63: a->size = 4; a->destSize = full; a->extend = 2; break;
+	case 0x0F:
+		op = *p++;
+		a->destSize = full;
+		switch(op) {
+		case 0xB6: a->size = 1; a->extend = 1; break;
+		case 0xB7: a->size = 2; a->extend = 1; break;
+		case 0xBE: a->size = 1; a->extend = 2; break;
+		case 0xBF: a->size = 2; a->extend = 2; break;
+		default: return false;
+		}
+		break;
+	default:
+		return false;
+	}
+
+	uint8_t modrm = *p++;
+	int mod = modrm >> 6, rm = modrm & 7;
+	a->reg = ((modrm >> 3) & 7) | ((rex & 0x04) ? 8 : 0);
+	if(mod == 3)
+		return false;
+	if(rm == 4) {
+		uint8_t sib = *p++;
+		if(mod == 0 && (sib & 7) == 5)
+			p += 4;
+	}
+	else if(mod == 0 && rm == 5) {
+		p += 4;
+	}
+	if(mod == 1)
+		p += 1;
+	else if(mod == 2)
+		p += 4;
+
+	if(immediate == 1)
+		a->value = *p;
+	else if(immediate == 2)
+		a->value = (uint16_t)(p[0] | (p[1] << 8));
+	else if(immediate == 4)
+		a->value = (uint64_t)(int64_t)(int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24));
+	p += immediate;
+
+	a->length = (int)(p - code);
+	return true;
+}
+
+static uint64_t prv_get_reg(greg_t* regs, const Access* a) {
+	if(a->size == 1 && !a->rex && a->reg >= 4 && a->reg < 8)
+		return ((uint64_t)regs[greg_index[a->reg - 4]] >> 8) & 0xFF;
+	return (uint64_t)regs[greg_index[a->reg]];
+}
+
+static void prv_set_reg(greg_t* regs, const Access* a, uint64_t value) {
+	uint64_t current;
+
+	if(a->destSize == 1 && !a->rex && a->reg >= 4 && a->reg < 8) {
+		current = (uint64_t)regs[greg_index[a->reg - 4]];
+		regs[greg_index[a->reg - 4]] = (greg_t)((current & ~0xFF00ull) | ((value & 0xFF) << 8));
+		return;
+	}
+	current = (uint64_t)regs[greg_index[a->reg]];
+	switch(a->destSize) {
+	case 1:  value = (current & ~0xFFull)   | (value & 0xFF);   break;
+	case 2:  value = (current & ~0xFFFFull) | (value & 0xFFFF); break;
+	case 4:  value &= 0xFFFFFFFFull; break;
+	default: break;
+	}
+	regs[greg_index[a->reg]] = (greg_t)value;
+}
+
+/** \brief Salta o tempo simulado até \b t, como se a task tivesse executado até lá. */
+static void prv_jump(uint64_t t) {
+	if(t != SIM_NEVER && t > model_time) {
+		warp += t - model_time;
+		last_time = model_time = t;
+	}
+}
+
+/** \brief Detecta esperas ativas: a mesma leitura repetida, com o mesmo valor e sem escritas entre elas.
+  * Nada pode mudar no valor lido até o próximo evento dos modelos, então o tempo simulado salta até ele,
+  * como se o laço tivesse executado até lá. Sem isso, cada volta custaria um sinal no host. Leituras de
+  * DWT_CYCCNT entre as repetições (limites de tempo da espera) são ignoradas; sem evento pendente, o
+  * salto é de POLL_QUANTUM, para que o limite seja alcançado: o tempo de CPU entre os sinais, descontado
+  * o custo mediano de cada um, pode não avançar. Pelo mesmo motivo, laços apenas sobre DWT_CYCCNT
+  * (atrasos) avançam até POLL_QUANTUM a cada três leituras.
+  */
+static void prv_poll(bool store, uint32_t address, uint32_t value) {
+	if(!store && address == DWT_CYCCNT_ADDRESS) {
+		if(++cycle_reads >= 3) {
+			uint64_t next = prv_next_event();
+			prv_jump((next < model_time + POLL_QUANTUM) ? next : model_time + POLL_QUANTUM);
+			cycle_reads = 0;
+		}
+		return;
+	}
+	cycle_reads = 0;
+	if(store || address != poll_address || value != poll_value) {
+		poll_address = store ? 0 : address;
+		poll_value = value;
+		poll_repeats = 0;
+		return;
+	}
+	if(++poll_repeats < 3)
+		return;
+
+	uint64_t next = prv_next_event();
+	prv_jump((next == SIM_NEVER) ? model_time + POLL_QUANTUM : next);
+	poll_repeats = 0;
+}
+
+/** \brief Acesso do firmware a um registrador. */
+static void prv_segv(int sig, siginfo_t* info, void* ucontext) {
+	ucontext_t* uc = ucontext;
+	greg_t* regs = uc->uc_mcontext.gregs;
+	uint64_t address = (uint64_t)(uintptr_t)info->si_addr;
+	Access a;
+
+	if(address > 0xFFFFFFFFull || !prv_backing((uint32_t)address))
+		prv_fatal("acesso inválido a", address);
+	if(!prv_decode((const uint8_t*)regs[REG_RIP], &a))
+		prv_fatal("instrução não suportada em", (uint64_t)regs[REG_RIP]);
+
+	sim_enter(true);
+	prv_advance(model_time);
+	accesses++;
+
+	if(a.store) {
+		uint64_t value = a.immediate ? a.value : prv_get_reg(regs, &a);
+		if(a.size == 8) {
+			prv_write((uint32_t)address, 4, (uint32_t)value);
+			prv_write((uint32_t)address + 4, 4, (uint32_t)(value >> 32));
+		}
+		else {
+			prv_write((uint32_t)address, a.size, (uint32_t)value);
+		}
+		prv_poll(true, (uint32_t)address, 0);
+	}
+	else {
+		uint64_t value;
+		if(a.size == 8)
+			value = prv_read((uint32_t)address, 4) | ((uint64_t)prv_read((uint32_t)address + 4, 4) << 32);
+		else
+			value = prv_read((uint32_t)address, a.size);
+		if(a.extend == 2)
+			value = (a.size == 1) ? (uint64_t)(int64_t)(int8_t)value
+				  : (a.size == 2) ? (uint64_t)(int64_t)(int16_t)value : (uint64_t)(int64_t)(int32_t)value;
+		prv_set_reg(regs, &a, value);
+		prv_poll(false, (uint32_t)address, (uint32_t)value);
+	}
+	regs[REG_RIP] += a.length;
+
+	prv_advance(model_time);
+	prv_dispatch();
+	prv_arm_timer();
+	sim_leave();
+	(void)sig;
+}
+
+/** \brief Evento de um modelo (ou interrupção adiada). */
+static void prv_alarm(int sig, siginfo_t* info, void* ucontext) {
+	if(depth) {
+		// a task está na simulação (sim_lock()): atendido por sim_unlock()
+		alarm_pending = true;
+		timer_armed = SIM_NEVER;
+		return;
+	}
+	sim_enter(true);
+	// o timer conta tempo de parede, que anda mais que o simulado: um evento quase vencido é tratado
+	// como vencido (senão o custo do próprio sinal adiaria o evento indefinidamente), a menos que o
+	// sinal seja de uma programação anterior do timer
+	struct itimerspec remaining;
+	timer_gettime(timer, &remaining);
+	if(!remaining.it_value.tv_sec && !remaining.it_value.tv_nsec && timer_armed == prv_next_event()
+	   && timer_armed - model_time <= ALARM_SLACK)
+		prv_jump(timer_armed);
+	timer_armed = SIM_NEVER;
+	prv_advance(model_time);
+	prv_dispatch();
+	prv_arm_timer();
+	sim_leave();
+	(void)sig; (void)info; (void)ucontext;
+}
+
+/** \brief Avança todos os modelos até o instante \b t, evento a evento. */
+static void prv_advance(uint64_t t) {
+	for(;;) {
+		uint64_t next = prv_next_event();
+		if(next > t)
+			break;
+		for(int i = 0; i < device_count; i++)
+			if(devices[i]->advance)
+				devices[i]->advance(devices[i], next);
+	}
+	for(int i = 0; i < device_count; i++)
+		if(devices[i]->advance)
+			devices[i]->advance(devices[i], t);
+}
+
+/** \brief Arma o timer para o próximo evento dos modelos.
+  * O timer conta tempo de parede, que nunca anda menos que o tempo simulado: no pior caso dispara
+  * antes do evento, e prv_alarm() apenas o rearma.
+  */
+static void prv_arm_timer(void) {
+	uint64_t next = prv_next_event();
+	struct itimerspec spec = {{0, 0}, {0, 0}};
+
+	if(!timer_ready || next == timer_armed)
+		return;
+	timer_armed = next;
+	if(next != SIM_NEVER) {
+		uint64_t delay = (next > model_time) ? next - model_time : 1;
+		spec.it_value.tv_sec  = delay / 1000000000ull;
+		spec.it_value.tv_nsec = delay % 1000000000ull;
+	}
+	timer_settime(timer, 0, &spec, 0);
+}
+
+static uint8_t prv_priority(int irq) {
+	return core_mem[0xE000E000 - CORE_START + NVIC_IP + irq] >> 4;
+}
+
+/** \brief Interrupção habilitada e pendente de maior prioridade que pode preemptar a execução atual. */
+static int prv_pending(void) {
+	int best = -1;
+	int bestPriority = running;
+
+	for(int irq = 0; irq < SIM_IRQ_COUNT; irq++) {
+		uint32_t bit = 1u << (irq & 31);
+		if(!(irq_enabled[irq >> 5] & bit) || !handlers[irq])
+			continue;
+		if(!(irq_soft[irq >> 5] & bit) && !(sources[irq].level && sources[irq].level(sources[irq].context)))
+			continue;
+		int priority = prv_priority(irq);
+		if(basepri && priority >= (int)basepri)
+			continue;
+		if(priority < bestPriority) {
+			best = irq;
+			bestPriority = priority;
+		}
+	}
+	return best;
+}
+
+/** \brief Atende as interrupções pendentes, preemptando o código interrompido pelo sinal. */
+static void prv_dispatch(void) {
+	uint32_t entries = 0;
+	int irq;
+
+	alarm_pending = false;
+	while(!primask && (irq = prv_pending()) >= 0) {
+		int previous = running;
+
+		irq_soft[irq >> 5] &= ~(1u << (irq & 31));
+		irq_counts[irq]++;
+		if(++entries > STORM_LIMIT)
+			prv_fatal("tempestade de interrupções no canal", (uint64_t)irq);
+
+		running = prv_priority(irq);
+		sim_leave();
+		handlers[irq]();
+		sim_enter(false);
+		running = previous;
+		prv_advance(model_time);
+	}
+}
+
+/** \brief Atende interrupções liberadas por código fora de sinais (desmascaramento, seções críticas). */
+static void prv_unmasked(void) {
+	if(depth)
+		return;
+	sim_lock();
+	sim_unlock();
+}
+
+/* NVIC, SCB e DWT -----------------------------------------------------------*/
+
+static void prv_nvic_write(SimDevice* dev, uint32_t offset, int size, uint32_t value) {
+	if(offset >= NVIC_ISER && offset < NVIC_ISER + 12 && size == 4) {
+		irq_enabled[(offset - NVIC_ISER) / 4] |= value;
+	}
+	else if(offset >= NVIC_ICER && offset < NVIC_ICER + 12 && size == 4) {
+		irq_enabled[(offset - NVIC_ICER) / 4] &= ~value;
+	}
+	else if(offset >= NVIC_ISPR && offset < NVIC_ISPR + 12 && size == 4) {
+		irq_soft[(offset - NVIC_ISPR) / 4] |= value;
+	}
+	else if(offset >= NVIC_ICPR && offset < NVIC_ICPR + 12 && size == 4) {
+		irq_soft[(offset - NVIC_ICPR) / 4] &= ~value;
+	}
+	else if(offset == SCB_AIRCR) {
+		sim_store(dev->base + offset, 4, 0xFA050000 | (value & 0x700));
+		return;
+	}
+	else {
+		sim_store(dev->base + offset, size, value);
+		return;
+	}
+	for(int i = 0; i < 3; i++) {
+		sim_store(dev->base + NVIC_ISER + 4 * i, 4, irq_enabled[i]);
+		sim_store(dev->base + NVIC_ICER + 4 * i, 4, irq_enabled[i]);
+		sim_store(dev->base + NVIC_ISPR + 4 * i, 4, irq_soft[i]);
+		sim_store(dev->base + NVIC_ICPR + 4 * i, 4, irq_soft[i]);
+	}
+}
+
+static SimDevice nvic_device = { 0xE000E000, 0x1000, 0, 0, prv_nvic_write, 0, 0 };
+
+static uint32_t prv_dwt_read(SimDevice* dev, uint32_t offset, int size) {
+	if(offset == 0x004)
+		return sim_cycles();
+	return sim_load(dev->base + offset, size);
+}
+
+static void prv_dwt_write(SimDevice* dev, uint32_t offset, int size, uint32_t value) {
+	if(offset == 0x004)
+		cycle_offset += value - sim_cycles();
+	else
+		sim_store(dev->base + offset, size, value);
+}
+
+static SimDevice dwt_device = { 0xE0001000, 0x1000, 0, prv_dwt_read, prv_dwt_write, 0, 0 };
+
+/* DMA -----------------------------------------------------------------------*/
+
+static uint32_t prv_dma_flags(SimDmaStream* s) {
+	return (sim_load(s->isr, 4) >> s->shift) & 0x3D;
+}
+
+static void prv_dma_set_flags(SimDmaStream* s, uint32_t flags) {
+	sim_store(s->isr, 4, sim_load(s->isr, 4) | (flags << s->shift));
+}
+
+static bool prv_dma_level(void* context) {
+	SimDmaStream* s = context;
+	uint32_t flags = prv_dma_flags(s);
+	uint32_t cr = sim_load(s->base, 4);
+	uint32_t enabled = ((cr & DMA_SxCR_TCIE) ? DMA_FLAG_TCIF : 0) | ((cr & DMA_SxCR_HTIE) ? DMA_FLAG_HTIF : 0)
+					 | ((cr & DMA_SxCR_TEIE) ? DMA_FLAG_TEIF : 0) | ((cr & DMA_SxCR_DMEIE) ? DMA_FLAG_DMEIF : 0)
+					 | ((sim_load(s->base + 0x14, 4) & DMA_SxFCR_FEIE) ? DMA_FLAG_FEIF : 0);
+	return (flags & enabled) != 0;
+}
+
+static void prv_dma_stop(SimDmaStream* s) {
+	s->active = false;
+	sim_store(s->base, 4, sim_load(s->base, 4) & ~DMA_SxCR_EN);
+}
+
+static void prv_dma_write(SimDevice* dev, uint32_t offset, int size, uint32_t value) {
+	SimDmaStream* streams = dev->context;
+
+	if(offset < 0x08)
+		return;	// LISR e HISR: apenas leitura
+	if(offset < 0x10) {
+		// LIFCR e HIFCR: escrever 1 limpa o flag correspondente; lidos como 0
+		uint32_t isr = dev->base + offset - 0x08;
+		sim_store(isr, 4, sim_load(isr, 4) & ~(value & 0x0F7D0F7D));
+		sim_store(dev->base + offset, 4, 0);
+		return;
+	}
+
+	uint32_t n = (offset - 0x10) / 0x18, reg = (offset - 0x10) % 0x18;
+	if(n > 7) {
+		sim_store(dev->base + offset, size, value);
+		return;
+	}
+	SimDmaStream* s = &streams[n];
+
+	if(reg != 0x00) {
+		// NDTR, PAR e M0AR só podem ser alterados com o stream desligado
+		if(!s->active)
+			sim_store(dev->base + offset, size, value);
+		return;
+	}
+
+	uint32_t old = sim_load(s->base, 4);
+	sim_store(dev->base + offset, size, value);
+	uint32_t cr = sim_load(s->base, 4);
+
+	if((cr & DMA_SxCR_EN) && !(old & DMA_SxCR_EN)) {
+		s->toMemory 	= (cr & DMA_SxCR_DIR) == 0;
+		s->circular 	= (cr & DMA_SxCR_CIRC) != 0;
+		s->increment 	= (cr & DMA_SxCR_MINC) != 0;
+		s->peripheral 	= sim_load(s->base + 0x08, 4);
+		s->memory 		= sim_load(s->base + 0x0C, 4);
+		s->reload 		= (uint16_t)sim_load(s->base + 0x04, 4);
+		s->remaining 	= s->reload;
+		s->index 		= 0;
+		s->active 		= (s->reload != 0);
+		if(!s->active)
+			sim_store(s->base, 4, cr & ~DMA_SxCR_EN);
+	}
+	else if(!(cr & DMA_SxCR_EN) && s->active) {
+		// desligado pelo software: TCIF indica o fim da transferência em curso
+		s->active = false;
+		prv_dma_set_flags(s, DMA_FLAG_TCIF);
+	}
+}
+
+/** \brief Conta uma transferência do stream, atualizando NDTR e os flags de metade e de fim. */
+static void prv_dma_step(SimDmaStream* s) {
+	if(s->increment)
+		s->index++;
+	s->remaining--;
+	if(s->remaining == s->reload / 2)
+		prv_dma_set_flags(s, DMA_FLAG_HTIF);
+	if(s->remaining == 0) {
+		prv_dma_set_flags(s, DMA_FLAG_TCIF);
+		if(s->circular) {
+			s->remaining = s->reload;
+			s->index = 0;
+		}
+		else {
+			prv_dma_stop(s);
+		}
+	}
+	sim_store(s->base + 0x04, 4, s->remaining);
+}
+
+static SimDevice dma_devices[2] = {
+	{ DMA1_BASE, 0x400, dma_streams[0], 0, prv_dma_write, 0, 0 },
+	{ DMA2_BASE, 0x400, dma_streams[1], 0, prv_dma_write, 0, 0 },
+};
+
+static void prv_dma_init(void) {
+	static const IRQn_Type irqs[2][8] = {
+		{ DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+		  DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn },
+		{ DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+		  DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn },
+	};
+	static const uint32_t shifts[4] = { 0, 6, 16, 22 };
+
+	for(int c = 0; c < 2; c++) {
+		for(int n = 0; n < 8; n++) {
+			SimDmaStream* s = &dma_streams[c][n];
+			s->base  = dma_devices[c].base + 0x10 + 0x18 * n;
+			s->isr   = dma_devices[c].base + ((n < 4) ? 0x00 : 0x04);
+			s->shift = shifts[n & 3];
+			s->irq   = irqs[c][n];
+			sim_irq_source(s->irq, prv_dma_level, s);
+		}
+		sim_device_add(&dma_devices[c]);
+	}
+}
+
+/* GPIO ----------------------------------------------------------------------*/
+
+static void prv_gpio_record(uint32_t port, uint16_t before, uint16_t after) {
+	uint16_t changed = before ^ after;
+	for(int pin = 0; pin < 16 && changed; pin++) {
+		if(!(changed & (1u << pin)))
+			continue;
+		changed &= ~(1u << pin);
+		if(gpio_edge_count < SIM_GPIO_EDGES)
+			gpio_edges[gpio_edge_count++] = (SimGpioEdge){ (GPIO_TypeDef*)(uintptr_t)port, (uint16_t)(1u << pin),
+														   (uint8_t)((after >> pin) & 1), model_time };
+	}
+}
+
+static uint32_t prv_gpio_read(SimDevice* dev, uint32_t offset, int size) {
+	uint32_t port = dev->base + (offset & ~0x3FFu);
+	uint32_t reg = offset & 0x3FF;
+
+	if(reg == 0x10) {
+		// IDR: saídas refletem ODR, entradas o nível dado por sim_gpio_set_input()
+		uint32_t moder = sim_load(port, 4);
+		uint16_t odr = (uint16_t)sim_load(port + 0x14, 2);
+		uint16_t idr = 0;
+		for(int pin = 0; pin < 16; pin++) {
+			bool output = ((moder >> (2 * pin)) & 3) == 1;
+			uint16_t source = output ? odr : gpio_ports[(offset >> 10)].inputs;
+			idr |= source & (1u << pin);
+		}
+		return (size == 4) ? idr : (idr >> (8 * (offset & 3))) & ((1u << (8 * size)) - 1);
+	}
+	return sim_load(dev->base + offset, size);
+}
+
+static void prv_gpio_write(SimDevice* dev, uint32_t offset, int size, uint32_t value) {
+	uint32_t port = dev->base + (offset & ~0x3FFu);
+	uint32_t reg = offset & 0x3FF;
+	uint16_t odr = (uint16_t)sim_load(port + 0x14, 2);
+	uint16_t next = odr;
+
+	if(reg == 0x18 || reg == 0x1A) {
+		// BSRRL (set) e BSRRH (reset); com 32 bits, os dois de uma vez
+		uint32_t bits = (reg == 0x1A) ? (value & 0xFFFF) << 16 : (size == 4) ? value : (value & 0xFFFF);
+		next = (uint16_t)((odr | (bits & 0xFFFF)) & ~(bits >> 16));
+		sim_store(port + 0x18, 4, 0);
+	}
+	else if(reg == 0x14) {
+		sim_store(dev->base + offset, size, value);
+		next = (uint16_t)sim_load(port + 0x14, 2);
+	}
+	else if(reg != 0x10) {
+		sim_store(dev->base + offset, size, value);
+	}
+
+	if(next != odr) {
+		sim_store(port + 0x14, 2, next);
+		prv_gpio_record(port, odr, next);
+	}
+}
+
+static SimDevice gpio_device = { GPIOA_BASE, 0x2400, 0, prv_gpio_read, prv_gpio_write, 0, 0 };
+
+/* RCC -----------------------------------------------------------------------*/
+
+/** \brief Registradores do RCC como deixados por SystemInit(): PLL a 168 MHz a partir do HSI. */
+static void prv_rcc_init(void) {
+	sim_store(RCC_BASE + 0x00, 4, RCC_CR_HSION | RCC_CR_HSIRDY | RCC_CR_PLLON | RCC_CR_PLLRDY);
+	sim_store(RCC_BASE + 0x04, 4, 16 | (336 << 6) | (7 << 24));					// PLLM, PLLN, PLLP = 2, PLLQ
+	sim_store(RCC_BASE + 0x08, 4, RCC_CFGR_SW_PLL | RCC_CFGR_SWS_PLL
+								| RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2);		// APB1 42 MHz, APB2 84 MHz
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/** \brief Lê um registrador sem passar pelos modelos (uso interno dos modelos). */
+uint32_t sim_load(uint32_t address, int size) {
+	uint8_t* p = prv_backing(address);
+	uint32_t value = 0;
+	if(p)
+		memcpy(&value, p, size);
+	return value;
+}
+
+/** \brief Escreve um registrador sem passar pelos modelos (uso interno dos modelos). */
+void sim_store(uint32_t address, int size, uint32_t value) {
+	uint8_t* p = prv_backing(address);
+	if(p)
+		memcpy(p, &value, size);
+}
+
+void sim_device_add(SimDevice* dev) {
+	if(device_count < MAX_DEVICES)
+		devices[device_count++] = dev;
+}
+
+void sim_irq_source(IRQn_Type irq, bool (*level)(void* context), void* context) {
+	sources[irq].level = level;
+	sources[irq].context = context;
+}
+
+/** \brief Entra na simulação a partir da task: os sinais dos modelos são adiados até sim_unlock(). */
+void sim_lock(void) {
+	sim_enter(false);
+}
+
+/** \brief Sai da simulação, atendendo os eventos e as interrupções que tenham ficado pendentes. */
+void sim_unlock(void) {
+	do {
+		if(depth == 1) {
+			prv_advance(model_time);
+			prv_dispatch();
+			prv_arm_timer();
+		}
+		sim_leave();
+	} while(!depth && alarm_pending && (sim_enter(false), true));
+}
+
+/** \brief Instante em que a simulação está (congelado durante o tratamento de um acesso). */
+uint64_t sim_model_time(void) {
+	return depth ? model_time : sim_now();
+}
+
+/** \brief Frequência do barramento (APB1 ou APB2) de um periférico. */
+uint32_t sim_pclk(uint32_t address) {
+	return (address >= APB2PERIPH_BASE) ? SIM_CORE_CLOCK / 2 : SIM_CORE_CLOCK / 4;
+}
+
+/** \brief Stream de DMA ligado, apontado para o registrador \b peripheral na direção dada (ou 0). */
+SimDmaStream* sim_dma_stream(uint32_t peripheral, bool toMemory) {
+	for(int c = 0; c < 2; c++)
+		for(int n = 0; n < 8; n++) {
+			SimDmaStream* s = &dma_streams[c][n];
+			if(s->active && s->peripheral == peripheral && s->toMemory == toMemory)
+				return s;
+		}
+	return 0;
+}
+
+/** \brief Transfere um byte do periférico para a memória pelo stream. */
+bool sim_dma_to_memory(SimDmaStream* stream, uint32_t value) {
+	if(!stream || !stream->active)
+		return false;
+	*(volatile uint8_t*)(uintptr_t)(stream->memory + stream->index) = (uint8_t)value;
+	prv_dma_step(stream);
+	return true;
+}
+
+/** \brief Transfere um byte da memória para o periférico pelo stream. */
+bool sim_dma_from_memory(SimDmaStream* stream, uint32_t* value) {
+	if(!stream || !stream->active)
+		return false;
+	*value = *(volatile uint8_t*)(uintptr_t)(stream->memory + stream->index);
+	prv_dma_step(stream);
+	return true;
+}
+
+/** \brief Transferências restantes do stream (NDTR), ou 0 se não houver stream. */
+uint16_t sim_dma_remaining(SimDmaStream* stream) {
+	return (stream && stream->active) ? stream->remaining : 0;
+}
+
+/** \brief Prepara a simulação: reserva as faixas de registradores, instala os tratadores de sinal,
+  * registra os modelos e mede o custo de um acesso simulado. Deve ser chamada antes de sim_run().
+  */
+void sim_init(void) {
+	struct sigaction action;
+	sigset_t alarm;
+
+	if(mmap((void*)(uintptr_t)PERIPH_START, PERIPH_SIZE, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) == MAP_FAILED ||
+	   mmap((void*)(uintptr_t)CORE_START, CORE_SIZE, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) == MAP_FAILED) {
+		perror("sim: mmap");
+		exit(2);
+	}
+	prctl(PR_SET_TIMERSLACK, 1, 0, 0, 0);
+
+	sigemptyset(&alarm);
+	sigaddset(&alarm, SIGALRM);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = prv_segv;
+	action.sa_flags = SA_SIGINFO | SA_NODEFER;
+	action.sa_mask = alarm;
+	sigaction(SIGSEGV, &action, 0);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = prv_alarm;
+	action.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigaction(SIGALRM, &action, 0);
+
+	prv_rcc_init();
+	sim_store(0xE000E000 + SCB_AIRCR, 4, 0xFA050000);
+	sim_device_add(&nvic_device);
+	sim_device_add(&dwt_device);
+	sim_device_add(&gpio_device);
+	prv_dma_init();
+	sim_usart_init();
+	sim_i2c_init();
+	sim_rtos_init();
+
+	// custo de um acesso: tempo total menos o tempo medido dentro do tratador, mediana de várias rodadas
+	uint64_t costs[CALIBRATION_ROUNDS];
+	volatile uint32_t* scratch = (volatile uint32_t*)(uintptr_t)(PERIPH_START + PERIPH_SIZE - 4);
+	origin = prv_real();
+	for(int r = 0; r < CALIBRATION_ROUNDS; r++) {
+		uint64_t before = overhead, start = prv_real();
+		for(int i = 0; i < CALIBRATION_TRAPS; i++)
+			(void)*scratch;
+		costs[r] = ((prv_real() - start) - (overhead - before)) / CALIBRATION_TRAPS;
+	}
+	for(int i = 1; i < CALIBRATION_ROUNDS; i++)
+		for(int j = i; j > 0 && costs[j] < costs[j - 1]; j--) {
+			uint64_t t = costs[j]; costs[j] = costs[j - 1]; costs[j - 1] = t;
+		}
+	trap_cost = costs[CALIBRATION_ROUNDS / 2];
+	accesses = 0;
+
+	struct sigevent event;
+	memset(&event, 0, sizeof(event));
+	event.sigev_notify = SIGEV_SIGNAL;
+	event.sigev_signo = SIGALRM;
+	timer_create(CLOCK_MONOTONIC, &event, &timer);
+}
+
+static void* prv_task(void* argument) {
+	sigset_t alarm;
+	sigemptyset(&alarm);
+	sigaddset(&alarm, SIGALRM);
+	pthread_sigmask(SIG_UNBLOCK, &alarm, 0);
+
+	// o relógio é o tempo de CPU desta thread
+	origin = prv_real();
+	overhead = 0;
+	warp = 0;
+	last_time = 0;
+	timer_ready = true;
+	((void (*)(void))argument)();
+	timer_ready = false;
+	return 0;
+}
+
+/** \brief Executa \b task como a única task do firmware, com as interrupções simuladas. */
+void sim_run(void (*task)(void)) {
+	pthread_attr_t attr;
+	pthread_t thread;
+	sigset_t alarm;
+
+	sigemptyset(&alarm);
+	sigaddset(&alarm, SIGALRM);
+	pthread_sigmask(SIG_BLOCK, &alarm, 0);
+
+	void* stack = mmap(0, TASK_STACK_SIZE, PROT_READ | PROT_WRITE,
+					   MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT | MAP_STACK, -1, 0);
+	if(stack == MAP_FAILED) {
+		perror("sim: pilha");
+		exit(2);
+	}
+	pthread_attr_init(&attr);
+	pthread_attr_setstack(&attr, stack, TASK_STACK_SIZE);
+
+	pthread_create(&thread, &attr, prv_task, (void*)task);
+	pthread_join(thread, 0);
+}
+
+/** \brief Tempo simulado, em ns. Nunca retrocede: o custo de um sinal descontado é uma mediana, e pode
+  * exceder o real; a leitura fica então no último instante já visto (a troca atômica protege contra um
+  * sinal entre a comparação e a escrita).
+  */
+uint64_t sim_now(void) {
+	if(depth)
+		return model_time;
+	uint64_t t = prv_real() - origin - overhead + warp;
+	uint64_t seen = __atomic_load_n(&last_time, __ATOMIC_RELAXED);
+	while((int64_t)t > (int64_t)seen)
+		if(__atomic_compare_exchange_n(&last_time, &seen, t, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return t;
+	return seen;
+}
+
+/** \brief Tempo simulado em ciclos do núcleo (o valor de DWT_CYCCNT). */
+uint32_t sim_cycles(void) {
+	return (uint32_t)(sim_model_time() * (SIM_CORE_CLOCK / 1000000) / 1000) + cycle_offset;
+}
+
+/** \brief Espera da task por \b ns de tempo simulado (as interrupções continuam sendo atendidas). */
+void sim_wait(uint64_t ns) {
+	uint64_t end = sim_now() + ns;
+	while(sim_idle(end) < end);
+}
+
+/** \brief A task, ociosa, salta até o próximo evento dos modelos ou até \b until, o que vier antes, e
+  * as interrupções pendentes são atendidas. Chamada em laços de espera, que reavaliam sua condição.
+  * @retval Instante alcançado: todos os eventos até ele foram processados.
+  */
+uint64_t sim_idle(uint64_t until) {
+	sim_enter(false);
+	uint64_t next = prv_next_event();
+	uint64_t from = model_time;
+	prv_jump((until < next) ? until : next);
+	uint64_t reached = model_time;
+	idle_time += reached - from;
+	sim_unlock();
+	return reached;
+}
+
+/** \brief Tempo simulado em que a task esteve ociosa (sim_idle(): semáforos, sim_wait()), em ns.
+  * Esperas ativas em registradores não contam: no Cortex-M4 elas ocupam o núcleo.
+  */
+uint64_t sim_idle_time(void) {
+	return idle_time;
+}
+
+uint32_t sim_irq_count(IRQn_Type irq) {
+	return ((int)irq >= 0 && irq < SIM_IRQ_COUNT) ? irq_counts[irq] : 0;
+}
+
+uint32_t sim_irq_total(void) {
+	uint32_t total = 0;
+	for(int i = 0; i < SIM_IRQ_COUNT; i++)
+		total += irq_counts[i];
+	return total;
+}
+
+/** \brief Acessos a registradores feitos pelo firmware. */
+uint64_t sim_accesses(void) {
+	return accesses;
+}
+
+/** \brief Marca uma interrupção como pendente (como NVIC_SetPendingIRQ()). */
+void sim_irq_raise(IRQn_Type irq) {
+	irq_soft[irq >> 5] |= 1u << (irq & 31);
+	prv_unmasked();
+}
+
+void sim_gpio_set_input(GPIO_TypeDef* port, uint16_t pin, uint8_t level) {
+	GpioState* state = &gpio_ports[((uint32_t)(uintptr_t)port - GPIOA_BASE) >> 10];
+	if(level)
+		state->inputs |= pin;
+	else
+		state->inputs &= ~pin;
+}
+
+int sim_gpio_edges(SimGpioEdge* edges, int max) {
+	int n = (gpio_edge_count < max) ? gpio_edge_count : max;
+	memcpy(edges, gpio_edges, n * sizeof(*edges));
+	return n;
+}
+
+void sim_gpio_clear_edges(void) {
+	gpio_edge_count = 0;
+}
+
+/* Cortex-M (core_cmFunc.h do host) ------------------------------------------*/
+
+uint32_t sim_get_primask(void) {
+	return primask;
+}
+
+void sim_set_primask(uint32_t value) {
+	primask = value & 1;
+	if(!primask)
+		prv_unmasked();
+}
+
+uint32_t sim_primask(void) {
+	return primask;
+}
+
+/** \brief Máscara de prioridade das seções críticas do FreeRTOS (0: nenhuma). */
+void sim_set_basepri(uint32_t priority) {
+	uint32_t previous = basepri;
+	basepri = priority;
+	if(!priority || (previous && priority > previous))
+		prv_unmasked();
+}
@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/sim_stm32.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Simulação, no host, dos periféricos do STM32F4 usados pelos drivers de comunicação.
+  *
+  * Os drivers do firmware (modules/common) são compilados sem alteração para o host. Os blocos de
+  * registradores ficam nos endereços reais, em páginas sem permissão de acesso: cada leitura ou escrita
+  * de registrador gera um SIGSEGV, cuja instrução é decodificada e executada pelos modelos dos
+  * periféricos (ver sim_stm32.c). Assim os efeitos colaterais de leitura (ex.: SR seguido de DR limpa
+  * RXNE e IDLE) e de escrita (ex.: bits rc_w0, IFCR, BSRR) são reproduzidos exatamente, no instante do
+  * acesso.
+  *
+  * O tempo simulado é o tempo de CPU da task no host, descontado do tempo gasto na própria simulação
+  * (tratadores de sinal e modelos); esperas da task (sim_wait(), semáforos, laços sobre um registrador)
+  * saltam direto para o próximo evento. Os modelos avançam em função dele: bytes saem da USART no ritmo do baudrate programado,
+  * a I2C1 percorre as fases de uma transação no ritmo de SCL (com escravos simulados, ver sim_i2c_slave()),
+  * o DMA atende as requisições dos periféricos, e as interrupções habilitadas no NVIC são atendidas, em
+  * ordem de prioridade e respeitando PRIMASK e as seções críticas, dentro de um tratador de sinal que
+  * interrompe o código do firmware, como faria o núcleo.
+  *
+  * Os ciclos reportados (DWT_CYCCNT) são o tempo simulado em ciclos de 168 MHz: medem o código compilado
+  * para o host, e não o do Cortex-M4. Já os tempos de barramento (bytes/s, bloqueio à espera do último
+  * bit) e as contagens (interrupções, acessos a registradores) independem do processador.
+  *
+  * O firmware roda em uma única thread ("task"), cuja pilha fica abaixo de 4 GiB para que endereços de
+  * buffers caibam nos registradores de 32 bits do DMA. O código precisa ser compilado com -O0 (apenas
+  * movimentações simples acessam a memória; ver prv_decode()) e ligado com -no-pie.
+  ******************************************************************************/
+
+#ifndef SIM_STM32_H
+#define SIM_STM32_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Byte visto no pino de TX de uma USART simulada. */
+typedef struct {
+	uint8_t 	value;		//!< Byte enviado.
+	uint64_t 	start;		//!< Início do start bit (ns de tempo simulado).
+	uint64_t 	end;		//!< Fim do stop bit (ns de tempo simulado).
+} SimUsartByte;
+
+/** \brief Chamada a cada byte que termina de sair por uma USART (no contexto da simulação).
+  * Pode injetar uma resposta com sim_usart_inject_at(); não deve acessar registradores.
+  */
+typedef void (*SimUsartListener)(USART_TypeDef* usart, const SimUsartByte* byte, void* context);
+
+/** \brief Mudança de nível de um pino de saída. */
+typedef struct {
+	GPIO_TypeDef* 	port;	//!< Porta.
+	uint16_t 		pin;	//!< Pino (\em GPIO_Pin_x).
+	uint8_t 		level;	//!< Novo nível.
+	uint64_t 		time;	//!< Instante (ns de tempo simulado).
+} SimGpioEdge;
+
+/* Exported constants --------------------------------------------------------*/
+
+/** Frequência do núcleo simulado (PLL a partir do HSI, como no firmware). */
+#define SIM_CORE_CLOCK		168000000
+
+/** Quantidade de canais de interrupção acompanhados. */
+#define SIM_IRQ_COUNT		82
+
+/** Bytes registrados por USART (ver sim_usart_tx()). */
+#define SIM_USART_LOG_SIZE	4096
+
+/** Mudanças de nível registradas (ver sim_gpio_edges()). */
+#define SIM_GPIO_EDGES		256
+
+/* Exported functions ------------------------------------------------------- */
+
+/* núcleo (sim_stm32.c) */
+void 	 sim_init(void);
+void 	 sim_run(void (*task)(void));
+uint64_t sim_now(void);
+uint32_t sim_cycles(void);
+void 	 sim_wait(uint64_t ns);
+uint64_t sim_idle_time(void);
+uint32_t sim_irq_count(IRQn_Type irq);
+uint32_t sim_irq_total(void);
+uint64_t sim_accesses(void);
+uint32_t sim_primask(void);
+void 	 sim_irq_raise(IRQn_Type irq);
+
+/* GPIO (sim_stm32.c) */
+void 	 sim_gpio_set_input(GPIO_TypeDef* port, uint16_t pin, uint8_t level);
+int 	 sim_gpio_edges(SimGpioEdge* edges, int max);
+void 	 sim_gpio_clear_edges(void);
+
+/* USART (sim_usart.c) */
+int 	 sim_usart_tx(USART_TypeDef* usart, SimUsartByte* bytes, int max);
+void 	 sim_usart_tx_clear(USART_TypeDef* usart);
+void 	 sim_usart_set_listener(USART_TypeDef* usart, SimUsartListener listener, void* context);
+void 	 sim_usart_inject(USART_TypeDef* usart, const uint8_t* data, int length);
+void 	 sim_usart_inject_at(USART_TypeDef* usart, const uint8_t* data, int length, uint64_t start);
+uint64_t sim_usart_frame_ns(USART_TypeDef* usart);
+
+/* I2C1 (sim_i2c.c) */
+void 	 sim_i2c_slave(uint8_t address, uint8_t* memory, int size);
+
+#endif /* SIM_STM32_H */
@@ -0,0 +1,319 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/sim_usart.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Modelo das USARTs 1, 2, 3 e 6 do STM32F4 (8-N-1), com requisições de DMA.
+  *
+  * Envio: o byte escrito em DR (pelo software ou pelo DMA, com DMAT) vai para o registrador de
+  * deslocamento assim que ele fica livre, liberando TXE; cada byte ocupa a linha por 10 bits no baudrate
+  * dado por BRR e OVER8. TC é ligado quando a linha fica ociosa sem dados em DR, e só é limpo pelo
+  * software (escrita de 0 em SR, ou leitura de SR seguida de escrita em DR), como no hardware.
+  *
+  * Recebimento: bytes injetados por sim_usart_inject() chegam no ritmo da linha. Com DMAR e um stream
+  * apontado para DR, vão direto para a memória; senão ligam RXNE (ou ORE, se o anterior não foi lido).
+  * IDLE é ligado um quadro após o último byte de uma rajada. Leituras de DR limpam RXNE, e, se
+  * precedidas por uma leitura de SR, os flags de erro e IDLE vistos nela.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "sim_internal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define USART_COUNT			4
+#define RX_QUEUE_SIZE		1024			//!< Bytes injetados ainda não recebidos (potência de 2).
+#define SR_RC_W0			0x0360			//!< CTS, LBD, TC e RXNE: limpos escrevendo 0.
+#define SR_READ_CLEARED		(USART_SR_IDLE | USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Estado de uma USART simulada. */
+typedef struct {
+	SimDevice 			device;
+	IRQn_Type 			irq;
+
+	bool 				tdrFull;		//!< Há um byte em DR esperando o registrador de deslocamento.
+	uint8_t 			tdr;
+	bool 				shifting;		//!< Byte saindo pela linha.
+	SimUsartByte 		shift;			//!< Byte em \b shifting.
+
+	uint8_t 			rxData[RX_QUEUE_SIZE];
+	uint64_t 			rxTime[RX_QUEUE_SIZE];	//!< Fim do stop bit de cada byte injetado.
+	uint32_t 			rxHead, rxTail;
+	uint16_t 			rdr;			//!< Último byte recebido (lido em DR).
+	uint64_t 			idleAt;			//!< Detecção de linha ociosa (SIM_NEVER: desarmada).
+
+	bool 				srRead;			//!< A última leitura foi de SR (sequências de limpeza).
+	uint16_t 			srSeen;			//!< Valor lido de SR.
+
+	SimUsartByte 		log[SIM_USART_LOG_SIZE];
+	int 				logCount;
+	SimUsartListener 	listener;
+	void* 				context;
+} UsartState;
+
+/* Private variables ---------------------------------------------------------*/
+static UsartState usarts[USART_COUNT];
+static const uint32_t usart_bases[USART_COUNT] = { USART1_BASE, USART2_BASE, USART3_BASE, USART6_BASE };
+static const IRQn_Type usart_irqs[USART_COUNT] = { USART1_IRQn, USART2_IRQn, USART3_IRQn, USART6_IRQn };
+
+/* Private functions ---------------------------------------------------------*/
+
+static UsartState* prv_usart(USART_TypeDef* usart) {
+	for(int i = 0; i < USART_COUNT; i++)
+		if(usarts[i].device.base == (uint32_t)(uintptr_t)usart)
+			return &usarts[i];
+	return 0;
+}
+
+static uint16_t prv_reg(UsartState* u, uint32_t offset) {
+	return (uint16_t)sim_load(u->device.base + offset, 2);
+}
+
+static void prv_set_sr(UsartState* u, uint16_t set, uint16_t clear) {
+	sim_store(u->device.base + 0x00, 2, (prv_reg(u, 0x00) | set) & ~clear);
+}
+
+/** \brief Duração de um quadro 8-N-1 (10 bits), em ns. */
+static uint64_t prv_frame(UsartState* u) {
+	uint32_t brr = prv_reg(u, 0x08);
+	uint32_t div = (prv_reg(u, 0x0C) & USART_CR1_OVER8) ? ((brr & 0xFFF0) >> 1) | (brr & 0x07) : brr;
+	if(!div)
+		return 1000000;
+	return 10ull * div * 1000000000ull / sim_pclk(u->device.base);
+}
+
+static bool prv_enabled(UsartState* u, uint16_t direction) {
+	uint16_t cr1 = prv_reg(u, 0x0C);
+	return (cr1 & USART_CR1_UE) && (cr1 & direction);
+}
+
+/** \brief Move bytes para DR (via DMA) e de DR para o registrador de deslocamento, no instante \b t. */
+static void prv_tx_service(UsartState* u, uint64_t t) {
+	if(!prv_enabled(u, USART_CR1_TE))
+		return;
+	for(;;) {
+		if(!u->tdrFull && (prv_reg(u, 0x14) & USART_CR3_DMAT)) {
+			uint32_t value;
+			if(sim_dma_from_memory(sim_dma_stream(u->device.base + 0x04, false), &value)) {
+				u->tdr = (uint8_t)value;
+				u->tdrFull = true;
+				prv_set_sr(u, 0, USART_SR_TXE);
+			}
+		}
+		if(u->shifting || !u->tdrFull)
+			break;
+		u->shifting = true;
+		u->shift = (SimUsartByte){ u->tdr, t, t + prv_frame(u) };
+		u->tdrFull = false;
+		prv_set_sr(u, USART_SR_TXE, 0);
+	}
+}
+
+/** \brief Fim do byte em \b shifting. */
+static void prv_tx_done(UsartState* u) {
+	SimUsartByte byte = u->shift;
+
+	u->shifting = false;
+	if(u->logCount < SIM_USART_LOG_SIZE)
+		u->log[u->logCount++] = byte;
+	prv_tx_service(u, byte.end);
+	if(!u->shifting && !u->tdrFull)
+		prv_set_sr(u, USART_SR_TC, 0);
+	if(u->listener)
+		u->listener((USART_TypeDef*)(uintptr_t)u->device.base, &byte, u->context);
+}
+
+/** \brief Chegada do primeiro byte da fila de recebimento. */
+static void prv_rx_arrival(UsartState* u) {
+	uint32_t i = u->rxTail++ & (RX_QUEUE_SIZE - 1);
+	uint8_t byte = u->rxData[i];
+	uint64_t t = u->rxTime[i];
+
+	if(!prv_enabled(u, USART_CR1_RE))
+		return;
+	u->idleAt = t + prv_frame(u);
+	if((prv_reg(u, 0x14) & USART_CR3_DMAR) && sim_dma_to_memory(sim_dma_stream(u->device.base + 0x04, true), byte)) {
+		u->rdr = byte;
+		return;
+	}
+	if(prv_reg(u, 0x00) & USART_SR_RXNE) {
+		prv_set_sr(u, USART_SR_ORE, 0);
+		return;
+	}
+	u->rdr = byte;
+	prv_set_sr(u, USART_SR_RXNE, 0);
+}
+
+static uint64_t prv_next(SimDevice* dev) {
+	UsartState* u = dev->context;
+	uint64_t next = u->idleAt;
+
+	if(u->shifting && u->shift.end < next)
+		next = u->shift.end;
+	if(u->rxHead != u->rxTail && u->rxTime[u->rxTail & (RX_QUEUE_SIZE - 1)] < next)
+		next = u->rxTime[u->rxTail & (RX_QUEUE_SIZE - 1)];
+	return next;
+}
+
+static void prv_advance(SimDevice* dev, uint64_t t) {
+	UsartState* u = dev->context;
+
+	for(;;) {
+		uint64_t next = prv_next(dev);
+		if(next > t)
+			break;
+		if(u->shifting && u->shift.end == next) {
+			prv_tx_done(u);
+		}
+		else if(u->rxHead != u->rxTail && u->rxTime[u->rxTail & (RX_QUEUE_SIZE - 1)] == next) {
+			prv_rx_arrival(u);
+		}
+		else {
+			u->idleAt = SIM_NEVER;
+			prv_set_sr(u, USART_SR_IDLE, 0);
+		}
+	}
+	prv_tx_service(u, t);
+}
+
+static uint32_t prv_read(SimDevice* dev, uint32_t offset, int size) {
+	UsartState* u = dev->context;
+
+	if(offset == 0x00) {
+		u->srRead = true;
+		u->srSeen = prv_reg(u, 0x00);
+		return u->srSeen;
+	}
+	if(offset == 0x04) {
+		uint16_t clear = USART_SR_RXNE | (u->srRead ? (u->srSeen & SR_READ_CLEARED) : 0);
+		u->srRead = false;
+		prv_set_sr(u, 0, clear);
+		return u->rdr;
+	}
+	return sim_load(dev->base + offset, size);
+}
+
+static void prv_write(SimDevice* dev, uint32_t offset, int size, uint32_t value) {
+	UsartState* u = dev->context;
+
+	if(offset == 0x00) {
+		uint16_t sr = prv_reg(u, 0x00);
+		sim_store(dev->base, 2, (sr & ~SR_RC_W0) | (sr & value & SR_RC_W0));
+		return;
+	}
+	if(offset == 0x04) {
+		if(u->srRead && (u->srSeen & USART_SR_TC))
+			prv_set_sr(u, 0, USART_SR_TC);
+		u->srRead = false;
+		if(prv_enabled(u, USART_CR1_TE) && !u->tdrFull) {
+			u->tdr = (uint8_t)value;
+			u->tdrFull = true;
+			prv_set_sr(u, 0, USART_SR_TXE);
+			prv_tx_service(u, sim_model_time());
+		}
+		return;
+	}
+	sim_store(dev->base + offset, size, value);
+}
+
+static bool prv_level(void* context) {
+	UsartState* u = context;
+	uint16_t sr = prv_reg(u, 0x00), cr1 = prv_reg(u, 0x0C);
+
+	return ((cr1 & USART_CR1_TXEIE)  && (sr & USART_SR_TXE))
+		|| ((cr1 & USART_CR1_TCIE)   && (sr & USART_SR_TC))
+		|| ((cr1 & USART_CR1_RXNEIE) && (sr & (USART_SR_RXNE | USART_SR_ORE)))
+		|| ((cr1 & USART_CR1_IDLEIE) && (sr & USART_SR_IDLE))
+		|| ((cr1 & USART_CR1_PEIE)   && (sr & USART_SR_PE));
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void sim_usart_init(void) {
+	for(int i = 0; i < USART_COUNT; i++) {
+		UsartState* u = &usarts[i];
+		memset(u, 0, sizeof(*u));
+		u->device = (SimDevice){ usart_bases[i], 0x400, u, prv_read, prv_write, prv_next, prv_advance };
+		u->irq = usart_irqs[i];
+		u->idleAt = SIM_NEVER;
+		sim_store(u->device.base + 0x00, 2, USART_SR_TXE | USART_SR_TC);
+		sim_device_add(&u->device);
+		sim_irq_source(u->irq, prv_level, u);
+	}
+}
+
+/** \brief Copia os bytes já enviados pela USART (até \b max), em ordem.
+  * @retval Quantidade de bytes registrados desde a última chamada de sim_usart_tx_clear().
+  */
+int sim_usart_tx(USART_TypeDef* usart, SimUsartByte* bytes, int max) {
+	UsartState* u = prv_usart(usart);
+	int n;
+
+	if(!u)
+		return 0;
+	sim_lock();
+	n = (u->logCount < max) ? u->logCount : max;
+	if(bytes)
+		memcpy(bytes, u->log, n * sizeof(*bytes));
+	n = u->logCount;
+	sim_unlock();
+	return n;
+}
+
+void sim_usart_tx_clear(USART_TypeDef* usart) {
+	UsartState* u = prv_usart(usart);
+	if(u) {
+		sim_lock();
+		u->logCount = 0;
+		sim_unlock();
+	}
+}
+
+void sim_usart_set_listener(USART_TypeDef* usart, SimUsartListener listener, void* context) {
+	UsartState* u = prv_usart(usart);
+	if(u) {
+		sim_lock();
+		u->listener = listener;
+		u->context = context;
+		sim_unlock();
+	}
+}
+
+/** \brief Injeta bytes no RX da USART, um quadro após o outro a partir de \b start (ns de tempo simulado),
+  * ou logo após os bytes já injetados, se estes terminarem depois.
+  */
+void sim_usart_inject_at(USART_TypeDef* usart, const uint8_t* data, int length, uint64_t start) {
+	UsartState* u = prv_usart(usart);
+	if(!u)
+		return;
+
+	sim_lock();
+	uint64_t frame = prv_frame(u);
+	uint64_t t = start;
+	if(u->rxHead != u->rxTail && u->rxTime[(u->rxHead - 1) & (RX_QUEUE_SIZE - 1)] > t)
+		t = u->rxTime[(u->rxHead - 1) & (RX_QUEUE_SIZE - 1)];
+	for(int i = 0; i < length && u->rxHead - u->rxTail < RX_QUEUE_SIZE; i++) {
+		t += frame;
+		u->rxData[u->rxHead & (RX_QUEUE_SIZE - 1)] = data[i];
+		u->rxTime[u->rxHead & (RX_QUEUE_SIZE - 1)] = t;
+		u->rxHead++;
+	}
+	sim_unlock();
+}
+
+/** \brief Injeta bytes no RX da USART a partir de agora. Ver sim_usart_inject_at(). */
+void sim_usart_inject(USART_TypeDef* usart, const uint8_t* data, int length) {
+	sim_lock();
+	sim_usart_inject_at(usart, data, length, sim_model_time());
+	sim_unlock();
+}
+
+/** \brief Duração de um quadro (10 bits) no baudrate programado, em ns. */
+uint64_t sim_usart_frame_ns(USART_TypeDef* usart) {
+	UsartState* u = prv_usart(usart);
+	return u ? prv_frame(u) : 0;
+}
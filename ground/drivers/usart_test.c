@@ -0,0 +1,265 @@
+/**
+  ******************************************************************************
+  * @file    ground/drivers/usart_test.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Testes, no host, do envio e do recebimento de c_common_uart.c.
+  *
+  * O driver é compilado sem alteração contra os periféricos simulados (ver sim_stm32.h): os bytes são
+  * conferidos no pino de TX simulado, com os instantes de início e fim de cada quadro, e as interrupções
+  * são contadas por canal.
+  *
+  * Uso:
+  * \code
+  *   make test
+  * \endcode
+  * Imprime uma linha por verificação e termina com código diferente de zero em caso de falha.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+#include "c_common_uart.h"
+#include "sim_stm32.h"
+
+/* Private define ------------------------------------------------------------*/
+#define NS_PER_US		1000ull
+#define TICKS_MS(ms)	((ms) / portTICK_RATE_MS)
+
+/* Private macro -------------------------------------------------------------*/
+#define CHECK(cond, ...)	prv_check((cond), #cond, __VA_ARGS__)
+
+/* Private variables ---------------------------------------------------------*/
+static int failures = 0;
+static int checks = 0;
+static SimUsartByte line[SIM_USART_LOG_SIZE];
+static int done_calls = 0;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void prv_check(int ok, const char* expression, const char* name) {
+	checks++;
+	if(ok) {
+		printf("ok     %s\n", name);
+	} else {
+		printf("FALHA  %s: %s\n", name, expression);
+		failures++;
+	}
+}
+
+/** \brief Compara os bytes vistos no pino de TX com \b expected, e confere que saíram sem intervalos. */
+static int prv_line_is(USART_TypeDef* usart, const uint8_t* expected, int length) {
+	int n = sim_usart_tx(usart, line, SIM_USART_LOG_SIZE);
+	if(n != length)
+		return 0;
+	for(int i = 0; i < n; i++) {
+		if(line[i].value != expected[i])
+			return 0;
+		if(i && line[i].start != line[i - 1].end)
+			return 0;
+	}
+	return 1;
+}
+
+static void prv_done(void* context) {
+	(void)context;
+	done_calls++;
+}
+
+/** \brief Envio copiado: os bytes saem em ordem, e flush só retorna após o último stop bit. */
+static void test_write_flush(void) {
+	static const uint8_t text[] = "proVANT";
+
+	sim_usart_tx_clear(USART2);
+	CHECK(c_common_usart_write(USART2, text, 7) == 7, "write aceita o bloco inteiro");
+	bool flushed = c_common_usart_flush(USART2, TICKS_MS(10));
+	uint64_t returned = sim_now();
+
+	CHECK(prv_line_is(USART2, text, 7), "write: bytes no pino, em ordem e sem intervalos");
+	int n = sim_usart_tx(USART2, line, SIM_USART_LOG_SIZE);
+	CHECK(n == 7 && returned >= line[6].end, "flush retorna após o fim do último stop bit");
+	CHECK(n == 7 && returned - line[6].end < 50 * NS_PER_US, "flush retorna logo após o último stop bit");
+	CHECK(flushed && !(USART2->CR1 & USART_CR1_TCIE), "flush retorna true e desliga TCIE");
+	CHECK(sim_irq_count(DMA1_Stream6_IRQn) == 1, "write: uma interrupção de DMA por transferência");
+}
+
+/** \brief Flush limitado: esgotado, retorna false e conta um timeout; a espera seguinte termina o envio. */
+static void test_flush_timeout(void) {
+	static uint8_t data[64];
+	USARTTxStats before = c_common_usart_tx_stats(USART2);
+
+	sim_usart_tx_clear(USART2);
+	c_common_usart_write(USART2, data, sizeof(data));	// ~5,6 ms a 115200 bit/s
+	uint64_t start = sim_now();
+	bool early = c_common_usart_flush(USART2, TICKS_MS(2));
+	uint64_t waited = sim_now() - start;
+	bool late = c_common_usart_flush(USART2, TICKS_MS(20));
+
+	USARTTxStats after = c_common_usart_tx_stats(USART2);
+	int n = sim_usart_tx(USART2, line, SIM_USART_LOG_SIZE);
+	CHECK(!early && waited >= 2000 * NS_PER_US && waited < 3000 * NS_PER_US, "flush esgotado retorna false no prazo");
+	CHECK(after.timeouts - before.timeouts == 1, "flush esgotado contado em timeouts");
+	CHECK(late && n == (int)sizeof(data) && sim_now() - line[n - 1].end < 50 * NS_PER_US,
+		  "flush seguinte acorda com o último stop bit");
+}
+
+/** \brief Segmentos sem cópia saem depois do que já estava no buffer, na ordem dada. */
+static void test_queue_order(void) {
+	static const uint8_t header[2] = { 0xFF, 0xFF };
+	static const uint8_t expected[] = { 'A', 'B', 0xFF, 0xFF, 1, 2, 3, 4, 0x55 };
+	uint8_t body[4] = { 1, 2, 3, 4 };
+	uint8_t checksum = 0x55;
+	USARTTxStats before = c_common_usart_tx_stats(USART2);
+	uint32_t irqs = sim_irq_count(DMA1_Stream6_IRQn);
+
+	sim_usart_tx_clear(USART2);
+	done_calls = 0;
+
+	__disable_irq();
+	c_common_usart_write(USART2, (const uint8_t *)"AB", 2);
+	USARTTxSegment packet[] = { { header, 2, 0, 0 }, { body, 4, 0, 0 }, { &checksum, 1, prv_done, 0 } };
+	bool accepted = c_common_usart_queue(USART2, packet, 3);
+	__enable_irq();
+	c_common_usart_flush(USART2, TICKS_MS(10));
+
+	USARTTxStats after = c_common_usart_tx_stats(USART2);
+	CHECK(accepted, "queue aceita os segmentos");
+	CHECK(prv_line_is(USART2, expected, sizeof(expected)), "queue: buffer em preenchimento antes dos segmentos");
+	CHECK(done_calls == 1, "queue: função de conclusão chamada uma vez");
+	CHECK(after.segments - before.segments == 3, "queue: segmentos contados");
+	CHECK(sim_irq_count(DMA1_Stream6_IRQn) - irqs == after.transfers - before.transfers,
+		  "queue: uma interrupção de DMA por segmento");
+}
+
+/** \brief Sem espaço, write aceita apenas o que cabe e queue recusa o pedido inteiro. */
+static void test_backpressure(void) {
+	static uint8_t data[3 * USART_TX_BUFFER_SIZE];
+	USARTTxSegment segments[USART_TX_QUEUE_SIZE + 1];
+	USARTTxStats before = c_common_usart_tx_stats(USART2);
+
+	for(unsigned i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)i;
+	for(int i = 0; i <= USART_TX_QUEUE_SIZE; i++)
+		segments[i] = (USARTTxSegment){ data, 1, 0, 0 };
+
+	sim_usart_tx_clear(USART2);
+	int accepted = c_common_usart_write(USART2, data, sizeof(data));
+	accepted += c_common_usart_write(USART2, data + accepted, sizeof(data) - accepted);
+	bool queued = c_common_usart_queue(USART2, segments, USART_TX_QUEUE_SIZE + 1);
+	c_common_usart_flush(USART2, TICKS_MS(50));	// 256 bytes: ~22 ms
+
+	USARTTxStats after = c_common_usart_tx_stats(USART2);
+	CHECK(accepted == 2 * USART_TX_BUFFER_SIZE, "write: aceita até encher os dois buffers");
+	CHECK(after.overrun - before.overrun == sizeof(data) * 2 - accepted - USART_TX_BUFFER_SIZE,
+		  "write: bytes recusados contados em overrun");
+	CHECK(!queued && after.backpressure - before.backpressure == 3, "queue: pedido maior que a fila é recusado");
+	CHECK(prv_line_is(USART2, data, accepted), "write: bytes aceitos saem em ordem");
+}
+
+/** \brief Recebimento por interrupção, com terminador e espera bloqueante. */
+static void test_rx_irq(void) {
+	uint8_t buf[16];
+	uint32_t irqs = sim_irq_count(USART2_IRQn);
+	USARTRxStats before = c_common_usart_rx_stats(USART2);
+
+	c_common_usart_set_rx_terminator(USART2, '\r');
+	sim_usart_inject(USART2, (const uint8_t *)"abc\rxy", 6);
+	int n = c_common_usart_read_timeout(USART2, buf, sizeof(buf), TICKS_MS(100));
+	USARTRxStats after = c_common_usart_rx_stats(USART2);
+
+	CHECK(n == 4 && !memcmp(buf, "abc\r", 4), "read_timeout termina no terminador");
+	CHECK(after.wakeups - before.wakeups == 1, "read_timeout: a task é acordada uma única vez");
+
+	sim_wait(3 * sim_usart_frame_ns(USART2));
+	CHECK(c_common_usart_available(USART2) == 2, "bytes após o terminador ficam no buffer");
+	CHECK(sim_irq_count(USART2_IRQn) - irqs == 6, "modo IRQ: uma interrupção por byte");
+
+	c_common_usart_set_rx_terminator(USART2, USART_NO_TERMINATOR);
+	n = c_common_usart_read_timeout(USART2, buf, sizeof(buf), TICKS_MS(5));
+	CHECK(n == 2 && c_common_usart_rx_stats(USART2).timeouts - after.timeouts == 1,
+		  "read_timeout retorna o que chegou ao fim do timeout");
+}
+
+/** \brief Bytes que chegam com as interrupções mascaradas causam overrun, contado como descarte. */
+static void test_rx_overrun(void) {
+	uint32_t dropped = c_common_usart_dropped(USART2);
+
+	__disable_irq();
+	sim_usart_inject(USART2, (const uint8_t *)"123", 3);
+	sim_wait(4 * sim_usart_frame_ns(USART2));
+	__enable_irq();
+
+	CHECK(c_common_usart_dropped(USART2) - dropped == 1, "overrun da USART contado em dropped");
+	CHECK(c_common_usart_available(USART2) == 1 && c_common_usart_read(USART2) == '1',
+		  "overrun: o primeiro byte é preservado");
+}
+
+/** \brief Recebimento por DMA circular, com uma interrupção por pacote. */
+static void test_rx_dma_idle(void) {
+	uint8_t frame[20], big[150], buf[150];
+
+	for(unsigned i = 0; i < sizeof(frame); i++)
+		frame[i] = (uint8_t)(0x80 + i);
+	for(unsigned i = 0; i < sizeof(big); i++)
+		big[i] = (uint8_t)(i * 7);
+
+	c_common_usart_set_rx_mode(USART6, USART_RX_MODE_DMA_IDLE);
+	uint32_t irqs = sim_irq_count(USART6_IRQn);
+
+	sim_usart_inject(USART6, frame, sizeof(frame));
+	sim_wait((sizeof(frame) + 3) * sim_usart_frame_ns(USART6));
+	CHECK(c_common_usart_rx_frames(USART6) == 1, "modo DMA: um quadro por rajada");
+	CHECK(sim_irq_count(USART6_IRQn) - irqs == 1, "modo DMA: uma interrupção da USART por quadro");
+	CHECK(c_common_usart_read_block(USART6, buf, sizeof(buf)) == (int)sizeof(frame) && !memcmp(buf, frame, sizeof(frame)),
+		  "modo DMA: quadro íntegro no buffer");
+
+	// maior que o buffer circular: metade e fim do buffer repassam os bytes à task durante a rajada. A
+	// 115200 bps a task tem quase 3 ms para esvaziar cada metade, folga para a variação do tempo no host.
+	c_common_usart_set_baudrate(USART6, 115200);
+	sim_usart_inject(USART6, big, sizeof(big));
+	int n = c_common_usart_read_timeout(USART6, buf, sizeof(big), TICKS_MS(50));
+	CHECK(n == (int)sizeof(big) && !memcmp(buf, big, sizeof(big)), "modo DMA: rajada maior que o buffer");
+	CHECK(c_common_usart_dropped(USART6) == 0, "modo DMA: nenhum byte descartado com a task lendo");
+}
+
+/** \brief Troca de baudrate em funcionamento. */
+static void test_baudrate(void) {
+	uint32_t baud = c_common_usart_set_baudrate(USART2, 1000000);
+
+	CHECK(baud >= 980000 && baud <= 1020000 && c_common_usart_get_baudrate(USART2) == baud,
+		  "set_baudrate retorna o baudrate efetivo");
+	sim_usart_tx_clear(USART2);
+	c_common_usart_write(USART2, (const uint8_t *)"0123456789", 10);
+	c_common_usart_flush(USART2, TICKS_MS(10));
+	int n = sim_usart_tx(USART2, line, SIM_USART_LOG_SIZE);
+	uint64_t expected = 10ull * 1000000000ull / baud;
+	CHECK(n == 10 && line[9].end - line[9].start == expected, "novo baudrate aplicado na linha");
+	CHECK(c_common_usart_set_baudrate(USART2, 100) == 0 && c_common_usart_get_baudrate(USART2) == baud,
+		  "baudrate fora do alcance é recusado");
+}
+
+static void prv_task(void) {
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
+	c_common_usart_init(USART2, 115200);
+	c_common_usart_init(USART6, 1000000);
+
+	test_write_flush();
+	test_flush_timeout();
+	test_queue_order();
+	test_backpressure();
+	test_rx_irq();
+	test_rx_overrun();
+	test_rx_dma_idle();
+	test_baudrate();
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(void) {
+	sim_init();
+	sim_run(prv_task);
+	printf("%d verificações, %d falhas\n", checks, failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,506 @@
+/**
+  ******************************************************************************
+  * @file    ground/estimation_benchmark/estimation_benchmark.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Comparação, no host, dos estimadores de atitude do firmware (Mahony, Madgwick e ESKF).
+  *
+  * Uso:
+  * \code
+  *   estimation_benchmark [-n] [-r referência.txt] [gravação.bin]
+  *   estimation_benchmark -w prefixo
+  * \endcode
+  * Sem argumentos, gera um voo sintético de 120 s a 1 kHz, com atitude conhecida, bias constante no
+  * giroscópio, ruído nos três sensores e acelerações laterais, e imprime para cada filtro o erro de
+  * atitude (RMS e máximo, após 10 s de convergência) e o bias estimado.
+  *
+  * Com uma gravação da telemetria (os bytes da porta serial, como lidos por \em ground/telemetry), os
+  * filtros rodam sobre os quadros IMU_RAW (200 Hz) e MAG_RAW gravados, convertidos pelas escalas
+  * nominais; sem atitude verdadeira, o erro é medido em relação ao ESKF. \c -n ignora o magnetômetro
+  * (ex.: gravações sem calibração de hard iron).
+  *
+  * Com \c -r, o erro é medido em relação a uma atitude de referência (linhas "tick w x y z", tick em
+  * ms, comparadas às amostras do mesmo tick), e o programa termina com erro se o ESKF passar de
+  * REPLAY_MAX_RMS_DEG ou REPLAY_MAX_DEG: é o teste de regressão de \c make \c test, sobre a gravação
+  * de \em data/. \c -w grava o voo sintético (RECORD_SECONDS) como gravação da telemetria, com as
+  * amostras quantizadas nas escalas nominais, e a atitude verdadeira como referência
+  * (prefixo.bin e prefixo.txt).
+  *
+  * Os ciclos por passo são os do TSC do host, para comparar os filtros entre si e detectar
+  * regressões. Na placa, o probe "ESTIM update" da telemetria de desempenho dá o custo real de um
+  * passo do filtro em uso (ver pv_module_estimation.c).
+  *
+  * Limitações: a gravação de \em data/ foi gerada com \c -w, não registrada em voo. Não havia uma
+  * gravação de voo com atitude de referência (ex.: captura de movimento), a placa nem uma toolchain
+  * ARM ao escrever esta comparação: o teste cobre o caminho das gravações (quadros, escalas,
+  * quantização e taxas do firmware), não sensores reais, e não há contagem de ciclos na placa.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "pv_interface_telemetry.h"
+#include "c_telemetry_cobs.h"
+#include "c_estimation_ahrs.h"
+#include "c_estimation_eskf.h"
+
+/* Private define ------------------------------------------------------------*/
+#define HAS_ACC				0x01
+#define HAS_MAG				0x02
+#define HAS_TRUTH			0x04
+
+#define SIM_RATE_HZ			1000
+#define SIM_SECONDS			120
+#define SIM_ACC_EVERY		20			//!< Média de uma rajada da FIFO a cada 20 ms, como no firmware.
+#define SIM_MAG_EVERY		13			//!< Magnetômetro a cada 13 conjuntos (~77 Hz).
+#define SETTLE_SECONDS		10.0f		//!< Convergência descartada da estatística de erro.
+#define REFERENCE_TIMEOUT	0.1f		//!< Idade máxima das referências dos filtros complementares (s).
+
+#define RECORD_SECONDS		30			//!< Duração do voo gravado por -w.
+#define RECORD_IMU_EVERY	5			//!< Quadro IMU_RAW a cada 5 ms (200 Hz), como no firmware.
+#define RECORD_TRUTH_EVERY	100			//!< Linha da referência a cada 100 ms.
+#define REPLAY_MAX_RMS_DEG	2.5f		//!< Limites do ESKF no teste com -r (graus, após SETTLE_SECONDS).
+#define REPLAY_MAX_DEG		10.0f
+
+// Escalas nominais dos quadros gravados (c_io_itg3205.h, c_io_adxl345.h; HMC5883L a 1,3 Ga)
+#define GYRO_RAD_PER_LSB	(0.017453293f / 14.375f)
+#define ACC_MS2_PER_LSB		(0.0039f * 9.80665f)
+#define MAG_UT_PER_LSB		(100.0f / 1090.0f)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** Uma amostra do giroscópio, com as referências novas do mesmo período. */
+typedef struct {
+	float 	t;					//!< Instante (s).
+	Vec3 	gyro;				//!< rad/s.
+	Vec3 	acc;				//!< m/s^2, se HAS_ACC.
+	Vec3 	mag;				//!< uT, se HAS_MAG.
+	Vec3 	force;				//!< Aceleração da amostra, sem média (só no voo sintético, para -w).
+	uint8_t has;
+	Quat 	truth;				//!< Atitude verdadeira, se HAS_TRUTH.
+} Sample;
+
+typedef enum { FILTER_ESKF = 0, FILTER_MAHONY, FILTER_MADGWICK, FILTERS } Filter;
+
+/** Resultado de um filtro sobre a sequência. */
+typedef struct {
+	double 		cycles;
+	uint32_t 	worst;
+	uint32_t 	steps;
+	double 		errorSq;
+	float 		errorMax;
+	uint32_t 	errorCount;
+	Vec3 		bias;
+} Result;
+
+/* Private variables ---------------------------------------------------------*/
+static const char* filter_names[FILTERS] = { "ESKF", "Mahony", "Madgwick" };
+
+static Sample* samples = NULL;
+static int count = 0, capacity = 0;
+static Quat* reference = NULL;		//!< Atitude do ESKF, referência das gravações.
+static int use_mag = 1;
+static int with_truth = 0;			//!< Erro medido em relação a \b truth (voo sintético ou -r).
+
+/* Private functions ---------------------------------------------------------*/
+
+static Sample* new_sample(void) {
+	if(count == capacity) {
+		capacity = capacity ? 2 * capacity : 4096;
+		samples = realloc(samples, capacity * sizeof(Sample));
+		if(!samples) {
+			perror("realloc");
+			exit(1);
+		}
+	}
+	memset(&samples[count], 0, sizeof(Sample));
+	return &samples[count++];
+}
+
+/** Normal padrão (Box-Muller), determinística. */
+static float gaussian(void) {
+	float u = ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);
+	float v = ((float)rand() + 1.0f) / ((float)RAND_MAX + 2.0f);
+	return sqrtf(-2.0f * logf(u)) * cosf(2.0f * PV_PI * v);
+}
+
+static Vec3 noise(float sigma) {
+	return pv_vec3(sigma * gaussian(), sigma * gaussian(), sigma * gaussian());
+}
+
+/** Voo sintético: rotações lentas nos três eixos, com acelerações laterais de 2 m/s^2 por 1 s a cada 15 s. */
+static void synthesize(int seconds) {
+	const float dt = 1.0f / SIM_RATE_HZ;
+	const Vec3 bias = pv_vec3(0.02f, -0.015f, 0.01f);
+	const Vec3 field = pv_vec3(20.0f, 0.0f, -40.0f);		// uT, norte com inclinação
+	Quat q = pv_quat_from_euler(pv_vec3(0.1f, -0.05f, 0.5f));
+	Vec3 accSum = pv_vec3(0.0f, 0.0f, 0.0f);
+
+	srand(1);
+	for(int k = 0; k < SIM_RATE_HZ * seconds; k++) {
+		float t = k * dt;
+		Vec3 rate = pv_vec3(0.8f * sinf(0.9f * t), 0.6f * sinf(0.55f * t + 1.0f), 0.4f * sinf(0.3f * t));
+		q = pv_quat_integrate(q, rate, dt);
+
+		Vec3 lateral = pv_vec3(fmodf(t, 15.0f) < 1.0f ? 2.0f : 0.0f, 0.0f, 0.0f);	// na Terra
+		Vec3 force = pv_quat_rotate_inv(q, pv_vec3_add(pv_vec3(0.0f, 0.0f, PV_GRAVITY), lateral));
+
+		Sample* s = new_sample();
+		s->t = t;
+		s->truth = q;
+		s->has = HAS_TRUTH;
+		s->gyro = pv_vec3_add(pv_vec3_add(rate, bias), noise(0.0066f));	// ITG3205: 0,38 graus/s RMS
+		s->force = pv_vec3_add(force, noise(0.2f));
+		accSum = pv_vec3_add(accSum, s->force);
+		if(k % SIM_ACC_EVERY == SIM_ACC_EVERY - 1) {
+			s->acc = pv_vec3_scale(accSum, 1.0f / SIM_ACC_EVERY);
+			s->has |= HAS_ACC;
+			accSum = pv_vec3(0.0f, 0.0f, 0.0f);
+		}
+		if(k % SIM_MAG_EVERY == 0) {
+			s->mag = pv_vec3_add(pv_quat_rotate_inv(q, field), noise(0.5f));
+			s->has |= HAS_MAG;
+		}
+	}
+}
+
+/** CRC32 do periférico da placa, sobre palavras little-endian (como em \em ground/telemetry). */
+static uint32_t crc32_stm32(const uint8_t *data, int length) {
+	uint32_t crc = TELEMETRY_CRC_INIT;
+
+	for(int i = 0; i < length; i += 4) {
+		uint32_t word = 0;
+		for(int b = 0; b < 4 && i + b < length; b++)
+			word |= (uint32_t)data[i + b] << (8 * b);
+
+		crc ^= word;
+		for(int bit = 0; bit < 32; bit++)
+			crc = (crc & 0x80000000) ? (crc << 1) ^ TELEMETRY_CRC_POLY : (crc << 1);
+	}
+	return crc;
+}
+
+/** Converte um quadro válido em amostra; MAG_RAW entra na amostra seguinte do giroscópio. */
+static void handle_frame(const uint8_t *encoded, int length, Vec3* mag, int* magNew) {
+	uint8_t frame[TELEMETRY_MAX_ENCODED];
+	TelemetryImuRaw imu;
+	TelemetryMagRaw raw;
+	int n = c_telemetry_cobs_decode(encoded, length, frame);
+
+	if(n < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE)
+		return;
+	n -= TELEMETRY_CRC_SIZE;
+	uint32_t crc = (uint32_t)frame[n] | ((uint32_t)frame[n+1] << 8) | ((uint32_t)frame[n+2] << 16) | ((uint32_t)frame[n+3] << 24);
+	if(crc != crc32_stm32(frame, n))
+		return;
+
+	const uint8_t* payload = frame + TELEMETRY_HEADER_SIZE;
+	int size = n - TELEMETRY_HEADER_SIZE;
+	if(frame[0] == TELEMETRY_MSG_MAG_RAW && size == sizeof(raw)) {
+		memcpy(&raw, payload, sizeof(raw));
+		if(!(raw.flags & 0x01)) {
+			*mag = pv_vec3_scale(pv_vec3(raw.mag[0], raw.mag[1], raw.mag[2]), MAG_UT_PER_LSB);
+			*magNew = 1;
+		}
+	} else if(frame[0] == TELEMETRY_MSG_IMU_RAW && size == sizeof(imu)) {
+		memcpy(&imu, payload, sizeof(imu));
+		Sample* s = new_sample();
+		s->t = imu.tick * 1e-3f;
+		s->gyro = pv_vec3_scale(pv_vec3(imu.gyro[0], imu.gyro[1], imu.gyro[2]), GYRO_RAD_PER_LSB);
+		s->acc = pv_vec3_scale(pv_vec3(imu.acc[0], imu.acc[1], imu.acc[2]), ACC_MS2_PER_LSB);	// já nos eixos do giroscópio
+		s->has = HAS_ACC;
+		if(*magNew && use_mag) {
+			s->mag = *mag;
+			s->has |= HAS_MAG;
+		}
+		*magNew = 0;
+	}
+}
+
+/** Lê uma gravação da telemetria. */
+static int load(const char* path) {
+	uint8_t encoded[TELEMETRY_MAX_ENCODED];
+	int fill = 0, overflow = 0, magNew = 0, c;
+	Vec3 mag = pv_vec3(0.0f, 0.0f, 0.0f);
+	FILE* f = fopen(path, "rb");
+
+	if(!f) {
+		perror(path);
+		return 0;
+	}
+	while((c = fgetc(f)) != EOF) {
+		if(c == TELEMETRY_DELIMITER) {
+			if(!overflow && fill)
+				handle_frame(encoded, fill, &mag, &magNew);
+			fill = 0;
+			overflow = 0;
+		} else if(fill < (int)sizeof(encoded)) {
+			encoded[fill++] = (uint8_t)c;
+		} else {
+			overflow = 1;
+		}
+	}
+	fclose(f);
+	return 1;
+}
+
+/** Lê a atitude de referência de uma gravação e a associa às amostras do mesmo tick. */
+static int load_reference(const char* path) {
+	char line[128];
+	int matched = 0, i = 0;
+	FILE* f = fopen(path, "r");
+
+	if(!f) {
+		perror(path);
+		return 0;
+	}
+	while(fgets(line, sizeof(line), f)) {
+		unsigned tick;
+		Quat q;
+		if(line[0] == '#' || sscanf(line, "%u %f %f %f %f", &tick, &q.w, &q.x, &q.y, &q.z) != 5)
+			continue;
+		while(i < count && samples[i].t < tick * 1e-3f - 0.0005f)
+			i++;
+		if(i < count && fabsf(samples[i].t - tick * 1e-3f) < 0.0005f) {
+			samples[i].truth = pv_quat_normalize(q);
+			samples[i].has |= HAS_TRUTH;
+			matched++;
+		}
+	}
+	fclose(f);
+	if(!matched)
+		fprintf(stderr, "%s: no reference matches the recording\n", path);
+	return matched;
+}
+
+/** Escreve um quadro da telemetria (cabeçalho, CRC, COBS e delimitador), como o firmware. */
+static void write_frame(FILE* f, uint8_t id, const void* payload, int size) {
+	static uint8_t seq = 0;
+	uint8_t frame[TELEMETRY_MAX_FRAME];
+	uint8_t encoded[TELEMETRY_MAX_ENCODED];
+
+	frame[0] = id;
+	frame[1] = seq++;
+	memcpy(frame + TELEMETRY_HEADER_SIZE, payload, size);
+	int n = TELEMETRY_HEADER_SIZE + size;
+	uint32_t crc = crc32_stm32(frame, n);
+	for(int b = 0; b < TELEMETRY_CRC_SIZE; b++)
+		frame[n++] = (uint8_t)(crc >> (8 * b));
+
+	n = c_telemetry_cobs_encode(frame, n, encoded);
+	encoded[n++] = TELEMETRY_DELIMITER;
+	fwrite(encoded, 1, n, f);
+}
+
+/** Quantiza um eixo na escala do sensor. */
+static int16_t quantize(float value, float scale) {
+	float lsb = roundf(value / scale);
+	return (int16_t)(lsb > 32767.0f ? 32767.0f : lsb < -32768.0f ? -32768.0f : lsb);
+}
+
+/** Grava o voo sintético como gravação da telemetria (prefixo.bin) e a atitude verdadeira (prefixo.txt). */
+static int record(const char* prefix) {
+	char path[512];
+
+	snprintf(path, sizeof(path), "%s.bin", prefix);
+	FILE* bin = fopen(path, "wb");
+	if(!bin) {
+		perror(path);
+		return 0;
+	}
+	snprintf(path, sizeof(path), "%s.txt", prefix);
+	FILE* txt = fopen(path, "w");
+	if(!txt) {
+		perror(path);
+		fclose(bin);
+		return 0;
+	}
+
+	fprintf(txt, "# estimation_benchmark -w: voo sintético de %d s, atitude verdadeira (tick w x y z)\n", RECORD_SECONDS);
+	for(int k = 0; k < count; k++) {
+		const Sample* s = &samples[k];
+		uint32_t tick = (uint32_t)k * 1000 / SIM_RATE_HZ;
+
+		if(s->has & HAS_MAG) {
+			TelemetryMagRaw mag = { .tick = tick, .flags = 0 };
+			mag.mag[0] = quantize(s->mag.x, MAG_UT_PER_LSB);
+			mag.mag[1] = quantize(s->mag.y, MAG_UT_PER_LSB);
+			mag.mag[2] = quantize(s->mag.z, MAG_UT_PER_LSB);
+			write_frame(bin, TELEMETRY_MSG_MAG_RAW, &mag, sizeof(mag));
+		}
+		if(k % RECORD_IMU_EVERY == 0) {
+			TelemetryImuRaw imu = { .tick = tick };
+			imu.acc[0]  = quantize(s->force.x, ACC_MS2_PER_LSB);
+			imu.acc[1]  = quantize(s->force.y, ACC_MS2_PER_LSB);
+			imu.acc[2]  = quantize(s->force.z, ACC_MS2_PER_LSB);
+			imu.gyro[0] = quantize(s->gyro.x, GYRO_RAD_PER_LSB);
+			imu.gyro[1] = quantize(s->gyro.y, GYRO_RAD_PER_LSB);
+			imu.gyro[2] = quantize(s->gyro.z, GYRO_RAD_PER_LSB);
+			write_frame(bin, TELEMETRY_MSG_IMU_RAW, &imu, sizeof(imu));
+		}
+		if(k % RECORD_TRUTH_EVERY == 0)
+			fprintf(txt, "%u %.6f %.6f %.6f %.6f\n", tick, (double)s->truth.w, (double)s->truth.x, (double)s->truth.y, (double)s->truth.z);
+	}
+
+	fclose(bin);
+	fclose(txt);
+	return 1;
+}
+
+/** Ângulo da rotação entre duas atitudes, em graus. */
+static float angle_between(Quat a, Quat b) {
+	float d = fabsf(pv_quat_dot(a, b));
+	return 2.0f * acosf(d < 1.0f ? d : 1.0f) * PV_RAD_TO_DEG;
+}
+
+/** Roda um filtro sobre toda a sequência. */
+static Result run(Filter filter) {
+	Result result = { 0 };
+	Ahrs ahrs;
+	Eskf eskf;
+	AhrsConfig config = c_estimation_ahrs_defaults(filter == FILTER_MADGWICK ? AHRS_MADGWICK : AHRS_MAHONY);
+	Vec3 acc = pv_vec3(0.0f, 0.0f, 0.0f), mag = acc;
+	float accTime = -1.0f, magTime = -1.0f;
+	int aligned = 0;
+
+	c_estimation_ahrs_init(&ahrs, &config);
+	c_estimation_eskf_init(&eskf, NULL);
+
+	for(int i = 0; i < count; i++) {
+		const Sample* s = &samples[i];
+		if(s->has & HAS_ACC) {
+			acc = s->acc;
+			accTime = s->t;
+		}
+		if(s->has & HAS_MAG) {
+			mag = s->mag;
+			magTime = s->t;
+		}
+		if(!aligned) {
+			if(accTime < 0.0f)
+				continue;
+			const Vec3* m = magTime >= 0.0f ? &mag : NULL;
+			c_estimation_ahrs_align(&ahrs, acc, m);
+			c_estimation_eskf_align(&eskf, acc, m);
+			aligned = 1;
+			continue;
+		}
+
+		float dt = s->t - samples[i - 1].t;
+		Quat q;
+		uint64_t start = __rdtsc();
+		if(filter == FILTER_ESKF) {
+			c_estimation_eskf_predict(&eskf, s->gyro, dt);
+			if(s->has & HAS_ACC)
+				c_estimation_eskf_update_acc(&eskf, s->acc);
+			if(s->has & HAS_MAG)
+				c_estimation_eskf_update_mag(&eskf, s->mag);
+			q = eskf.attitude;
+		} else {
+			const Vec3* a = s->t - accTime <= REFERENCE_TIMEOUT ? &acc : NULL;
+			const Vec3* m = magTime >= 0.0f && s->t - magTime <= REFERENCE_TIMEOUT ? &mag : NULL;
+			c_estimation_ahrs_update(&ahrs, s->gyro, a, m, dt);
+			q = ahrs.attitude;
+		}
+		uint32_t cycles = (uint32_t)(__rdtsc() - start);
+
+		result.cycles += cycles;
+		result.steps++;
+		if(cycles > result.worst)
+			result.worst = cycles;
+
+		if(filter == FILTER_ESKF && reference)
+			reference[i] = q;
+		if(s->t - samples[0].t < SETTLE_SECONDS)
+			continue;
+		if(with_truth ? !(s->has & HAS_TRUTH) : filter == FILTER_ESKF)
+			continue;
+		float error = angle_between(q, with_truth ? s->truth : reference[i]);
+		result.errorSq += (double)error * error;
+		result.errorCount++;
+		if(error > result.errorMax)
+			result.errorMax = error;
+	}
+
+	if(filter == FILTER_ESKF)
+		result.bias = eskf.bias;
+	else if(filter == FILTER_MAHONY)
+		result.bias = pv_vec3_neg(ahrs.bias);		// correção somada = -bias do sensor
+	return result;
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+	const char* path = NULL;
+	const char* truth = NULL;
+	const char* prefix = NULL;
+	int failed = 0;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-n"))
+			use_mag = 0;
+		else if(!strcmp(argv[i], "-r") && i + 1 < argc)
+			truth = argv[++i];
+		else if(!strcmp(argv[i], "-w") && i + 1 < argc)
+			prefix = argv[++i];
+		else
+			path = argv[i];
+	}
+
+	if(prefix) {
+		synthesize(RECORD_SECONDS);
+		int ok = record(prefix);
+		free(samples);
+		return ok ? 0 : 1;
+	}
+
+	int synthetic = !path;
+	if(synthetic)
+		synthesize(SIM_SECONDS);
+	else if(!load(path))
+		return 1;
+	if(!synthetic && truth && !load_reference(truth))
+		return 1;
+	with_truth = synthetic || truth;
+	if(count < 2) {
+		fprintf(stderr, "no IMU samples\n");
+		return 1;
+	}
+	reference = calloc(count, sizeof(Quat));
+
+	printf("%d samples, %.1f s, %s\n", count, (double)(samples[count - 1].t - samples[0].t),
+			synthetic ? "synthetic flight (error vs. truth)" : with_truth ? "recording (error vs. reference)" : "recording (error vs. ESKF)");
+	printf("%-9s %10s %10s %12s %12s   %s\n", "filter", "cyc/step", "worst", "rms (deg)", "max (deg)", "gyro bias (rad/s)");
+	for(Filter f = 0; f < FILTERS; f++) {
+		Result r = run(f);
+		printf("%-9s %10.1f %10u ", filter_names[f], r.steps ? r.cycles / r.steps : 0.0, r.worst);
+		if(r.errorCount)
+			printf("%12.3f %12.3f ", sqrt(r.errorSq / r.errorCount), (double)r.errorMax);
+		else
+			printf("%12s %12s ", "-", "-");
+		if(f == FILTER_MADGWICK)
+			printf("  -\n");
+		else
+			printf("  %.4f %.4f %.4f\n", (double)r.bias.x, (double)r.bias.y, (double)r.bias.z);
+
+		if(f == FILTER_ESKF && truth && !synthetic) {
+			float rms = r.errorCount ? (float)sqrt(r.errorSq / r.errorCount) : 0.0f;
+			failed = !r.errorCount || rms > REPLAY_MAX_RMS_DEG || r.errorMax > REPLAY_MAX_DEG;
+		}
+	}
+	if(synthetic)
+		printf("true bias: 0.0200 -0.0150 0.0100\n");
+
+	if(truth && !synthetic)
+		printf("replay: ESKF %s (limits %.1f deg rms, %.1f deg max)\n", failed ? "FAILED" : "ok",
+				(double)REPLAY_MAX_RMS_DEG, (double)REPLAY_MAX_DEG);
+
+	free(reference);
+	free(samples);
+	return failed;
+}
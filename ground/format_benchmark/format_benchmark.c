@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+  * @file    ground/format_benchmark/format_benchmark.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Ciclos por caractere de c_common_format() e do snprintf() da biblioteca C, no host.
+  *
+  * Uso:
+  * \code
+  *   format_benchmark [repetições]
+  * \endcode
+  * Formata cada caso o número de vezes pedido (20000 por omissão) e imprime o menor custo observado por
+  * chamada, em ciclos do TSC, e o custo por caractere emitido. Os dois formatadores rodam no mesmo
+  * processador e com as mesmas entradas, então a razão entre eles é comparável; os valores absolutos
+  * são do host, e não do Cortex-M4 (na placa, medir com c_common_perf_cycles()).
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "c_common_format.h"
+#include "c_common_uart.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEXT_SIZE		128
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Um caso: formata com c_common_format() (\b native) ou com snprintf(). */
+typedef int (*Case)(char* text, int native);
+
+/* Private variables ---------------------------------------------------------*/
+static volatile int sink;	//!< Impede que as chamadas sejam descartadas pelo compilador.
+
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Substitui o driver da USART, usado apenas por c_common_format_usart() (não medido). */
+int c_common_usart_write(USART_TypeDef* USARTx, const uint8_t *data, int length) {
+	(void)USARTx; (void)data;
+	return length;
+}
+
+static int case_accel(char* text, int native) {
+	return native ? c_common_format(text, TEXT_SIZE, "Accel: %d %d %d\n\r", -123, 4567, 1023)
+				  : snprintf(text, TEXT_SIZE, "Accel: %d %d %d\n\r", -123, 4567, 1023);
+}
+
+static int case_channel(char* text, int native) {
+	return native ? c_common_format(text, TEXT_SIZE, "Canal %d : %4d\n\r", 3, 512)
+				  : snprintf(text, TEXT_SIZE, "Canal %d : %4d\n\r", 3, 512);
+}
+
+static int case_float(char* text, int native) {
+	return native ? c_common_format(text, TEXT_SIZE, "T = %.2f C\n\r", 23.4567)
+				  : snprintf(text, TEXT_SIZE, "T = %.2f C\n\r", 23.4567);
+}
+
+static int case_stats(char* text, int native) {
+	const char* fmt = "RX blocks %u wakeups %u switches %u timeouts %u latency us last %u max %u\n\r";
+	return native ? c_common_format(text, TEXT_SIZE, fmt, 1204u, 1198u, 311u, 6u, 12u, 87u)
+				  : snprintf(text, TEXT_SIZE, fmt, 1204u, 1198u, 311u, 6u, 12u, 87u);
+}
+
+static int case_hex(char* text, int native) {
+	return native ? c_common_format(text, TEXT_SIZE, "crc %08X len %u", 0xC0FFEE42u, 96u)
+				  : snprintf(text, TEXT_SIZE, "crc %08X len %u", 0xC0FFEE42u, 96u);
+}
+
+/** \brief Menor custo de uma chamada, em ciclos do TSC. */
+static uint64_t prv_best(Case run, int native, int repeat) {
+	char text[TEXT_SIZE];
+	uint64_t best = UINT64_MAX;
+
+	for(int i = 0; i < repeat; i++) {
+		uint64_t start = __rdtsc();
+		sink = run(text, native);
+		uint64_t cycles = __rdtsc() - start;
+		if(cycles < best)
+			best = cycles;
+	}
+	return best;
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+	static const struct { const char* name; Case run; } cases[] = {
+		{ "accel %d x3",   case_accel },
+		{ "canal %d %4d",  case_channel },
+		{ "%.2f",          case_float },
+		{ "stats %u x6",   case_stats },
+		{ "%08X %u",       case_hex },
+	};
+	int repeat = argc > 1 ? atoi(argv[1]) : 20000;
+	char a[TEXT_SIZE], b[TEXT_SIZE];
+	uint64_t empty = UINT64_MAX;
+
+	if(repeat < 1)
+		repeat = 1;
+
+	// custo da própria medida, descontado dos resultados
+	for(int i = 0; i < repeat; i++) {
+		uint64_t start = __rdtsc();
+		uint64_t cycles = __rdtsc() - start;
+		if(cycles < empty)
+			empty = cycles;
+	}
+
+	printf("%-14s %5s %12s %10s %12s %10s %7s\n", "format", "chars", "format/call", "/char",
+		   "snprintf/call", "/char", "ratio");
+	for(unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		int n = cases[i].run(a, 1);
+		cases[i].run(b, 0);
+		if(strcmp(a, b))
+			printf("%-14s saída diferente: \"%s\" x \"%s\"\n", cases[i].name, a, b);
+
+		uint64_t native = prv_best(cases[i].run, 1, repeat) - empty;
+		uint64_t libc = prv_best(cases[i].run, 0, repeat) - empty;
+		printf("%-14s %5d %12llu %10.1f %12llu %10.1f %7.1f\n", cases[i].name, n,
+			   (unsigned long long)native, (double)native / n,
+			   (unsigned long long)libc, (double)libc / n, (double)libc / (double)native);
+	}
+	printf("(ciclos do TSC do host, menor de %d chamadas)\n", repeat);
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    ground/math_benchmark/math_benchmark.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Ciclos por operação da biblioteca de matemática (lib/pv_math.h), no host.
+  *
+  * Uso:
+  * \code
+  *   math_benchmark [repetições]
+  * \endcode
+  * Roda pv_math_bench_run() o número de vezes pedido (5 por omissão) e imprime, para cada operação,
+  * o menor custo observado, em ciclos do TSC. Serve para comparar versões da biblioteca e detectar
+  * regressões; os valores absolutos da placa vêm de pv_math_bench_run() no próprio firmware.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "pv_math_bench.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_RESULTS		32
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+	const char* name;
+	float 		best;	//!< Menor custo por operação, em ciclos.
+} Result;
+
+/* Private variables ---------------------------------------------------------*/
+static Result results[MAX_RESULTS];
+static int count = 0;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t tsc(void) {
+	return (uint32_t)__rdtsc();
+}
+
+static void report(const char* name, uint32_t cycles, uint32_t runs) {
+	float perOp = (float)cycles / (float)runs;
+	int i;
+
+	for(i = 0; i < count && strcmp(results[i].name, name); i++);
+	if(i == count) {
+		if(count == MAX_RESULTS)
+			return;
+		results[count].name = name;
+		results[count].best = perOp;
+		count++;
+	} else if(perOp < results[i].best) {
+		results[i].best = perOp;
+	}
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+	int repeat = argc > 1 ? atoi(argv[1]) : 5;
+
+	if(repeat < 1)
+		repeat = 1;
+
+	for(int i = 0; i < repeat; i++)
+		pv_math_bench_run(tsc, report);
+
+	printf("%-16s %10s\n", "operation", "cycles/op");
+	for(int i = 0; i < count; i++)
+		printf("%-16s %10.1f\n", results[i].name, (double)results[i].best);
+	printf("(baseline já descontado das operações; %d execuções x %d repetições)\n", PV_BENCH_RUNS, repeat);
+
+	return 0;
+}
@@ -0,0 +1,410 @@
+/**
+  ******************************************************************************
+  * @file    ground/telemetry/telemetry_decoder.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Decodificador, na estação de solo, da telemetria binária do io-board.
+  *
+  * Uso:
+  * \code
+  *   telemetry_decoder [/dev/ttyUSB0 [115200]]
+  * \endcode
+  * Sem argumentos, lê o fluxo da entrada padrão (ex.: de um arquivo gravado). Cada mensagem
+  * válida é impressa em uma linha; quadros com CRC inválido e quadros perdidos (lacunas no
+  * número de sequência) são contados e reportados ao final.
+  *
+  * Em uma porta serial, pedidos de troca de baudrate da placa (TELEMETRY_MSG_BAUD_SWITCH) são
+  * confirmados e seguidos; se nenhum quadro válido chegar em 2 s no novo baudrate, o anterior
+  * é restaurado.
+  *
+  * Também em uma porta serial, linhas digitadas na entrada padrão são enviadas à placa como comandos
+  * de calibração (TELEMETRY_MSG_CALIBRATE): \c "cal acc|gyro|mag" inicia o procedimento do sensor,
+  * \c "reset acc|gyro|mag" volta o sensor à escala nominal e \c "save" grava os coeficientes na flash.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "pv_interface_telemetry.h"
+#include "c_telemetry_cobs.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BAUD_REVERT_MS	2000	//!< Sem quadros válidos por este tempo após uma troca, volta ao baudrate anterior.
+
+/* Private variables ---------------------------------------------------------*/
+static unsigned long frames_ok = 0, frames_bad = 0, frames_lost = 0;
+static int last_seq = -1;
+
+static int serial_fd = -1;			//!< Porta serial, ou -1 ao ler da entrada padrão.
+static int serial_baudrate = 0;		//!< Baudrate atual da porta.
+static int previous_baudrate = 0;	//!< Baudrate a restaurar caso a troca falhe.
+static long long revert_at = 0;		//!< Instante (ms) da restauração; 0 se não há troca pendente.
+static uint8_t tx_seq = 0;			//!< Número de sequência dos quadros enviados à placa.
+static int stdin_open = 1;			//!< Entrada padrão ainda aberta para comandos.
+
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief CRC32 equivalente ao do periférico do STM32 (ver pv_interface_telemetry.h). */
+static uint32_t crc32_stm32(const uint8_t *data, int length) {
+	uint32_t crc = TELEMETRY_CRC_INIT;
+
+	for(int i = 0; i < length; i += 4) {
+		uint32_t word = 0;
+		for(int b = 0; b < 4 && i + b < length; b++)
+			word |= (uint32_t)data[i + b] << (8 * b);
+
+		crc ^= word;
+		for(int bit = 0; bit < 32; bit++)
+			crc = (crc & 0x80000000) ? (crc << 1) ^ TELEMETRY_CRC_POLY : (crc << 1);
+	}
+	return crc;
+}
+
+/** \brief Relógio monotônico, em ms. */
+static long long now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/** \brief Constante do termios para um baudrate, ou B0 caso o sistema não o suporte. */
+static speed_t speed_of(int baudrate) {
+	switch(baudrate) {
+	case 9600:    return B9600;
+	case 57600:   return B57600;
+	case 115200:  return B115200;
+	case 230400:  return B230400;
+	case 460800:  return B460800;
+	case 921600:  return B921600;
+#ifdef B1000000
+	case 1000000: return B1000000;
+#endif
+#ifdef B2000000
+	case 2000000: return B2000000;
+#endif
+#ifdef B3000000
+	case 3000000: return B3000000;
+#endif
+#ifdef B4000000
+	case 4000000: return B4000000;
+#endif
+	}
+	return B0;
+}
+
+/** \brief Troca o baudrate da porta serial. */
+static int set_baudrate(int fd, int baudrate) {
+	struct termios tty;
+	speed_t speed = speed_of(baudrate);
+
+	if(speed == B0 || tcgetattr(fd, &tty) < 0)
+		return 0;
+
+	cfsetispeed(&tty, speed);
+	cfsetospeed(&tty, speed);
+	if(tcsetattr(fd, TCSANOW, &tty) < 0)
+		return 0;
+
+	tcflush(fd, TCIFLUSH); // bytes recebidos no baudrate anterior
+	serial_baudrate = baudrate;
+	return 1;
+}
+
+/** \brief Envia uma mensagem à placa, no mesmo formato dos quadros recebidos. */
+static void send_frame(uint8_t id, const void *payload, int length) {
+	uint8_t frame[TELEMETRY_MAX_FRAME];
+	uint8_t encoded[TELEMETRY_MAX_ENCODED];
+	int n = 0;
+
+	frame[n++] = id;
+	frame[n++] = tx_seq++;
+	memcpy(frame + n, payload, length);
+	n += length;
+
+	uint32_t crc = crc32_stm32(frame, n);
+	for(int i = 0; i < TELEMETRY_CRC_SIZE; i++, crc >>= 8)
+		frame[n++] = (uint8_t)crc;
+
+	int e = c_telemetry_cobs_encode(frame, n, encoded);
+	encoded[e++] = TELEMETRY_DELIMITER;
+	if(write(serial_fd, encoded, e) != e)
+		perror("write");
+}
+
+/** \brief Confirma e segue um pedido de troca de baudrate. */
+static void handle_baud_switch(const TelemetryBaud *request) {
+	int baudrate = (int)request->baudrate;
+
+	if(serial_fd < 0 || speed_of(baudrate) == B0) {
+		fprintf(stderr, "baudrate %d not supported, staying at %d\n", baudrate, serial_baudrate);
+		return;
+	}
+
+	send_frame(TELEMETRY_MSG_BAUD_ACK, request, sizeof(*request));
+	tcdrain(serial_fd);
+
+	if(baudrate != serial_baudrate) {
+		previous_baudrate = serial_baudrate;
+		if(set_baudrate(serial_fd, baudrate)) {
+			revert_at = now_ms() + BAUD_REVERT_MS;
+			fprintf(stderr, "baudrate %d -> %d\n", previous_baudrate, baudrate);
+		}
+	}
+}
+
+/** \brief Envia um comando de calibração digitado (ver o início do arquivo). */
+static void handle_command(const char *line) {
+	static const char *sensors[] = { "acc", "gyro", "mag" };
+	char verb[16] = "", name[16] = "";
+	TelemetryCalibrate cmd = { 0, TELEMETRY_CALIBRATE_SAVE };
+
+	if(sscanf(line, "%15s %15s", verb, name) < 1)
+		return;
+
+	if(strcmp(verb, "save") != 0) {
+		if(strcmp(verb, "cal") == 0)
+			cmd.action = TELEMETRY_CALIBRATE_BEGIN;
+		else if(strcmp(verb, "reset") == 0)
+			cmd.action = TELEMETRY_CALIBRATE_RESET;
+		else {
+			fprintf(stderr, "commands: cal acc|gyro|mag, reset acc|gyro|mag, save\n");
+			return;
+		}
+
+		for(cmd.sensor = 0; cmd.sensor < 3 && strcmp(name, sensors[cmd.sensor]) != 0; cmd.sensor++);
+		if(cmd.sensor == 3) {
+			fprintf(stderr, "unknown sensor '%s' (acc, gyro, mag)\n", name);
+			return;
+		}
+	}
+
+	send_frame(TELEMETRY_MSG_CALIBRATE, &cmd, sizeof(cmd));
+}
+
+/** \brief Lê as linhas disponíveis na entrada padrão e as trata como comandos. */
+static void read_commands(void) {
+	static char line[64];
+	static int fill = 0;
+	char chunk[64];
+	ssize_t r = read(STDIN_FILENO, chunk, sizeof(chunk));
+
+	if(r <= 0) {
+		stdin_open = 0;
+		return;
+	}
+	for(ssize_t i = 0; i < r; i++) {
+		if(chunk[i] == '\n') {
+			line[fill] = '\0';
+			handle_command(line);
+			fill = 0;
+		}
+		else if(fill < (int)sizeof(line) - 1) {
+			line[fill++] = chunk[i];
+		}
+	}
+}
+
+/** \brief Copia o payload para a estrutura da mensagem, se o tamanho conferir. */
+static int payload_as(void *dst, size_t size, const uint8_t *payload, int length) {
+	if((size_t)length != size)
+		return 0;
+	memcpy(dst, payload, size);
+	return 1;
+}
+
+/** \brief Imprime uma mensagem já validada. */
+static void print_message(uint8_t id, const uint8_t *payload, int length) {
+	TelemetryHeartbeat hb;
+	TelemetryImuRaw imu;
+	TelemetryMagRaw mag;
+	TelemetryAttitude att;
+	TelemetryRc rc;
+	TelemetryServo servo;
+	TelemetryPerf perf;
+	TelemetryBaud baud;
+	TelemetryCalibration cal;
+
+	switch(id) {
+	case TELEMETRY_MSG_HEARTBEAT:
+		if(payload_as(&hb, sizeof(hb), payload, length))
+			printf("HEARTBEAT %u frames %u bytes %u dropped %u\n", hb.tick, hb.frames, hb.bytes, hb.dropped);
+		return;
+	case TELEMETRY_MSG_TEXT:
+		printf("TEXT %.*s\n", length, (const char *)payload);
+		return;
+	case TELEMETRY_MSG_IMU_RAW:
+		if(payload_as(&imu, sizeof(imu), payload, length))
+			printf("IMU %u acc %d %d %d gyro %d %d %d\n", imu.tick,
+					imu.acc[0], imu.acc[1], imu.acc[2], imu.gyro[0], imu.gyro[1], imu.gyro[2]);
+		return;
+	case TELEMETRY_MSG_MAG_RAW:
+		if(payload_as(&mag, sizeof(mag), payload, length))
+			printf("MAG %u %d %d %d flags 0x%02x\n", mag.tick, mag.mag[0], mag.mag[1], mag.mag[2], mag.flags);
+		return;
+	case TELEMETRY_MSG_ATTITUDE:
+		if(payload_as(&att, sizeof(att), payload, length))
+			printf("ATTITUDE %u q %.4f %.4f %.4f %.4f euler %.2f %.2f %.2f rate %.3f %.3f %.3f flags 0x%02x\n", att.tick,
+					att.quat[0] / 10000.0, att.quat[1] / 10000.0, att.quat[2] / 10000.0, att.quat[3] / 10000.0,
+					att.euler[0] / 100.0, att.euler[1] / 100.0, att.euler[2] / 100.0,
+					att.rate[0] / 1000.0, att.rate[1] / 1000.0, att.rate[2] / 1000.0, att.flags);
+		return;
+	case TELEMETRY_MSG_RC:
+		if(payload_as(&rc, sizeof(rc), payload, length))
+			printf("RC %u %u %u %u %u %u %u\n", rc.tick,
+					rc.channel[0], rc.channel[1], rc.channel[2], rc.channel[3], rc.channel[4], rc.channel[5]);
+		return;
+	case TELEMETRY_MSG_SERVO:
+		if(payload_as(&servo, sizeof(servo), payload, length))
+			printf("SERVO %u id %u setpoint %d\n", servo.tick, servo.id, servo.setpoint);
+		return;
+	case TELEMETRY_MSG_PERF:
+		if(payload_as(&perf, sizeof(perf), payload, length)) {
+			perf.name[sizeof(perf.name) - 1] = '\0';
+			printf("PERF %u %-16s calls %6u  B/s %7.0f  cyc/B %7.1f  calls/frame %5.1f  avg cyc %7.0f  worst us %8.1f\n",
+					perf.tick, perf.name, perf.count,
+					perf.interval ? perf.bytes * 1000.0 / perf.interval : 0.0,
+					perf.bytes ? (double)perf.cycles / perf.bytes : 0.0,
+					perf.frames ? (double)perf.count / perf.frames : 0.0,
+					perf.count ? (double)perf.cycles / perf.count : 0.0,
+					perf.max * 1e6 / TELEMETRY_CPU_HZ);
+		}
+		return;
+	case TELEMETRY_MSG_CALIBRATION:
+		if(payload_as(&cal, sizeof(cal), payload, length))
+			printf("CALIBRATION %u sensor %u state %u samples %u poses 0x%02x calibrated 0x%x saved %u\n", cal.tick,
+					cal.sensor, cal.state, cal.samples, cal.poses, cal.calibrated, cal.saved);
+		return;
+	case TELEMETRY_MSG_BAUD_SWITCH:
+		if(payload_as(&baud, sizeof(baud), payload, length)) {
+			printf("BAUD_SWITCH %u\n", baud.baudrate);
+			handle_baud_switch(&baud);
+		}
+		return;
+	}
+	printf("UNKNOWN 0x%02x (%d bytes)\n", id, length);
+}
+
+/** \brief Valida e imprime um quadro codificado (sem o delimitador). */
+static void handle_frame(uint8_t *encoded, int length) {
+	uint8_t frame[TELEMETRY_MAX_ENCODED];
+	int n = c_telemetry_cobs_decode(encoded, length, frame);
+
+	if(n < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE) {
+		frames_bad++;
+		return;
+	}
+
+	n -= TELEMETRY_CRC_SIZE;
+	uint32_t crc = (uint32_t)frame[n] | ((uint32_t)frame[n+1] << 8) | ((uint32_t)frame[n+2] << 16) | ((uint32_t)frame[n+3] << 24);
+	if(crc != crc32_stm32(frame, n)) {
+		frames_bad++;
+		return;
+	}
+
+	uint8_t seq = frame[1];
+	if(last_seq >= 0)
+		frames_lost += (uint8_t)(seq - last_seq - 1);
+	last_seq = seq;
+	frames_ok++;
+	revert_at = 0;
+
+	print_message(frame[0], frame + TELEMETRY_HEADER_SIZE, n - TELEMETRY_HEADER_SIZE);
+}
+
+/** \brief Abre e configura a porta serial (modo raw, 8-N-1). */
+static int open_serial(const char *path, int baudrate) {
+	struct termios tty;
+	int fd = open(path, O_RDWR | O_NOCTTY);
+
+	if(fd < 0 || !isatty(fd))
+		return fd;
+
+	tcgetattr(fd, &tty);
+	cfmakeraw(&tty);
+	tty.c_cc[VMIN]  = 1;
+	tty.c_cc[VTIME] = 0;
+	tcsetattr(fd, TCSANOW, &tty);
+
+	if(!set_baudrate(fd, baudrate))
+		set_baudrate(fd, 115200);
+	serial_fd = fd;
+
+	return fd;
+}
+
+/* Main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+	uint8_t chunk[256];
+	uint8_t encoded[TELEMETRY_MAX_ENCODED];
+	int fill = 0;
+	int overflow = 0;
+	int fd = STDIN_FILENO;
+
+	const uint16_t probe = 1;
+	if(*(const uint8_t *)&probe != 1) {
+		fprintf(stderr, "telemetry_decoder: the message structs are little-endian; big-endian hosts are not supported\n");
+		return 1;
+	}
+
+	if(argc > 1) {
+		fd = open_serial(argv[1], argc > 2 ? atoi(argv[2]) : 115200);
+		if(fd < 0) {
+			perror(argv[1]);
+			return 1;
+		}
+	}
+
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	for(;;) {
+		if(revert_at && now_ms() >= revert_at) {
+			fprintf(stderr, "no frames, baudrate %d -> %d\n", serial_baudrate, previous_baudrate);
+			set_baudrate(fd, previous_baudrate);
+			revert_at = 0;
+			fill = 0;
+		}
+		if(serial_fd >= 0) {
+			struct pollfd pfd[2] = { { fd, POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+			if(poll(pfd, stdin_open ? 2 : 1, revert_at ? 100 : -1) <= 0)
+				continue;
+			if(stdin_open && pfd[1].revents)
+				read_commands();
+			if(!pfd[0].revents)
+				continue;
+		}
+
+		ssize_t r = read(fd, chunk, sizeof(chunk));
+		if(r <= 0)
+			break;
+
+		for(ssize_t i = 0; i < r; i++) {
+			if(chunk[i] == TELEMETRY_DELIMITER) {
+				if(overflow)
+					frames_bad++;
+				else if(fill)
+					handle_frame(encoded, fill);
+				fill = 0;
+				overflow = 0;
+			}
+			else if(fill < (int)sizeof(encoded)) {
+				encoded[fill++] = chunk[i];
+			}
+			else {
+				// quadro longo demais: descarta até o próximo delimitador
+				overflow = 1;
+			}
+		}
+	}
+
+	fprintf(stderr, "frames ok %lu, bad %lu, lost %lu\n", frames_ok, frames_bad, frames_lost);
+	return 0;
+}
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_crc.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do CRC32 por hardware.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_common_crc.h"
+
+/** @addtogroup Common_Components
+  * @{
+  */
+
+/** @addtogroup Common_Components_CRC
+  * \brief CRC32 calculado pelo periférico CRC, uma palavra de 32 bits por ciclo de barramento.
+  *
+  * O periférico implementa apenas o CRC-32 MPEG-2: polinômio 0x04C11DB7, valor inicial 0xFFFFFFFF,
+  * palavras processadas do bit mais significativo para o menos significativo, sem reflexão e sem
+  * XOR final. Os bytes são agrupados em palavras little-endian (o byte 0 é o menos significativo da
+  * primeira palavra) e a última palavra é completada com zeros. Quem verifica o CRC em outra máquina
+  * deve seguir as mesmas regras.
+  *
+  * O periférico é único: as chamadas não são reentrantes, e devem ser serializadas pelo chamador.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Liga o clock do periférico CRC.
+  */
+void c_common_crc_init(void) {
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
+}
+
+/** \brief Calcula o CRC32 de um bloco de bytes (ver \ref Common_Components_CRC).
+  *
+  * @param  data Bytes de entrada (sem requisito de alinhamento).
+  * @param  length Quantidade de bytes.
+  * @retval CRC32 do bloco.
+  */
+uint32_t c_common_crc_compute(const uint8_t *data, int length) {
+	int i = 0;
+
+	CRC->CR = CRC_CR_RESET;
+
+	for(; i + 4 <= length; i += 4)
+		CRC->DR = (uint32_t)data[i] | ((uint32_t)data[i+1] << 8) | ((uint32_t)data[i+2] << 16) | ((uint32_t)data[i+3] << 24);
+
+	if(i < length) {
+		uint32_t word = 0;
+		for(int shift = 0; i < length; i++, shift += 8)
+			word |= (uint32_t)data[i] << shift;
+		CRC->DR = word;
+	}
+
+	return CRC->DR;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
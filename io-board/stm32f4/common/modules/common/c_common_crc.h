@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_crc.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   CRC32 calculado pelo periférico CRC do STM32.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_COMMON_CRC_H
+#define C_COMMON_CRC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+void     c_common_crc_init(void);
+uint32_t c_common_crc_compute(const uint8_t *data, int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_COMMON_CRC_H
@@ -0,0 +1,348 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_format.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação da formatação de texto.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_common_format.h"
+#include "c_common_uart.h"
+
+/** @addtogroup Common_Components
+  * @{
+  */
+
+/** @addtogroup Common_Components_Format
+  * \brief Subconjunto do printf, sem alocação e com uso de pilha limitado, para as tasks.
+  *
+  * O \em sprintf da newlib ocupa vários kB de flash, usa aritmética double em software para %f,
+  * e pode consumir boa parte dos 130 words de pilha de uma task criada com \b configMINIMAL_STACK_SIZE.
+  * Aqui a formatação é feita em uma única passada, sem recursão; os buffers locais somam 36 bytes (12 em
+  * prv_format(), para um inteiro de 32 bits, e 24 em prv_fixed(), chamada por ela para %f e %q), e
+  * c_common_format_usart() acrescenta FORMAT_USART_CHUNK bytes.
+  *
+  * Especificadores aceitos, com flags \b '-' e \b '0', largura e precisão:
+  *
+  * | Especificador | Argumento       | Saída                                                  |
+  * |---------------|-----------------|--------------------------------------------------------|
+  * | %d %i         | int             | Decimal com sinal                                      |
+  * | %u            | unsigned        | Decimal sem sinal                                      |
+  * | %x %X         | unsigned        | Hexadecimal                                            |
+  * | %c            | int             | Caractere                                              |
+  * | %s            | const char*     | String (a precisão limita o comprimento)               |
+  * | %f            | double          | Ponto fixo com precisão casas (padrão 3, máx. 6)       |
+  * | %q            | int             | Ponto fixo decimal: %.2q com 12345 imprime 123.45      |
+  * | %%            | -               | '%'                                                    |
+  *
+  * O modificador \b l é aceito e ignorado (int e long têm 32 bits no Cortex-M4). %f converte o
+  * argumento para float logo na entrada e só usa aritmética de precisão simples (FPU); valores cuja
+  * parte inteira não cabe em 32 bits são impressos como "ovf".
+  *
+  * \b Custo: cada dígito decimal custa uma multiplicação longa (a divisão por 10 é feita por
+  * multiplicação), uma subtração e o armazenamento, e cada caractere literal, uma cópia com teste de
+  * limite. Medido no host (x86-64, gcc -O2, ground/format_benchmark): 5,4 a 6,6 ciclos por caractere
+  * emitido, contra 5,8 a 30 do \em snprintf da glibc para as mesmas chamadas (de 1,0 vez, em textos
+  * longos com poucos campos, a 4,5 vezes, com %f). Esses ciclos são do host; os do Cortex-M4 não foram
+  * medidos, e podem ser obtidos na placa com c_common_perf_cycles() (ver \ref Common_Components_Perf)
+  * em volta da chamada.
+  *
+  * \code{.c}
+  * char str[32];
+  * c_common_format(str, sizeof(str), "Canal %d : %4d\n\r", i, c_rc_receiver_get_channel(i));
+  *
+  * c_common_format_usart(USART2, "T = %.2f C\n\r", temperature);
+  * \endcode
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Destino dos caracteres formatados. */
+typedef struct {
+	char* 			buf;		//!< Buffer de saída.
+	int 			size;		//!< Capacidade de \b buf (reservado 1 byte para o terminador, se \b usart for 0).
+	int 			len;		//!< Bytes em \b buf.
+	int 			total;		//!< Total de caracteres emitidos.
+	USART_TypeDef* 	usart;		//!< USART para onde \b buf é esvaziado quando cheio, ou 0.
+} FormatSink;
+
+/* Private define ------------------------------------------------------------*/
+#define FORMAT_FLAG_LEFT		0x01	//!< Alinhamento à esquerda ('-').
+#define FORMAT_FLAG_ZERO		0x02	//!< Completa com zeros ('0').
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/** Potências de 10 usadas para a parte fracionária. */
+static const uint32_t pow10[FORMAT_MAX_PRECISION + 1] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Emite um caractere; quando há USART, esvazia o buffer ao enchê-lo. */
+static void prv_put(FormatSink* sink, char c) {
+	if(sink->usart) {
+		if(sink->len == sink->size) {
+			c_common_usart_write(sink->usart, (const uint8_t *)sink->buf, sink->len);
+			sink->len = 0;
+		}
+		sink->buf[sink->len++] = c;
+	}
+	else if(sink->len < sink->size - 1) {
+		sink->buf[sink->len++] = c;
+	}
+	sink->total++;
+}
+
+/** \brief Emite \b n cópias de um caractere. */
+static void prv_fill(FormatSink* sink, char c, int n) {
+	while(n-- > 0)
+		prv_put(sink, c);
+}
+
+/** \brief Emite um campo já convertido, com o preenchimento pedido.
+  *
+  * @param sign 	Sinal ('-'), ou 0.
+  * @param digits 	Caracteres do campo, sem o sinal.
+  * @param n 		Quantidade de caracteres em \b digits.
+  */
+static void prv_field(FormatSink* sink, char sign, const char* digits, int n, int width, uint8_t flags) {
+	int pad = width - n - (sign ? 1 : 0);
+
+	if(!(flags & (FORMAT_FLAG_LEFT | FORMAT_FLAG_ZERO)))
+		prv_fill(sink, ' ', pad);
+	if(sign)
+		prv_put(sink, sign);
+	if((flags & FORMAT_FLAG_ZERO) && !(flags & FORMAT_FLAG_LEFT))
+		prv_fill(sink, '0', pad);
+	for(int i = 0; i < n; i++)
+		prv_put(sink, digits[i]);
+	if(flags & FORMAT_FLAG_LEFT)
+		prv_fill(sink, ' ', pad);
+}
+
+/** \brief Converte um inteiro sem sinal, da direita para a esquerda, no fim de \b end.
+  * @retval Ponteiro para o primeiro dígito.
+  */
+static char* prv_utoa(uint32_t value, char* end, uint32_t base, bool upper, int minDigits) {
+	const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+	char* p = end;
+
+	if(base == 10) {
+		// divisor constante: o compilador troca a divisão por multiplicação
+		do {
+			uint32_t q = value / 10;
+			*--p = (char)('0' + (value - q*10));
+			value = q;
+			minDigits--;
+		} while(value || minDigits > 0);
+	}
+	else {
+		do {
+			*--p = digits[value % base];
+			value /= base;
+			minDigits--;
+		} while(value || minDigits > 0);
+	}
+
+	return p;
+}
+
+/** \brief Emite um número em ponto fixo: parte inteira, ponto e \b precision casas de \b frac. */
+static void prv_fixed(FormatSink* sink, bool negative, uint32_t ipart, uint32_t frac, int precision, int width, uint8_t flags) {
+	char digits[24];
+	char* end = digits + sizeof(digits);
+	char* p = end;
+
+	if(precision > 0) {
+		p = prv_utoa(frac, p, 10, false, precision);
+		*--p = '.';
+	}
+	p = prv_utoa(ipart, p, 10, false, 1);
+
+	prv_field(sink, negative ? '-' : 0, p, end - p, width, flags);
+}
+
+/** \brief Núcleo da formatação. */
+static void prv_format(FormatSink* sink, const char* fmt, va_list args) {
+	char digits[12];
+	char* end = digits + sizeof(digits);
+
+	for(; *fmt; fmt++) {
+		if(*fmt != '%') {
+			prv_put(sink, *fmt);
+			continue;
+		}
+
+		uint8_t flags = 0;
+		int width = 0;
+		int precision = -1;
+
+		for(fmt++; *fmt == '-' || *fmt == '0'; fmt++)
+			flags |= (*fmt == '-') ? FORMAT_FLAG_LEFT : FORMAT_FLAG_ZERO;
+		for(; *fmt >= '0' && *fmt <= '9'; fmt++)
+			width = width*10 + (*fmt - '0');
+		if(*fmt == '.') {
+			precision = 0;
+			for(fmt++; *fmt >= '0' && *fmt <= '9'; fmt++)
+				precision = precision*10 + (*fmt - '0');
+		}
+		while(*fmt == 'l')
+			fmt++;
+
+		switch(*fmt) {
+		case 'd':
+		case 'i': {
+			int32_t value = va_arg(args, int32_t);
+			uint32_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+			char* p = prv_utoa(magnitude, end, 10, false, 1);
+			prv_field(sink, (value < 0) ? '-' : 0, p, end - p, width, flags);
+			break;
+		}
+		case 'u': {
+			char* p = prv_utoa(va_arg(args, uint32_t), end, 10, false, 1);
+			prv_field(sink, 0, p, end - p, width, flags);
+			break;
+		}
+		case 'x':
+		case 'X': {
+			char* p = prv_utoa(va_arg(args, uint32_t), end, 16, *fmt == 'X', 1);
+			prv_field(sink, 0, p, end - p, width, flags);
+			break;
+		}
+		case 'c': {
+			char c = (char)va_arg(args, int);
+			prv_field(sink, 0, &c, 1, width, flags & FORMAT_FLAG_LEFT);
+			break;
+		}
+		case 's': {
+			const char* s = va_arg(args, const char*);
+			int n = 0;
+			if(!s)
+				s = "(null)";
+			while(s[n] && (precision < 0 || n < precision))
+				n++;
+			prv_field(sink, 0, s, n, width, flags & FORMAT_FLAG_LEFT);
+			break;
+		}
+		case 'q': {
+			int32_t value = va_arg(args, int32_t);
+			uint32_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+			if(precision < 0)
+				precision = 0;
+			if(precision > FORMAT_MAX_PRECISION)
+				precision = FORMAT_MAX_PRECISION;
+			prv_fixed(sink, value < 0, magnitude / pow10[precision], magnitude % pow10[precision], precision, width, flags);
+			break;
+		}
+		case 'f': {
+			float value = (float)va_arg(args, double);
+			if(precision < 0)
+				precision = 3;
+			if(precision > FORMAT_MAX_PRECISION)
+				precision = FORMAT_MAX_PRECISION;
+
+			if(value != value) {
+				prv_field(sink, 0, "nan", 3, width, flags & FORMAT_FLAG_LEFT);
+				break;
+			}
+			bool negative = value < 0.0f;
+			if(negative)
+				value = -value;
+			if(value >= 4294967040.0f) {
+				prv_field(sink, negative ? '-' : 0, "ovf", 3, width, flags & FORMAT_FLAG_LEFT);
+				break;
+			}
+
+			uint32_t ipart = (uint32_t)value;
+			uint32_t frac = (uint32_t)((value - (float)ipart) * (float)pow10[precision] + 0.5f);
+			if(frac >= pow10[precision]) {
+				// arredondamento propagado para a parte inteira (ex.: 1.9996 com 3 casas)
+				frac -= pow10[precision];
+				ipart++;
+			}
+			prv_fixed(sink, negative, ipart, frac, precision, width, flags);
+			break;
+		}
+		case '%':
+			prv_put(sink, '%');
+			break;
+		case '\0':
+			return;
+		default:
+			// especificador desconhecido: emitido como está
+			prv_put(sink, '%');
+			prv_put(sink, *fmt);
+			break;
+		}
+	}
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Formata em um buffer, como \em vsnprintf (ver \ref Common_Components_Format).
+  *
+  * @param  dst Destino. Sempre terminado em zero, se \b size > 0.
+  * @param  size Capacidade de \b dst, incluindo o terminador.
+  * @param  fmt Formato.
+  * @param  args Argumentos.
+  * @retval Quantidade de caracteres escritos em \b dst (sem o terminador).
+  */
+int c_common_vformat(char *dst, int size, const char *fmt, va_list args) {
+	FormatSink sink = { dst, size, 0, 0, 0 };
+
+	if(size <= 0)
+		return 0;
+
+	prv_format(&sink, fmt, args);
+	dst[sink.len] = '\0';
+	return sink.len;
+}
+
+/** \brief Formata em um buffer, como \em snprintf (ver \ref Common_Components_Format).
+  *
+  * @param  dst Destino. Sempre terminado em zero, se \b size > 0.
+  * @param  size Capacidade de \b dst, incluindo o terminador.
+  * @param  fmt Formato.
+  * @retval Quantidade de caracteres escritos em \b dst (sem o terminador).
+  */
+int c_common_format(char *dst, int size, const char *fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	int n = c_common_vformat(dst, size, fmt, args);
+	va_end(args);
+	return n;
+}
+
+/** \brief Formata diretamente para o envio da USART, sem buffer do chamador.
+  * O texto é formatado em blocos de FORMAT_USART_CHUNK bytes na pilha, copiados para o buffer de
+  * envio por c_common_usart_write() (não bloqueia; ver \ref Common_Components_UART).
+  *
+  * @param  USARTx USART usada.
+  * @param  fmt Formato.
+  * @retval Quantidade de caracteres formatados.
+  */
+int c_common_format_usart(USART_TypeDef* USARTx, const char *fmt, ...) {
+	char chunk[FORMAT_USART_CHUNK];
+	FormatSink sink = { chunk, sizeof(chunk), 0, 0, USARTx };
+	va_list args;
+
+	va_start(args, fmt);
+	prv_format(&sink, fmt, args);
+	va_end(args);
+
+	if(sink.len)
+		c_common_usart_write(USARTx, (const uint8_t *)chunk, sink.len);
+	return sink.total;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_format.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Formatação de texto sem alocação, em substituição ao sprintf.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_COMMON_FORMAT_H
+#define C_COMMON_FORMAT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+#include <stdarg.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+
+/** Bytes formatados na pilha antes de cada cópia para a USART (c_common_format_usart()). */
+#define FORMAT_USART_CHUNK		32
+
+/** Maior precisão aceita para %f e %q. */
+#define FORMAT_MAX_PRECISION	6
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+int c_common_format(char *dst, int size, const char *fmt, ...);
+int c_common_vformat(char *dst, int size, const char *fmt, va_list args);
+int c_common_format_usart(USART_TypeDef* USARTx, const char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_COMMON_FORMAT_H
@@ -9,6 +9,10 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "c_common_i2c.h"
+#include "c_common_perf.h"
+
+/* FreeRTOS kernel includes */
+#include "task.h"
 
 /** @addtogroup Common_Components
   * @{
@@ -17,6 +21,42 @@
 /** @addtogroup Common_Components_I2C
   *  \brief Funções para uso da I2C (I2C1).
   *
+  *  As transações são executadas por uma máquina de estados nos tratadores de interrupção de eventos e
+  *  de erros da I2C1: quem as pede descreve endereço, registrador e buffers em um I2CTransfer e o
+  *  submete com c_common_i2c_submit(), que retorna imediatamente. O fim da transação é avisado pela
+  *  função \b done e/ou pelo semáforo \b signal do descritor. c_common_i2c_transfer() submete e dorme
+  *  até o fim, de modo que a task não consome CPU enquanto os bytes trafegam (uma leitura de 6 bytes
+  *  a 100 kHz leva ~700 us de barramento, durante os quais a CPU atende apenas algumas interrupções).
+  *
+  *  \code{.c}
+  *  uint8_t raw[6];
+  *  I2CTransfer t = { .device = 0x53, .reg = 0x32, .rxData = raw, .rxLength = sizeof(raw) };
+  *  if(c_common_i2c_transfer(&t) == I2C_RESULT_OK)
+  *  	...
+  *  \endcode
+  *
+  *  Leituras de 2 ou mais bytes são feitas por DMA (DMA1 stream 0, canal 1): após o START repetido, o
+  *  DMA esvazia o registrador de dados a cada byte e o bit LAST faz o periférico responder NACK ao
+  *  último sozinho. A CPU atua apenas no fim (interrupção do DMA, que gera o STOP), e não a cada byte.
+  *  O buffer de leitura deve estar na SRAM acessível ao DMA.
+  *
+  *  Cada dispositivo declara a velocidade máxima que suporta com c_common_i2c_set_device_speed() (por
+  *  omissão, 100 kHz). Antes de cada transação, o driver reprograma CCR e TRISE se o dispositivo pedir
+  *  um perfil diferente do atual; os valores dos perfis são calculados uma vez, a partir de PCLK1, e
+  *  arredondados para nunca exceder a frequência nominal.
+  *
+  *  Nenhuma espera é ilimitada. Cada transação tem um orçamento em ciclos, calculado pelo número de bits
+  *  no fio e a velocidade do dispositivo (c_common_i2c_budget_cycles()); esgotado, a transação é
+  *  abortada com I2C_RESULT_TIMEOUT. Após um timeout ou erro de barramento, o barramento é recuperado
+  *  (c_common_i2c_recover()): até 9 pulsos em SCL, para que um escravo preso no meio de um byte solte
+  *  SDA, seguidos de um STOP e da reinicialização do periférico. As funções de byte têm um limite fixo
+  *  de 1 ms por espera. Os contadores de erros e o pior caso ficam em I2CStats.
+  *
+  *  c_common_i2c_readBytes() e c_common_i2c_writeByte() são invólucros bloqueantes sobre transações.
+  *  Apenas uma transação é executada por vez; c_common_i2c_submit() recusa novas enquanto houver uma
+  *  em andamento. As funções de byte (c_common_i2c_start(), c_common_i2c_write(), ...) acessam o
+  *  periférico diretamente, por consulta, e não podem ser usadas durante uma transação.
+  *
   *  Posto que apenas a I2C1 será usada, as funções terão esta "hard-coded", via define:
   *
   *  \code{.c}
@@ -52,33 +92,133 @@
 
 /* Private typedef -----------------------------------------------------------*/
 #define I2Cx 	I2C1
+
+/** \brief Etapas de uma transação, percorridas pelo tratador de eventos. */
+typedef enum {
+	I2C_PHASE_IDLE = 0,
+	I2C_PHASE_START_WRITE,		//!< Aguarda o START (SB) para enviar o endereço de escrita.
+	I2C_PHASE_ADDR_WRITE,		//!< Aguarda a confirmação do endereço (ADDR).
+	I2C_PHASE_WRITE,			//!< Envia registrador e dados, um byte por TXE.
+	I2C_PHASE_WRITE_END,		//!< Aguarda o fim do último byte (BTF).
+	I2C_PHASE_START_READ,		//!< Aguarda o START repetido (SB) para enviar o endereço de leitura.
+	I2C_PHASE_ADDR_READ,		//!< Aguarda a confirmação do endereço (ADDR).
+	I2C_PHASE_READ,				//!< Recebe os dados (RXNE, e BTF para os três últimos).
+	I2C_PHASE_READ_DMA			//!< Recebe os dados por DMA, até a interrupção de fim de transferência.
+} I2CPhase;
+
+/** \brief Estado da transação em andamento. */
+typedef struct {
+	I2CTransfer* volatile 	transfer;	//!< Transação em andamento, ou 0.
+	volatile I2CPhase 		phase;		//!< Etapa atual.
+	uint16_t 				written;	//!< Bytes enviados, incluindo o registrador.
+	uint16_t 				received;	//!< Bytes recebidos.
+	I2CSpeed 				speed;		//!< Perfil programado em CCR e TRISE.
+	volatile bool 			stuck;		//!< Barramento não ficou livre a tempo; exige recuperação.
+	xSemaphoreHandle 		wake;		//!< Semáforo da task de c_common_i2c_transfer() dona da transação, ou 0.
+} I2CEngine;
+
+/** \brief Espera de uma task em c_common_i2c_transfer(). */
+typedef struct {
+	xSemaphoreHandle 		wake;		//!< Liberado ao receber a vez e ao fim da transação.
+	I2CTransfer* 			transfer;	//!< Transação à espera da vez.
+	volatile bool 			used;		//!< Reservada por uma chamada em andamento.
+} I2CWaiter;
+
+/** \brief Valores de CCR e TRISE de um perfil de velocidade. */
+typedef struct {
+	uint16_t 				ccr;		//!< CCR, com F/S e DUTY.
+	uint16_t 				trise;		//!< TRISE.
+	uint32_t 				hz;			//!< Frequência de SCL resultante.
+} I2CTiming;
+
 /* Private define ------------------------------------------------------------*/
+
+#define I2C_RX_DMA			DMA1_Stream0	//!< Stream de recebimento da I2C1 (canal 1).
+#define I2C_RX_DMA_MIN		2				//!< Leituras a partir deste tamanho usam DMA (LAST exige N >= 2).
+#define I2C_RX_DMA_FLAGS	(DMA_LISR_FEIF0 | DMA_LISR_DMEIF0 | DMA_LISR_TEIF0 | DMA_LISR_HTIF0 | DMA_LISR_TCIF0)
+
+#define I2C_TIMEOUT_FACTOR		2		//!< Margem do orçamento sobre o tempo nominal no fio (clock stretching).
+#define I2C_TIMEOUT_SLACK_US	100		//!< Folga fixa do orçamento (latência das interrupções).
+#define I2C_STOP_PERIODS		2		//!< Espera máxima pelo fim do STOP anterior, em períodos de SCL.
+#define I2C_POLL_TIMEOUT_US		1000	//!< Espera máxima de cada evento nas funções de byte.
+#define I2C_CONTENTION_MS		10		//!< Espera máxima pela vez em c_common_i2c_transfer().
+#define I2C_MAX_WAITERS			4		//!< Tasks simultâneas em c_common_i2c_transfer().
+#define I2C_RECOVERY_HALF_US	5		//!< Meio período de SCL na recuperação (100 kHz).
+
+#define I2C_SCL_PIN			GPIO_Pin_8
+#define I2C_SDA_PIN			GPIO_Pin_9
+
 /* Private macro -------------------------------------------------------------*/
+
+/** Seção crítica curta com relação aos tratadores de interrupção (salva e restaura PRIMASK). */
+#define I2C_ENTER_CRITICAL()	uint32_t primask = __get_PRIMASK(); __disable_irq()
+#define I2C_EXIT_CRITICAL()		__set_PRIMASK(primask)
+
+/** Espera pela condição por no máximo I2C_POLL_TIMEOUT_US; se esgotada, conta um timeout e segue. */
+#define I2C_POLL(condition)		do { uint32_t poll_start = c_common_perf_cycles(); \
+									 while(!(condition)) \
+										 if(c_common_perf_cycles() - poll_start > prv_us_to_cycles(I2C_POLL_TIMEOUT_US)) { \
+											 i2c_stats.timeouts++; \
+											 break; \
+										 } \
+								} while(0)
+
 /* Private variables ---------------------------------------------------------*/
+PerfProbe i2c_read_probe;	//! c_common_i2c_readBytes() (bytes lidos, tempo até o fim da transação).
+PerfProbe i2c_write_probe;	//! c_common_i2c_writeByte() (bytes escritos, tempo até o fim da transação).
+PerfProbe i2c_irq_probe;	//! Tratadores de interrupção (ciclos de CPU de fato gastos; quadros: transações).
+
+I2CEngine 			i2c_engine;			//! Transação em andamento.
+I2CTiming 			i2c_timings[I2C_SPEED_COUNT];	//! Registradores de cada perfil, para o PCLK1 atual.
+uint8_t 			i2c_device_speed[128];			//! Perfil de cada endereço de 7 bits (I2CSpeed).
+I2CWaiter 			i2c_waiters[I2C_MAX_WAITERS];		//! Esperas de c_common_i2c_transfer(), uma por task.
+I2CWaiter* 			i2c_waiter_queue[I2C_MAX_WAITERS];	//! Fila pela vez, da espera mais antiga à mais recente.
+int 				i2c_waiter_count = 0;
+I2CStats 			i2c_stats;			//! Contadores de erros e pior caso.
+I2CIdleHook 		i2c_idle_hooks[I2C_MAX_IDLE_HOOKS];	//! Ganchos de periférico livre, em ordem de prioridade.
+int 				i2c_idle_hook_count = 0;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
-/* Exported functions definitions --------------------------------------------*/
 
-/** \brief Inicializa a I2C1 em PB8 e PB9 (SCL e SDA).
- *
- */
-void c_common_i2c_init(){
+/** \brief Converte microssegundos em ciclos de clock. */
+static inline uint32_t prv_us_to_cycles(uint32_t us) {
+	return us * (SystemCoreClock / 1000000);
+}
+
+/** \brief Espera ativa, medida pelo contador de ciclos. */
+static void prv_delay_us(uint32_t us) {
+	uint32_t start = c_common_perf_cycles();
+	while(c_common_perf_cycles() - start < prv_us_to_cycles(us));
+}
 
+/** \brief Aguarda o STOP da transação anterior ser gerado (o hardware limpa CR1.STOP), por no máximo
+  * I2C_STOP_PERIODS períodos de SCL no perfil atual, e verifica, sem esperar, se o barramento ficou livre.
+  * Até CR1.STOP ser limpo, CR1 não pode ser escrito (RM0090: risco de um segundo STOP).
+  */
+static bool prv_wait_stop(void) {
+	uint32_t hz = (i2c_engine.speed < I2C_SPEED_COUNT) ? i2c_timings[i2c_engine.speed].hz : 0;
+	uint32_t limit = I2C_STOP_PERIODS * (SystemCoreClock / (hz ? hz : 100000));
+	uint32_t start = c_common_perf_cycles();
+
+	while(I2Cx->CR1 & I2C_CR1_STOP)
+		if(c_common_perf_cycles() - start > limit)
+			return false;
+	return !(I2Cx->SR2 & I2C_SR2_BUSY);
+}
+
+/** \brief Configura os pinos (PB8 e PB9, função alternativa) e o periférico, a 100 kHz. */
+static void prv_bus_init(void) {
         GPIO_InitTypeDef GPIO_InitStruct;
         I2C_InitTypeDef I2C_InitStruct;
 
-        // enable APB1 peripheral clock for I2C1
-        RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
-        // enable clock for SCL and SDA pins
-        RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOB, ENABLE);
-
         /* setup SCL and SDA pins
          * You can connect I2C1 to two different
          * pairs of pins:
          * 1. SCL on PB6 and SDA on PB7
          * 2. SCL on PB8 and SDA on PB9 <-----------
          */
-        GPIO_InitStruct.GPIO_Pin = GPIO_Pin_8 | GPIO_Pin_9;
+        GPIO_InitStruct.GPIO_Pin = I2C_SCL_PIN | I2C_SDA_PIN;
         GPIO_InitStruct.GPIO_Mode = GPIO_Mode_AF;
         GPIO_InitStruct.GPIO_Speed = GPIO_Speed_50MHz;
         GPIO_InitStruct.GPIO_OType = GPIO_OType_OD; // set output to open drain --> the line has to be only pulled low, not driven high
@@ -102,6 +242,732 @@ void c_common_i2c_init(){
         I2C_Cmd(I2C1, ENABLE);
 }
 
+/** \brief Calcula CCR e TRISE de cada perfil para o clock do periférico (RM0090, registradores I2C_CCR e I2C_TRISE).
+  *
+  * Standard: Thigh = Tlow = CCR/PCLK1; Fast: Thigh + Tlow = 3 ou 25 CCR/PCLK1 (DUTY 0 ou 1). CCR é
+  * arredondado para cima, de modo que SCL fica no máximo na frequência nominal (com PCLK1 = 42 MHz:
+  * 100 kHz, 400 kHz e 336 kHz). TRISE é o tempo de subida máximo (1000 ns ou 300 ns) em ciclos, mais 1.
+  */
+static void prv_compute_timings(uint32_t pclk1) {
+	uint32_t mhz = pclk1 / 1000000;
+	uint32_t ccr;
+
+	ccr = (pclk1 + 2*100000 - 1) / (2*100000);
+	if(ccr < 4)
+		ccr = 4;
+	i2c_timings[I2C_SPEED_STANDARD] = (I2CTiming){ ccr, mhz + 1, pclk1 / (2*ccr) };
+
+	ccr = (pclk1 + 3*400000 - 1) / (3*400000);
+	if(ccr < 1)
+		ccr = 1;
+	i2c_timings[I2C_SPEED_FAST] = (I2CTiming){ I2C_CCR_FS | ccr, mhz*300/1000 + 1, pclk1 / (3*ccr) };
+
+	ccr = (pclk1 + 25*400000 - 1) / (25*400000);
+	if(ccr < 1)
+		ccr = 1;
+	i2c_timings[I2C_SPEED_FAST_DUTY_16_9] = (I2CTiming){ I2C_CCR_FS | I2C_CCR_DUTY | ccr, mhz*300/1000 + 1, pclk1 / (25*ccr) };
+}
+
+/** \brief Programa um perfil de velocidade. O periférico é desligado durante a troca, e por isso
+  * só pode ser chamada com o barramento livre.
+  */
+static void prv_apply_speed(I2CSpeed speed) {
+	if(speed == i2c_engine.speed || speed >= I2C_SPEED_COUNT)
+		return;
+
+	I2Cx->CR1  &= ~I2C_CR1_PE;
+	I2Cx->CCR   = i2c_timings[speed].ccr;
+	I2Cx->TRISE = i2c_timings[speed].trise;
+	I2Cx->CR1  |= I2C_CR1_PE;
+	i2c_engine.speed = speed;
+}
+
+/** \brief Verifica se os buffers de uma transação são coerentes com os tamanhos. */
+static inline bool prv_valid(const I2CTransfer* transfer) {
+	return transfer && (transfer->txData || !transfer->txLength) && (transfer->rxData || !transfer->rxLength);
+}
+
+/** \brief Desliga interrupções e DMA e libera o motor. Chamada nos tratadores ou com as interrupções desabilitadas. */
+static void prv_release(void) {
+	I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+	// CR1 só é escrito se preciso: com um STOP pendente, a escrita poderia gerar um segundo
+	if(I2Cx->CR1 & I2C_CR1_POS)
+		I2Cx->CR1 &= ~I2C_CR1_POS;
+	I2C_RX_DMA->CR &= ~DMA_SxCR_EN;
+	i2c_engine.phase 	= I2C_PHASE_IDLE;
+	i2c_engine.wake 	= 0;
+	i2c_engine.transfer = 0;
+}
+
+/** \brief Retira uma espera da fila. Chamada com as interrupções desabilitadas.
+  * @retval true caso ela estivesse na fila.
+  */
+static bool prv_waiter_remove(I2CWaiter* waiter) {
+	for(int i = 0; i < i2c_waiter_count; i++)
+		if(i2c_waiter_queue[i] == waiter) {
+			for(i2c_waiter_count--; i < i2c_waiter_count; i++)
+				i2c_waiter_queue[i] = i2c_waiter_queue[i + 1];
+			return true;
+		}
+	return false;
+}
+
+/** \brief Com o periférico livre, retorna a task que espera a vez há mais tempo (0 se não houver).
+  * Chamada com as interrupções desabilitadas.
+  */
+static I2CWaiter* prv_turn_head(void) {
+	return (!i2c_engine.transfer && i2c_waiter_count) ? i2c_waiter_queue[0] : 0;
+}
+
+/** \brief Com o periférico livre, acorda a task que espera a vez há mais tempo. Chamada pelos tratadores.
+  *
+  * O periférico não é reservado: a task o ocupa ao acordar (ver prv_claim()), e até lá um gancho de
+  * c_common_i2c_add_idle_hook() ainda pode submeter.
+  * @param woken Marcado com pdTRUE caso a task acordada tenha prioridade maior que a interrompida.
+  */
+static void prv_pass_turn_from_isr(portBASE_TYPE* woken) {
+	I2C_ENTER_CRITICAL();
+	I2CWaiter* waiter = prv_turn_head();
+	if(waiter)
+		xSemaphoreGiveFromISR(waiter->wake, woken);
+	I2C_EXIT_CRITICAL();
+}
+
+/** \brief Como prv_pass_turn_from_isr(), em uma task. Se a task acordada tiver prioridade maior, a troca de
+  * contexto é feita por xSemaphoreGive().
+  */
+static void prv_pass_turn(void) {
+	I2C_ENTER_CRITICAL();
+	I2CWaiter* waiter = prv_turn_head();
+	I2C_EXIT_CRITICAL();
+
+	// fora da seção crítica: se a espera sair da fila antes disso, o aviso é descartado por prv_claim()
+	if(waiter)
+		xSemaphoreGive(waiter->wake);
+}
+
+/** \brief Ocupa o periférico para a transação de uma task, esperando a vez por no máximo \b ticks.
+  *
+  * A task ocupa o periférico apenas quando ele está livre e ela é a primeira da fila (ou a fila está
+  * vazia), e sai da fila no mesmo instante. Ao ser acordada, tenta de novo: entre o aviso e a sua
+  * execução, um gancho de periférico livre pode ter submetido, e então ela volta a dormir, ainda à
+  * frente da fila.
+  * @retval true caso o periférico tenha sido ocupado; false se o prazo se esgotou.
+  */
+static bool prv_claim(I2CWaiter* waiter, portTickType ticks) {
+	portTickType start = xTaskGetTickCount();
+	bool queued = false;
+
+	for(;;) {
+		I2C_ENTER_CRITICAL();
+		bool claimed = !i2c_engine.transfer && (!i2c_waiter_count || i2c_waiter_queue[0] == waiter);
+		if(claimed) {
+			prv_waiter_remove(waiter);
+			i2c_engine.transfer = waiter->transfer;
+			i2c_engine.wake 	= waiter->wake;
+		}
+		else if(!queued)
+			i2c_waiter_queue[i2c_waiter_count++] = waiter;
+		I2C_EXIT_CRITICAL();
+
+		if(claimed) {
+			// descarta avisos de vez posteriores ao último despertar: o próximo aviso é o fim da transação
+			xSemaphoreTake(waiter->wake, 0);
+			return true;
+		}
+		queued = true;
+
+		portTickType elapsed = xTaskGetTickCount() - start;
+		if(elapsed >= ticks || xSemaphoreTake(waiter->wake, ticks - elapsed) != pdTRUE) {
+			I2C_ENTER_CRITICAL();
+			prv_waiter_remove(waiter);
+			I2C_EXIT_CRITICAL();
+
+			// a vez recebida junto com o fim do prazo passa à próxima da fila
+			xSemaphoreTake(waiter->wake, 0);
+			prv_pass_turn();
+			return false;
+		}
+	}
+}
+
+/** \brief Inicia a transação que ocupa o motor (i2c_engine.transfer); se o barramento não se liberar, o
+  * motor é liberado e o barramento marcado como preso.
+  * @retval true caso a transação tenha sido iniciada.
+  */
+static bool prv_start(I2CTransfer* transfer) {
+	// o STOP da transação anterior pode ainda estar sendo gerado; se o barramento não se liberar, está preso
+	if(!prv_wait_stop()) {
+		i2c_stats.timeouts++;
+		i2c_engine.stuck = true;
+		i2c_engine.wake = 0;
+		i2c_engine.transfer = 0;
+		return false;
+	}
+
+	transfer->result 	= I2C_RESULT_PENDING;
+	i2c_engine.written 	= 0;
+	i2c_engine.received = 0;
+	i2c_engine.phase 	= I2C_PHASE_START_WRITE;
+	prv_apply_speed((I2CSpeed)i2c_device_speed[transfer->device & 0x7F]);
+
+	I2Cx->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN;
+	I2Cx->CR1 |= I2C_CR1_START;
+
+	return true;
+}
+
+/** \brief Aborta uma transação que excedeu o orçamento.
+  * @retval true caso ela ainda estivesse em andamento; false se terminou enquanto o tempo se esgotava.
+  */
+static bool prv_abort(I2CTransfer* transfer) {
+	I2C_ENTER_CRITICAL();
+	bool running = (i2c_engine.transfer == transfer);
+	if(running) {
+		prv_release();
+		transfer->result = I2C_RESULT_TIMEOUT;
+		i2c_stats.timeouts++;
+	}
+	I2C_EXIT_CRITICAL();
+
+	return running;
+}
+
+/** \brief Encerra a transação em andamento e avisa quem a submeteu. Chamada pelos tratadores. */
+static void prv_finish(I2CResult result) {
+	I2CTransfer* transfer = i2c_engine.transfer;
+	xSemaphoreHandle wake = i2c_engine.wake;
+	portBASE_TYPE woken = pdFALSE;
+
+	prv_release();
+	PERF_PROBE_FRAME(i2c_irq_probe);
+
+	if(result == I2C_RESULT_OK)
+		i2c_stats.transfers++;
+	else if(result == I2C_RESULT_NACK)
+		i2c_stats.nacks++;
+	else
+		i2c_stats.errors++;
+
+	transfer->result = result;
+	if(transfer->done)
+		transfer->done(transfer);
+	if(transfer->signal)
+		xSemaphoreGiveFromISR(transfer->signal, &woken);
+	if(wake)
+		xSemaphoreGiveFromISR(wake, &woken);
+
+	// periférico livre: o trabalho adiado nas interrupções prossegue, pela ordem de registro, e depois
+	// a task que espera a vez há mais tempo
+	for(int i = 0; i < i2c_idle_hook_count && !i2c_engine.transfer; i++)
+		if(i2c_idle_hooks[i]())
+			break;
+	prv_pass_turn_from_isr(&woken);
+
+	portEND_SWITCHING_ISR(woken);
+}
+
+/** \brief Configura o reconhecimento (ACK/POS) e as interrupções para a leitura, ao fim da fase de endereço.
+  * Segue os procedimentos do manual de referência para 1, 2 e 3 ou mais bytes: o NACK do último byte
+  * precisa ser programado antes de ele ser recebido, o que é feito com o barramento parado (BTF).
+  */
+static void prv_read_setup(uint16_t length) {
+	if(length == 1) {
+		I2Cx->CR1 &= ~I2C_CR1_ACK;
+		(void)I2Cx->SR2; // limpa ADDR
+		I2Cx->CR1 |= I2C_CR1_STOP;
+		I2Cx->CR2 |= I2C_CR2_ITBUFEN;
+	}
+	else if(length == 2) {
+		I2Cx->CR1 = (I2Cx->CR1 & ~I2C_CR1_ACK) | I2C_CR1_POS;
+		(void)I2Cx->SR2;
+		I2Cx->CR2 &= ~I2C_CR2_ITBUFEN;
+	}
+	else {
+		I2Cx->CR1 |= I2C_CR1_ACK;
+		(void)I2Cx->SR2;
+		if(length == 3)
+			I2Cx->CR2 &= ~I2C_CR2_ITBUFEN;
+		else
+			I2Cx->CR2 |= I2C_CR2_ITBUFEN;
+	}
+}
+
+/** \brief Entrega a leitura ao DMA, ao fim da fase de endereço (ADDR ainda ativo, barramento parado).
+  * Com LAST, o periférico responde NACK ao byte que completa a transferência do DMA.
+  */
+static void prv_read_dma_setup(I2CTransfer* transfer) {
+	DMA1->LIFCR = I2C_RX_DMA_FLAGS;
+	I2C_RX_DMA->M0AR = (uint32_t)transfer->rxData;
+	I2C_RX_DMA->NDTR = transfer->rxLength;
+	I2C_RX_DMA->CR  |= DMA_SxCR_EN;
+
+	I2Cx->CR1 |= I2C_CR1_ACK;
+	I2Cx->CR2 = (I2Cx->CR2 & ~I2C_CR2_ITBUFEN) | I2C_CR2_DMAEN | I2C_CR2_LAST;
+	(void)I2Cx->SR2; // limpa ADDR
+}
+
+/** \brief Tratamento da fase de leitura. */
+static void prv_read_event(I2CTransfer* transfer, uint16_t sr1) {
+	uint16_t remaining = transfer->rxLength - i2c_engine.received;
+
+	if(remaining > 3 && (sr1 & I2C_SR1_RXNE)) {
+		transfer->rxData[i2c_engine.received++] = I2Cx->DR;
+		if(remaining == 4)
+			I2Cx->CR2 &= ~I2C_CR2_ITBUFEN; // os três últimos são tratados por BTF
+	}
+	else if(remaining == 3 && (sr1 & I2C_SR1_BTF)) {
+		// N-2 em DR, N-1 no registrador de deslocamento: o byte N será recebido com NACK
+		I2Cx->CR1 &= ~I2C_CR1_ACK;
+		transfer->rxData[i2c_engine.received++] = I2Cx->DR;
+	}
+	else if(remaining == 2 && (sr1 & I2C_SR1_BTF)) {
+		I2Cx->CR1 |= I2C_CR1_STOP;
+		transfer->rxData[i2c_engine.received++] = I2Cx->DR;
+		transfer->rxData[i2c_engine.received++] = I2Cx->DR;
+		prv_finish(I2C_RESULT_OK);
+	}
+	else if(remaining == 1 && (sr1 & I2C_SR1_RXNE)) {
+		transfer->rxData[i2c_engine.received++] = I2Cx->DR;
+		prv_finish(I2C_RESULT_OK);
+	}
+}
+
+/** \brief Tratamento das interrupções de evento: avança a transação em andamento. */
+static void prv_event_irq(void) {
+	I2CTransfer* transfer = i2c_engine.transfer;
+	uint16_t sr1 = I2Cx->SR1;
+
+	if(!transfer) {
+		I2Cx->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN);
+		return;
+	}
+
+	switch(i2c_engine.phase) {
+	case I2C_PHASE_START_WRITE:
+		if(sr1 & I2C_SR1_SB) {
+			I2Cx->DR = transfer->device << 1;
+			i2c_engine.phase = I2C_PHASE_ADDR_WRITE;
+		}
+		break;
+
+	case I2C_PHASE_ADDR_WRITE:
+		if(sr1 & I2C_SR1_ADDR) {
+			(void)I2Cx->SR2; // limpa ADDR; TXE segue
+			i2c_engine.phase = I2C_PHASE_WRITE;
+		}
+		break;
+
+	case I2C_PHASE_WRITE:
+		if(sr1 & I2C_SR1_TXE) {
+			uint16_t n = i2c_engine.written++;
+			I2Cx->DR = n ? transfer->txData[n - 1] : transfer->reg;
+			if(i2c_engine.written > transfer->txLength) {
+				I2Cx->CR2 &= ~I2C_CR2_ITBUFEN;
+				i2c_engine.phase = I2C_PHASE_WRITE_END;
+			}
+		}
+		break;
+
+	case I2C_PHASE_WRITE_END:
+		if(sr1 & I2C_SR1_BTF) {
+			if(transfer->rxLength) {
+				// BTF só seria limpo pelo START repetido, e manteria a interrupção ativa até lá: a leitura
+				// de DR (após a de SR1 acima) o limpa antes
+				(void)I2Cx->DR;
+				I2Cx->CR1 |= I2C_CR1_START;
+				i2c_engine.phase = I2C_PHASE_START_READ;
+			}
+			else {
+				I2Cx->CR1 |= I2C_CR1_STOP;
+				prv_finish(I2C_RESULT_OK);
+			}
+		}
+		break;
+
+	case I2C_PHASE_START_READ:
+		if(sr1 & I2C_SR1_SB) {
+			I2Cx->DR = (transfer->device << 1) | 0x01;
+			i2c_engine.phase = I2C_PHASE_ADDR_READ;
+		}
+		break;
+
+	case I2C_PHASE_ADDR_READ:
+		if(sr1 & I2C_SR1_ADDR) {
+			if(transfer->rxLength >= I2C_RX_DMA_MIN) {
+				prv_read_dma_setup(transfer);
+				i2c_engine.phase = I2C_PHASE_READ_DMA;
+			}
+			else {
+				prv_read_setup(transfer->rxLength);
+				i2c_engine.phase = I2C_PHASE_READ;
+			}
+		}
+		break;
+
+	case I2C_PHASE_READ:
+		prv_read_event(transfer, sr1);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/** \brief Tratamento das interrupções de erro: encerra a transação em andamento. */
+static void prv_error_irq(void) {
+	uint16_t sr1 = I2Cx->SR1;
+	I2Cx->SR1 = (uint16_t)~(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR);
+
+	if(!i2c_engine.transfer)
+		return;
+
+	// com perda de arbitragem o periférico já deixou o barramento; nos demais casos, libera-o
+	if(!(sr1 & I2C_SR1_ARLO))
+		I2Cx->CR1 |= I2C_CR1_STOP;
+
+	prv_finish((sr1 & I2C_SR1_AF) ? I2C_RESULT_NACK : I2C_RESULT_ERROR);
+}
+
+/** \brief Tratamento da interrupção do stream de recebimento: o último byte (já com NACK) foi lido. */
+static void prv_rx_dma_irq(void) {
+	uint32_t flags = DMA1->LISR & I2C_RX_DMA_FLAGS;
+	DMA1->LIFCR = flags;
+
+	if(!i2c_engine.transfer || i2c_engine.phase != I2C_PHASE_READ_DMA)
+		return;
+
+	if(flags & DMA_LISR_TEIF0) {
+		I2Cx->CR1 |= I2C_CR1_STOP;
+		prv_finish(I2C_RESULT_ERROR);
+	}
+	else if(flags & DMA_LISR_TCIF0) {
+		I2Cx->CR1 |= I2C_CR1_STOP;
+		i2c_engine.received = i2c_engine.transfer->rxLength;
+		prv_finish(I2C_RESULT_OK);
+	}
+}
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Inicializa a I2C1 em PB8 e PB9 (SCL e SDA).
+ *
+ */
+void c_common_i2c_init(){
+
+        // enable APB1 peripheral clock for I2C1
+        RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+        // enable clock for SCL and SDA pins
+        RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOB, ENABLE);
+
+        // the timeouts are measured with the cycle counter
+        c_common_perf_init();
+        prv_bus_init();
+
+        // RX DMA: I2C1_RX on DMA1 stream 0, channel 1 (peripheral -> memory, bytes)
+        RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+        I2C_RX_DMA->CR &= ~DMA_SxCR_EN;
+        while(I2C_RX_DMA->CR & DMA_SxCR_EN);
+        I2C_RX_DMA->CR  = DMA_Channel_1 | DMA_Priority_High | DMA_DIR_PeripheralToMemory | DMA_MemoryInc_Enable
+        				| DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+        I2C_RX_DMA->FCR = DMA_FIFOMode_Disable;
+        I2C_RX_DMA->PAR = (uint32_t)&I2Cx->DR;
+
+        // event and error interrupts, enabled in the peripheral only during a transfer
+        NVIC_InitTypeDef NVIC_InitStruct;
+        NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = I2C_IRQ_PRIORITY;
+        NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+        NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_InitStruct.NVIC_IRQChannel = I2C1_EV_IRQn;
+        NVIC_Init(&NVIC_InitStruct);
+        NVIC_InitStruct.NVIC_IRQChannel = I2C1_ER_IRQn;
+        NVIC_Init(&NVIC_InitStruct);
+        NVIC_InitStruct.NVIC_IRQChannel = DMA1_Stream0_IRQn;
+        NVIC_Init(&NVIC_InitStruct);
+
+        RCC_ClocksTypeDef clocks;
+        RCC_GetClocksFreq(&clocks);
+        prv_compute_timings(clocks.PCLK1_Frequency);
+
+        i2c_engine.transfer = 0;
+        i2c_engine.phase = I2C_PHASE_IDLE;
+        i2c_engine.stuck = false;
+        i2c_stats = (I2CStats){0};
+        i2c_engine.speed = I2C_SPEED_COUNT; // força a programação do perfil padrão
+        prv_apply_speed(I2C_SPEED_STANDARD);
+        i2c_engine.wake = 0;
+        i2c_waiter_count = 0;
+        for(int i = 0; i < I2C_MAX_WAITERS; i++) {
+                vSemaphoreCreateBinary(i2c_waiters[i].wake);
+                if(i2c_waiters[i].wake)
+                        xSemaphoreTake(i2c_waiters[i].wake, 0);
+                i2c_waiters[i].used = false;
+        }
+
+        c_common_perf_register(&i2c_read_probe,  "I2C1", "read");
+        c_common_perf_register(&i2c_write_probe, "I2C1", "write");
+        c_common_perf_register(&i2c_irq_probe,   "I2C1", "irq");
+}
+
+/** \brief Submete uma transação, sem bloquear.
+ *
+ * A transação é executada pelos tratadores de interrupção; ao seu fim, \b result é preenchido, \b done
+ * é chamada e \b signal é liberado (os dois últimos, se presentes).
+ *
+ * Pode ser chamada de interrupções (ex.: \b done e os ganchos de c_common_i2c_add_idle_hook()): não usa
+ * o FreeRTOS, e a única espera é a do STOP da transação anterior, limitada a I2C_STOP_PERIODS períodos
+ * de SCL (20 us a 100 kHz, 5 us a 400 kHz). Se o barramento não estiver livre ao fim dela, a transação é
+ * recusada e o barramento marcado como preso; a recuperação fica para c_common_i2c_transfer().
+ *
+ * @param transfer Descrição da transação; deve permanecer válida até o fim.
+ * @retval true caso a transação tenha sido iniciada; false se houver outra em andamento ou a descrição for inválida.
+ */
+bool c_common_i2c_submit(I2CTransfer *transfer) {
+	if(!prv_valid(transfer))
+		return false;
+
+	I2C_ENTER_CRITICAL();
+	bool accepted = !i2c_engine.transfer;
+	if(accepted)
+		i2c_engine.transfer = transfer;
+	I2C_EXIT_CRITICAL();
+
+	return accepted && prv_start(transfer);
+}
+
+/** \brief Executa uma transação, dormindo até o seu fim.
+ *
+ * Com o escalonador em execução, a task fica bloqueada num semáforo próprio do módulo (\b signal e
+ * \b done do descritor são preservados e também avisados); antes dele, aguarda consultando \b result.
+ * Se houver outra transação em andamento, a task entra numa fila e dorme até receber a vez: ao fim de
+ * cada transação, após os ganchos de c_common_i2c_add_idle_hook(), a task que espera há mais tempo é
+ * acordada, e ocupa o periférico apenas ao iniciar a sua transação. Até lá, c_common_i2c_busy() é
+ * falso e as interrupções continuam submetendo (elas têm preferência sobre as tasks); a task que as
+ * encontra no periférico volta a dormir, à frente da fila. A espera pela vez dura no máximo I2C_CONTENTION_MS; até
+ * I2C_MAX_WAITERS tasks podem estar em c_common_i2c_transfer() ao mesmo tempo (além disso, a
+ * transação termina em I2C_RESULT_TIMEOUT). Antes do escalonador, a vez é aguardada por consulta.
+ *
+ * Atenção: antes do escalonador, o FreeRTOS deixa mascaradas as interrupções de prioridade até
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY (inclusive a da I2C) assim que qualquer objeto é criado, como os
+ * semáforos de c_common_i2c_init(). Nesse caso a transação termina em I2C_RESULT_TIMEOUT; a
+ * configuração dos dispositivos deve ser feita numa task.
+ *
+ * O tempo de retorno é limitado por: I2C_CONTENTION_MS (vez) + I2C_STOP_PERIODS de SCL (barramento livre)
+ * + uma recuperação, caso ele não se libere + c_common_i2c_budget_cycles() (arredondado para cima em
+ * ticks, mais um, quando a task dorme) + uma recuperação, após timeout ou erro. Cada recuperação dura
+ * no máximo ~130 us (9 pulsos e um STOP a 100 kHz, mais a reinicialização).
+ *
+ * @param transfer Descrição da transação.
+ * @retval Resultado da transação.
+ */
+I2CResult c_common_i2c_transfer(I2CTransfer *transfer) {
+	bool sleep = i2c_waiters[0].wake && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+	I2CWaiter* waiter = 0;
+	bool recovered = false;
+	uint32_t start = c_common_perf_cycles();
+	uint32_t cycles_per_tick = (SystemCoreClock / 1000) * portTICK_RATE_MS;
+
+	if(!prv_valid(transfer))
+		return I2C_RESULT_ERROR;
+
+	if(sleep) {
+		I2C_ENTER_CRITICAL();
+		for(int i = 0; i < I2C_MAX_WAITERS && !waiter; i++)
+			if(!i2c_waiters[i].used) {
+				waiter = &i2c_waiters[i];
+				waiter->used = true;
+				waiter->transfer = transfer;
+			}
+		I2C_EXIT_CRITICAL();
+
+		if(!waiter) {
+			i2c_stats.timeouts++;
+			return I2C_RESULT_TIMEOUT;
+		}
+	}
+
+	for(;;) {
+		bool started;
+
+		if(sleep) {
+			// periférico livre e nenhuma task antes: ocupa-o; senão, entra na fila e dorme até receber a vez
+			if(!prv_claim(waiter, I2C_CONTENTION_MS / portTICK_RATE_MS + 1)) {
+				i2c_stats.timeouts++;
+				waiter->used = false;
+				return I2C_RESULT_TIMEOUT;
+			}
+			started = prv_start(transfer);
+		}
+		else {
+			started = c_common_i2c_submit(transfer);
+			if(!started && !i2c_engine.stuck && c_common_perf_cycles() - start <= prv_us_to_cycles(I2C_CONTENTION_MS * 1000))
+				continue;
+		}
+
+		if(started)
+			break;
+		if(!i2c_engine.stuck || recovered) {
+			i2c_stats.timeouts++;
+			if(waiter)
+				waiter->used = false;
+			return I2C_RESULT_TIMEOUT;
+		}
+		c_common_i2c_recover();
+		recovered = true;
+	}
+
+	uint32_t budget = c_common_i2c_budget_cycles(transfer);
+	uint32_t submitted = c_common_perf_cycles();
+	bool finished;
+
+	if(sleep)
+		finished = (xSemaphoreTake(waiter->wake, (budget + cycles_per_tick - 1) / cycles_per_tick + 1) == pdTRUE);
+	else {
+		while(transfer->result == I2C_RESULT_PENDING && c_common_perf_cycles() - submitted <= budget);
+		finished = (transfer->result != I2C_RESULT_PENDING);
+	}
+
+	// terminou junto com o fim do prazo: descarta o aviso, para não acordar a próxima espera
+	if(!finished && !prv_abort(transfer) && sleep)
+		xSemaphoreTake(waiter->wake, 0);
+	if(waiter)
+		waiter->used = false;
+
+	if(transfer->result == I2C_RESULT_TIMEOUT || transfer->result == I2C_RESULT_ERROR)
+		c_common_i2c_recover();
+
+	uint32_t elapsed = c_common_perf_cycles() - start;
+	if(elapsed > i2c_stats.worstCycles)
+		i2c_stats.worstCycles = elapsed;
+
+	return transfer->result;
+}
+
+/** \brief Orçamento de tempo de uma transação, em ciclos de clock.
+ *
+ * Bits no fio (9 por byte: endereço, registrador e dados, e endereço de leitura e dados lidos, mais
+ * START, START repetido e STOP) na velocidade do dispositivo, vezes I2C_TIMEOUT_FACTOR, mais
+ * I2C_TIMEOUT_SLACK_US. Ex.: leitura de 6 bytes a 400 kHz: 84 bits, 210 us nominais, 520 us de orçamento.
+ *
+ * @param transfer Descrição da transação.
+ * @retval Orçamento em ciclos.
+ */
+uint32_t c_common_i2c_budget_cycles(const I2CTransfer *transfer) {
+	uint32_t bytes = 2 + transfer->txLength + (transfer->rxLength ? 1 + transfer->rxLength : 0);
+	uint32_t bits  = 9*bytes + (transfer->rxLength ? 3 : 2);
+	uint32_t hz    = i2c_timings[i2c_device_speed[transfer->device & 0x7F]].hz;
+
+	if(!hz)
+		hz = 100000;
+
+	return (uint32_t)((uint64_t)bits * SystemCoreClock * I2C_TIMEOUT_FACTOR / hz) + prv_us_to_cycles(I2C_TIMEOUT_SLACK_US);
+}
+
+/** \brief Recupera o barramento e reinicializa o periférico.
+ *
+ * Um escravo interrompido no meio de uma leitura pode manter SDA em nível baixo indefinidamente,
+ * esperando os pulsos de clock restantes. Com os pinos como GPIO, SCL é pulsado até 9 vezes, até que
+ * SDA seja liberada, e um STOP é gerado à mão. Em seguida o periférico é reiniciado (SWRST) e
+ * reconfigurado, com o perfil de velocidade reprogramado na próxima transação. Com outra
+ * transação em andamento, a recuperação não é feita (o próximo a encontrar o barramento
+ * preso a fará).
+ */
+void c_common_i2c_recover(void) {
+	static I2CTransfer claim; // ocupa o motor durante a recuperação
+	GPIO_InitTypeDef GPIO_InitStruct;
+
+	I2C_ENTER_CRITICAL();
+	bool idle = !i2c_engine.transfer;
+	if(idle)
+		i2c_engine.transfer = &claim;
+	I2C_EXIT_CRITICAL();
+
+	if(!idle)
+		return;
+
+	I2Cx->CR1 &= ~I2C_CR1_PE;
+
+	GPIO_SetBits(GPIOB, I2C_SCL_PIN | I2C_SDA_PIN);
+	GPIO_InitStruct.GPIO_Pin   = I2C_SCL_PIN | I2C_SDA_PIN;
+	GPIO_InitStruct.GPIO_Mode  = GPIO_Mode_OUT;
+	GPIO_InitStruct.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStruct.GPIO_OType = GPIO_OType_OD;
+	GPIO_InitStruct.GPIO_PuPd  = GPIO_PuPd_UP;
+	GPIO_Init(GPIOB, &GPIO_InitStruct);
+	prv_delay_us(I2C_RECOVERY_HALF_US);
+
+	for(int i = 0; i < 9 && !(GPIOB->IDR & I2C_SDA_PIN); i++) {
+		GPIO_ResetBits(GPIOB, I2C_SCL_PIN);
+		prv_delay_us(I2C_RECOVERY_HALF_US);
+		GPIO_SetBits(GPIOB, I2C_SCL_PIN);
+		prv_delay_us(I2C_RECOVERY_HALF_US);
+	}
+
+	// STOP: SDA sobe com SCL em nível alto
+	GPIO_ResetBits(GPIOB, I2C_SCL_PIN);
+	GPIO_ResetBits(GPIOB, I2C_SDA_PIN);
+	prv_delay_us(I2C_RECOVERY_HALF_US);
+	GPIO_SetBits(GPIOB, I2C_SCL_PIN);
+	prv_delay_us(I2C_RECOVERY_HALF_US);
+	GPIO_SetBits(GPIOB, I2C_SDA_PIN);
+	prv_delay_us(I2C_RECOVERY_HALF_US);
+
+	I2Cx->CR1 |= I2C_CR1_SWRST;
+	I2Cx->CR1 &= ~I2C_CR1_SWRST;
+	prv_bus_init();
+
+	i2c_engine.speed = I2C_SPEED_COUNT; // SWRST zerou CCR e TRISE
+	prv_apply_speed(I2C_SPEED_STANDARD);
+	i2c_engine.stuck = false;
+	i2c_stats.recoveries++;
+	i2c_engine.transfer = 0;
+
+	// a recuperação não passa por prv_finish(): a vez é entregue aqui (em task, sem a API FromISR)
+	prv_pass_turn();
+}
+
+/** \brief Retorna os contadores de erros e o pior caso da I2C.
+ *
+ * @retval Cópia dos contadores.
+ */
+I2CStats c_common_i2c_stats(void) {
+	I2CStats stats;
+
+	I2C_ENTER_CRITICAL();
+	stats = i2c_stats;
+	I2C_EXIT_CRITICAL();
+
+	return stats;
+}
+
+/** \brief Declara a velocidade máxima suportada por um dispositivo.
+ * As transações com ele passam a usar esse perfil; dispositivos não declarados usam I2C_SPEED_STANDARD.
+ * A velocidade efetiva do barramento é também limitada pelos pull-ups e pela capacitância das linhas.
+ *
+ * @param device Endereço de 7 bits do dispositivo.
+ * @param speed Perfil de velocidade.
+ */
+void c_common_i2c_set_device_speed(uint8_t device, I2CSpeed speed) {
+	if(speed < I2C_SPEED_COUNT)
+		i2c_device_speed[device & 0x7F] = speed;
+}
+
+/** \brief Frequência de SCL de um perfil, para o clock atual do periférico.
+ *
+ * @param speed Perfil de velocidade.
+ * @retval Frequência em Hz (0 para um perfil inválido, ou antes de c_common_i2c_init()).
+ */
+uint32_t c_common_i2c_speed_hz(I2CSpeed speed) {
+	return (speed < I2C_SPEED_COUNT) ? i2c_timings[speed].hz : 0;
+}
+
+/** \brief Informa se há uma transação em andamento.
+ *
+ * @retval true enquanto a I2C estiver ocupada com uma transação submetida.
+ */
+bool c_common_i2c_busy(void) {
+	return i2c_engine.transfer != 0;
+}
+
 /** \brief Emite uma condição de início de transmissão e envia o endereço do escravo com o bit de R/W.
  *
  * @param address 	Endereço de 7 bits do escravo.
@@ -111,13 +977,13 @@ void c_common_i2c_init(){
  */
 void c_common_i2c_start(/*I2C_TypeDef* I2Cx,*/ uint8_t address, uint8_t direction) {
         // wait until I2C1 is not busy anymore
-        while(I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY));
+        I2C_POLL(!I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY));
 
         // Send I2C1 START condition
         I2C_GenerateSTART(I2Cx, ENABLE);
 
         // wait for I2C1 EV5 --> Slave has acknowledged start condition
-        while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_MODE_SELECT));
+        I2C_POLL(I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_MODE_SELECT));
 
         // Send slave Address for write
         I2C_Send7bitAddress(I2Cx, address, direction);
@@ -128,10 +994,10 @@ void c_common_i2c_start(/*I2C_TypeDef* I2Cx,*/ uint8_t address, uint8_t directio
          * direction
          */
         if(direction == I2C_Direction_Transmitter){
-                while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
+                I2C_POLL(I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
         }
         else if(direction == I2C_Direction_Receiver){
-                while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED));
+                I2C_POLL(I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED));
         }
 }
 
@@ -142,7 +1008,7 @@ void c_common_i2c_start(/*I2C_TypeDef* I2Cx,*/ uint8_t address, uint8_t directio
 void c_common_i2c_write(/*I2C_TypeDef* I2Cx,*/ uint8_t data) {
         I2C_SendData(I2Cx, data);
         // wait for I2C1 EV8_2 --> byte has been transmitted
-        while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+        I2C_POLL(I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
 }
 
 /** \brief Lê um byte do escravo e confima (acknowledges) o byte (requisita um próximo).
@@ -153,7 +1019,7 @@ uint8_t c_common_i2c_readAck(/*I2C_TypeDef* I2Cx,*/) {
         // enable acknowledge of recieved data
         I2C_AcknowledgeConfig(I2Cx, ENABLE);
         // wait until one byte has been received
-        while( !I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_RECEIVED) );
+        I2C_POLL(I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_RECEIVED));
         // read data from I2C data register and return data byte
         uint8_t data = I2C_ReceiveData(I2Cx);
         return data;
@@ -170,7 +1036,7 @@ uint8_t c_common_i2c_readNack(/*I2C_TypeDef* I2Cx,*/) {
         I2C_AcknowledgeConfig(I2Cx, DISABLE);
         I2C_GenerateSTOP(I2Cx, ENABLE);
         // wait until one byte has been received
-        while( !I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_RECEIVED) );
+        I2C_POLL(I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_RECEIVED));
         // read data from I2C data register and return data byte
         uint8_t data = I2C_ReceiveData(I2Cx);
         return data;
@@ -184,6 +1050,27 @@ void c_common_i2c_stop(/*I2C_TypeDef* I2Cx*/) {
         I2C_GenerateSTOP(I2Cx, ENABLE);
 }
 
+/** \brief Registra um gancho, chamado na interrupção da I2C ao fim de cada transação que deixe o periférico livre.
+ *
+ * Permite que componentes que submetem transações a partir de interrupções (ex.: \ref Module_IO_Component_Sampler)
+ * adiem o seu trabalho enquanto o periférico estiver ocupado, e o retomem sem depender de uma task. Os
+ * ganchos são chamados na ordem de registro, até que um deles submeta uma transação; a ordem é, portanto,
+ * a prioridade. Devem ser registrados antes do uso, com a mesma prioridade de interrupção da I2C.
+ *
+ * @param hook Gancho; retorna true caso tenha submetido uma transação.
+ * @retval false caso não haja mais espaço (I2C_MAX_IDLE_HOOKS).
+ */
+bool c_common_i2c_add_idle_hook(I2CIdleHook hook) {
+	for(int i = 0; i < i2c_idle_hook_count; i++)
+		if(i2c_idle_hooks[i] == hook)
+			return true;
+	if(i2c_idle_hook_count >= I2C_MAX_IDLE_HOOKS)
+		return false;
+
+	i2c_idle_hooks[i2c_idle_hook_count++] = hook;
+	return true;
+}
+
 /** \brief Lê uma quantidade de bytes de um dado endereço em um determinado dispositivo.
  *
  *	Exemplo: lê 1 byte a partir do endereço de memória 0x00 do dispositivo com endereço
@@ -199,16 +1086,12 @@ void c_common_i2c_stop(/*I2C_TypeDef* I2Cx*/) {
  *
  */
 void c_common_i2c_readBytes(uint8_t device, uint8_t address, char bytesToRead, uint8_t * recvBuffer) {
-	c_common_i2c_start(device<<1, I2C_Direction_Transmitter);
-	c_common_i2c_write(address);
-	c_common_i2c_stop();
-
-	c_common_i2c_start(device<<1, I2C_Direction_Receiver);
-	for(int i=0; i<bytesToRead-1; i++)
-		recvBuffer[i] = c_common_i2c_readAck();
+	I2CTransfer transfer = { .device = device, .reg = address, .rxData = recvBuffer, .rxLength = bytesToRead };
 
-	recvBuffer[bytesToRead-1] = c_common_i2c_readNack();
-	c_common_i2c_stop();
+	PERF_PROBE_BEGIN();
+	c_common_i2c_transfer(&transfer);
+	PERF_PROBE_END(i2c_read_probe, bytesToRead);
+	PERF_PROBE_FRAME(i2c_read_probe);
 }
 
 /** \brief Escreve um byte num dispositivo com um dado endereço.
@@ -218,14 +1101,128 @@ void c_common_i2c_readBytes(uint8_t device, uint8_t address, char bytesToRead, u
  * @param byteToWrite Byte a ser escrito.
  */
 void c_common_i2c_writeByte(uint8_t device, uint8_t address, uint8_t byteToWrite) {
-	c_common_i2c_start(device<<1, I2C_Direction_Transmitter);
-	c_common_i2c_write(address);
-	c_common_i2c_write(byteToWrite);
-	c_common_i2c_stop();
+	c_common_i2c_writeBytes(device, address, &byteToWrite, 1);
+}
+
+/** \brief Escreve uma sequência de registradores numa única transação (rajada).
+ *
+ * Os bytes seguem o registrador \b address no mesmo START/STOP; o dispositivo deve incrementar o
+ * endereço a cada byte (auto-incremento, presente no ADXL345, ITG3205 e HMC5883L).
+ *
+ *	Exemplo: zera os offsets X, Y e Z do ADXL345 (registradores 0x1E a 0x20).
+ *	\code{.c}
+ *	uint8_t offsets[3] = {0, 0, 0};
+ *	c_common_i2c_writeBytes(0x53, 0x1E, offsets, 3);
+ *	\endcode
+ *
+ * @param device Endereço do dispositivo no barramento.
+ * @param address Primeiro registrador escrito.
+ * @param data Bytes escritos a partir de \b address.
+ * @param length Quantidade de bytes.
+ * @retval Resultado da transação.
+ */
+I2CResult c_common_i2c_writeBytes(uint8_t device, uint8_t address, const uint8_t *data, uint16_t length) {
+	I2CTransfer transfer = { .device = device, .reg = address, .txData = data, .txLength = length };
+
+	PERF_PROBE_BEGIN();
+	c_common_i2c_transfer(&transfer);
+	PERF_PROBE_END(i2c_write_probe, length);
+	PERF_PROBE_FRAME(i2c_write_probe);
+
+	return transfer.result;
+}
+
+/** \brief Agrupa os passos iniciais de uma tabela de inicialização numa rajada.
+ *
+ * Passos consecutivos no mesmo dispositivo, com registradores consecutivos e sem espera entre eles,
+ * até I2C_BURST_MAX, formam uma rajada que começa no registrador de \b steps[0].
+ *
+ * @param steps Passos restantes da tabela.
+ * @param count Quantidade de passos restantes (ao menos 1).
+ * @param burst Destino dos valores da rajada (I2C_BURST_MAX bytes).
+ * @retval Quantidade de passos agrupados.
+ */
+int c_common_i2c_sequence_burst(const I2CInitStep *steps, int count, uint8_t *burst) {
+	int length = 1;
+
+	burst[0] = steps[0].value;
+	while(length < count && length < I2C_BURST_MAX
+			&& !steps[length - 1].delay
+			&& steps[length].device == steps[0].device
+			&& steps[length].reg == (uint8_t)(steps[0].reg + length)) {
+		burst[length] = steps[length].value;
+		length++;
+	}
+
+	return length;
+}
+
+/** \brief Executa uma tabela de inicialização de um ou mais dispositivos.
+ *
+ * Passos consecutivos no mesmo dispositivo, com registradores consecutivos e sem espera entre eles,
+ * são agrupados numa única rajada (c_common_i2c_sequence_burst() e c_common_i2c_writeBytes()). Após cada
+ * passo com \b delay, aguarda o tempo pedido: bloqueando a task, com o escalonador em execução, ou em
+ * espera ativa, antes dele.
+ *
+ *	Exemplo:
+ *	\code{.c}
+ *	static const I2CInitStep imu_init[] = {
+ *		{ 0x53, 0x2C, 0x0A, 0 },	// ADXL345 BW_RATE: 100 Hz
+ *		{ 0x53, 0x2D, 0x08, 0 },	// POWER_CTL: medição (rajada com o passo anterior)
+ *		{ 0x68, 0x3E, 0x01, 5 },	// ITG3205 PWR_MGM: PLL do giro X, 5 ms para estabilizar
+ *	};
+ *	c_common_i2c_init_sequence(imu_init, sizeof(imu_init)/sizeof(imu_init[0]));
+ *	\endcode
+ *
+ * @param steps Tabela de passos.
+ * @param count Quantidade de passos.
+ * @retval Quantidade de passos executados; menor que \b count se uma escrita falhou (o passo seguinte
+ * ao último executado é o que falhou).
+ */
+int c_common_i2c_init_sequence(const I2CInitStep *steps, int count) {
+	uint8_t burst[I2C_BURST_MAX];
+	int done = 0;
+
+	while(done < count) {
+		const I2CInitStep* first = &steps[done];
+		int length = c_common_i2c_sequence_burst(first, count - done, burst);
+
+		if(c_common_i2c_writeBytes(first->device, first->reg, burst, length) != I2C_RESULT_OK)
+			return done;
+		done += length;
+
+		uint8_t delay = steps[done - 1].delay;
+		if(delay) {
+			if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+				vTaskDelay((delay + portTICK_RATE_MS - 1) / portTICK_RATE_MS);
+			else
+				prv_delay_us(delay * 1000);
+		}
+	}
+
+	return done;
 }
 
 /* IRQ handlers ------------------------------------------------------------- */
 
+void I2C1_EV_IRQHandler(void) {
+	PERF_PROBE_BEGIN();
+	prv_event_irq();
+	PERF_PROBE_END(i2c_irq_probe, 0);
+}
+
+void I2C1_ER_IRQHandler(void) {
+	PERF_PROBE_BEGIN();
+	prv_error_irq();
+	PERF_PROBE_END(i2c_irq_probe, 0);
+}
+
+void DMA1_Stream0_IRQHandler(void) {
+	PERF_PROBE_BEGIN();
+	prv_rx_dma_irq();
+	PERF_PROBE_END(i2c_irq_probe, 0);
+}
+
 
 /**
   * @}
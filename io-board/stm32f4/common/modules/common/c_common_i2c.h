@@ -15,6 +15,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx_conf.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -22,7 +24,78 @@
 
 /* Includes ------------------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
+
+/** \brief Perfis de velocidade do barramento (ver c_common_i2c_set_device_speed()). */
+typedef enum {
+	I2C_SPEED_STANDARD = 0,		//!< Standard-mode, 100 kHz.
+	I2C_SPEED_FAST,				//!< Fast-mode, até 400 kHz, Tlow/Thigh = 2.
+	I2C_SPEED_FAST_DUTY_16_9,	//!< Fast-mode, até 400 kHz, Tlow/Thigh = 16/9 (exige PCLK1 múltiplo de 10 MHz para atingir 400 kHz).
+	I2C_SPEED_COUNT
+} I2CSpeed;
+
+/** \brief Resultado de uma transação (ver I2CTransfer). */
+typedef enum {
+	I2C_RESULT_PENDING = 0,		//!< Em andamento.
+	I2C_RESULT_OK,				//!< Concluída.
+	I2C_RESULT_NACK,			//!< O escravo não confirmou o endereço ou um byte.
+	I2C_RESULT_ERROR,			//!< Erro de barramento, perda de arbitragem ou overrun.
+	I2C_RESULT_TIMEOUT			//!< Não concluída no tempo previsto (ver c_common_i2c_budget_cycles()).
+} I2CResult;
+
+/** \brief Contadores de erros e do pior caso da I2C (ver c_common_i2c_stats()). */
+typedef struct {
+	uint32_t transfers;		//!< Transações concluídas com sucesso.
+	uint32_t nacks;			//!< Transações encerradas por falta de ACK.
+	uint32_t errors;		//!< Erros de barramento, perdas de arbitragem, overruns e erros de DMA.
+	uint32_t timeouts;		//!< Esperas esgotadas (transações, barramento ocupado e funções de byte).
+	uint32_t recoveries;	//!< Recuperações do barramento (ver c_common_i2c_recover()).
+	uint32_t worstCycles;	//!< Maior duração de c_common_i2c_transfer(), em ciclos.
+} I2CStats;
+
+struct I2CTransfer;
+
+/** \brief Função chamada ao fim de uma transação, no tratador de interrupção da I2C.
+  * Deve ser curta, e usar apenas a API \em FromISR do FreeRTOS.
+  */
+typedef void (*I2CCallback)(struct I2CTransfer *transfer);
+
+/** \brief Descrição de uma transação com um registrador de um dispositivo.
+  *
+  * O registrador \b reg é sempre enviado, seguido dos \b txLength bytes de \b txData. Se \b rxLength
+  * não for zero, segue um START repetido e a leitura de \b rxLength bytes em \b rxData. Os buffers
+  * pertencem a quem submete a transação, e devem permanecer válidos até o seu fim.
+  */
+typedef struct I2CTransfer {
+	uint8_t 				device;		//!< Endereço de 7 bits do dispositivo.
+	uint8_t 				reg;		//!< Registrador (primeiro byte enviado).
+	const uint8_t* 			txData;		//!< Dados escritos após o registrador.
+	uint16_t 				txLength;	//!< Quantidade de bytes em \b txData.
+	uint8_t* 				rxData;		//!< Destino da leitura.
+	uint16_t 				rxLength;	//!< Quantidade de bytes lidos (0 para apenas escrever).
+	I2CCallback 			done;		//!< Chamada ao fim da transação (opcional).
+	void* 					context;	//!< Livre para uso de \b done.
+	xSemaphoreHandle 		signal;		//!< Semáforo liberado ao fim da transação (opcional).
+	volatile I2CResult 		result;		//!< Resultado, I2C_RESULT_PENDING enquanto em andamento.
+} I2CTransfer;
+
+/** \brief Gancho chamado na interrupção da I2C quando o periférico fica livre (ver c_common_i2c_add_idle_hook()).
+  * @retval true caso tenha submetido uma transação.
+  */
+typedef bool (*I2CIdleHook)(void);
+
+/** \brief Passo de uma sequência de inicialização (ver c_common_i2c_init_sequence()). */
+typedef struct {
+	uint8_t 				device;		//!< Endereço de 7 bits do dispositivo.
+	uint8_t 				reg;		//!< Registrador escrito.
+	uint8_t 				value;		//!< Valor escrito.
+	uint8_t 				delay;		//!< Espera após a escrita, em ms (ex.: estabilização de um modo).
+} I2CInitStep;
+
 /* Exported constants --------------------------------------------------------*/
+#define I2C_BURST_MAX		16	//!< Maior rajada montada por c_common_i2c_init_sequence().
+#define I2C_MAX_IDLE_HOOKS	4	//!< Máximo de ganchos de c_common_i2c_add_idle_hook().
+#define I2C_IRQ_PRIORITY	6	//!< Prioridade (preempção) das interrupções; ver configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY.
+
 /* Exported macro ------------------------------------------------------------*/
 
 /* Exported functions ------------------------------------------------------- */
@@ -33,8 +106,21 @@ uint8_t c_common_i2c_readAck();
 uint8_t c_common_i2c_readNack();
 void c_common_i2c_stop();
 
+bool c_common_i2c_submit(I2CTransfer *transfer);
+I2CResult c_common_i2c_transfer(I2CTransfer *transfer);
+bool c_common_i2c_busy(void);
+bool c_common_i2c_add_idle_hook(I2CIdleHook hook);
+uint32_t c_common_i2c_budget_cycles(const I2CTransfer *transfer);
+void c_common_i2c_recover(void);
+I2CStats c_common_i2c_stats(void);
+void c_common_i2c_set_device_speed(uint8_t device, I2CSpeed speed);
+uint32_t c_common_i2c_speed_hz(I2CSpeed speed);
+
 void c_common_i2c_readBytes(uint8_t device, uint8_t address, char bytesToRead, uint8_t * recvBuffer);
 void c_common_i2c_writeByte(uint8_t device, uint8_t address, uint8_t byteToWrite);
+I2CResult c_common_i2c_writeBytes(uint8_t device, uint8_t address, const uint8_t *data, uint16_t length);
+int c_common_i2c_sequence_burst(const I2CInitStep *steps, int count, uint8_t *burst);
+int c_common_i2c_init_sequence(const I2CInitStep *steps, int count);
 
 /* Header-defined wrapper functions ----------------------------------------- */
 
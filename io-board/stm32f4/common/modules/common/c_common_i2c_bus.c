@@ -0,0 +1,346 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_i2c_bus.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do gerenciador do barramento I2C.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_common_i2c_bus.h"
+
+/* FreeRTOS kernel includes */
+#include "task.h"
+#include "queue.h"
+
+/** @addtogroup Common_Components
+  * @{
+  */
+
+/** @addtogroup Common_Components_I2C_Bus
+  * \brief Serializa o acesso ao barramento I2C entre várias tasks, sem mutex.
+  *
+  * Cada task (ou driver) é um I2CClient com uma prioridade. Os pedidos (I2CTransfer, ver
+  * \ref Common_Components_I2C) são postados na fila da prioridade do cliente, e uma única task, dona
+  * do barramento, os executa em sequência, sempre a partir da fila mais prioritária não vazia. Ao fim
+  * de cada transação, o resultado é copiado no descritor do pedido e o semáforo do cliente é liberado.
+  *
+  * Como nenhuma task de cliente segura o barramento, uma task de baixa prioridade não consegue atrasar
+  * uma de alta por mais que uma transação (a que estiver em andamento), e não há inversão de prioridade
+  * a ser herdada. A task do barramento deve ter prioridade maior que a dos clientes.
+  *
+  * \code{.c}
+  * I2CClient imu;
+  * c_common_i2c_client_init(&imu, "imu", I2C_PRIORITY_HIGH);
+  * ...
+  * I2CTransfer t = { .device = 0x53, .reg = 0x32, .rxData = raw, .rxLength = 6 };
+  * if(c_common_i2c_request(&imu, &t) == I2C_RESULT_OK)
+  * 	...
+  * \endcode
+  *
+  * Componentes que submetem pelas interrupções (ex.: \ref Module_IO_Component_Sampler) não passam pelas
+  * filas, o que custaria uma troca de contexto a cada leitura: são clientes de interrupção, que submetem
+  * com c_common_i2c_client_submit() e avisam o fim com c_common_i2c_client_complete(). Eles têm
+  * preferência sobre todas as filas, na ordem dos seus ganchos de periférico livre (ver
+  * c_common_i2c_add_idle_hook()); a task do barramento recebe a vez quando nenhum deles a quer.
+  *
+  * Os tempos de espera e de atendimento de cada cliente são medidos (I2CClientStats) e, pelo probe do
+  * cliente, enviados junto aos demais contadores de desempenho. Funções que usam a I2C diretamente
+  * (c_common_i2c_readBytes(), ...) disputam o periférico transação a transação com a task do
+  * barramento.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Pedido na fila: transação, cliente e instante do pedido. */
+typedef struct {
+	I2CClient* 		client;
+	I2CTransfer* 	transfer;
+	uint32_t 		stamp;		//!< c_common_perf_cycles() no momento do pedido.
+} I2CRequest;
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+xQueueHandle 		i2c_bus_queues[I2C_PRIORITY_COUNT];	//! Uma fila de I2CRequest por prioridade.
+xSemaphoreHandle 	i2c_bus_wake = 0;					//! Liberado a cada pedido postado.
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Informa se os pedidos são atendidos pela task do barramento. */
+static bool prv_running(void) {
+	return i2c_bus_wake && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+/** \brief Retira o próximo pedido, da fila mais prioritária não vazia. */
+static bool prv_next_request(I2CRequest* request) {
+	for(int p = 0; p < I2C_PRIORITY_COUNT; p++)
+		if(xQueueReceive(i2c_bus_queues[p], request, 0) == pdTRUE)
+			return true;
+	return false;
+}
+
+/** \brief Contabiliza um pedido concluído nos contadores do cliente. */
+static void prv_account(I2CClient* client, const I2CTransfer* transfer, I2CResult result, uint32_t wait, uint32_t latency) {
+	client->stats.requests++;
+	if(result != I2C_RESULT_OK)
+		client->stats.errors++;
+	if(wait > client->stats.waitMax)
+		client->stats.waitMax = wait;
+	client->stats.latencyLast = latency;
+	client->stats.latencySum += latency;
+	if(latency > client->stats.latencyMax)
+		client->stats.latencyMax = latency;
+
+#if PERF_PROBES_ENABLED
+	c_common_perf_probe_add(&client->probe, latency, transfer->txLength + transfer->rxLength);
+	if(result == I2C_RESULT_OK)
+		PERF_PROBE_FRAME(client->probe);
+#endif
+}
+
+/** \brief Executa um pedido e publica o resultado. Chamada em task.
+ *
+ * A transação executada é uma cópia do descritor, sem \b done e \b signal: o resultado só aparece no
+ * descritor do cliente depois que a task não o usa mais, e o cliente pode então descartá-lo.
+ */
+static I2CResult prv_execute(I2CClient* client, I2CTransfer* transfer, uint32_t stamp) {
+	I2CTransfer work = *transfer;
+
+	work.done 	= 0;
+	work.signal = 0;
+
+	uint32_t wait = c_common_perf_cycles() - stamp;
+	I2CResult result = c_common_i2c_transfer(&work);
+	uint32_t latency = c_common_perf_cycles() - stamp;
+
+	taskENTER_CRITICAL();
+	prv_account(client, &work, result, wait, latency);
+	transfer->result = result;
+	taskEXIT_CRITICAL();
+
+	return result;
+}
+
+/** \brief Task dona do barramento: executa os pedidos em sequência e avisa os clientes. */
+static void prv_bus_task(void *pvParameters) {
+	I2CRequest request;
+
+	while(1) {
+		xSemaphoreTake(i2c_bus_wake, portMAX_DELAY);
+
+		while(prv_next_request(&request)) {
+			prv_execute(request.client, request.transfer, request.stamp);
+			xSemaphoreGive(request.client->done);
+		}
+	}
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Cria as filas e a task dona do barramento. Chamar após c_common_i2c_init().
+  *
+  * @param  priority Prioridade da task do barramento; deve ser maior que a das tasks clientes.
+  * @retval true em caso de sucesso.
+  */
+bool c_common_i2c_bus_init(unsigned portBASE_TYPE priority) {
+	for(int p = 0; p < I2C_PRIORITY_COUNT; p++) {
+		i2c_bus_queues[p] = xQueueCreate(I2C_BUS_QUEUE_LENGTH, sizeof(I2CRequest));
+		if(!i2c_bus_queues[p])
+			return false;
+	}
+
+	vSemaphoreCreateBinary(i2c_bus_wake);
+	if(!i2c_bus_wake)
+		return false;
+	xSemaphoreTake(i2c_bus_wake, 0);
+
+	return xTaskCreate(prv_bus_task, (signed char *)"I2C bus", configMINIMAL_STACK_SIZE, NULL, priority, NULL) == pdPASS;
+}
+
+/** \brief Inicializa um cliente do barramento. Pode ser chamada de novo, o que zera os contadores.
+  *
+  * @param  client Cliente a inicializar.
+  * @param  name Nome do cliente (até 11 caracteres aparecem na telemetria de desempenho).
+  * @param  priority Fila usada pelos pedidos do cliente (não usada por clientes de interrupção).
+  * @retval true em caso de sucesso.
+  */
+bool c_common_i2c_client_init(I2CClient *client, const char *name, I2CPriority priority) {
+	client->name 	 = name;
+	client->priority = (priority < I2C_PRIORITY_COUNT) ? priority : I2C_PRIORITY_LOW;
+	client->stats 	 = (I2CClientStats){0};
+	if(!client->done)
+		client->done = xSemaphoreCreateCounting(I2C_BUS_QUEUE_LENGTH, 0);
+
+	c_common_perf_register(&client->probe, "I2C", name);
+	return client->done != 0;
+}
+
+/** \brief Posta um pedido, sem bloquear.
+  *
+  * A transação será executada pela task do barramento; ao seu fim, \b transfer->result é preenchido e
+  * o semáforo do cliente é liberado (ver c_common_i2c_wait()). \b transfer e seus buffers devem
+  * permanecer válidos até lá. \b done e \b signal do descritor não são usados.
+  *
+  * @param  client Cliente que faz o pedido.
+  * @param  transfer Transação.
+  * @retval true caso o pedido tenha sido enfileirado; false se a fila da prioridade estiver cheia, ou se
+  * a task do barramento não estiver em execução.
+  */
+bool c_common_i2c_post(I2CClient *client, I2CTransfer *transfer) {
+	I2CRequest request = { client, transfer, c_common_perf_cycles() };
+
+	if(!prv_running())
+		return false;
+
+	transfer->result = I2C_RESULT_PENDING;
+	if(xQueueSend(i2c_bus_queues[client->priority], &request, 0) != pdTRUE) {
+		taskENTER_CRITICAL();
+		client->stats.rejected++;
+		taskEXIT_CRITICAL();
+		return false;
+	}
+
+	xSemaphoreGive(i2c_bus_wake);
+	return true;
+}
+
+/** \brief Aguarda o fim de um pedido postado.
+  *
+  * O semáforo do cliente conta as conclusões de todos os seus pedidos: cada uma acorda a espera, que
+  * confere o resultado do pedido aguardado e volta a dormir se ele ainda estiver pendente. Assim, os
+  * pedidos de um cliente podem ser aguardados em qualquer ordem.
+  *
+  * @param  client Cliente.
+  * @param  transfer Transação postada pelo cliente.
+  * @param  ticks Tempo máximo de espera.
+  * @retval Resultado da transação, ou I2C_RESULT_PENDING caso o tempo tenha se esgotado (o pedido
+  * continua na fila, e \b transfer deve permanecer válida).
+  */
+I2CResult c_common_i2c_wait(I2CClient *client, I2CTransfer *transfer, portTickType ticks) {
+	portTickType start = xTaskGetTickCount();
+
+	while(transfer->result == I2C_RESULT_PENDING) {
+		portTickType elapsed = xTaskGetTickCount() - start;
+
+		if(ticks != portMAX_DELAY && elapsed >= ticks)
+			break;
+		xSemaphoreTake(client->done, (ticks == portMAX_DELAY) ? portMAX_DELAY : ticks - elapsed);
+	}
+
+	return transfer->result;
+}
+
+/** \brief Posta um pedido e dorme até o seu fim.
+  *
+  * Se a fila estiver cheia, aguarda e tenta novamente. Antes do escalonador, ou sem a task do barramento
+  * (c_common_i2c_bus_init()), a transação é executada pela própria chamada, e também contabilizada no
+  * cliente. Como toda transação tem duração limitada (ver c_common_i2c_transfer()), a espera também é.
+  *
+  * @param  client Cliente que faz o pedido.
+  * @param  transfer Transação.
+  * @retval Resultado da transação.
+  */
+I2CResult c_common_i2c_request(I2CClient *client, I2CTransfer *transfer) {
+	if(!prv_running())
+		return prv_execute(client, transfer, c_common_perf_cycles());
+
+	while(!c_common_i2c_post(client, transfer))
+		vTaskDelay(1);
+
+	return c_common_i2c_wait(client, transfer, portMAX_DELAY);
+}
+
+/** \brief Executa uma tabela de inicialização (ver c_common_i2c_init_sequence()) como pedidos do cliente.
+  *
+  * Cada rajada é um pedido; as esperas dos passos são feitas pela task do cliente, fora do barramento.
+  * Antes do escalonador, executa c_common_i2c_init_sequence().
+  *
+  * @param  client Cliente que faz os pedidos.
+  * @param  steps Tabela de passos.
+  * @param  count Quantidade de passos.
+  * @retval Quantidade de passos executados (ver c_common_i2c_init_sequence()).
+  */
+int c_common_i2c_request_sequence(I2CClient *client, const I2CInitStep *steps, int count) {
+	uint8_t burst[I2C_BURST_MAX];
+	int done = 0;
+
+	if(xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+		return c_common_i2c_init_sequence(steps, count);
+
+	while(done < count) {
+		const I2CInitStep* first = &steps[done];
+		int length = c_common_i2c_sequence_burst(first, count - done, burst);
+		I2CTransfer transfer = { .device = first->device, .reg = first->reg, .txData = burst, .txLength = length };
+
+		if(c_common_i2c_request(client, &transfer) != I2C_RESULT_OK)
+			return done;
+		done += length;
+
+		uint8_t delay = steps[done - 1].delay;
+		if(delay)
+			vTaskDelay((delay + portTICK_RATE_MS - 1) / portTICK_RATE_MS);
+	}
+
+	return done;
+}
+
+/** \brief Submete a transação de um cliente de interrupção, sem bloquear.
+  *
+  * Pode ser chamada de interrupções, como c_common_i2c_submit(). O cliente tem no máximo uma transação
+  * em andamento, e deve chamar c_common_i2c_client_complete() no seu fim (na função \b done).
+  *
+  * @param  client Cliente.
+  * @param  transfer Transação.
+  * @param  stamp c_common_perf_cycles() no instante do pedido (ex.: o disparo de uma amostragem).
+  * @retval true caso a transação tenha sido iniciada (ver c_common_i2c_submit()).
+  */
+bool c_common_i2c_client_submit(I2CClient *client, I2CTransfer *transfer, uint32_t stamp) {
+	client->stamp = stamp;
+	if(!c_common_i2c_submit(transfer)) {
+		client->stats.rejected++;
+		return false;
+	}
+
+	uint32_t wait = c_common_perf_cycles() - stamp;
+	if(wait > client->stats.waitMax)
+		client->stats.waitMax = wait;
+	return true;
+}
+
+/** \brief Contabiliza o fim da transação de um cliente de interrupção. Chamada na função \b done.
+  *
+  * @param  client Cliente.
+  * @param  transfer Transação concluída.
+  */
+void c_common_i2c_client_complete(I2CClient *client, const I2CTransfer *transfer) {
+	prv_account(client, transfer, transfer->result, 0, c_common_perf_cycles() - client->stamp);
+}
+
+/** \brief Retorna os contadores de um cliente.
+  *
+  * @param  client Cliente.
+  * @retval Cópia dos contadores.
+  */
+I2CClientStats c_common_i2c_client_stats(I2CClient *client) {
+	I2CClientStats stats;
+
+	taskENTER_CRITICAL(); // mascara a I2C (prioridade abaixo de configMAX_SYSCALL_INTERRUPT_PRIORITY)
+	stats = client->stats;
+	taskEXIT_CRITICAL();
+
+	return stats;
+}
+
+/* IRQ handlers ------------------------------------------------------------- */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_i2c_bus.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Gerenciador do barramento I2C: filas de pedidos por prioridade e uma task dona do barramento.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_COMMON_I2C_BUS_H
+#define C_COMMON_I2C_BUS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+#include "c_common_i2c.h"
+#include "c_common_perf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Prioridade dos pedidos de um cliente. Pedidos mais prioritários são atendidos primeiro. */
+typedef enum {
+	I2C_PRIORITY_HIGH = 0,		//!< Ex.: leitura de sensores do laço de controle.
+	I2C_PRIORITY_NORMAL,		//!< Ex.: sensores auxiliares.
+	I2C_PRIORITY_LOW,			//!< Ex.: configuração, diagnóstico.
+	I2C_PRIORITY_COUNT
+} I2CPriority;
+
+/** \brief Contadores de um cliente. Tempos em ciclos de clock (ver \ref Common_Components_Perf). */
+typedef struct {
+	uint32_t requests;		//!< Pedidos concluídos.
+	uint32_t errors;		//!< Pedidos concluídos com resultado diferente de I2C_RESULT_OK.
+	uint32_t rejected;		//!< Pedidos recusados (fila cheia, ou periférico ocupado para um cliente de interrupção).
+	uint32_t waitMax;		//!< Maior espera, do pedido ao início da transação.
+	uint32_t latencyLast;	//!< Tempo do último pedido, do pedido ao fim da transação.
+	uint32_t latencyMax;	//!< Maior tempo de um pedido.
+	uint32_t latencySum;	//!< Soma dos tempos; a média é latencySum/requests.
+} I2CClientStats;
+
+/** \brief Cliente do barramento: uma task, um driver ou um componente que submete pelas interrupções. */
+typedef struct {
+	const char* 		name;		//!< Nome, para os contadores de desempenho.
+	I2CPriority 		priority;	//!< Fila usada pelos pedidos.
+	xSemaphoreHandle 	done;		//!< Liberado a cada pedido concluído (semáforo contador).
+	uint32_t 			stamp;		//!< Instante do pedido em andamento de um cliente de interrupção.
+	I2CClientStats 		stats;		//!< Contadores.
+	PerfProbe 			probe;		//!< Pedidos, bytes e tempo do pedido ao fim (enviado pela telemetria).
+} I2CClient;
+
+/* Exported constants --------------------------------------------------------*/
+
+/** Pedidos pendentes em cada fila de prioridade (e por cliente). */
+#define I2C_BUS_QUEUE_LENGTH	8
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+bool c_common_i2c_bus_init(unsigned portBASE_TYPE priority);
+bool c_common_i2c_client_init(I2CClient *client, const char *name, I2CPriority priority);
+bool c_common_i2c_post(I2CClient *client, I2CTransfer *transfer);
+I2CResult c_common_i2c_wait(I2CClient *client, I2CTransfer *transfer, portTickType ticks);
+I2CResult c_common_i2c_request(I2CClient *client, I2CTransfer *transfer);
+int c_common_i2c_request_sequence(I2CClient *client, const I2CInitStep *steps, int count);
+bool c_common_i2c_client_submit(I2CClient *client, I2CTransfer *transfer, uint32_t stamp);
+void c_common_i2c_client_complete(I2CClient *client, const I2CTransfer *transfer);
+I2CClientStats c_common_i2c_client_stats(I2CClient *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_COMMON_I2C_BUS_H
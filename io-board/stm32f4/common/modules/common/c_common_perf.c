@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_perf.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do contador de ciclos.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_common_perf.h"
+
+/** @addtogroup Common_Components
+  * @{
+  */
+
+/** @addtogroup Common_Components_Perf
+  * \brief Medição de tempos em ciclos de clock, pelo contador CYCCNT da unidade DWT do Cortex-M4.
+  *
+  * Ler o contador custa um único acesso a registrador, de forma que as medições podem ser feitas
+  * inclusive dentro de tratadores de interrupção.
+  *
+  * \code{.c}
+  * c_common_perf_init();
+  *
+  * uint32_t start = c_common_perf_cycles();
+  * // trecho medido
+  * uint32_t us = c_common_perf_cycles_to_us(c_common_perf_cycles() - start);
+  * \endcode
+  *
+  * Os drivers (USART, I2C, servos) mantêm ainda probes (PerfProbe) em volta de cada chamada de API e de
+  * cada tratador de interrupção, registrados em uma tabela por c_common_perf_register(). Cada probe
+  * acumula execuções, bytes, quadros, ciclos e o pior caso; a partir deles, quem lê a tabela
+  * (c_common_perf_snapshot()) obtém bytes/s, ciclos por byte, entradas no tratador por quadro e o tempo
+  * máximo de bloqueio de cada API. Esta é a referência de desempenho contra a qual mudanças nos drivers
+  * devem ser comparadas. Os probes custam poucas dezenas de ciclos por execução, e podem ser removidos
+  * compilando com \b PERF_PROBES_ENABLED igual a 0.
+  *
+  * \code{.c}
+  * static PerfProbe probe;
+  * c_common_perf_register(&probe, "I2C1", "read");
+  *
+  * PERF_PROBE_BEGIN();
+  * // operação medida, que processa n bytes
+  * PERF_PROBE_END(probe, n);
+  * \endcode
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+PerfProbe* perf_probes[PERF_MAX_PROBES];	//! Probes registrados.
+int perf_probes_count = 0;					//! Quantidade de probes registrados.
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Liga a unidade de trace e o contador de ciclos. Pode ser chamada mais de uma vez;
+  * o contador não é zerado.
+  */
+void c_common_perf_init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	PERF_DWT_CTRL 	 |= PERF_DWT_CTRL_CYCCNTENA;
+}
+
+/** \brief Zera um probe e o inclui na tabela (uma única vez, mesmo se chamada novamente).
+  * Chamada na inicialização dos drivers, antes do escalonador.
+  *
+  * @param  probe Probe a registrar; deve existir por todo o programa.
+  * @param  owner Dono da operação (ex.: "USART2").
+  * @param  name Operação (ex.: "write").
+  */
+void c_common_perf_register(PerfProbe* probe, const char* owner, const char* name) {
+	*probe = (PerfProbe){ owner, name, 0, 0, 0, 0, 0 };
+
+	for(int i = 0; i < perf_probes_count; i++)
+		if(perf_probes[i] == probe)
+			return;
+	if(perf_probes_count < PERF_MAX_PROBES)
+		perf_probes[perf_probes_count++] = probe;
+}
+
+/** \brief Quantidade de probes registrados. */
+int c_common_perf_probe_count(void) {
+	return perf_probes_count;
+}
+
+/** \brief Copia (e opcionalmente zera) um probe, de forma atômica com relação às interrupções.
+  *
+  * @param  index Índice do probe, de 0 a c_common_perf_probe_count() - 1.
+  * @param  out Destino da cópia.
+  * @param  reset Zera os contadores após a cópia, iniciando um novo intervalo de medição.
+  * @retval false caso o índice seja inválido.
+  */
+bool c_common_perf_snapshot(int index, PerfProbe* out, bool reset) {
+	if(index < 0 || index >= perf_probes_count)
+		return false;
+
+	PerfProbe* probe = perf_probes[index];
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	*out = *probe;
+	if(reset) {
+		probe->count  = 0;
+		probe->bytes  = 0;
+		probe->frames = 0;
+		probe->cycles = 0;
+		probe->max 	  = 0;
+	}
+
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_perf.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Contador de ciclos (DWT) para medições de desempenho.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_COMMON_PERF_H
+#define C_COMMON_PERF_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Ponto de medição de uma operação (chamada de API ou tratador de interrupção).
+  * Cada probe deve ser atualizado de um único contexto; atualizações concorrentes podem perder amostras,
+  * o que é aceitável para estatísticas.
+  */
+typedef struct {
+	const char* 		owner;		//!< Dono da operação (ex.: "USART2").
+	const char* 		name;		//!< Operação (ex.: "write").
+	volatile uint32_t 	count;		//!< Execuções (chamadas ou entradas no tratador).
+	volatile uint32_t 	bytes;		//!< Bytes processados.
+	volatile uint32_t 	frames;		//!< Quadros, pacotes ou transferências completas.
+	volatile uint32_t 	cycles;		//!< Ciclos gastos, somados.
+	volatile uint32_t 	max;		//!< Pior caso de uma execução (ciclos).
+} PerfProbe;
+
+/* Exported constants --------------------------------------------------------*/
+
+/** Habilita os probes de desempenho dos drivers (PERF_PROBE_BEGIN/PERF_PROBE_END). */
+#ifndef PERF_PROBES_ENABLED
+#define PERF_PROBES_ENABLED		1
+#endif
+
+/** Quantidade máxima de probes registrados. */
+#define PERF_MAX_PROBES			24
+
+/* Registradores do DWT, ausentes do core_cm4.h desta versão do CMSIS. */
+#define PERF_DWT_CTRL			(*(volatile uint32_t *)0xE0001000) //!< DWT_CTRL.
+#define PERF_DWT_CYCCNT			(*(volatile uint32_t *)0xE0001004) //!< DWT_CYCCNT.
+#define PERF_DWT_CTRL_CYCCNTENA	((uint32_t)0x00000001)			   //!< Habilita DWT_CYCCNT.
+
+/* Exported macro ------------------------------------------------------------*/
+
+#if PERF_PROBES_ENABLED
+/** Marca o início do trecho medido (declara uma variável local). */
+#define PERF_PROBE_BEGIN()					uint32_t perf_start = c_common_perf_cycles()
+/** Marca o fim do trecho medido, contabilizando \b nbytes em \b probe. */
+#define PERF_PROBE_END(probe, nbytes)		c_common_perf_probe_add(&(probe), c_common_perf_cycles() - perf_start, (nbytes))
+/** Contabiliza um quadro completo em \b probe. */
+#define PERF_PROBE_FRAME(probe)				((probe).frames++)
+#else
+#define PERF_PROBE_BEGIN()
+#define PERF_PROBE_END(probe, nbytes)
+#define PERF_PROBE_FRAME(probe)
+#endif
+
+/* Exported functions ------------------------------------------------------- */
+void c_common_perf_init(void);
+void c_common_perf_register(PerfProbe* probe, const char* owner, const char* name);
+int  c_common_perf_probe_count(void);
+bool c_common_perf_snapshot(int index, PerfProbe* out, bool reset);
+
+/* Header-defined wrapper functions ----------------------------------------- */
+/** @addtogroup Common_Components
+  * @{
+  */
+/** @addtogroup Common_Components_Perf
+  * @{
+  */
+
+/** \brief Valor atual do contador de ciclos. Diferenças entre duas leituras são válidas
+  * mesmo com o contador dando a volta (a cada ~25 s a 168 MHz).
+  */
+static inline uint32_t c_common_perf_cycles(void) { return PERF_DWT_CYCCNT; }
+
+/** \brief Contabiliza uma execução de \b cycles ciclos, que processou \b bytes bytes. */
+static inline void c_common_perf_probe_add(PerfProbe* probe, uint32_t cycles, uint32_t bytes) {
+	probe->count++;
+	probe->bytes  += bytes;
+	probe->cycles += cycles;
+	if(cycles > probe->max)
+		probe->max = cycles;
+}
+
+/** \brief Converte ciclos em microssegundos, a partir de \b SystemCoreClock. */
+static inline uint32_t c_common_perf_cycles_to_us(uint32_t cycles) { return cycles / (SystemCoreClock / 1000000); }
+
+/**
+  * @}
+  */
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_COMMON_PERF_H
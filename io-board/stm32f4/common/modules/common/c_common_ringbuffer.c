@@ -0,0 +1,148 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_ringbuffer.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do buffer circular SPSC.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_common_ringbuffer.h"
+
+/** @addtogroup Common_Components
+  * @{
+  */
+
+/** @addtogroup Common_Components_RingBuffer
+  * \brief Buffer circular lock-free para um produtor (ex.: tratador de interrupção) e um consumidor (ex.: task).
+  *
+  * O tamanho deve ser potência de 2, de forma que os índices são obtidos por máscara. Os contadores
+  * \b head e \b tail nunca são zerados: a diferença entre eles é a ocupação, o que permite distinguir
+  * buffer cheio de buffer vazio sem flags adicionais. Quando o buffer está cheio, o produtor descarta
+  * o byte novo e incrementa \b dropped; os dados ainda não lidos nunca são sobrescritos.
+  *
+  * A exceção é o produtor por DMA circular (c_common_ringbuffer_produce()), que escreve na área de
+  * armazenamento sem consultar \b tail. Nesse caso os bytes sobrescritos são contados, e o consumidor
+  * passa a ler a partir dos dados mais antigos ainda válidos.
+  *
+  * \code{.c}
+  * uint8_t storage[64];
+  * RingBuffer rb;
+  * c_common_ringbuffer_init(&rb, storage, sizeof(storage));
+  *
+  * // ISR
+  * c_common_ringbuffer_put(&rb, USART_ReceiveData(USART2));
+  *
+  * // task
+  * uint8_t frame[16];
+  * int n = c_common_ringbuffer_read(&rb, frame, sizeof(frame));
+  * \endcode
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Retorna o \b tail efetivo, saltando dados já sobrescritos pelo produtor. Lado do consumidor. */
+static inline uint32_t prv_tail(RingBuffer* rb) {
+	uint32_t head = rb->head;
+	uint32_t tail = rb->tail;
+	return (head - tail > rb->mask + 1) ? head - (rb->mask + 1) : tail;
+}
+
+/** \brief Copia até \b n bytes a partir de \b tail, sem consumi-los. Lado do consumidor.
+ * \b head é relido aqui: se o produtor tiver dado mais de uma volta desde prv_tail(), \b tail é
+ * reajustado para o dado mais antigo ainda presente.
+ */
+static int prv_copy(RingBuffer* rb, uint32_t* tail, uint8_t* dst, int n) {
+	uint32_t count = rb->head - *tail;
+	__DMB(); // head lido antes dos dados
+
+	if(count > rb->mask + 1) {
+		*tail += count - (rb->mask + 1);
+		count = rb->mask + 1;
+	}
+	if((uint32_t)n > count)
+		n = count;
+
+	uint32_t start = *tail & rb->mask;
+	uint32_t first = rb->mask + 1 - start; // bytes até o fim da área de armazenamento
+	if(first > (uint32_t)n)
+		first = n;
+
+	for(uint32_t i=0; i<first; i++)
+		dst[i] = rb->buffer[start + i];
+	for(uint32_t i=first; i<(uint32_t)n; i++)
+		dst[i] = rb->buffer[i - first];
+
+	return n;
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Inicializa o buffer circular sobre uma área de armazenamento.
+ *
+ * @param rb Buffer a inicializar.
+ * @param storage Área de armazenamento.
+ * @param size Tamanho de \b storage. Deve ser potência de 2.
+ */
+void c_common_ringbuffer_init(RingBuffer* rb, uint8_t* storage, uint32_t size) {
+	assert_param((size & (size - 1)) == 0);
+
+	rb->buffer  = storage;
+	rb->mask    = size - 1;
+	rb->head    = 0;
+	rb->tail    = 0;
+	rb->dropped = 0;
+}
+
+/** \brief Lê e consome até \b n bytes de uma só vez. Lado do consumidor.
+ *
+ * @param rb Buffer.
+ * @param dst Destino, com pelo menos \b n bytes.
+ * @param n Quantidade máxima de bytes.
+ * @retval Quantidade de bytes lidos.
+ */
+int c_common_ringbuffer_read(RingBuffer* rb, uint8_t* dst, int n) {
+	if(n <= 0)
+		return 0;
+
+	uint32_t tail = prv_tail(rb);
+	n = prv_copy(rb, &tail, dst, n);
+	__DMB(); // dados lidos antes de liberar as posições
+	rb->tail = tail + n;
+
+	return n;
+}
+
+/** \brief Copia até \b n bytes sem consumi-los. Lado do consumidor.
+ *
+ * @param rb Buffer.
+ * @param dst Destino, com pelo menos \b n bytes.
+ * @param n Quantidade máxima de bytes.
+ * @retval Quantidade de bytes copiados.
+ */
+int c_common_ringbuffer_peek(RingBuffer* rb, uint8_t* dst, int n) {
+	if(n <= 0)
+		return 0;
+
+	uint32_t tail = prv_tail(rb);
+	return prv_copy(rb, &tail, dst, n);
+}
+
+/* IRQ handlers ------------------------------------------------------------- */
+
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file    modules/common/c_common_ringbuffer.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Buffer circular lock-free de um produtor e um consumidor (SPSC).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_COMMON_RINGBUFFER_H
+#define C_COMMON_RINGBUFFER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Buffer circular de bytes com um único produtor e um único consumidor.
+  *
+  * \b head só é escrito pelo produtor e \b tail só pelo consumidor. Ambos crescem
+  * monotonicamente e são reduzidos ao tamanho do buffer por máscara.
+  */
+typedef struct {
+	uint8_t* 			buffer;		//!< Área de armazenamento (tamanho potência de 2).
+	uint32_t 			mask;		//!< Tamanho do buffer - 1.
+	volatile uint32_t 	head;		//!< Total de bytes escritos (produtor).
+	volatile uint32_t 	tail;		//!< Total de bytes lidos (consumidor).
+	volatile uint32_t 	dropped;	//!< Bytes descartados por buffer cheio (produtor).
+} RingBuffer;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+void c_common_ringbuffer_init(RingBuffer* rb, uint8_t* storage, uint32_t size);
+int  c_common_ringbuffer_read(RingBuffer* rb, uint8_t* dst, int n);
+int  c_common_ringbuffer_peek(RingBuffer* rb, uint8_t* dst, int n);
+
+/* Header-defined wrapper functions ----------------------------------------- */
+/** @addtogroup Common_Components
+  * @{
+  */
+/** @addtogroup Common_Components_RingBuffer
+  * @{
+  */
+
+/** \brief Quantidade de bytes não lidos. Pode ser chamada por qualquer um dos lados. */
+static inline uint32_t c_common_ringbuffer_count(const RingBuffer* rb) { return rb->head - rb->tail; }
+
+/** \brief Espaço livre no buffer. */
+static inline uint32_t c_common_ringbuffer_free(const RingBuffer* rb) { return rb->mask + 1 - (rb->head - rb->tail); }
+
+/** \brief Insere um byte (lado do produtor). Se o buffer estiver cheio, o byte é descartado e contado.
+ *  @retval true caso o byte tenha sido armazenado.
+ */
+static inline bool c_common_ringbuffer_put(RingBuffer* rb, uint8_t byte) {
+	uint32_t head = rb->head;
+	if(head - rb->tail > rb->mask) {
+		rb->dropped++;
+		return false;
+	}
+	rb->buffer[head & rb->mask] = byte;
+	__DMB(); // dado visível antes do novo head
+	rb->head = head + 1;
+	return true;
+}
+
+/** \brief Publica \b n bytes já escritos diretamente na área de armazenamento (ex.: por DMA circular).
+ *  Lado do produtor. Como os dados já foram escritos, bytes não lidos que tenham sido sobrescritos
+ *  são apenas contados em \b dropped; o consumidor descarta-os na próxima leitura.
+ */
+static inline void c_common_ringbuffer_produce(RingBuffer* rb, uint32_t n) {
+	uint32_t size = rb->mask + 1;
+	uint32_t head = rb->head + n;
+	uint32_t used = head - rb->tail;
+
+	if(used > size) {
+		uint32_t lost = used - size;
+		rb->dropped += (lost < n) ? lost : n;
+	}
+	__DMB(); // dados visíveis antes do novo head
+	rb->head = head;
+}
+
+/** \brief Remove um byte (lado do consumidor).
+ *  @retval true caso havia um byte a ser lido.
+ */
+static inline bool c_common_ringbuffer_get(RingBuffer* rb, uint8_t* byte) {
+	uint32_t head = rb->head;
+	uint32_t tail = rb->tail;
+	if(head == tail)
+		return false;
+	if(head - tail > rb->mask + 1)
+		tail = head - (rb->mask + 1); // dados sobrescritos pelo produtor (ver c_common_ringbuffer_produce)
+	__DMB(); // head lido antes do dado
+	*byte = rb->buffer[tail & rb->mask];
+	__DMB(); // dado lido antes de liberar a posição
+	rb->tail = tail + 1;
+	return true;
+}
+
+/**
+  * @}
+  */
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_COMMON_RINGBUFFER_H
@@ -9,6 +9,12 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "c_common_uart.h"
+#include "c_common_ringbuffer.h"
+#include "c_common_perf.h"
+
+/* FreeRTOS kernel includes */
+#include "task.h"
+#include "semphr.h"
 
 /** @addtogroup Common_Components
   * @{
@@ -18,121 +24,685 @@
   *
   * \brief Implementa as funções básicas de envio e recebimento de UART/USART.
   *
-  * Para cada uma, é instalado o tratador de interrupções respectivo, e um buffer circular que armazena
-  * o que vai sendo recebido. Enquanto o buffer não tiver sido completamente lido, uma flag é mantida
-  * setada.
+  * Para cada uma, é instalado o tratador de interrupções respectivo, e um buffer circular (RingBuffer,
+  * ver \ref Common_Components_RingBuffer) que armazena o que vai sendo recebido. O tratador é o único
+  * produtor e a task que lê a USART, o único consumidor. Bytes recebidos com o buffer cheio, ou perdidos
+  * por overrun da USART, são descartados e contados (ver c_common_usart_dropped()).
+  *
+  * Protocolos podem consumir quadros inteiros com c_common_usart_read_block(), e inspecionar cabeçalhos
+  * sem consumi-los com c_common_usart_peek().
+  *
+  * Tasks podem ainda dormir à espera de dados com c_common_usart_read_timeout(), em vez de consultar
+  * c_common_usart_available() periodicamente. Cada porta possui um semáforo binário, liberado pelo
+  * tratador de interrupção (xSemaphoreGiveFromISR()) assim que há bytes suficientes para a leitura em
+  * curso, ou assim que chega o terminador configurado (c_common_usart_set_rx_terminator()). A task é
+  * portanto acordada uma única vez por leitura, e a latência é a de uma troca de contexto, não a do
+  * período de consulta. Os contadores em USARTRxStats (c_common_usart_rx_stats()) permitem medir isso.
+  * Cada porta registra probes de desempenho (ver \ref Common_Components_Perf) para os tratadores de envio
+  * e de recebimento e para c_common_usart_write() e c_common_usart_flush().
+  *
+  * Por chamarem a API do FreeRTOS, as interrupções das USARTs e de seus streams de DMA têm prioridade
+  * numericamente maior ou igual a \b configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, com os grupos de
+  * prioridade em \b NVIC_PriorityGroup_4.
+  *
+  * Portas rápidas (ex.: barramento dos servos em USART6, a 1 Mbit/s) podem trocar a interrupção por byte
+  * por DMA circular com detecção de linha ociosa, via c_common_usart_set_rx_mode(): o tratador é então
+  * executado uma vez por pacote recebido, e não uma vez por byte.
   *
-  * \bug A flag de recebimento (ex.: usart2_available_flag) é setada quando o indexador do buffer circular
-  * (usart2_rb_in) está a frente do indexador de leitura do buffer (usart2_rb_out). Caso o buffer tenha
-  * dado "uma volta completa", a flag não é mantida setada, mesmo havendo 64 caracteres não tratados.
+  * O envio é feito por DMA, a partir de uma fila de segmentos (ponteiro, tamanho e função de conclusão,
+  * ver USARTTxSegment) percorrida em ordem pelo tratador de interrupção do stream: ao fim de cada
+  * transferência, o segmento é devolvido ao seu dono e o próximo é disparado.
   *
-  * \todo Implementar UART3 - disponível na placa STM32F407
+  * c_common_usart_queue() enfileira segmentos do chamador sem copiá-los, de modo que cabeçalho, dados e
+  * checksum de um pacote podem estar em buffers distintos e ainda assim sair em sequência. As demais
+  * funções de envio copiam os dados para um de dois buffers de envio (double-buffering) e retornam
+  * imediatamente; o buffer em preenchimento entra na fila como mais um segmento quando o DMA fica livre,
+  * ou quando um segmento sem cópia é enfileirado depois dele. Caso os dois buffers estejam ocupados, os
+  * bytes excedentes são descartados e contabilizados em USARTTxStats (ver c_common_usart_tx_stats()).
+  *
+  * O envio e o recebimento são testados no host, sem alteração neste arquivo, contra USARTs, DMA e NVIC
+  * simulados nos endereços reais (ver ground/drivers/usart_test.c).
+  *
+  * As USARTs suportadas (1, 2, 3 e 6) são descritas em uma tabela constante (USARTDescriptor: pinos,
+  * função alternativa, clocks, interrupção e streams de DMA), e todo o código é comum a elas. Qualquer
+  * porta é inicializada por c_common_usart_init(). Os tratadores de interrupção acessam o estado da sua
+  * porta diretamente pelo índice, e as funções que recebem um \em USART_TypeDef* o encontram em tempo
+  * constante a partir do endereço do periférico (ver USART_SLOT).
+  *
+  * | USART  | TX   | RX   | DMA TX           | DMA RX           |
+  * |--------|------|------|------------------|------------------|
+  * | USART1 | PB6  | PB7  | DMA2 S7, canal 4 | DMA2 S5, canal 4 |
+  * | USART2 | PA2  | PA3  | DMA1 S6, canal 4 | DMA1 S5, canal 4 |
+  * | USART3 | PB10 | PB11 | DMA1 S3, canal 4 | DMA1 S1, canal 4 |
+  * | USART6 | PC6  | PC7  | DMA2 S6, canal 5 | DMA2 S1, canal 5 |
   * @{
   */
 
 /* Private typedef -----------------------------------------------------------*/
+
+/** \brief Stream de DMA e os registradores de flags que lhe correspondem. */
+typedef struct {
+	DMA_Stream_TypeDef* 		stream;		//!< Stream de DMA.
+	volatile uint32_t* 			isr;		//!< LISR ou HISR do controlador de DMA.
+	volatile uint32_t* 			ifcr;		//!< LIFCR ou HIFCR do controlador de DMA.
+	uint32_t 					flagShift;	//!< Posição dos flags do stream em LISR/HISR.
+} DMAStream;
+
+/** \brief Descrição constante do hardware de uma USART. */
+typedef struct {
+	USART_TypeDef* 			usart;			//!< Periférico.
+	GPIO_TypeDef* 			port;			//!< Porta dos pinos de TX e RX.
+	uint16_t 				txPin;			//!< Pino de TX (\em GPIO_Pin_x).
+	uint16_t 				rxPin;			//!< Pino de RX (\em GPIO_Pin_x).
+	uint8_t 				txSource;		//!< Fonte do pino de TX (\em GPIO_PinSourcex).
+	uint8_t 				rxSource;		//!< Fonte do pino de RX (\em GPIO_PinSourcex).
+	uint8_t 				af;				//!< Função alternativa (\em GPIO_AF_USARTx).
+	uint32_t 				gpioClock;		//!< Clock da porta (\em RCC_AHB1Periph_GPIOx).
+	uint32_t 				clock;			//!< Clock da USART (\em RCC_APBxPeriph_USARTx).
+	bool 					apb2;			//!< USART no barramento APB2 (USART1 e USART6).
+	uint8_t 				irq;			//!< Canal de interrupção da USART.
+	uint8_t 				priority;		//!< Prioridade (preempção) das interrupções da porta.
+	DMA_TypeDef* 			dma;			//!< Controlador de DMA dos dois streams.
+	DMA_Stream_TypeDef* 	txStream;		//!< Stream de DMA de envio.
+	uint8_t 				txStreamNumber;	//!< Número do stream de envio.
+	uint32_t 				txChannel;		//!< Canal do stream de envio (\em DMA_Channel_x).
+	uint8_t 				txIrq;			//!< Canal de interrupção do stream de envio.
+	DMA_Stream_TypeDef* 	rxStream;		//!< Stream de DMA de recebimento.
+	uint8_t 				rxStreamNumber;	//!< Número do stream de recebimento.
+	uint32_t 				rxChannel;		//!< Canal do stream de recebimento (\em DMA_Channel_x).
+	uint8_t 				rxIrq;			//!< Canal de interrupção do stream de recebimento.
+	const char* 			name;			//!< Nome da porta, para os probes de desempenho.
+} USARTDescriptor;
+
+/** \brief Estado do envio via DMA de uma USART. */
+typedef struct {
+	uint8_t 					buffer[2][USART_TX_BUFFER_SIZE];	//!< Buffers de envio (double-buffering).
+	volatile uint16_t 			fill;		//!< Bytes reservados no buffer sendo preenchido.
+	volatile uint8_t 			active;		//!< Índice do buffer sendo preenchido.
+	volatile bool 				queued[2];	//!< Buffer de envio na fila (não pode ser preenchido).
+	volatile uint8_t 			copying[2];	//!< Escritas ainda copiando para cada buffer (o DMA as aguarda).
+	USARTTxSegment 				queue[USART_TX_QUEUE_SIZE];	//!< Fila de segmentos; o primeiro está no DMA.
+	volatile uint32_t 			head;		//!< Segmentos enfileirados (total).
+	volatile uint32_t 			tail;		//!< Segmentos concluídos (total).
+	volatile bool 				busy;		//!< Há uma transferência de DMA em andamento.
+	USART_TypeDef* 				usart;		//!< USART atendida.
+	DMAStream 					dma;		//!< Stream de DMA de envio.
+	USARTTxStats 				stats;		//!< Contadores de desempenho.
+	PerfProbe 					irqProbe;	//!< Tratador do stream (quadros: transferências concluídas).
+	PerfProbe 					writeProbe;	//!< c_common_usart_write() (bytes aceitos).
+	PerfProbe 					flushProbe;	//!< c_common_usart_flush() (tempo bloqueado).
+	xSemaphoreHandle 			drained;	//!< Liberado pelo tratador da USART ao ver TC, para c_common_usart_flush().
+} USARTTxEngine;
+
+/** \brief Estado do recebimento de uma USART. */
+typedef struct {
+	uint8_t 					buffer[USART_RX_BUFFER_SIZE]; //!< Armazenamento do Ring-Buffer (destino do DMA circular).
+	RingBuffer 					ring;		//!< Ring-Buffer de recebimento.
+	USARTRxMode 				mode;		//!< Modo de recebimento atual.
+	USART_TypeDef* 				usart;		//!< USART atendida.
+	DMAStream 					dma;		//!< Stream de DMA de recebimento.
+	uint32_t 					channel;	//!< Canal do stream ligado ao RX da USART.
+	uint32_t 					dmaPos;		//!< Última posição de escrita do DMA já repassada ao Ring-Buffer.
+	volatile uint32_t 			frames;		//!< Quadros recebidos (linha ociosa após dados).
+	xSemaphoreHandle 			signal;		//!< Liberado pelo tratador para acordar a task leitora.
+	volatile uint32_t 			waiting;	//!< Bytes aguardados pela task leitora (0: ninguém aguardando).
+	volatile bool 				terminated;	//!< O terminador chegou durante a espera.
+	int16_t 					terminator;	//!< Byte que encerra uma leitura, ou USART_NO_TERMINATOR.
+	volatile uint32_t 			stamp;		//!< Instante (ciclos) em que o semáforo foi liberado.
+	USARTRxStats 				stats;		//!< Contadores do recebimento bloqueante.
+	PerfProbe 					irqProbe;	//!< Tratadores de recebimento (bytes repassados; quadros: linha ociosa).
+} USARTRxEngine;
+
+/** \brief Estado de uma USART. */
+typedef struct {
+	const USARTDescriptor* 		desc;		//!< Descrição do hardware.
+	volatile bool 				ready;		//!< Porta já inicializada.
+	uint32_t 					baudrate;	//!< Baudrate efetivo, obtido do divisor programado.
+	USARTTxEngine 				tx;			//!< Envio.
+	USARTRxEngine 				rx;			//!< Recebimento.
+} USARTPort;
+
+/** \brief Índices das portas em usart_descriptors e usart_ports. */
+enum {
+	USART_PORT_1 = 0,
+	USART_PORT_2,
+	USART_PORT_3,
+	USART_PORT_6,
+	USART_PORT_COUNT
+};
+
 /* Private define ------------------------------------------------------------*/
-#define RECV_BUFFER_SIZE	64
+#define DMA_FLAG_TCIF		((uint32_t)0x20) //!< TCIFx, relativo a flagShift.
+#define DMA_FLAG_HTIF		((uint32_t)0x10) //!< HTIFx, relativo a flagShift.
+#define DMA_FLAG_TEIF		((uint32_t)0x08) //!< TEIFx, relativo a flagShift.
+#define DMA_FLAG_ALL		((uint32_t)0x3D) //!< Todos os flags de um stream.
+
+#define USART_BAUD_MAX_ERROR	20			//!< Erro máximo aceito no baudrate, em milésimos (2%).
+#define USART_RX_WAKE_LEVEL		(USART_RX_BUFFER_SIZE / 2) //!< Ocupação que acorda o leitor mesmo antes do pedido completo.
 
 /* Private macro -------------------------------------------------------------*/
+
+/** Índice (0 a 7) derivado do endereço do periférico, distinto para USART1, 2, 3 e 6. */
+#define USART_SLOT(address)		((((uint32_t)(address)) >> 10) & 0x07)
+
+/** Seção crítica curta com relação aos tratadores de interrupção (salva e restaura PRIMASK). */
+#define TX_ENTER_CRITICAL()		uint32_t primask = __get_PRIMASK(); __disable_irq()
+#define TX_EXIT_CRITICAL()		__set_PRIMASK(primask)
+
 /* Private variables ---------------------------------------------------------*/
-unsigned char usart2_recv_buffer[RECV_BUFFER_SIZE]; //! Ring-Buffer de recebimento de USART2.
-unsigned char usart6_recv_buffer[RECV_BUFFER_SIZE]; //! Ring-Buffer de recebimento de USART6.
 
-int usart2_rb_in  = 0; //! Index do Ring-Buffer para recebimento na USART2.
-int usart2_rb_out = 0; //! Index para leitura do Ring-Buffer da USART2.
+/** Tabela com o hardware de cada porta. As prioridades respeitam configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (5):
+  * o barramento dos servos (USART6, 1 Mbit/s) fica com a maior prioridade permitida.
+  */
+static const USARTDescriptor usart_descriptors[USART_PORT_COUNT] = {
+	[USART_PORT_1] = {
+		USART1, GPIOB, GPIO_Pin_6,  GPIO_Pin_7,  GPIO_PinSource6,  GPIO_PinSource7,  GPIO_AF_USART1,
+		RCC_AHB1Periph_GPIOB, RCC_APB2Periph_USART1, true,  USART1_IRQn, 6,
+		DMA2, DMA2_Stream7, 7, DMA_Channel_4, DMA2_Stream7_IRQn, DMA2_Stream5, 5, DMA_Channel_4, DMA2_Stream5_IRQn,
+		"USART1"
+	},
+	[USART_PORT_2] = {
+		USART2, GPIOA, GPIO_Pin_2,  GPIO_Pin_3,  GPIO_PinSource2,  GPIO_PinSource3,  GPIO_AF_USART2,
+		RCC_AHB1Periph_GPIOA, RCC_APB1Periph_USART2, false, USART2_IRQn, 6,
+		DMA1, DMA1_Stream6, 6, DMA_Channel_4, DMA1_Stream6_IRQn, DMA1_Stream5, 5, DMA_Channel_4, DMA1_Stream5_IRQn,
+		"USART2"
+	},
+	[USART_PORT_3] = {
+		USART3, GPIOB, GPIO_Pin_10, GPIO_Pin_11, GPIO_PinSource10, GPIO_PinSource11, GPIO_AF_USART3,
+		RCC_AHB1Periph_GPIOB, RCC_APB1Periph_USART3, false, USART3_IRQn, 6,
+		DMA1, DMA1_Stream3, 3, DMA_Channel_4, DMA1_Stream3_IRQn, DMA1_Stream1, 1, DMA_Channel_4, DMA1_Stream1_IRQn,
+		"USART3"
+	},
+	[USART_PORT_6] = {
+		USART6, GPIOC, GPIO_Pin_6,  GPIO_Pin_7,  GPIO_PinSource6,  GPIO_PinSource7,  GPIO_AF_USART6,
+		RCC_AHB1Periph_GPIOC, RCC_APB2Periph_USART6, true,  USART6_IRQn, 5,
+		DMA2, DMA2_Stream6, 6, DMA_Channel_5, DMA2_Stream6_IRQn, DMA2_Stream1, 1, DMA_Channel_5, DMA2_Stream1_IRQn,
+		"USART6"
+	},
+};
 
-int usart6_rb_in  = 0; //! Index do Ring-Buffer para recebimento na USART2.
-int usart6_rb_out = 0; //! Index para leitura do Ring-Buffer da USART2.
+USARTPort usart_ports[USART_PORT_COUNT]; //! Estado de cada porta.
 
-bool usart2_available_flag = 0;	//! Flag de recebimento de USART2.
-bool usart6_available_flag = 0;	//! Flag de recebimento de USART6.
+/** Porta correspondente a cada USART_SLOT. */
+static USARTPort* const usart_slots[8] = {
+	[USART_SLOT(USART1_BASE)] = &usart_ports[USART_PORT_1],
+	[USART_SLOT(USART2_BASE)] = &usart_ports[USART_PORT_2],
+	[USART_SLOT(USART3_BASE)] = &usart_ports[USART_PORT_3],
+	[USART_SLOT(USART6_BASE)] = &usart_ports[USART_PORT_6],
+};
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
-/* Exported functions definitions --------------------------------------------*/
 
-/** \brief Inicializa a USART6 com o Baurate desejado em modo 8-N-1.
-  *	Instala USART2 nos pinos PA6 e PA7 (TX e RX, respectivamente) - pinos 1 e 2
-  *	do conector UEXT (10 vias).
-  * Tratador de interrupções para recebimento já é instalado automaticamente.
+/** \brief Retorna o estado da USART em tempo constante, ou 0 caso ela não seja suportada
+  * ou ainda não tenha sido inicializada.
+  */
+static inline USARTPort* prv_port(USART_TypeDef* USARTx) {
+	USARTPort* port = usart_slots[USART_SLOT(USARTx)];
+	// UART4/5 colidem com outros índices: confirma o periférico
+	return (port && port->ready && port->desc->usart == USARTx) ? port : 0;
+}
+
+/** \brief Retorna o estado de envio da USART, ou 0 caso ela não esteja disponível. */
+static inline USARTTxEngine* prv_tx_engine(USART_TypeDef* USARTx) {
+	USARTPort* port = prv_port(USARTx);
+	return port ? &port->tx : 0;
+}
+
+/** \brief Liga o clock do controlador, desliga o stream, limpa seus flags e habilita sua interrupção.
   *
-  * @param  baudrate a ser inicializado.
-  * @retval None
+  * @param dma 		Descritor a preencher.
+  * @param DMAx 	Controlador de DMA (DMA1 ou DMA2).
+  * @param stream 	Stream de DMA.
+  * @param streamNumber Número (0 a 7) do stream.
+  * @param irq 		Canal de interrupção do stream.
+  * @param priority Prioridade (preempção) da interrupção.
   */
-void c_common_usart6_init(int baudrate) {
-	GPIO_InitTypeDef GPIO_InitStruct; // this is for the GPIO pins used as TX and RX
-	USART_InitTypeDef USART_InitStruct; // this is for the USART6 initilization
-	NVIC_InitTypeDef NVIC_InitStructure; // this is used to configure the NVIC (nested vector interrupt controller)
+static void prv_dma_stream_init(DMAStream* dma, DMA_TypeDef* DMAx, DMA_Stream_TypeDef* stream,
+		uint8_t streamNumber, uint8_t irq, uint8_t priority) {
+	const uint8_t shifts[4] = {0, 6, 16, 22};
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	dma->stream 	= stream;
+	dma->isr 		= (streamNumber < 4) ? &DMAx->LISR  : &DMAx->HISR;
+	dma->ifcr 		= (streamNumber < 4) ? &DMAx->LIFCR : &DMAx->HIFCR;
+	dma->flagShift 	= shifts[streamNumber & 0x03];
+
+	RCC_AHB1PeriphClockCmd((DMAx == DMA1) ? RCC_AHB1Periph_DMA1 : RCC_AHB1Periph_DMA2, ENABLE);
+
+	// stream desligado e sem flags pendentes antes de ser configurado
+	stream->CR &= ~DMA_SxCR_EN;
+	while(stream->CR & DMA_SxCR_EN);
+	*dma->ifcr = DMA_FLAG_ALL << dma->flagShift;
+
+	NVIC_InitStructure.NVIC_IRQChannel = irq;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = priority;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/** \brief Lê e limpa os flags pendentes de um stream.
+  * @retval Flags do stream, alinhados em 0 (\em DMA_FLAG_x).
+  */
+static inline uint32_t prv_dma_flags(DMAStream* dma) {
+	uint32_t flags = (*dma->isr >> dma->flagShift) & DMA_FLAG_ALL;
+	*dma->ifcr = flags << dma->flagShift;
+	return flags;
+}
 
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART6, ENABLE);
+/** \brief Configura o stream de DMA de envio de uma USART.
+  *
+  * @param tx 		Estado de envio a inicializar.
+  * @param desc 	Descrição do hardware da USART.
+  */
+static void prv_tx_init(USARTTxEngine* tx, const USARTDescriptor* desc) {
+	DMA_Stream_TypeDef* stream = desc->txStream;
 
-	/* enable the peripheral clock for the pins used by
-	* USART6, PB6 for TX and PB7 for RX
-	*/
-	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOC, ENABLE);
+	tx->fill 	  = 0;
+	tx->active 	  = 0;
+	tx->queued[0] = false;
+	tx->queued[1] = false;
+	tx->copying[0] = 0;
+	tx->copying[1] = 0;
+	tx->head 	  = 0;
+	tx->tail 	  = 0;
+	tx->busy 	  = false;
+	tx->usart 	  = desc->usart;
+	tx->stats 	  = (USARTTxStats){0};
 
-	GPIO_InitStruct.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7; // Pins 6 (TX) and 7 (RX) are used
-	GPIO_InitStruct.GPIO_Mode = GPIO_Mode_AF;       // the pins are configured as alternate function so the USART peripheral has access to them
-	GPIO_InitStruct.GPIO_Speed = GPIO_Speed_50MHz;    // this defines the IO speed and has nothing to do with the baudrate!
-	GPIO_InitStruct.GPIO_OType = GPIO_OType_PP;      // this defines the output type as push pull mode (as opposed to open drain)
-	GPIO_InitStruct.GPIO_PuPd = GPIO_PuPd_UP;      // this activates the pullup resistors on the IO pins
-	GPIO_Init(GPIOC, &GPIO_InitStruct);          // now all the values are passed to the GPIO_Init() function which sets the GPIO registers
+	// criado já liberado: esvazia-o antes do primeiro uso
+	if(!tx->drained)
+		vSemaphoreCreateBinary(tx->drained);
+	xSemaphoreTake(tx->drained, 0);
 
-	GPIO_PinAFConfig(GPIOC, GPIO_PinSource6, GPIO_AF_USART6); //
-	GPIO_PinAFConfig(GPIOC, GPIO_PinSource7, GPIO_AF_USART6);
+	prv_dma_stream_init(&tx->dma, desc->dma, stream, desc->txStreamNumber, desc->txIrq, desc->priority);
 
-	USART_InitStruct.USART_BaudRate = baudrate;        // the baudrate is set to the value we passed into this init function
-	USART_InitStruct.USART_WordLength = USART_WordLength_8b;// we want the data frame size to be 8 bits (standard)
-	USART_InitStruct.USART_StopBits = USART_StopBits_1;    // we want 1 stop bit (standard)
-	USART_InitStruct.USART_Parity = USART_Parity_No;    // we don't want a parity bit (standard)
-	USART_InitStruct.USART_HardwareFlowControl = USART_HardwareFlowControl_None; // we don't want flow control (standard)
-	USART_InitStruct.USART_Mode = USART_Mode_Tx | USART_Mode_Rx; // we want to enable the transmitter and the receiver
-	USART_Init(USART6, &USART_InitStruct);          // again all the properties are passed to the USART_Init function which takes care of all the bit setting
+	// memória -> periférico, incremento apenas na memória, bytes, interrupções de fim e de erro
+	stream->CR  = desc->txChannel | DMA_Priority_Medium | DMA_DIR_MemoryToPeripheral | DMA_MemoryInc_Enable
+				| DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+	stream->FCR = DMA_FIFOMode_Disable;
+	stream->PAR = (uint32_t)&desc->usart->DR;
 
-	USART_ITConfig(USART6, USART_IT_RXNE, ENABLE);       // enable the USART6 receive interrupt
+	USART_DMACmd(desc->usart, USART_DMAReq_Tx, ENABLE);
+}
+
+/** \brief Conclusão de um buffer de envio: ele pode voltar a ser preenchido. */
+static void prv_tx_release(void *context) {
+	*(volatile bool *)context = false;
+}
 
-	NVIC_InitStructure.NVIC_IRQChannel = USART6_IRQn;     // we want to configure the USART6 interrupts
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;// this sets the priority group of the USART6 interrupts
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;     // this sets the subpriority inside the group
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;       // the USART6 interrupts are globally enabled
-	NVIC_Init(&NVIC_InitStructure);               // the properties are passed to the NVIC_Init function which takes care of the low level stuff
+/** \brief Enfileira o buffer em preenchimento como um segmento e passa a preencher o outro.
+  * Deve ser chamada com as interrupções desabilitadas, com espaço na fila e \b fill > 0.
+  */
+static void prv_tx_seal(USARTTxEngine* tx) {
+	uint8_t active = tx->active;
 
-	// finally this enables the complete USART6 peripheral
-	USART_Cmd(USART6, ENABLE);
+	tx->queue[tx->head & (USART_TX_QUEUE_SIZE - 1)] =
+			(USARTTxSegment){ tx->buffer[active], tx->fill, prv_tx_release, (void *)&tx->queued[active] };
+	tx->head++;
+	tx->queued[active] = true;
+	tx->active = active ^ 1;
+	tx->fill   = 0;
 }
 
-/** \brief Inicializa a USART2 com o Baurate desejado em modo 8-N-1.
- * 	Instala USART2 nos pinos PA2 e PA3 (TX e RX, respectivamente) - pinos D1 e D0
- * 	do layout do Arduino.
-  * Tratador de interrupções para recebimento já é instalado automaticamente.
+/** \brief Entrega o primeiro segmento da fila ao DMA.
+  * Deve ser chamada com as interrupções desabilitadas, com o DMA livre e a fila não vazia.
+  */
+static void prv_tx_start(USARTTxEngine* tx) {
+	const USARTTxSegment* segment = &tx->queue[tx->tail & (USART_TX_QUEUE_SIZE - 1)];
+
+	tx->busy = true;
+	tx->dma.stream->M0AR = (uint32_t)segment->data;
+	tx->dma.stream->NDTR = segment->length;
+
+	tx->stats.bytes += segment->length;
+	tx->stats.transfers++;
+
+	// TC é limpo aqui para que c_common_usart_flush() só o veja após o último byte desta transferência
+	tx->usart->SR = (uint16_t)~USART_SR_TC;
+	tx->dma.stream->CR |= DMA_SxCR_EN;
+}
+
+/** \brief Informa se um segmento ainda está sendo copiado por c_common_usart_write() (só os buffers de envio). */
+static bool prv_tx_copying(const USARTTxEngine* tx, const USARTTxSegment* segment) {
+	return (segment->data == tx->buffer[0] && tx->copying[0]) || (segment->data == tx->buffer[1] && tx->copying[1]);
+}
+
+/** \brief Dispara o envio caso o DMA esteja livre, fechando o buffer em preenchimento se a fila estiver vazia.
+  * Um buffer de envio fechado durante uma cópia só vai ao DMA quando ela termina (a escrita chama
+  * esta função de novo). Deve ser chamada com as interrupções desabilitadas.
+  */
+static void prv_tx_kick(USARTTxEngine* tx) {
+	if(tx->busy)
+		return;
+	if(tx->head == tx->tail && tx->fill)
+		prv_tx_seal(tx);
+	if(tx->head != tx->tail && !prv_tx_copying(tx, &tx->queue[tx->tail & (USART_TX_QUEUE_SIZE - 1)]))
+		prv_tx_start(tx);
+}
+
+/** \brief Reserva espaço no buffer em preenchimento para uma cópia, feita depois com as interrupções
+  * habilitadas; até prv_tx_publish(), o buffer não vai ao DMA.
+  *
+  * @param tx 		Estado de envio.
+  * @param length 	Bytes pedidos; na volta, bytes reservados (o excesso é contabilizado como overrun).
+  * @param active 	Buffer reservado, a passar para prv_tx_publish().
+  * @retval Destino da cópia.
+  */
+static uint8_t* prv_tx_reserve(USARTTxEngine* tx, int* length, uint8_t* active) {
+	TX_ENTER_CRITICAL();
+
+	uint8_t index = tx->active;
+	int room = tx->queued[index] ? 0 : USART_TX_BUFFER_SIZE - tx->fill;
+	int accepted = (*length < room) ? *length : room;
+	if(accepted < *length) {
+		tx->stats.overrun += *length - accepted;
+		tx->stats.backpressure++;
+	}
+
+	uint8_t *dst = &tx->buffer[index][tx->fill];
+	tx->fill += accepted;
+	if(tx->fill > tx->stats.peak)
+		tx->stats.peak = tx->fill;
+	tx->copying[index]++;
+
+	TX_EXIT_CRITICAL();
+
+	*length = accepted;
+	*active = index;
+	return dst;
+}
+
+/** \brief Conclui uma cópia reservada com prv_tx_reserve() e dispara o envio, se o DMA estiver livre. */
+static void prv_tx_publish(USARTTxEngine* tx, uint8_t active) {
+	TX_ENTER_CRITICAL();
+	tx->copying[active]--;
+	prv_tx_kick(tx);
+	TX_EXIT_CRITICAL();
+}
+
+/** \brief Tratamento comum às interrupções dos streams de envio. */
+static void prv_tx_irq(USARTTxEngine* tx) {
+	PERF_PROBE_BEGIN();
+	uint32_t flags = prv_dma_flags(&tx->dma);
+
+	if(flags & DMA_FLAG_TEIF)
+		tx->stats.errors++;
+
+	if(flags & (DMA_FLAG_TCIF | DMA_FLAG_TEIF)) {
+		PERF_PROBE_FRAME(tx->irqProbe);
+		USARTTxSegment segment = tx->queue[tx->tail & (USART_TX_QUEUE_SIZE - 1)];
+		tx->tail++;
+		tx->busy = false;
+		if(segment.done)
+			segment.done(segment.context);
+		prv_tx_kick(tx);
+	}
+	PERF_PROBE_END(tx->irqProbe, 0);
+}
+
+/** \brief Informa se tudo o que foi enfileirado já saiu pelo pino (fila vazia e TC). Sem isso, e com
+  * \b arm, liga TCIE para que o tratador da USART avise o fim (ver prv_tx_drained_irq()).
+  */
+static bool prv_tx_drained(USARTTxEngine* tx, bool arm) {
+	TX_ENTER_CRITICAL();
+	bool drained = !tx->busy && tx->head == tx->tail && !tx->fill && (tx->usart->SR & USART_SR_TC);
+	if(!drained && arm)
+		tx->usart->CR1 |= USART_CR1_TCIE;
+	TX_EXIT_CRITICAL();
+
+	return drained;
+}
+
+/** \brief TC com TCIE ligado: desliga TCIE e acorda a task em c_common_usart_flush(), que confere a fila.
+  * TC não é limpo aqui (é limpo por prv_tx_start()); TCIE desligado evita novas interrupções.
+  */
+static void prv_tx_drained_irq(USARTTxEngine* tx) {
+	portBASE_TYPE woken = pdFALSE;
+	USART_TypeDef* USARTx = tx->usart;
+
+	if(!USARTx || !(USARTx->CR1 & USART_CR1_TCIE) || !(USARTx->SR & USART_SR_TC))
+		return;
+
+	USARTx->CR1 &= ~USART_CR1_TCIE;
+	xSemaphoreGiveFromISR(tx->drained, &woken);
+	portEND_SWITCHING_ISR(woken);
+}
+
+/** \brief Retorna o estado de recebimento da USART, ou 0 caso ela não esteja disponível. */
+static inline USARTRxEngine* prv_rx_engine(USART_TypeDef* USARTx) {
+	USARTPort* port = prv_port(USARTx);
+	return port ? &port->rx : 0;
+}
+
+/** \brief Retorna o Ring-Buffer de recebimento da USART, ou 0 caso ela não seja suportada. */
+static RingBuffer* prv_rx_buffer(USART_TypeDef* USARTx) {
+	USARTRxEngine* rx = prv_rx_engine(USARTx);
+	return rx ? &rx->ring : 0;
+}
+
+/** \brief Prepara o estado de recebimento de uma USART e o stream de DMA associado (ainda desligado).
+  * O stream usa a mesma prioridade da USART, de forma que os tratadores não se interrompem.
+  *
+  * @param rx 		Estado de recebimento a inicializar.
+  * @param desc 	Descrição do hardware da USART.
+  */
+static void prv_rx_init(USARTRxEngine* rx, const USARTDescriptor* desc) {
+	c_common_ringbuffer_init(&rx->ring, rx->buffer, USART_RX_BUFFER_SIZE);
+	rx->mode 	= USART_RX_MODE_IRQ;
+	rx->usart 	= desc->usart;
+	rx->channel = desc->rxChannel;
+	rx->dmaPos 	= 0;
+	rx->frames 	= 0;
+	rx->waiting = 0;
+	rx->terminated = false;
+	rx->terminator = USART_NO_TERMINATOR;
+	rx->stats 	= (USARTRxStats){0};
+
+	// criado já liberado: esvazia-o antes do primeiro uso
+	if(!rx->signal)
+		vSemaphoreCreateBinary(rx->signal);
+	xSemaphoreTake(rx->signal, 0);
+
+	prv_dma_stream_init(&rx->dma, desc->dma, desc->rxStream, desc->rxStreamNumber, desc->rxIrq, desc->priority);
+}
+
+/** \brief Repassa ao Ring-Buffer os bytes escritos pelo DMA circular desde a última chamada.
+  * Chamada pelos tratadores da USART (IDLE) e do stream (metade e fim do buffer), que têm a
+  * mesma prioridade e portanto não se interrompem.
+  */
+static void prv_rx_dma_update(USARTRxEngine* rx) {
+	uint32_t pos = (USART_RX_BUFFER_SIZE - rx->dma.stream->NDTR) & (USART_RX_BUFFER_SIZE - 1);
+	uint32_t n = (pos - rx->dmaPos) & (USART_RX_BUFFER_SIZE - 1);
+
+	if(rx->waiting && rx->terminator != USART_NO_TERMINATOR) {
+		for(uint32_t i = 0; i < n; i++)
+			if(rx->buffer[(rx->dmaPos + i) & (USART_RX_BUFFER_SIZE - 1)] == (uint8_t)rx->terminator)
+				rx->terminated = true;
+	}
+
+	rx->dmaPos = pos;
+	if(n)
+		c_common_ringbuffer_produce(&rx->ring, n);
+}
+
+/** \brief Acorda a task leitora, caso ela esteja aguardando e a condição da leitura tenha sido atingida.
+  * Chamada pelos tratadores de interrupção após repassarem bytes ao Ring-Buffer. Leituras maiores que
+  * o buffer nunca seriam atendidas de uma vez: a task é acordada também com o buffer pela metade, para
+  * esvaziá-lo antes que transborde.
+  */
+static void prv_rx_notify(USARTRxEngine* rx) {
+	portBASE_TYPE woken = pdFALSE;
+	uint32_t count;
+
+	if(!rx->waiting)
+		return;
+	count = c_common_ringbuffer_count(&rx->ring);
+	if(!rx->terminated && count < rx->waiting && count < USART_RX_WAKE_LEVEL)
+		return;
+
+	rx->waiting = 0;
+	rx->stamp = c_common_perf_cycles();
+	xSemaphoreGiveFromISR(rx->signal, &woken);
+	rx->stats.wakeups++;
+	if(woken)
+		rx->stats.switches++;
+	portEND_SWITCHING_ISR(woken);
+}
+
+/** \brief Tratamento comum às interrupções das USARTs. */
+static void prv_rx_irq(USARTRxEngine* rx) {
+	PERF_PROBE_BEGIN();
+	USART_TypeDef* USARTx = rx->usart;
+	uint16_t status = USARTx->SR;
+	uint32_t head = rx->ring.head;
+
+	if(rx->mode == USART_RX_MODE_DMA_IDLE) {
+		if(status & USART_SR_IDLE) {
+			// a leitura de SR seguida de DR limpa IDLE (e ORE)
+			(void)USARTx->DR;
+			if(status & USART_SR_ORE)
+				rx->ring.dropped++;
+			prv_rx_dma_update(rx);
+			rx->frames++;
+			PERF_PROBE_FRAME(rx->irqProbe);
+			prv_rx_notify(rx);
+		}
+	}
+	else if(status & (USART_SR_RXNE | USART_SR_ORE)) {
+		// a leitura de SR seguida de DR limpa RXNE e ORE. ORE sem RXNE: o byte seguinte chegou entre as
+		// leituras de SR e DR da interrupção anterior, e se perdeu; DR ainda contém o byte já guardado
+		uint8_t byte = USARTx->DR;
+		if(status & USART_SR_ORE)
+			rx->ring.dropped++;
+		if(status & USART_SR_RXNE) {
+			c_common_ringbuffer_put(&rx->ring, byte);
+			if(byte == rx->terminator)
+				rx->terminated = true;
+			prv_rx_notify(rx);
+		}
+	}
+	PERF_PROBE_END(rx->irqProbe, rx->ring.head - head);
+}
+
+/** \brief Tratamento comum às interrupções dos streams de recebimento. */
+static void prv_rx_dma_irq(USARTRxEngine* rx) {
+	PERF_PROBE_BEGIN();
+	uint32_t head = rx->ring.head;
+
+	if(prv_dma_flags(&rx->dma) & (DMA_FLAG_HTIF | DMA_FLAG_TCIF)) {
+		prv_rx_dma_update(rx);
+		prv_rx_notify(rx);
+	}
+	PERF_PROBE_END(rx->irqProbe, rx->ring.head - head);
+}
+
+/** \brief Frequência do barramento (APB1 ou APB2) que alimenta a USART. */
+static uint32_t prv_pclk(const USARTDescriptor* desc) {
+	RCC_ClocksTypeDef clocks;
+	RCC_GetClocksFreq(&clocks);
+	return desc->apb2 ? clocks.PCLK2_Frequency : clocks.PCLK1_Frequency;
+}
+
+/** \brief Calcula o divisor de uma USART para o baudrate pedido.
+  *
+  * Com oversampling de 16, baud = pclk / BRR, com BRR = mantissa:fração de 4 bits. Com oversampling de 8
+  * (OVER8), baud = pclk / div, com BRR = (div & ~7) << 1 | (div & 7). Nos dois casos o divisor é
+  * round(pclk / baud): OVER8 não ganha resolução, apenas dobra o baudrate máximo (divisor mínimo 8, e
+  * não 16). Por isso OVER8 só é usado quando necessário, já que a amostragem por 16 tolera mais ruído.
+  *
+  * @param pclk 	Clock da USART.
+  * @param baudrate Baudrate pedido.
+  * @param brr 		Valor de BRR calculado.
+  * @param over8 	Se OVER8 deve ser ligado.
+  * @retval Baudrate efetivo, ou 0 caso o pedido esteja fora do alcance ou com erro acima de USART_BAUD_MAX_ERROR.
+  */
+static uint32_t prv_baud_divisor(uint32_t pclk, uint32_t baudrate, uint16_t* brr, bool* over8) {
+	if(!baudrate)
+		return 0;
+
+	uint32_t div = (pclk + baudrate/2) / baudrate;
+	if(div < 8 || div > 0xFFFF)
+		return 0;
+
+	*over8 = (div < 16);
+	*brr   = *over8 ? (uint16_t)(((div & ~7u) << 1) | (div & 7u)) : (uint16_t)div;
+
+	uint32_t actual = pclk / div;
+	uint32_t error  = (actual > baudrate) ? actual - baudrate : baudrate - actual;
+	if((uint64_t)error * 1000 > (uint64_t)baudrate * USART_BAUD_MAX_ERROR)
+		return 0;
+
+	return actual;
+}
+
+/** \brief Programa o divisor (e OVER8) de uma porta. A USART é desligada durante a troca.
+  * @retval Baudrate efetivo, ou 0 caso o pedido seja inválido (nada é alterado).
+  */
+static uint32_t prv_apply_baudrate(USARTPort* port, uint32_t baudrate) {
+	USART_TypeDef* USARTx = port->desc->usart;
+	uint16_t brr;
+	bool over8;
+
+	uint32_t actual = prv_baud_divisor(prv_pclk(port->desc), baudrate, &brr, &over8);
+	if(!actual)
+		return 0;
+
+	// OVER8 só pode ser alterado com UE desligado
+	USARTx->CR1 &= ~USART_CR1_UE;
+	if(over8)
+		USARTx->CR1 |= USART_CR1_OVER8;
+	else
+		USARTx->CR1 &= ~USART_CR1_OVER8;
+	USARTx->BRR  = brr;
+	USARTx->CR1 |= USART_CR1_UE;
+
+	port->baudrate = actual;
+	return actual;
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Inicializa uma USART com o Baudrate desejado em modo 8-N-1.
+  * Os pinos, clocks e streams de DMA são os da tabela usart_descriptors (ver \ref Common_Components_UART).
+  * O envio por DMA e o tratador de interrupções para recebimento (modo \b USART_RX_MODE_IRQ) já são
+  * instalados automaticamente. O divisor é o de c_common_usart_set_baudrate(), inclusive para as
+  * velocidades que exigem oversampling de 8.
   *
+  * @param  USARTx USART1, USART2, USART3 ou USART6.
   * @param  baudrate a ser inicializado.
   * @retval None
   */
-void c_common_usart2_init(int baudrate) {
+void c_common_usart_init(USART_TypeDef* USARTx, int baudrate) {
 	GPIO_InitTypeDef GPIO_InitStructure;
 	USART_InitTypeDef USART_InitStructure;
 	NVIC_InitTypeDef NVIC_InitStructure;
 
-	/* enable peripheral clock for USART2 */
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART2, ENABLE);
+	USARTPort* port = usart_slots[USART_SLOT(USARTx)];
+	const USARTDescriptor* desc = port ? &usart_descriptors[port - usart_ports] : 0;
+	if(!desc || desc->usart != USARTx)
+		return;
+
+	port->ready = false;
+	port->desc  = desc;
 
-	/* GPIOA clock enable */
-	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOA, ENABLE);
+	/* enable peripheral clocks for the USART and its pins */
+	if(desc->apb2)
+		RCC_APB2PeriphClockCmd(desc->clock, ENABLE);
+	else
+		RCC_APB1PeriphClockCmd(desc->clock, ENABLE);
+	RCC_AHB1PeriphClockCmd(desc->gpioClock, ENABLE);
 
-	/* GPIOA Configuration:  USART2 TX on PA2, RX on PA3 */
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_2 | GPIO_Pin_3;
-	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;
-	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;
-	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP ;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
+	GPIO_InitStructure.GPIO_Pin = desc->txPin | desc->rxPin;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;       // the pins are configured as alternate function so the USART peripheral has access to them
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;  // this defines the IO speed and has nothing to do with the baudrate!
+	GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;     // this defines the output type as push pull mode (as opposed to open drain)
+	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP;       // this activates the pullup resistors on the IO pins
+	GPIO_Init(desc->port, &GPIO_InitStructure);
 
-	/* Connect USART2 pins to AF2 */
-	// TX = PA2
-	GPIO_PinAFConfig(GPIOA, GPIO_PinSource2, GPIO_AF_USART2);
-	GPIO_PinAFConfig(GPIOA, GPIO_PinSource3, GPIO_AF_USART2);
+	GPIO_PinAFConfig(desc->port, desc->txSource, desc->af);
+	GPIO_PinAFConfig(desc->port, desc->rxSource, desc->af);
 
 	USART_InitStructure.USART_BaudRate = baudrate;
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
@@ -140,122 +710,578 @@ void c_common_usart2_init(int baudrate) {
 	USART_InitStructure.USART_Parity = USART_Parity_No;
 	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
 	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
-	USART_Init(USART2, &USART_InitStructure);
+	USART_Init(USARTx, &USART_InitStructure);
 
-	USART_ITConfig(USART2, USART_IT_RXNE, ENABLE); // enable the USART1 receive interrupt
+	USART_ITConfig(USARTx, USART_IT_RXNE, ENABLE); // enable the receive interrupt
 
-	NVIC_InitStructure.NVIC_IRQChannel = USART2_IRQn;		 // we want to configure the USART1 interrupts
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;// this sets the priority group of the USART1 interrupts
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;		 // this sets the subpriority inside the group
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;			 // the USART1 interrupts are globally enabled
-	NVIC_Init(&NVIC_InitStructure);							 // the properties are passed to the NVIC_Init function which takes care of the low level stuff
+	prv_tx_init(&port->tx, desc);
+	prv_rx_init(&port->rx, desc);
+	c_common_perf_register(&port->tx.irqProbe, 	 desc->name, "tx irq");
+	c_common_perf_register(&port->tx.writeProbe, desc->name, "write");
+	c_common_perf_register(&port->tx.flushProbe, desc->name, "flush");
+	c_common_perf_register(&port->rx.irqProbe, 	 desc->name, "rx irq");
+	port->ready = true;
 
-	USART_Cmd(USART2, ENABLE); // enable USART2
+	NVIC_InitStructure.NVIC_IRQChannel = desc->irq;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = desc->priority;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	USART_Cmd(USARTx, ENABLE);
+	prv_apply_baudrate(port, baudrate);
+}
+
+/** \brief Inicializa a USART6 com o Baurate desejado em modo 8-N-1.
+  *	Instala USART6 nos pinos PC6 e PC7 (TX e RX, respectivamente) - pinos 1 e 2
+  *	do conector UEXT (10 vias). Equivalente a c_common_usart_init(USART6, baudrate).
+  *
+  * @param  baudrate a ser inicializado.
+  * @retval None
+  */
+void c_common_usart6_init(int baudrate) {
+	c_common_usart_init(USART6, baudrate);
+}
+
+/** \brief Inicializa a USART2 com o Baurate desejado em modo 8-N-1.
+ * 	Instala USART2 nos pinos PA2 e PA3 (TX e RX, respectivamente) - pinos D1 e D0
+ * 	do layout do Arduino. Equivalente a c_common_usart_init(USART2, baudrate).
+  *
+  * @param  baudrate a ser inicializado.
+  * @retval None
+  */
+void c_common_usart2_init(int baudrate) {
+	c_common_usart_init(USART2, baudrate);
+}
+
+/** \brief Verifica se um baudrate pode ser gerado por uma USART, sem alterá-la.
+  *
+  * @param  USARTx USART a verificar (já inicializada).
+  * @param  baudrate Baudrate pedido.
+  * @retval Baudrate efetivo que seria programado, ou 0 caso esteja fora do alcance ou com erro acima de 2%.
+  */
+uint32_t c_common_usart_check_baudrate(USART_TypeDef* USARTx, uint32_t baudrate) {
+	USARTPort* port = prv_port(USARTx);
+	uint16_t brr;
+	bool over8;
+
+	return port ? prv_baud_divisor(prv_pclk(port->desc), baudrate, &brr, &over8) : 0;
+}
+
+/** \brief Troca o baudrate de uma USART em funcionamento.
+  *
+  * Aguarda o fim do envio em andamento (c_common_usart_flush(), por no máximo USART_FLUSH_TIMEOUT_MS),
+  * desliga a USART, programa o novo divisor
+  * (com OVER8 caso o divisor fique abaixo de 16) e a religa. O Ring-Buffer de recebimento e o modo de
+  * recebimento são mantidos. Com APB1 a 42 MHz (USART2 e 3) o máximo é 5,25 Mbit/s; com APB2 a 84 MHz
+  * (USART1 e 6), 10,5 Mbit/s, limitados na prática pelo conversor do outro lado.
+  *
+  * Bytes enfileirados por outras tasks durante a troca podem sair em qualquer uma das duas velocidades.
+  *
+  * @param  USARTx USART a configurar (já inicializada).
+  * @param  baudrate Baudrate pedido.
+  * @retval Baudrate efetivo, ou 0 caso o pedido seja inválido ou o envio em andamento não termine (a USART
+  * não é alterada).
+  */
+uint32_t c_common_usart_set_baudrate(USART_TypeDef* USARTx, uint32_t baudrate) {
+	USARTPort* port = prv_port(USARTx);
+	if(!port || !c_common_usart_check_baudrate(USARTx, baudrate))
+		return 0;
+
+	if(!c_common_usart_flush(USARTx, USART_FLUSH_TIMEOUT_MS / portTICK_RATE_MS))
+		return 0;
+	return prv_apply_baudrate(port, baudrate);
+}
+
+/** \brief Retorna o baudrate efetivo de uma USART (obtido do divisor programado).
+  *
+  * @param  USARTx USART a verificar.
+  * @retval Baudrate, ou 0 caso a USART não tenha sido inicializada.
+  */
+uint32_t c_common_usart_get_baudrate(USART_TypeDef* USARTx) {
+	USARTPort* port = prv_port(USARTx);
+	return port ? port->baudrate : 0;
+}
+
+/** \brief Seleciona o modo de recebimento da USART.
+  *
+  * - \b USART_RX_MODE_IRQ: uma interrupção por byte (padrão após a inicialização). Adequado para portas
+  * 	de baixa taxa.
+  * - \b USART_RX_MODE_DMA_IDLE: o DMA escreve continuamente no Ring-Buffer (modo circular), e a
+  * 	interrupção de linha ociosa (IDLE) da USART publica os bytes recebidos de uma só vez ao fim de
+  * 	cada pacote. Interrupções de metade e de fim do buffer garantem que pacotes maiores que o buffer
+  * 	também sejam repassados. Nesse modo, bytes sobrescritos antes de serem lidos são contados em
+  * 	c_common_usart_dropped().
+  *
+  * Os dados ainda não lidos são descartados na troca de modo.
+  *
+  * @param  USARTx USART a configurar (já inicializada).
+  * @param  mode Modo desejado.
+  */
+void c_common_usart_set_rx_mode(USART_TypeDef* USARTx, USARTRxMode mode) {
+	USARTRxEngine* rx = prv_rx_engine(USARTx);
+	if(!rx)
+		return;
+
+	DMA_Stream_TypeDef* stream = rx->dma.stream;
+
+	// para tudo antes de trocar de modo
+	USART_ITConfig(USARTx, USART_IT_RXNE, DISABLE);
+	USART_ITConfig(USARTx, USART_IT_IDLE, DISABLE);
+	USART_DMACmd(USARTx, USART_DMAReq_Rx, DISABLE);
+	stream->CR &= ~DMA_SxCR_EN;
+	while(stream->CR & DMA_SxCR_EN);
+	prv_dma_flags(&rx->dma);
+
+	c_common_ringbuffer_init(&rx->ring, rx->buffer, USART_RX_BUFFER_SIZE);
+	rx->dmaPos = 0;
+	rx->mode = mode;
+
+	if(mode == USART_RX_MODE_DMA_IDLE) {
+		// periférico -> memória, circular sobre o Ring-Buffer, interrupções de metade e de fim
+		stream->CR   = rx->channel | DMA_Priority_High | DMA_DIR_PeripheralToMemory | DMA_MemoryInc_Enable
+					 | DMA_Mode_Circular | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+		stream->FCR  = DMA_FIFOMode_Disable;
+		stream->PAR  = (uint32_t)&USARTx->DR;
+		stream->M0AR = (uint32_t)rx->buffer;
+		stream->NDTR = USART_RX_BUFFER_SIZE;
+		stream->CR  |= DMA_SxCR_EN;
+
+		USART_DMACmd(USARTx, USART_DMAReq_Rx, ENABLE);
+		USART_ITConfig(USARTx, USART_IT_IDLE, ENABLE);
+	}
+	else {
+		USART_ITConfig(USARTx, USART_IT_RXNE, ENABLE);
+	}
+}
+
+/** \brief Retorna quantos quadros (rajadas de bytes seguidas de linha ociosa) já foram recebidos.
+  * Só é atualizado no modo \b USART_RX_MODE_DMA_IDLE.
+  *
+  * @param  USARTx USART a verificar.
+  * @retval Total de quadros recebidos desde a última troca de modo.
+  */
+uint32_t c_common_usart_rx_frames(USART_TypeDef* USARTx) {
+	USARTRxEngine* rx = prv_rx_engine(USARTx);
+	return rx ? rx->frames : 0;
+}
+
+/** \brief Enfileira um bloco de bytes para envio via DMA, sem bloquear.
+  *
+  * Os dados são copiados para o buffer de envio da USART, e a função retorna logo em seguida.
+  * Se não houver espaço para todo o bloco, apenas a parte inicial que couber é aceita; o restante
+  * é descartado e contabilizado em USARTTxStats::overrun.
+  *
+  * Só a reserva do espaço e a publicação da cópia são feitas com as interrupções desabilitadas; a
+  * cópia em si (até USART_TX_BUFFER_SIZE bytes) não atrasa os tratadores das demais portas, dos
+  * servos e da I2C. Enquanto ela não termina, o buffer não é entregue ao DMA.
+  *
+  * @param  USARTx USART usada.
+  * @param  data Bytes a serem enviados.
+  * @param  length Quantidade de bytes.
+  * @retval Quantidade de bytes aceitos.
+  */
+int c_common_usart_write(USART_TypeDef* USARTx, const uint8_t *data, int length) {
+	USARTTxEngine* tx = prv_tx_engine(USARTx);
+	if(!tx || length <= 0)
+		return 0;
+
+	PERF_PROBE_BEGIN();
+	uint8_t active;
+	int accepted = length;
+
+	uint8_t *dst = prv_tx_reserve(tx, &accepted, &active);
+	for(int i=0; i<accepted; i++)
+		dst[i] = data[i];
+	prv_tx_publish(tx, active);
+
+	PERF_PROBE_END(tx->writeProbe, accepted);
+
+	return accepted;
+}
+
+/** \brief Enfileira segmentos para envio por DMA, sem copiá-los (scatter-gather).
+  *
+  * Os segmentos saem em sequência, na ordem dada e depois de tudo que já foi enviado por esta ou pelas
+  * demais funções de envio. Cada um é devolvido ao dono pela sua função \b done, chamada no tratador de
+  * interrupção do stream assim que o DMA termina de lê-lo (o último byte pode ainda estar saindo pelo
+  * pino: ver c_common_usart_flush()). Não bloqueia; o pedido é aceito por inteiro ou recusado.
+  *
+  * \code{.c}
+  * static const uint8_t header[2] = { 0xFF, 0xFF };
+  * USARTTxSegment packet[] = { {header, 2, 0, 0}, {body, n, 0, 0}, {&checksum, 1, body_done, 0} };
+  * c_common_usart_queue(USART6, packet, 3);
+  * \endcode
+  *
+  * @param  USARTx USART usada.
+  * @param  segments Descritores dos segmentos (copiados para a fila; podem ser descartados no retorno).
+  * @param  count Quantidade de segmentos.
+  * @retval true caso todos os segmentos tenham sido enfileirados; false se a fila não tiver espaço para
+  * eles (contabilizado em USARTTxStats::backpressure) ou algum segmento for vazio.
+  */
+bool c_common_usart_queue(USART_TypeDef* USARTx, const USARTTxSegment *segments, int count) {
+	USARTTxEngine* tx = prv_tx_engine(USARTx);
+	if(!tx || count <= 0)
+		return false;
+	for(int i=0; i<count; i++)
+		if(!segments[i].data || !segments[i].length)
+			return false;
+
+	TX_ENTER_CRITICAL();
+
+	// o buffer em preenchimento vai antes, para manter a ordem do que já foi escrito
+	uint32_t needed = count + (tx->fill ? 1 : 0);
+	bool accepted = (USART_TX_QUEUE_SIZE - (tx->head - tx->tail) >= needed);
+
+	if(accepted) {
+		if(tx->fill)
+			prv_tx_seal(tx);
+		for(int i=0; i<count; i++)
+			tx->queue[(tx->head + i) & (USART_TX_QUEUE_SIZE - 1)] = segments[i];
+		tx->head += count;
+		tx->stats.segments += count;
+		prv_tx_kick(tx);
+	}
+	else {
+		tx->stats.backpressure++;
+	}
+
+	TX_EXIT_CRITICAL();
+
+	return accepted;
 }
 
 /** \brief Enviar uma string.
+  * Não bloqueia: ver c_common_usart_write().
   *
   * @param  USARTx USART usada.
   * @retval s String a ser enviada.
   */
 void c_common_usart_puts(USART_TypeDef* USARTx, volatile char *s){
+	int length = 0;
+	while(s[length])
+		length++;
 
-	while(*s){
-		// wait until data register is empty
-		while( !(USARTx->SR & 0x00000040) );
-		USART_SendData(USARTx, *s);
-		*s++;
-	}
+	c_common_usart_write(USARTx, (const uint8_t *)s, length);
 }
 
 /** \brief Envia apenas um \em char pela USART desejada.
+  * Não bloqueia: ver c_common_usart_write().
   *
   * @param  USARTx USART usada.
   * @retval c Caracter a ser enviado.
   */
 void c_common_usart_putchar(USART_TypeDef* USARTx, volatile char c){
-	// wait until data register is empty
-	while( !(USARTx->SR & 0x00000040) );
-	USART_SendData(USARTx, c);
+	uint8_t byte = c;
+	c_common_usart_write(USARTx, &byte, 1);
 }
 
-/** \brief Retorna se existe algum caracter não lido no Ring-Buffer da USART escolhida.
+/** \brief Aguarda, por no máximo \b ticks, até que todos os bytes enfileirados tenham saído pelo pino de TX.
+  * Útil em barramentos half-duplex, nos quais a direção só pode ser trocada após o último bit.
+  *
+  * Com o escalonador em execução, a task dorme no semáforo da porta, liberado pelo tratador da USART
+  * ao ver TC (TCIE fica ligado só durante a espera); a cada aviso, a fila de envio é conferida de novo.
+  * Antes dele, TC é consultado, com o mesmo limite medido em ciclos. Uma task por vez pode aguardar
+  * cada porta. Esperas esgotadas são contadas em USARTTxStats::timeouts.
+  *
+  * @param  USARTx USART usada.
+  * @param  ticks Tempo máximo de espera (portMAX_DELAY: sem limite).
+  * @retval true caso tudo tenha sido enviado; false se o tempo se esgotou (os bytes continuam na fila) ou
+  * a USART não for suportada.
+  */
+bool c_common_usart_flush(USART_TypeDef* USARTx, portTickType ticks) {
+	USARTTxEngine* tx = prv_tx_engine(USARTx);
+	if(!tx)
+		return false;
+
+	PERF_PROBE_BEGIN();
+	bool sleep = tx->drained && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+	portTickType start = xTaskGetTickCount();
+	uint32_t polled = c_common_perf_cycles();
+	uint32_t cycles_per_tick = (SystemCoreClock / 1000) * portTICK_RATE_MS;
+	bool drained;
+
+	while(!(drained = prv_tx_drained(tx, sleep))) {
+		if(sleep) {
+			portTickType elapsed = xTaskGetTickCount() - start;
+			if(ticks != portMAX_DELAY && elapsed >= ticks)
+				break;
+			xSemaphoreTake(tx->drained, (ticks == portMAX_DELAY) ? portMAX_DELAY : ticks - elapsed);
+		}
+		else if(ticks != portMAX_DELAY && (c_common_perf_cycles() - polled) / cycles_per_tick >= ticks)
+			break;
+	}
+
+	if(!drained) {
+		TX_ENTER_CRITICAL();
+		tx->stats.timeouts++;
+		TX_EXIT_CRITICAL();
+	}
+	PERF_PROBE_END(tx->flushProbe, 0);
+	return drained;
+}
+
+/** \brief Retorna os contadores de desempenho do envio da USART.
+  *
+  * @param  USARTx USART usada.
+  * @retval Cópia dos contadores (zerados caso a USART não seja suportada).
+  */
+USARTTxStats c_common_usart_tx_stats(USART_TypeDef* USARTx) {
+	USARTTxEngine* tx = prv_tx_engine(USARTx);
+	USARTTxStats stats = {0};
+
+	if(tx) {
+		TX_ENTER_CRITICAL();
+		stats = tx->stats;
+		TX_EXIT_CRITICAL();
+	}
+	return stats;
+}
+
+/** \brief Retorna quantos bytes ainda cabem no buffer de envio em preenchimento.
+  * Permite a quem envia quadros evitar que eles sejam truncados por c_common_usart_write(). O valor só
+  * pode aumentar até a próxima escrita, já que o tratador de interrupção apenas libera espaço.
+  *
+  * @param  USARTx USART usada.
+  * @retval Bytes livres (0 caso a USART não seja suportada).
+  */
+int c_common_usart_tx_free(USART_TypeDef* USARTx) {
+	USARTTxEngine* tx = prv_tx_engine(USARTx);
+	return (tx && !tx->queued[tx->active]) ? USART_TX_BUFFER_SIZE - tx->fill : 0;
+}
+
+/** \brief Retorna quantos caracteres não lidos existem no Ring-Buffer da USART escolhida.
  *
  * 	@param USARTx USART a verificar.
- * 	@return 1 caso haja um caracter não lido, 0 caso contrário.
+ * 	@return Quantidade de caracteres não lidos (0 caso não haja nenhum).
  */
-bool c_common_usart_available(USART_TypeDef* USARTx) {
-	if(USARTx == USART2)
-		return usart2_available_flag;
-	else if(USARTx == USART6)
-		return usart6_available_flag;
-	else
-		return 0;
+int c_common_usart_available(USART_TypeDef* USARTx) {
+	RingBuffer* rx = prv_rx_buffer(USARTx);
+	return rx ? (int)c_common_ringbuffer_count(rx) : 0;
 }
 
-/** \brief Retorna o caracter recebido e não-lido mais recente do Ring-Buffer.
+/** \brief Retorna o caracter não-lido mais antigo do Ring-Buffer.
  *
  * 	@param USARTx USART a verificar.
- * 	@return Caracter recebido e não-lido mais recente.
+ * 	@return Caracter recebido e não-lido mais antigo, ou 0 caso não haja nenhum.
  */
 unsigned char c_common_usart_read(USART_TypeDef* USARTx) {
-	if(USARTx == USART2) {
-		uint8_t ret = usart2_recv_buffer[usart2_rb_out];
-		if(usart2_rb_out < RECV_BUFFER_SIZE-1) usart2_rb_out++;
-		else	usart2_rb_out = 0;
-		if(usart2_rb_in == usart2_rb_out) usart2_available_flag = false;
-		return ret;
+	RingBuffer* rx = prv_rx_buffer(USARTx);
+	uint8_t ret = 0;
+
+	if(rx)
+		c_common_ringbuffer_get(rx, &ret);
+	return ret;
+}
+
+/** \brief Lê e consome até \b n caracteres do Ring-Buffer de uma só vez.
+ *
+ * 	@param USARTx USART a ler.
+ * 	@param buf Destino, com pelo menos \b n bytes.
+ * 	@param n Quantidade máxima de caracteres.
+ * 	@return Quantidade de caracteres lidos.
+ */
+int c_common_usart_read_block(USART_TypeDef* USARTx, uint8_t *buf, int n) {
+	RingBuffer* rx = prv_rx_buffer(USARTx);
+	return rx ? c_common_ringbuffer_read(rx, buf, n) : 0;
+}
+
+/** \brief Copia até \b n caracteres do Ring-Buffer sem consumi-los.
+ *
+ * 	@param USARTx USART a ler.
+ * 	@param buf Destino, com pelo menos \b n bytes.
+ * 	@param n Quantidade máxima de caracteres.
+ * 	@return Quantidade de caracteres copiados.
+ */
+int c_common_usart_peek(USART_TypeDef* USARTx, uint8_t *buf, int n) {
+	RingBuffer* rx = prv_rx_buffer(USARTx);
+	return rx ? c_common_ringbuffer_peek(rx, buf, n) : 0;
+}
+
+/** \brief Lê até \b n caracteres, bloqueando a task até que eles cheguem ou até o timeout.
+ *
+ * 	A leitura termina ao completar \b n caracteres, ao receber o terminador configurado em
+ * 	c_common_usart_set_rx_terminator() (que é incluído em \b buf), ou após \b ticks ticks do sistema.
+ * 	Enquanto aguarda, a task fica bloqueada em um semáforo, e não consome CPU. Apenas uma task pode
+ * 	ler cada USART. Não deve ser chamada antes de iniciar o escalonador.
+ *
+ * 	\code{.c}
+ * 	uint8_t line[32];
+ * 	c_common_usart_set_rx_terminator(USART2, '\r');
+ * 	int n = c_common_usart_read_timeout(USART2, line, sizeof(line), 1000/portTICK_RATE_MS);
+ * 	\endcode
+ *
+ * 	@param USARTx USART a ler.
+ * 	@param buf Destino, com pelo menos \b n bytes.
+ * 	@param n Quantidade máxima de caracteres.
+ * 	@param ticks Tempo máximo de espera, em ticks (\b portMAX_DELAY para aguardar indefinidamente).
+ * 	@return Quantidade de caracteres lidos (menor que \b n em caso de terminador ou timeout).
+ */
+int c_common_usart_read_timeout(USART_TypeDef* USARTx, uint8_t *buf, int n, portTickType ticks) {
+	USARTRxEngine* rx = prv_rx_engine(USARTx);
+	portTickType start = xTaskGetTickCount();
+	int got = 0;
+
+	if(!rx || !rx->signal || n <= 0)
+		return 0;
+
+	while(got < n) {
+		// consome o que já chegou
+		if(rx->terminator == USART_NO_TERMINATOR) {
+			got += c_common_ringbuffer_read(&rx->ring, buf + got, n - got);
+		}
+		else {
+			bool found = false;
+			while(got < n && !found && c_common_ringbuffer_get(&rx->ring, &buf[got]))
+				found = (buf[got++] == (uint8_t)rx->terminator);
+			if(found)
+				break;
+		}
+		if(got >= n)
+			break;
+
+		portTickType elapsed = xTaskGetTickCount() - start;
+		if(ticks != portMAX_DELAY && elapsed >= ticks)
+			break;
+
+		// arma a espera; bytes que tenham chegado entre a leitura acima e este ponto não geraram aviso
+		rx->terminated = false;
+		rx->waiting = n - got;
+		__DMB();
+		if(c_common_ringbuffer_count(&rx->ring)) {
+			rx->waiting = 0;
+			xSemaphoreTake(rx->signal, 0);
+			continue;
+		}
+
+		rx->stats.blocks++;
+		if(xSemaphoreTake(rx->signal, (ticks == portMAX_DELAY) ? portMAX_DELAY : ticks - elapsed) == pdTRUE) {
+			uint32_t latency = c_common_perf_cycles() - rx->stamp;
+			rx->stats.latencyLast = latency;
+			rx->stats.latencySum += latency;
+			if(latency > rx->stats.latencyMax)
+				rx->stats.latencyMax = latency;
+		}
+		else {
+			// desarma antes de esvaziar o semáforo, para não deixar um aviso atrasado para a próxima leitura
+			rx->waiting = 0;
+			xSemaphoreTake(rx->signal, 0);
+			rx->stats.timeouts++;
+		}
 	}
-	else if(USARTx == USART6) {
-		uint8_t ret = usart6_recv_buffer[usart6_rb_out];
-		if(usart6_rb_out < RECV_BUFFER_SIZE-1) usart6_rb_out++;
-		else	usart6_rb_out = 0;
-		if(usart6_rb_in == usart6_rb_out) usart6_available_flag = false;
-		return ret;
+
+	return got;
+}
+
+/** \brief Configura o byte que encerra as leituras de c_common_usart_read_timeout() (ex.: '\\n').
+ *
+ * 	@param USARTx USART a configurar.
+ * 	@param terminator Byte terminador, ou USART_NO_TERMINATOR.
+ */
+void c_common_usart_set_rx_terminator(USART_TypeDef* USARTx, int terminator) {
+	USARTRxEngine* rx = prv_rx_engine(USARTx);
+	if(rx)
+		rx->terminator = (terminator < 0) ? USART_NO_TERMINATOR : (uint8_t)terminator;
+}
+
+/** \brief Retorna os contadores do recebimento bloqueante da USART.
+ *
+ * 	@param USARTx USART a verificar.
+ * 	@return Cópia dos contadores (zerados caso a USART não seja suportada).
+ */
+USARTRxStats c_common_usart_rx_stats(USART_TypeDef* USARTx) {
+	USARTRxEngine* rx = prv_rx_engine(USARTx);
+	USARTRxStats stats = {0};
+
+	if(rx) {
+		TX_ENTER_CRITICAL();
+		stats = rx->stats;
+		TX_EXIT_CRITICAL();
 	}
-	else return 0;
+	return stats;
+}
+
+/** \brief Retorna quantos caracteres recebidos foram descartados, por buffer cheio ou por overrun.
+ *
+ * 	@param USARTx USART a verificar.
+ * 	@return Total de caracteres descartados desde a inicialização.
+ */
+uint32_t c_common_usart_dropped(USART_TypeDef* USARTx) {
+	RingBuffer* rx = prv_rx_buffer(USARTx);
+	return rx ? rx->dropped : 0;
 }
 
 /* IRQ handlers ------------------------------------------------------------- */
 
-/** \brief Tratador de interrupção para o recebimento de um byte em USART2.
-  * Armazena os bytes lidos no buffer usart2_recv_buffer e seta o flag
-  * usart2_available_flag .
-  *
-  * @param  None
-  * @retval None
+/** \brief Tratador de interrupção de USART1. Ver prv_rx_irq(). */
+void USART1_IRQHandler(void){
+	prv_rx_irq(&usart_ports[USART_PORT_1].rx);
+	prv_tx_drained_irq(&usart_ports[USART_PORT_1].tx);
+}
+
+/** \brief Tratador de interrupção de USART2.
+  * Armazena os bytes lidos no Ring-Buffer, ou, no modo DMA, publica os bytes
+  * do pacote que acaba de terminar.
   */
 void USART2_IRQHandler(void){
-	// check if the USART1 receive interrupt flag was set
-	if( USART_GetITStatus(USART2, USART_IT_RXNE) ){
-		usart2_available_flag = 1;
-		usart2_recv_buffer[usart2_rb_in] = USART_ReceiveData(USART2);
-		if(usart2_rb_in < RECV_BUFFER_SIZE-1) usart2_rb_in++;
-		else	usart2_rb_in = 0;
-
-		USART_ClearFlag(USART2, USART_IT_RXNE);
-		USART_ClearITPendingBit(USART2, USART_IT_RXNE);
-	}
+	prv_rx_irq(&usart_ports[USART_PORT_2].rx);
+	prv_tx_drained_irq(&usart_ports[USART_PORT_2].tx);
 }
 
-/** \brief Tratador de interrupção para o recebimento de um byte em USART6.
-  * Armazena os bytes lidos no buffer usart2_recv_buffer e seta o flag
-  * usart2_available_flag .
-  *
-  * @param  None
-  * @retval None
-  */
+/** \brief Tratador de interrupção de USART3. Ver prv_rx_irq(). */
+void USART3_IRQHandler(void){
+	prv_rx_irq(&usart_ports[USART_PORT_3].rx);
+	prv_tx_drained_irq(&usart_ports[USART_PORT_3].tx);
+}
+
+/** \brief Tratador de interrupção de USART6. Ver prv_rx_irq(). */
 void USART6_IRQHandler(void){
-	// check if the USART1 receive interrupt flag was set
-	if( USART_GetITStatus(USART6, USART_IT_RXNE) ){
-		usart6_available_flag = 1;
-		usart6_recv_buffer[usart6_rb_in] = USART_ReceiveData(USART6);
-		if(usart6_rb_in < RECV_BUFFER_SIZE-1) usart6_rb_in++;
-		else	usart6_rb_in = 0;
-
-		USART_ClearFlag(USART6, USART_IT_RXNE);
-		USART_ClearITPendingBit(USART6, USART_IT_RXNE);
-	}
+	prv_rx_irq(&usart_ports[USART_PORT_6].rx);
+	prv_tx_drained_irq(&usart_ports[USART_PORT_6].tx);
+}
+
+/** \brief Stream de recebimento da USART1 (DMA2, Stream 5). */
+void DMA2_Stream5_IRQHandler(void) {
+	prv_rx_dma_irq(&usart_ports[USART_PORT_1].rx);
+}
+
+/** \brief Stream de recebimento da USART2 (DMA1, Stream 5).
+  * Publica os bytes ao atingir a metade ou o fim do buffer circular.
+  */
+void DMA1_Stream5_IRQHandler(void) {
+	prv_rx_dma_irq(&usart_ports[USART_PORT_2].rx);
+}
+
+/** \brief Stream de recebimento da USART3 (DMA1, Stream 1). */
+void DMA1_Stream1_IRQHandler(void) {
+	prv_rx_dma_irq(&usart_ports[USART_PORT_3].rx);
+}
+
+/** \brief Stream de recebimento da USART6 (DMA2, Stream 1). */
+void DMA2_Stream1_IRQHandler(void) {
+	prv_rx_dma_irq(&usart_ports[USART_PORT_6].rx);
+}
+
+/** \brief Stream de envio da USART1 (DMA2, Stream 7). */
+void DMA2_Stream7_IRQHandler(void) {
+	prv_tx_irq(&usart_ports[USART_PORT_1].tx);
+}
+
+/** \brief Stream de envio da USART2 (DMA1, Stream 6).
+  * Troca os buffers e dispara a próxima transferência, se houver.
+  */
+void DMA1_Stream6_IRQHandler(void) {
+	prv_tx_irq(&usart_ports[USART_PORT_2].tx);
+}
+
+/** \brief Stream de envio da USART3 (DMA1, Stream 3). */
+void DMA1_Stream3_IRQHandler(void) {
+	prv_tx_irq(&usart_ports[USART_PORT_3].tx);
+}
+
+/** \brief Stream de envio da USART6 (DMA2, Stream 6). */
+void DMA2_Stream6_IRQHandler(void) {
+	prv_tx_irq(&usart_ports[USART_PORT_6].tx);
 }
 
 /**
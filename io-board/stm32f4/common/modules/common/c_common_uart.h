@@ -5,10 +5,6 @@
   * @version V1.0.0
   * @date    30-November-2013
   * @brief   Funcões para configuração de UART, para uso em outros módulos.
-  *	TODO
-  *
-  * \todo	 1 - Programar os wrappers para UART3 (dos servos?) .
-  * \todo	 2 - ...
   *****************************************************************************/
 
 /* Define to prevent recursive inclusion -------------------------------------*/
@@ -17,6 +13,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx_conf.h"
+#include "FreeRTOS.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -24,16 +21,98 @@
 
 /* Includes ------------------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
+
+/** \brief Modos de recebimento de uma USART. Ver c_common_usart_set_rx_mode(). */
+typedef enum {
+	USART_RX_MODE_IRQ = 0,		//!< Uma interrupção por byte recebido.
+	USART_RX_MODE_DMA_IDLE		//!< DMA circular, uma interrupção por pacote (linha ociosa).
+} USARTRxMode;
+
+/** \brief Contadores de desempenho do envio via DMA de uma USART. */
+typedef struct {
+	uint32_t bytes;			//!< Bytes entregues ao DMA.
+	uint32_t transfers;		//!< Transferências de DMA iniciadas.
+	uint32_t overrun;		//!< Bytes descartados por falta de espaço nos buffers de envio.
+	uint32_t backpressure;	//!< Chamadas que não puderam ser aceitas por completo.
+	uint32_t segments;		//!< Segmentos enfileirados por c_common_usart_queue() (sem cópia).
+	uint32_t errors;		//!< Erros de transferência reportados pelo DMA.
+	uint32_t timeouts;		//!< Esperas de c_common_usart_flush() esgotadas.
+	uint16_t peak;			//!< Maior ocupação observada do buffer em preenchimento.
+} USARTTxStats;
+
+/** \brief Função chamada quando o DMA termina de ler um segmento de envio, liberando o buffer.
+  * Executa no tratador de interrupção do stream: deve ser curta, e usar apenas a API \em FromISR do FreeRTOS.
+  */
+typedef void (*USARTTxCallback)(void *context);
+
+/** \brief Segmento de envio sem cópia (ver c_common_usart_queue()).
+  * O buffer apontado pertence a quem o enfileirou, e deve permanecer válido e inalterado até \b done
+  * ser chamada (ou até c_common_usart_flush() retornar true).
+  */
+typedef struct {
+	const uint8_t* 		data;		//!< Início do segmento.
+	uint16_t 			length;		//!< Tamanho do segmento (1 a 65535 bytes).
+	USARTTxCallback 	done;		//!< Chamada ao fim do segmento (opcional).
+	void* 				context;	//!< Argumento de \b done.
+} USARTTxSegment;
+
+/** \brief Contadores do recebimento bloqueante (c_common_usart_read_timeout()) de uma USART.
+  * As latências são medidas em ciclos de clock (ver \ref Common_Components_Perf), do instante em que
+  * o tratador de interrupção libera o semáforo até a task leitora voltar a executar.
+  */
+typedef struct {
+	uint32_t blocks;		//!< Vezes em que a task leitora bloqueou à espera de dados.
+	uint32_t wakeups;		//!< Vezes em que foi acordada pelo tratador de interrupção.
+	uint32_t switches;		//!< Acordadas com troca de contexto imediata, na saída da interrupção.
+	uint32_t timeouts;		//!< Esperas encerradas por timeout.
+	uint32_t latencyLast;	//!< Latência de acordar da última espera (ciclos).
+	uint32_t latencyMax;	//!< Maior latência de acordar observada (ciclos).
+	uint32_t latencySum;	//!< Soma das latências (ciclos); a média é latencySum/wakeups.
+} USARTRxStats;
+
 /* Exported constants --------------------------------------------------------*/
+
+/** Sem terminador de leitura. Ver c_common_usart_set_rx_terminator(). */
+#define USART_NO_TERMINATOR		(-1)
+
+/** Tamanho de cada um dos dois buffers de envio de uma USART. */
+#define USART_TX_BUFFER_SIZE	128
+
+/** Segmentos na fila de envio de uma USART, incluindo os buffers de envio. Deve ser potência de 2. */
+#define USART_TX_QUEUE_SIZE		16
+
+/** Espera máxima de c_common_usart_set_baudrate() pelo fim do envio em andamento (256 bytes a 9600 bit/s). */
+#define USART_FLUSH_TIMEOUT_MS	300
+
+/** Tamanho do Ring-Buffer de recebimento de uma USART. Deve ser potência de 2. */
+#define USART_RX_BUFFER_SIZE	64
+
 /* Exported macro ------------------------------------------------------------*/
 
 /* Exported functions ------------------------------------------------------- */
+void c_common_usart_init(USART_TypeDef* USARTx, int baudrate);
 void c_common_usart2_init(int baudrate);
 void c_common_usart6_init(int baudrate);
+uint32_t c_common_usart_check_baudrate(USART_TypeDef* USARTx, uint32_t baudrate);
+uint32_t c_common_usart_set_baudrate(USART_TypeDef* USARTx, uint32_t baudrate);
+uint32_t c_common_usart_get_baudrate(USART_TypeDef* USARTx);
 void c_common_usart_puts(USART_TypeDef* USARTx, volatile char *s);
 void c_common_usart_putchar(USART_TypeDef* USARTx, volatile char c);
-bool c_common_usart_available(USART_TypeDef* USARTx);
+int  c_common_usart_write(USART_TypeDef* USARTx, const uint8_t *data, int length);
+bool c_common_usart_queue(USART_TypeDef* USARTx, const USARTTxSegment *segments, int count);
+bool c_common_usart_flush(USART_TypeDef* USARTx, portTickType ticks);
+USARTTxStats c_common_usart_tx_stats(USART_TypeDef* USARTx);
+int  c_common_usart_tx_free(USART_TypeDef* USARTx);
+int  c_common_usart_available(USART_TypeDef* USARTx);
 unsigned char c_common_usart_read(USART_TypeDef* USARTx);
+int  c_common_usart_read_block(USART_TypeDef* USARTx, uint8_t *buf, int n);
+int  c_common_usart_peek(USART_TypeDef* USARTx, uint8_t *buf, int n);
+uint32_t c_common_usart_dropped(USART_TypeDef* USARTx);
+void c_common_usart_set_rx_mode(USART_TypeDef* USARTx, USARTRxMode mode);
+uint32_t c_common_usart_rx_frames(USART_TypeDef* USARTx);
+int  c_common_usart_read_timeout(USART_TypeDef* USARTx, uint8_t *buf, int n, portTickType ticks);
+void c_common_usart_set_rx_terminator(USART_TypeDef* USARTx, int terminator);
+USARTRxStats c_common_usart_rx_stats(USART_TypeDef* USARTx);
 
 /* Header-defined wrapper functions ----------------------------------------- */
 /** @addtogroup Common_Components
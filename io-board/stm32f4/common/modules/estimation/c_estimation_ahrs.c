@@ -0,0 +1,198 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/c_estimation_ahrs.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Filtro complementar de atitude em quatérnios (Mahony ou Madgwick).
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_estimation_ahrs.h"
+
+/** @addtogroup Module_Estimation
+  * @{
+  */
+
+/** @addtogroup Module_Estimation_Component_AHRS
+  *	\brief Atitude pela integração do giroscópio, corrigida pela gravidade e pelo campo magnético.
+  *
+  * A cada passo, a vertical e o norte magnético estimados (levados ao referencial do corpo pela
+  * atitude atual) são comparados com o acelerômetro e o magnetômetro normalizados; o erro é o
+  * produto vetorial entre medida e estimativa, um eixo de rotação no corpo. O magnetômetro só
+  * corrige a guinada: o seu erro é projetado na vertical, e perturbações magnéticas não inclinam a
+  * atitude. O erro corrige a velocidade angular, que é então integrada (pv_quat_integrate()):
+  * - Mahony: rate + kp * erro + integral de ki * erro. O termo integral converge para o bias
+  *   residual do giroscópio, e é limitado a \b biasLimit.
+  * - Madgwick: rate + 2 * beta * erro / |erro|. É o passo de gradiente descendente de Madgwick
+  *   escrito como rotação (o gradiente de |q* g q - a|^2 é q [0, erro]), sem a expansão do jacobiano.
+  *
+  * O referencial da Terra tem z para cima e x para o norte magnético (horizontal); Euler ZYX.
+  *
+  * Tudo em float, sobre \ref Lib_Math, sem dependências do hardware: o componente compila também no
+  * host. Custo de um passo com acelerômetro e magnetômetro: ~250 operações da FPU, quatro raízes e
+  * três divisões.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define AHRS_MIN_NORM_SQ	1e-12f		//!< Abaixo disso, um vetor é tratado como nulo.
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Direção horizontal do campo de \b mag (unitário, no corpo), levada à Terra por \b attitude e
+  * trazida de volta ao corpo: o norte magnético estimado, com a inclinação do campo preservada.
+  */
+static Vec3 prv_north(Quat attitude, Vec3 mag) {
+	Vec3 h = pv_quat_rotate(attitude, mag);
+	Vec3 b = pv_vec3(sqrtf(fmaf(h.x, h.x, h.y * h.y)), 0.0f, h.z);
+
+	return pv_quat_rotate_inv(attitude, b);
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Ganhos de referência de cada algoritmo.
+ *
+ * Mahony: kp = 1 (constante de tempo de ~1 s) e ki = 0,1 (o bias converge em ~10 s, com
+ * amortecimento 1,6), bias de até 0,1 rad/s.
+ * Madgwick: beta = 0,1 rad/s (limita a correção a ~11 graus/s). Ambos ignoram o acelerômetro com
+ * norma fora de g +/- 20%.
+ *
+ * @param algorithm Algoritmo.
+ */
+AhrsConfig c_estimation_ahrs_defaults(AhrsAlgorithm algorithm) {
+	AhrsConfig config = {
+		.algorithm = algorithm,
+		.kp = 1.0f,
+		.ki = 0.1f,
+		.beta = 0.1f,
+		.biasLimit = 0.1f,
+		.accGate = 0.2f,
+	};
+	return config;
+}
+
+/** \brief Inicializa o filtro na identidade, ainda não alinhado.
+ *
+ * @param ahrs Filtro.
+ * @param config Ganhos; nulo para os de c_estimation_ahrs_defaults(AHRS_MAHONY).
+ */
+void c_estimation_ahrs_init(Ahrs* ahrs, const AhrsConfig* config) {
+	ahrs->config   = config ? *config : c_estimation_ahrs_defaults(AHRS_MAHONY);
+	ahrs->attitude = pv_quat_identity();
+	ahrs->bias     = pv_vec3(0.0f, 0.0f, 0.0f);
+	ahrs->rate     = pv_vec3(0.0f, 0.0f, 0.0f);
+	ahrs->aligned  = false;
+}
+
+/** \brief Atitude tirada diretamente das medidas: rolagem e arfagem da gravidade, guinada do campo
+ * magnético (zero sem magnetômetro). Usada também no alinhamento de \ref Module_Estimation_Component_ESKF.
+ *
+ * @param acc Acelerômetro (qualquer unidade), com o veículo parado.
+ * @param mag Magnetômetro (qualquer unidade), ou nulo.
+ * @param attitude Destino da atitude.
+ * @retval false se \b acc é nulo; \b attitude não muda.
+ */
+bool c_estimation_ahrs_attitude(Vec3 acc, const Vec3* mag, Quat* attitude) {
+	if(pv_vec3_norm_sq(acc) < AHRS_MIN_NORM_SQ)
+		return false;
+
+	float roll  = atan2f(acc.y, acc.z);
+	float pitch = atan2f(-acc.x, sqrtf(fmaf(acc.y, acc.y, acc.z * acc.z)));
+	Quat level  = pv_quat_from_euler(pv_vec3(roll, pitch, 0.0f));
+	float yaw   = 0.0f;
+
+	if(mag && pv_vec3_norm_sq(*mag) >= AHRS_MIN_NORM_SQ) {
+		Vec3 h = pv_quat_rotate(level, *mag);		// campo no plano horizontal, com guinada nula
+		yaw = atan2f(-h.y, h.x);
+	}
+
+	*attitude = pv_quat_from_euler(pv_vec3(roll, pitch, yaw));
+	return true;
+}
+
+/** \brief Alinha o filtro pelas medidas (c_estimation_ahrs_attitude()). Evita a convergência lenta a
+ * partir da identidade.
+ *
+ * @param ahrs Filtro.
+ * @param acc Acelerômetro (qualquer unidade), com o veículo parado.
+ * @param mag Magnetômetro (qualquer unidade), ou nulo.
+ * @retval false se \b acc é nulo; a atitude não muda.
+ */
+bool c_estimation_ahrs_align(Ahrs* ahrs, Vec3 acc, const Vec3* mag) {
+	if(!c_estimation_ahrs_attitude(acc, mag, &ahrs->attitude))
+		return false;
+
+	ahrs->aligned = true;
+	return true;
+}
+
+/** \brief Avança a atitude de \b dt segundos.
+ *
+ * @param ahrs Filtro.
+ * @param gyro Velocidade angular do corpo (rad/s).
+ * @param acc Acelerômetro (m/s^2), ou nulo para apenas integrar o giroscópio.
+ * @param mag Magnetômetro (qualquer unidade), ou nulo.
+ * @param dt Intervalo desde o passo anterior (s).
+ * @retval Medidas usadas na correção (AHRS_USED_ACC, AHRS_USED_MAG).
+ */
+uint8_t c_estimation_ahrs_update(Ahrs* ahrs, Vec3 gyro, const Vec3* acc, const Vec3* mag, float dt) {
+	const AhrsConfig* config = &ahrs->config;
+	Quat q = ahrs->attitude;
+	Vec3 error = pv_vec3(0.0f, 0.0f, 0.0f);
+	uint8_t used = 0;
+
+	Vec3 up = pv_quat_rotate_inv(q, pv_vec3(0.0f, 0.0f, 1.0f));
+	if(acc) {
+		float normSq = pv_vec3_norm_sq(*acc);
+		float limit  = config->accGate * PV_GRAVITY;
+		float norm   = sqrtf(normSq);
+		if(normSq >= AHRS_MIN_NORM_SQ && fabsf(norm - PV_GRAVITY) <= limit) {
+			error = pv_vec3_cross(pv_vec3_scale(*acc, 1.0f / norm), up);
+			used |= AHRS_USED_ACC;
+		}
+	}
+	if(mag) {
+		float normSq = pv_vec3_norm_sq(*mag);
+		if(normSq >= AHRS_MIN_NORM_SQ) {
+			Vec3 m = pv_vec3_scale(*mag, pv_rsqrtf(normSq));
+			Vec3 heading = pv_vec3_cross(m, prv_north(q, m));
+			error = pv_vec3_madd(error, up, pv_vec3_dot(up, heading));	// só a componente de guinada
+			used |= AHRS_USED_MAG;
+		}
+	}
+
+	Vec3 rate;
+	if(config->algorithm == AHRS_MADGWICK) {
+		float normSq = pv_vec3_norm_sq(error);
+		ahrs->rate = gyro;
+		rate = gyro;
+		if(normSq >= AHRS_MIN_NORM_SQ)
+			rate = pv_vec3_madd(gyro, error, 2.0f * config->beta * pv_rsqrtf(normSq));
+	} else {
+		if(config->ki > 0.0f && used) {
+			Vec3 bias = pv_vec3_madd(ahrs->bias, error, config->ki * dt);
+			ahrs->bias = pv_vec3(pv_clampf(bias.x, -config->biasLimit, config->biasLimit),
+								 pv_clampf(bias.y, -config->biasLimit, config->biasLimit),
+								 pv_clampf(bias.z, -config->biasLimit, config->biasLimit));
+		}
+		ahrs->rate = pv_vec3_add(gyro, ahrs->bias);
+		rate = pv_vec3_madd(ahrs->rate, error, config->kp);
+	}
+
+	ahrs->attitude = pv_quat_integrate(q, rate, dt);
+	return used;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/c_estimation_ahrs.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Filtro complementar de atitude em quatérnios (Mahony ou Madgwick).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_ESTIMATION_AHRS_H
+#define C_ESTIMATION_AHRS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Algoritmo de correção do giroscópio. */
+typedef enum {
+	AHRS_MAHONY = 0,			//!< Proporcional-integral sobre o erro (estima também o bias do giroscópio).
+	AHRS_MADGWICK				//!< Passo de gradiente de tamanho fixo (\b beta) na direção do erro.
+} AhrsAlgorithm;
+
+/** \brief Ganhos do filtro (ver c_estimation_ahrs_defaults()). */
+typedef struct {
+	AhrsAlgorithm 	algorithm;
+	float 			kp;			//!< Mahony: ganho proporcional (rad/s por unidade de erro).
+	float 			ki;			//!< Mahony: ganho integral (rad/s^2 por unidade de erro); 0 desliga.
+	float 			beta;		//!< Madgwick: velocidade de correção (rad/s).
+	float 			biasLimit;	//!< Mahony: limite do bias estimado em cada eixo (rad/s).
+	float 			accGate;	//!< Acelerômetro ignorado se a norma se afasta de g mais que esta fração.
+} AhrsConfig;
+
+/** \brief Estado do filtro. */
+typedef struct {
+	AhrsConfig 		config;
+	Quat 			attitude;	//!< Atitude (corpo para Terra).
+	Vec3 			bias;		//!< Mahony: correção integral, somada ao giroscópio (-bias do sensor).
+	Vec3 			rate;		//!< Velocidade angular do corpo do último passo, com o bias corrigido (rad/s).
+	bool 			aligned;	//!< Atitude inicial já tirada do acelerômetro (c_estimation_ahrs_align()).
+} Ahrs;
+
+/* Exported constants --------------------------------------------------------*/
+#define AHRS_USED_ACC		0x01	//!< O acelerômetro corrigiu o passo.
+#define AHRS_USED_MAG		0x02	//!< O magnetômetro corrigiu o passo.
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+AhrsConfig c_estimation_ahrs_defaults(AhrsAlgorithm algorithm);
+void    c_estimation_ahrs_init(Ahrs* ahrs, const AhrsConfig* config);
+bool    c_estimation_ahrs_attitude(Vec3 acc, const Vec3* mag, Quat* attitude);
+bool    c_estimation_ahrs_align(Ahrs* ahrs, Vec3 acc, const Vec3* mag);
+uint8_t c_estimation_ahrs_update(Ahrs* ahrs, Vec3 gyro, const Vec3* acc, const Vec3* mag, float dt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_ESTIMATION_AHRS_H
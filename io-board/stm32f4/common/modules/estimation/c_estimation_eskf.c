@@ -0,0 +1,311 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/c_estimation_eskf.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Filtro de Kalman de estado de erro para atitude e bias do giroscópio.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_estimation_eskf.h"
+#include "c_estimation_ahrs.h"
+
+/** @addtogroup Module_Estimation
+  * @{
+  */
+
+/** @addtogroup Module_Estimation_Component_ESKF
+  *	\brief Filtro de Kalman de estado de erro (ESKF) com 6 estados: erro de atitude e erro de bias.
+  *
+  * O estado nominal (atitude e bias do giroscópio) é integrado a cada amostra do giroscópio; o
+  * filtro estima apenas o erro x = (dtheta, dbias), pequeno, e por isso linear. A cada medida, o
+  * erro estimado é somado ao estado nominal e volta a zero.
+  *
+  * Propagação (c_estimation_eskf_predict()), com w = (gyro - bias) dt:
+  * \code
+  * F = | I - [w]x   -dt I |      P = F P F' + diag(gyroNoise^2 dt, biasWalk^2 dt)
+  *     |    0         I   |
+  * \endcode
+  * Medidas, processadas como atualizações escalares sequenciais (sem inversão de matrizes):
+  * - Acelerômetro: a direção da gravidade, z = acc / |acc|, prevista v = attitude* (0, 0, 1);
+  *   H = [ [v]x 0 ]. O ruído cresce com o desvio da norma em relação a g.
+  * - Magnetômetro: só a guinada, com inovação atan2(-h.y, h.x) para h = attitude mag (o campo na
+  *   Terra, que deveria estar no plano xz); H = [ v' 0 ].
+  *
+  * Tudo é desenrolado à mão sobre blocos 3x3 (\ref Lib_Math), em vez das rotinas genéricas
+  * arm_mat_* do CMSIS-DSP para 6x6: F tem estrutura ([w]x vira produtos vetoriais), H tem o bloco
+  * do bias nulo, e P é simétrica: só os 21 elementos distintos são calculados, e o triângulo
+  * superior é espelhado no inferior. Custo: a propagação tem ~150 operações da FPU; cada
+  * atualização escalar, ~60. É uma contagem de operações, não uma medida.
+  *
+  * Na placa, o passo do filtro (propagação e correções) é medido pelo probe "ESTIM eskf" (DWT, ver
+  * pv_module_estimation.c): ciclos médios e pior caso, e em \b frames os passos com correção. Essa
+  * contagem ainda não foi feita: o filtro não foi compilado para o Cortex-M4 nem executado na placa,
+  * e se ele cabe no laço de 500 Hz (336000 ciclos por período a 168 MHz) continua em aberto até a
+  * leitura do probe. No host, \em ground/estimation_benchmark (\c make \c test) reproduz uma gravação
+  * da telemetria e confere o erro de atitude contra uma referência.
+  *
+  * Referencial e atitude como em \ref Module_Estimation_Component_AHRS, cujo alinhamento inicial
+  * (c_estimation_ahrs_attitude()) é reaproveitado.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define ESKF_MIN_NORM_SQ	1e-12f		//!< Abaixo disso, um vetor é tratado como nulo.
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Copia o triângulo superior de uma matriz simétrica no inferior. */
+static inline void prv_mirror(Mat3* a) {
+	a->m[1][0] = a->m[0][1];
+	a->m[2][0] = a->m[0][2];
+	a->m[2][1] = a->m[1][2];
+}
+
+/** \brief Covariância diagonal inicial. */
+static void prv_reset_covariance(Eskf* eskf) {
+	float sa = eskf->config.attitudeSigma, sb = eskf->config.biasSigma;
+
+	eskf->Paa = pv_mat3_diag(pv_vec3(sa * sa, sa * sa, sa * sa));
+	eskf->Pab = pv_mat3_diag(pv_vec3(0.0f, 0.0f, 0.0f));
+	eskf->Pbb = pv_mat3_diag(pv_vec3(sb * sb, sb * sb, sb * sb));
+}
+
+/** \brief Atualização escalar com H = [ h 0 ] e ruído \b r, acumulando o erro estimado.
+  *
+  * @param innovation Medida menos previsão; o erro já acumulado (\b dtheta) é descontado.
+  * @retval false se a variância da inovação não é positiva (medida ignorada).
+  */
+static bool prv_update(Eskf* eskf, Vec3 h, float innovation, float r, Vec3* dtheta, Vec3* dbias) {
+	Mat3* A = &eskf->Paa;
+	Mat3* B = &eskf->Pab;
+	Mat3* C = &eskf->Pbb;
+	Vec3 pa = pv_mat3_mul_vec(A, h);			// P H' = (Paa h, Pab' h)
+	Vec3 pb = pv_mat3_mul_vec_t(B, h);
+	float s = pv_vec3_dot(h, pa) + r;
+
+	if(!(s > 0.0f))
+		return false;
+
+	float inv = 1.0f / s;
+	float y = innovation - pv_vec3_dot(h, *dtheta);
+	*dtheta = pv_vec3_madd(*dtheta, pa, y * inv);
+	*dbias  = pv_vec3_madd(*dbias, pb, y * inv);
+
+	// P -= (P H')(P H')' / s: triângulos superiores de Paa e Pbb, e Pab inteira
+	Vec3 ka = pv_vec3_scale(pa, inv), kb = pv_vec3_scale(pb, inv);
+	A->m[0][0] = fmaf(-ka.x, pa.x, A->m[0][0]);
+	A->m[0][1] = fmaf(-ka.x, pa.y, A->m[0][1]);
+	A->m[0][2] = fmaf(-ka.x, pa.z, A->m[0][2]);
+	A->m[1][1] = fmaf(-ka.y, pa.y, A->m[1][1]);
+	A->m[1][2] = fmaf(-ka.y, pa.z, A->m[1][2]);
+	A->m[2][2] = fmaf(-ka.z, pa.z, A->m[2][2]);
+
+	B->m[0][0] = fmaf(-ka.x, pb.x, B->m[0][0]);
+	B->m[0][1] = fmaf(-ka.x, pb.y, B->m[0][1]);
+	B->m[0][2] = fmaf(-ka.x, pb.z, B->m[0][2]);
+	B->m[1][0] = fmaf(-ka.y, pb.x, B->m[1][0]);
+	B->m[1][1] = fmaf(-ka.y, pb.y, B->m[1][1]);
+	B->m[1][2] = fmaf(-ka.y, pb.z, B->m[1][2]);
+	B->m[2][0] = fmaf(-ka.z, pb.x, B->m[2][0]);
+	B->m[2][1] = fmaf(-ka.z, pb.y, B->m[2][1]);
+	B->m[2][2] = fmaf(-ka.z, pb.z, B->m[2][2]);
+
+	C->m[0][0] = fmaf(-kb.x, pb.x, C->m[0][0]);
+	C->m[0][1] = fmaf(-kb.x, pb.y, C->m[0][1]);
+	C->m[0][2] = fmaf(-kb.x, pb.z, C->m[0][2]);
+	C->m[1][1] = fmaf(-kb.y, pb.y, C->m[1][1]);
+	C->m[1][2] = fmaf(-kb.y, pb.z, C->m[1][2]);
+	C->m[2][2] = fmaf(-kb.z, pb.z, C->m[2][2]);
+
+	prv_mirror(A);
+	prv_mirror(C);
+	return true;
+}
+
+/** \brief Soma o erro estimado ao estado nominal (o erro volta a zero). */
+static void prv_inject(Eskf* eskf, Vec3 dtheta, Vec3 dbias) {
+	eskf->attitude = pv_quat_integrate(eskf->attitude, dtheta, 1.0f);	// attitude * (1, dtheta/2)
+	eskf->bias = pv_vec3_add(eskf->bias, dbias);
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Ruídos de referência para a IMU da placa (ITG3205 a 1 kHz, acelerômetro a ~50 Hz).
+ *
+ * gyroNoise = 0,005 rad/s/sqrt(Hz), folgado em relação à folha de dados por causa da vibração;
+ * biasWalk = 1e-4 rad/s/sqrt(s); accNoise = 0,05; magNoise = 0,05 rad; accGate = 20%;
+ * incertezas iniciais de 0,05 rad e 0,02 rad/s (giroscópio já calibrado).
+ */
+EskfConfig c_estimation_eskf_defaults(void) {
+	EskfConfig config = {
+		.gyroNoise = 0.005f,
+		.biasWalk = 1e-4f,
+		.accNoise = 0.05f,
+		.magNoise = 0.05f,
+		.accGate = 0.2f,
+		.attitudeSigma = 0.05f,
+		.biasSigma = 0.02f,
+	};
+	return config;
+}
+
+/** \brief Inicializa o filtro na identidade, com bias nulo, ainda não alinhado.
+ *
+ * @param eskf Filtro.
+ * @param config Ruídos; nulo para os de c_estimation_eskf_defaults().
+ */
+void c_estimation_eskf_init(Eskf* eskf, const EskfConfig* config) {
+	eskf->config   = config ? *config : c_estimation_eskf_defaults();
+	eskf->attitude = pv_quat_identity();
+	eskf->bias     = pv_vec3(0.0f, 0.0f, 0.0f);
+	eskf->rate     = pv_vec3(0.0f, 0.0f, 0.0f);
+	eskf->aligned  = false;
+	prv_reset_covariance(eskf);
+}
+
+/** \brief Tira a atitude das medidas (c_estimation_ahrs_attitude()) e reinicia a covariância.
+ *
+ * @param eskf Filtro.
+ * @param acc Acelerômetro (qualquer unidade), com o veículo parado.
+ * @param mag Magnetômetro (qualquer unidade), ou nulo.
+ * @retval false se \b acc é nulo; o filtro não muda.
+ */
+bool c_estimation_eskf_align(Eskf* eskf, Vec3 acc, const Vec3* mag) {
+	if(!c_estimation_ahrs_attitude(acc, mag, &eskf->attitude))
+		return false;
+
+	prv_reset_covariance(eskf);
+	eskf->aligned = true;
+	return true;
+}
+
+/** \brief Propaga o estado nominal e a covariância por \b dt segundos.
+ *
+ * @param eskf Filtro.
+ * @param gyro Velocidade angular medida (rad/s).
+ * @param dt Intervalo desde a amostra anterior (s).
+ */
+void c_estimation_eskf_predict(Eskf* eskf, Vec3 gyro, float dt) {
+	const EskfConfig* config = &eskf->config;
+	const Mat3* A = &eskf->Paa;
+	const Mat3* B = &eskf->Pab;
+	const Mat3* C = &eskf->Pbb;
+	Mat3 Paa, Pab;
+
+	eskf->rate = pv_vec3_sub(gyro, eskf->bias);
+	eskf->attitude = pv_quat_integrate(eskf->attitude, eskf->rate, dt);
+
+	Vec3 w = pv_vec3_scale(eskf->rate, dt);
+	float qa = config->gyroNoise * config->gyroNoise * dt;
+	float qb = config->biasWalk * config->biasWalk * dt;
+	float dt2 = dt * dt;
+
+	// T = (I - [w]x) Paa: as colunas de [w]x Paa são w x (colunas de Paa), que é simétrica
+	Vec3 u0 = pv_vec3_cross(w, pv_mat3_row(A, 0));
+	Vec3 u1 = pv_vec3_cross(w, pv_mat3_row(A, 1));
+	Vec3 u2 = pv_vec3_cross(w, pv_mat3_row(A, 2));
+	Vec3 t0 = pv_vec3(A->m[0][0] - u0.x, A->m[0][1] - u1.x, A->m[0][2] - u2.x);
+	Vec3 t1 = pv_vec3(A->m[1][0] - u0.y, A->m[1][1] - u1.y, A->m[1][2] - u2.y);
+	Vec3 t2 = pv_vec3(A->m[2][0] - u0.z, A->m[2][1] - u1.z, A->m[2][2] - u2.z);
+
+	// X = (I - [w]x) Pab, coluna a coluna
+	Vec3 b0 = pv_mat3_col(B, 0), b1 = pv_mat3_col(B, 1), b2 = pv_mat3_col(B, 2);
+	Vec3 x0 = pv_vec3_sub(b0, pv_vec3_cross(w, b0));
+	Vec3 x1 = pv_vec3_sub(b1, pv_vec3_cross(w, b1));
+	Vec3 x2 = pv_vec3_sub(b2, pv_vec3_cross(w, b2));
+
+	// Paa = T (I - [w]x)' - dt (X + X') + dt^2 Pbb + qa I, com a linha i de T [w]x igual a t_i x w;
+	// só o triângulo superior
+	Paa.m[0][0] = t0.x + (t0.y * w.z - t0.z * w.y) - 2.0f * dt * x0.x + dt2 * C->m[0][0] + qa;
+	Paa.m[0][1] = t0.y + (t0.z * w.x - t0.x * w.z) - dt * (x1.x + x0.y) + dt2 * C->m[0][1];
+	Paa.m[0][2] = t0.z + (t0.x * w.y - t0.y * w.x) - dt * (x2.x + x0.z) + dt2 * C->m[0][2];
+	Paa.m[1][1] = t1.y + (t1.z * w.x - t1.x * w.z) - 2.0f * dt * x1.y + dt2 * C->m[1][1] + qa;
+	Paa.m[1][2] = t1.z + (t1.x * w.y - t1.y * w.x) - dt * (x2.y + x1.z) + dt2 * C->m[1][2];
+	Paa.m[2][2] = t2.z + (t2.x * w.y - t2.y * w.x) - 2.0f * dt * x2.z + dt2 * C->m[2][2] + qa;
+	prv_mirror(&Paa);
+
+	// Pab = X - dt Pbb
+	Pab.m[0][0] = fmaf(-dt, C->m[0][0], x0.x);
+	Pab.m[0][1] = fmaf(-dt, C->m[0][1], x1.x);
+	Pab.m[0][2] = fmaf(-dt, C->m[0][2], x2.x);
+	Pab.m[1][0] = fmaf(-dt, C->m[1][0], x0.y);
+	Pab.m[1][1] = fmaf(-dt, C->m[1][1], x1.y);
+	Pab.m[1][2] = fmaf(-dt, C->m[1][2], x2.y);
+	Pab.m[2][0] = fmaf(-dt, C->m[2][0], x0.z);
+	Pab.m[2][1] = fmaf(-dt, C->m[2][1], x1.z);
+	Pab.m[2][2] = fmaf(-dt, C->m[2][2], x2.z);
+
+	eskf->Paa = Paa;
+	eskf->Pab = Pab;
+	eskf->Pbb.m[0][0] += qb;
+	eskf->Pbb.m[1][1] += qb;
+	eskf->Pbb.m[2][2] += qb;
+}
+
+/** \brief Corrige a atitude (rolagem e arfagem) e o bias pela direção da gravidade.
+ *
+ * @param eskf Filtro.
+ * @param acc Acelerômetro (m/s^2), de preferência a média de algumas amostras.
+ * @retval false se a norma está fora de g +/- \b accGate (aceleração do veículo); nada muda.
+ */
+bool c_estimation_eskf_update_acc(Eskf* eskf, Vec3 acc) {
+	const EskfConfig* config = &eskf->config;
+	float normSq = pv_vec3_norm_sq(acc);
+
+	if(normSq < ESKF_MIN_NORM_SQ)
+		return false;
+
+	float norm = sqrtf(normSq);
+	float deviation = norm * (1.0f / PV_GRAVITY) - 1.0f;
+	if(fabsf(deviation) > config->accGate)
+		return false;
+
+	Vec3 a = pv_vec3_scale(acc, 1.0f / norm);
+	Vec3 v = pv_quat_rotate_inv(eskf->attitude, pv_vec3(0.0f, 0.0f, 1.0f));
+	Vec3 y = pv_vec3_sub(a, v);
+	float r = fmaf(config->accNoise, config->accNoise, deviation * deviation);
+	Vec3 dtheta = pv_vec3(0.0f, 0.0f, 0.0f), dbias = dtheta;
+
+	// H = [v]x, linha a linha
+	prv_update(eskf, pv_vec3(0.0f, -v.z, v.y), y.x, r, &dtheta, &dbias);
+	prv_update(eskf, pv_vec3(v.z, 0.0f, -v.x), y.y, r, &dtheta, &dbias);
+	prv_update(eskf, pv_vec3(-v.y, v.x, 0.0f), y.z, r, &dtheta, &dbias);
+	prv_inject(eskf, dtheta, dbias);
+	return true;
+}
+
+/** \brief Corrige a guinada (e o bias) pelo campo magnético.
+ *
+ * @param eskf Filtro.
+ * @param mag Magnetômetro (qualquer unidade).
+ * @retval false se o campo é nulo ou vertical; nada muda.
+ */
+bool c_estimation_eskf_update_mag(Eskf* eskf, Vec3 mag) {
+	Vec3 h = pv_quat_rotate(eskf->attitude, mag);
+
+	if(fmaf(h.x, h.x, h.y * h.y) < ESKF_MIN_NORM_SQ)
+		return false;
+
+	Vec3 v = pv_quat_rotate_inv(eskf->attitude, pv_vec3(0.0f, 0.0f, 1.0f));
+	Vec3 dtheta = pv_vec3(0.0f, 0.0f, 0.0f), dbias = dtheta;
+
+	// o erro de guinada é a componente vertical (na Terra) de dtheta: H = [ v' 0 ]
+	if(!prv_update(eskf, v, atan2f(-h.y, h.x), eskf->config.magNoise * eskf->config.magNoise, &dtheta, &dbias))
+		return false;
+	prv_inject(eskf, dtheta, dbias);
+	return true;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
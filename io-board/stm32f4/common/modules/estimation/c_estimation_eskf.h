@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/c_estimation_eskf.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Filtro de Kalman de estado de erro para atitude e bias do giroscópio.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_ESTIMATION_ESKF_H
+#define C_ESTIMATION_ESKF_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Ruídos do modelo e incertezas iniciais (ver c_estimation_eskf_defaults()). */
+typedef struct {
+	float 	gyroNoise;			//!< Densidade do ruído do giroscópio (rad/s/sqrt(Hz)).
+	float 	biasWalk;			//!< Passeio aleatório do bias (rad/s/sqrt(s)).
+	float 	accNoise;			//!< Ruído da direção da gravidade medida (unitário; ~rad).
+	float 	magNoise;			//!< Ruído da guinada medida pelo magnetômetro (rad).
+	float 	accGate;			//!< Acelerômetro ignorado se a norma se afasta de g mais que esta fração.
+	float 	attitudeSigma;		//!< Incerteza inicial da atitude, após o alinhamento (rad).
+	float 	biasSigma;			//!< Incerteza inicial do bias (rad/s).
+} EskfConfig;
+
+/** \brief Estado do filtro: estado nominal e covariância do erro, em blocos 3x3 simétricos.
+  *
+  * Erro x = (dtheta, dbias): dtheta é a rotação de erro no referencial do corpo
+  * (atitude real = attitude * exp(dtheta)); dbias o erro do bias.
+  */
+typedef struct {
+	EskfConfig 	config;
+	Quat 		attitude;		//!< Atitude (corpo para Terra).
+	Vec3 		bias;			//!< Bias do giroscópio (rad/s): rate = gyro - bias.
+	Vec3 		rate;			//!< Velocidade angular do corpo do último passo, sem o bias (rad/s).
+	Mat3 		Paa;			//!< Covariância de dtheta (simétrica).
+	Mat3 		Pab;			//!< Covariância cruzada entre dtheta e dbias.
+	Mat3 		Pbb;			//!< Covariância de dbias (simétrica).
+	bool 		aligned;		//!< Atitude inicial já tirada das medidas (c_estimation_eskf_align()).
+} Eskf;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+EskfConfig c_estimation_eskf_defaults(void);
+void c_estimation_eskf_init(Eskf* eskf, const EskfConfig* config);
+bool c_estimation_eskf_align(Eskf* eskf, Vec3 acc, const Vec3* mag);
+void c_estimation_eskf_predict(Eskf* eskf, Vec3 gyro, float dt);
+bool c_estimation_eskf_update_acc(Eskf* eskf, Vec3 acc);
+bool c_estimation_eskf_update_mag(Eskf* eskf, Vec3 mag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_ESTIMATION_ESKF_H
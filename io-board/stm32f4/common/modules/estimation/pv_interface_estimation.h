@@ -0,0 +1,45 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/pv_interface_estimation.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Dados publicados pelo módulo de estimação para os demais módulos.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_INTERFACE_ESTIMATION_H
+#define PV_INTERFACE_ESTIMATION_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "pv_math.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Atitude e velocidades angulares estimadas em um período de amostragem. */
+typedef struct {
+	uint32_t 	timestamp;		//!< Instante da amostra do giroscópio, em us (ver c_io_sampler_micros()).
+	uint32_t 	sequence;		//!< Passos do estimador; saltos indicam estimativas não lidas.
+	Quat 		attitude;		//!< Atitude (corpo para Terra; Terra com z para cima, x para o norte magnético).
+	Vec3 		euler;			//!< Rolagem, arfagem e guinada (ZYX), em rad.
+	Vec3 		rate;			//!< Velocidade angular do corpo, sem o bias estimado, em rad/s.
+	uint8_t 	flags;			//!< Medidas usadas na correção (ESTIMATION_USED_ACC, ESTIMATION_USED_MAG).
+} EstimationAttitude;
+
+/* Exported constants --------------------------------------------------------*/
+#define ESTIMATION_USED_ACC		0x01	//!< A gravidade corrigiu a atitude.
+#define ESTIMATION_USED_MAG		0x02	//!< O campo magnético corrigiu a guinada.
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_INTERFACE_ESTIMATION_H
@@ -0,0 +1,246 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/pv_module_estimation.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do módulo de estimação de atitude.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_module_estimation.h"
+#include "c_common_perf.h"
+
+/* FreeRTOS kernel includes */
+#include "FreeRTOS.h"
+#include "queue.h"
+
+/** @addtogroup ProVANT_Modules
+  * @{
+  */
+
+/** @addtogroup Module_Estimation
+  * \brief Estimação de atitude a partir das amostras calibradas da IMU.
+  *
+  * A task que lê os sensores entrega cada amostra ao módulo: o acelerômetro e o magnetômetro como
+  * referências (module_estimation_acc(), module_estimation_mag()), e o giroscópio como o passo do
+  * filtro (module_estimation_update()), que roda à taxa do giroscópio (1 kHz na cadeia da IMU). As
+  * amostras do acelerômetro chegam em rajadas da FIFO: a média de cada rajada é a referência dos
+  * passos seguintes, o que também reduz o ruído. Referências sem amostras novas há mais de
+  * 100 ms deixam de ser usadas. O intervalo de cada passo vem dos instantes das amostras do
+  * giroscópio, e a atitude inicial é tirada do primeiro acelerômetro (e magnetômetro) disponível.
+  *
+  * O filtro é escolhido em module_estimation_init(): um dos complementares de
+  * \ref Module_Estimation_Component_AHRS (Mahony ou Madgwick), que usam a referência mais recente em
+  * todo passo, ou o filtro de Kalman de \ref Module_Estimation_Component_ESKF, que propaga a
+  * covariância em todo passo e só corrige com cada média nova do acelerômetro e cada amostra nova do
+  * magnetômetro (medidas repetidas não são independentes). Nos dois casos \b rate é o giroscópio sem
+  * o bias estimado, e \b flags indica as referências usadas no passo. Cada passo é publicado numa
+  * fila de um elemento, sobrescrita, de onde qualquer task lê a estimativa mais recente com
+  * module_estimation_read():
+  * \code{.c}
+  * EstimationAttitude att;
+  * if(module_estimation_read(&att))
+  * 	roll = att.euler.x;
+  * \endcode
+  *
+  * O custo de um passo, conversão para Euler e publicação incluídas, é medido pelo probe
+  * "ESTIM update" (ver \ref Common_Components_Perf), e o do filtro sozinho, com o ESKF, por
+  * "ESTIM eskf": ciclos médios e pior caso vão ao solo na telemetria de desempenho. É esse pior caso,
+  * lido na placa a 168 MHz, que diz se o filtro cabe no laço de controle (336000 ciclos por período
+  * a 500 Hz) e do qual se deriva ESTIMATION_BUDGET_CYCLES. Ele ainda não foi medido: não foi possível
+  * compilar para o Cortex-M4 nem executar na placa ao escrever este módulo, e os números de
+  * \em ground/estimation_benchmark, que compara os filtros no host, não valem para a FPU de precisão
+  * simples. Por isso o orçamento é 0, e nada é contado. Com um orçamento definido, \b frames de
+  * "ESTIM update" conta os passos acima dele; é um contador para o solo, não uma imposição: o passo
+  * não é interrompido nem descartado.
+  *
+  * As funções de entrada devem ser chamadas de uma única task.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define ESTIMATION_REFERENCE_TIMEOUT_US		100000	//!< Idade máxima do acelerômetro e do magnetômetro.
+#define ESTIMATION_MAX_DT_US				20000	//!< Limite do intervalo de um passo (lacunas na aquisição).
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+xQueueHandle 		estimation_queue = 0;		//! Última estimativa (fila de um elemento).
+EstimationFilter 	estimation_filter;			//! Filtro em uso.
+Ahrs 				estimation_ahrs;			//! Estado dos filtros complementares.
+Eskf 				estimation_eskf;			//! Estado do filtro de Kalman.
+EstimationAttitude 	estimation_out;				//! Estimativa sendo montada.
+PerfProbe 			estimation_probe;			//! module_estimation_update().
+PerfProbe 			estimation_eskf_probe;		//! Passo do ESKF (quadros: passos com correção).
+
+/* Referências: média da rajada do acelerômetro em curso e últimas medidas. */
+Vec3 		estimation_acc_sum;
+uint32_t 	estimation_acc_count = 0;
+Vec3 		estimation_acc;
+uint32_t 	estimation_acc_time;
+bool 		estimation_acc_valid = false;
+bool 		estimation_acc_new = false;		//! Média ainda não usada pelo ESKF.
+Vec3 		estimation_mag;
+uint32_t 	estimation_mag_time;
+bool 		estimation_mag_valid = false;
+bool 		estimation_mag_new = false;		//! Amostra ainda não usada pelo ESKF.
+
+uint32_t 	estimation_last;					//! Instante do passo anterior, em us.
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Passo do filtro de Kalman: correções só com medidas novas e ainda recentes. */
+static uint8_t prv_eskf_step(Vec3 gyro, const Vec3* acc, const Vec3* mag, float dt) {
+	uint8_t used = 0;
+	PERF_PROBE_BEGIN();
+
+	c_estimation_eskf_predict(&estimation_eskf, gyro, dt);
+	if(acc && estimation_acc_new && c_estimation_eskf_update_acc(&estimation_eskf, *acc))
+		used |= ESTIMATION_USED_ACC;
+	if(mag && estimation_mag_new && c_estimation_eskf_update_mag(&estimation_eskf, *mag))
+		used |= ESTIMATION_USED_MAG;
+	estimation_acc_new = false;
+	estimation_mag_new = false;
+
+	PERF_PROBE_END(estimation_eskf_probe, 0);
+	if(used)
+		PERF_PROBE_FRAME(estimation_eskf_probe);
+	return used;
+}
+
+/** \brief Referência com menos de ESTIMATION_REFERENCE_TIMEOUT_US em \b now, ou nulo. */
+static const Vec3* prv_fresh(const Vec3* reference, bool valid, uint32_t time, uint32_t now) {
+	// com sinal: amostras da FIFO esvaziada depois do giroscópio podem ser mais novas que ele
+	return (valid && (int32_t)(now - time) <= ESTIMATION_REFERENCE_TIMEOUT_US) ? reference : 0;
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Inicializa o módulo de estimação.
+  *
+  * Os ganhos e ruídos são os de c_estimation_ahrs_defaults() e c_estimation_eskf_defaults().
+  *
+  * @param  filter Filtro de atitude.
+  * @retval false se a fila de publicação não pôde ser criada.
+  */
+bool module_estimation_init(EstimationFilter filter) {
+	AhrsConfig config = c_estimation_ahrs_defaults(filter == ESTIMATION_MADGWICK ? AHRS_MADGWICK : AHRS_MAHONY);
+
+	estimation_filter = filter;
+	c_estimation_ahrs_init(&estimation_ahrs, &config);
+	c_estimation_eskf_init(&estimation_eskf, 0);
+	estimation_out = (EstimationAttitude){ .attitude = estimation_ahrs.attitude };
+	estimation_acc_count = 0;
+	estimation_acc_valid = false;
+	estimation_acc_new = false;
+	estimation_mag_valid = false;
+	estimation_mag_new = false;
+
+	if(!estimation_queue)
+		estimation_queue = xQueueCreate(1, sizeof(EstimationAttitude));
+	c_common_perf_register(&estimation_probe, "ESTIM", "update");
+	c_common_perf_register(&estimation_eskf_probe, "ESTIM", "eskf");
+	return estimation_queue != 0;
+}
+
+/** \brief Entrega uma amostra do acelerômetro.
+  *
+  * @param  acc Aceleração no referencial do corpo (m/s^2), alinhada ao giroscópio.
+  * @param  timestamp Instante da amostra, em us.
+  */
+void module_estimation_acc(const float acc[3], uint32_t timestamp) {
+	estimation_acc_sum = pv_vec3_add(estimation_acc_count ? estimation_acc_sum : pv_vec3(0.0f, 0.0f, 0.0f), pv_vec3_load(acc));
+	estimation_acc_count++;
+	estimation_acc_time = timestamp;
+}
+
+/** \brief Entrega uma amostra do magnetômetro.
+  *
+  * @param  mag Campo no referencial do corpo (qualquer unidade), alinhado ao giroscópio.
+  * @param  timestamp Instante da amostra, em us.
+  */
+void module_estimation_mag(const float mag[3], uint32_t timestamp) {
+	estimation_mag = pv_vec3_load(mag);
+	estimation_mag_time = timestamp;
+	estimation_mag_valid = true;
+	estimation_mag_new = true;
+}
+
+/** \brief Avança a estimativa com uma amostra do giroscópio e a publica.
+  *
+  * @param  gyro Velocidade angular do corpo (rad/s).
+  * @param  timestamp Instante da amostra, em us.
+  * @retval true se uma estimativa foi publicada (falso até haver um acelerômetro para o alinhamento).
+  */
+bool module_estimation_update(const float gyro[3], uint32_t timestamp) {
+	uint32_t start = c_common_perf_cycles();
+
+	if(estimation_acc_count) {
+		estimation_acc = pv_vec3_scale(estimation_acc_sum, 1.0f / (float)estimation_acc_count);
+		estimation_acc_count = 0;
+		estimation_acc_valid = true;
+		estimation_acc_new = true;
+	}
+	const Vec3* acc = prv_fresh(&estimation_acc, estimation_acc_valid, estimation_acc_time, timestamp);
+	const Vec3* mag = prv_fresh(&estimation_mag, estimation_mag_valid, estimation_mag_time, timestamp);
+
+	bool eskf = estimation_filter == ESTIMATION_ESKF;
+	if(eskf ? !estimation_eskf.aligned : !estimation_ahrs.aligned) {
+		if(!acc || !(eskf ? c_estimation_eskf_align(&estimation_eskf, *acc, mag)
+				: c_estimation_ahrs_align(&estimation_ahrs, *acc, mag)))
+			return false;
+		estimation_last = timestamp;
+		estimation_acc_new = false;		// já usados no alinhamento
+		estimation_mag_new = false;
+	}
+
+	uint32_t elapsed = timestamp - estimation_last;
+	if(elapsed > ESTIMATION_MAX_DT_US)
+		elapsed = ESTIMATION_MAX_DT_US;
+	estimation_last = timestamp;
+
+	float dt = (float)elapsed * 1e-6f;
+	uint8_t used;
+	if(eskf) {
+		used = prv_eskf_step(pv_vec3_load(gyro), acc, mag, dt);
+		estimation_out.attitude = estimation_eskf.attitude;
+		estimation_out.rate     = estimation_eskf.rate;
+	} else {
+		used = c_estimation_ahrs_update(&estimation_ahrs, pv_vec3_load(gyro), acc, mag, dt);
+		estimation_out.attitude = estimation_ahrs.attitude;
+		estimation_out.rate     = estimation_ahrs.rate;
+	}
+
+	estimation_out.timestamp = timestamp;
+	estimation_out.sequence++;
+	estimation_out.euler     = pv_quat_to_euler(estimation_out.attitude);
+	estimation_out.flags     = used;		// ESTIMATION_USED_* = AHRS_USED_*
+	xQueueOverwrite(estimation_queue, &estimation_out);
+
+	uint32_t cycles = c_common_perf_cycles() - start;
+	c_common_perf_probe_add(&estimation_probe, cycles, 0);
+#if ESTIMATION_BUDGET_CYCLES
+	if(cycles > ESTIMATION_BUDGET_CYCLES)
+		estimation_probe.frames++;	// passos acima do orçamento (apenas contados)
+#endif
+	return true;
+}
+
+/** \brief Lê a estimativa mais recente, sem bloquear. Pode ser chamada de qualquer task.
+  *
+  * @param  attitude Destino da estimativa.
+  * @retval false se ainda não há estimativa.
+  */
+bool module_estimation_read(EstimationAttitude* attitude) {
+	return estimation_queue && xQueuePeek(estimation_queue, attitude, 0) == pdTRUE;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
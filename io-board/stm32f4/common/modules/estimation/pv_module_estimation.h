@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file    modules/estimation/pv_module_estimation.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Módulo de estimação de atitude, à taxa do giroscópio.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MODULE_ESTIMATION_H
+#define PV_MODULE_ESTIMATION_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+#include "pv_interface_estimation.h"
+#include "c_estimation_ahrs.h"
+#include "c_estimation_eskf.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Filtro de atitude do módulo. */
+typedef enum {
+	ESTIMATION_MAHONY = 0,		//!< Complementar PI (c_estimation_ahrs), com bias do giroscópio.
+	ESTIMATION_MADGWICK,		//!< Complementar de passo fixo (c_estimation_ahrs), sem bias.
+	ESTIMATION_ESKF				//!< Kalman de estado de erro (c_estimation_eskf), com bias e covariância.
+} EstimationFilter;
+
+/* Exported constants --------------------------------------------------------*/
+/** Orçamento de um passo, em ciclos, derivado do pior caso do probe "ESTIM update" medido na placa.
+  * 0: ainda não medido, e os passos acima dele não são contados. */
+#ifndef ESTIMATION_BUDGET_CYCLES
+#define ESTIMATION_BUDGET_CYCLES	0
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+bool module_estimation_init(EstimationFilter filter);
+void module_estimation_acc(const float acc[3], uint32_t timestamp);
+void module_estimation_mag(const float mag[3], uint32_t timestamp);
+bool module_estimation_update(const float gyro[3], uint32_t timestamp);
+bool module_estimation_read(EstimationAttitude* attitude);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MODULE_ESTIMATION_H
@@ -0,0 +1,443 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_adxl345.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do acelerômetro ADXL345.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_io_adxl345.h"
+
+#include "c_common_i2c.h"
+#include "c_common_i2c_bus.h"
+#include "c_common_gpio.h"
+#include "c_common_ringbuffer.h"
+#include "c_io_sampler.h"
+
+/* FreeRTOS kernel includes */
+#include "task.h"
+#include "semphr.h"
+
+/** @addtogroup Module_IO
+  * @{
+  */
+
+/** @addtogroup Module_IO_Component_ADXL345
+  *	\brief Componente para o acelerômetro de 3 eixos ADXL345.
+  *
+  * Configura fundo de escala (sempre em resolução plena, 3,9 mg/LSB) e taxa de saída, e oferece dois
+  * modos de amostragem:
+  *
+  * - Cadeia de \ref Module_IO_Component_Sampler (c_io_adxl345_attach()): uma leitura de 6 bytes por
+  *   período do timer, adequada a taxas de saída até a do timer.
+  * - FIFO (c_io_adxl345_fifo_start()): o sensor acumula amostras em modo stream, e o pino INT1 sobe ao
+  *   atingir o nível \b watermark. A interrupção externa dispara o esvaziamento, feito inteiramente
+  *   nas interrupções: FIFO_STATUS informa a quantidade de amostras, e cada uma é lida em sequência. Há
+  *   uma interrupção (e, para a task, um aviso) a cada \b watermark amostras, o que permite 800 a
+  *   3200 Hz sem acordar a task a cada amostra.
+  *
+  * O sensor só avança a FIFO ao fim da leitura de DATAZ1, e o auto-incremento segue para FIFO_CTL;
+  * por isso cada amostra custa uma leitura de 6 bytes, e não há como ler várias numa só rajada.
+  * Entre uma amostra e a seguinte, o barramento é liberado (ver c_common_i2c_add_idle_hook()): a
+  * cadeia de aquisição, registrada antes, tem preferência.
+  *
+  * Os instantes das amostras são reconstituídos a partir da taxa de saída: a amostra que completa o
+  * \b watermark é a do instante da interrupção, e as demais estão a um período umas das outras.
+  *
+  * Os dois modos são exclusivos: as leituras da cadeia também consumiriam a FIFO.
+  *
+  * No gerenciador do barramento (ver \ref Common_Components_I2C_Bus), o esvaziamento é o cliente de
+  * interrupção "adxl fifo", cuja latência é medida da borda (ou do fim da leitura anterior) ao fim de
+  * cada leitura; as demais transações são pedidos do cliente "adxl345".
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** \brief Fase do esvaziamento da FIFO. */
+typedef enum {
+	ADXL_DRAIN_IDLE = 0,	//!< Aguardando a interrupção do sensor.
+	ADXL_DRAIN_STATUS,		//!< Lendo FIFO_STATUS.
+	ADXL_DRAIN_ENTRIES		//!< Lendo as amostras.
+} ADXLDrain;
+
+/** \brief Amostra no buffer circular. */
+typedef struct {
+	uint32_t 	timestamp;
+	uint8_t 	data[ADXL345_READ_LENGTH];
+} ADXLRecord;
+
+/* Private define ------------------------------------------------------------*/
+
+// Registradores
+#define ADXL_DEVID			0x00
+#define ADXL_BW_RATE		0x2C
+#define ADXL_POWER_CTL		0x2D
+#define ADXL_INT_ENABLE		0x2E
+#define ADXL_INT_MAP		0x2F
+#define ADXL_DATA_FORMAT	0x31
+#define ADXL_DATAX0			0x32
+#define ADXL_FIFO_CTL		0x38
+#define ADXL_FIFO_STATUS	0x39
+
+#define ADXL_ID				0xE5
+#define ADXL_MEASURE		0x08
+#define ADXL_FULL_RES		0x08
+#define ADXL_FIFO_STREAM	0x80
+#define ADXL_INT_WATERMARK	0x02
+#define ADXL_ENTRIES_MASK	0x3F
+
+// Pino INT1 do sensor
+#define ADXL_INT_PORT		GPIOE
+#define ADXL_INT_PIN		GPIO_Pin_1
+#define ADXL_EXTI_PORT		EXTI_PortSourceGPIOE
+#define ADXL_EXTI_SOURCE	EXTI_PinSource1
+#define ADXL_EXTI_LINE		EXTI_Line1			// Tem que ser a mesma do pino
+#define ADXL_EXTI_IRQ		EXTI1_IRQn
+
+#define ADXL_RING_SIZE		1024				//!< Bytes do buffer circular (potência de 2): 85 amostras.
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+uint8_t 			adxl345_address = 0;		//! Endereço do sensor; 0 antes de c_io_adxl345_init().
+uint32_t 			adxl345_hz;					//! Taxa de saída, em Hz.
+uint8_t 			adxl345_watermark;			//! Nível da FIFO que dispara a interrupção.
+
+volatile ADXLDrain 	adxl345_phase = ADXL_DRAIN_IDLE;
+volatile bool 		adxl345_waiting = false;	//! Próxima leitura do esvaziamento à espera do barramento.
+uint32_t 			adxl345_waiting_since;		//! c_common_perf_cycles() quando a leitura passou a esperar.
+int 				adxl345_remaining;			//! Amostras ainda a ler.
+uint32_t 			adxl345_anchor;				//! Instante da interrupção, em us.
+int 				adxl345_index;				//! Posição da próxima amostra em relação à do instante de adxl345_anchor.
+uint8_t 			adxl345_status;				//! Destino da leitura de FIFO_STATUS.
+ADXLRecord 			adxl345_record;				//! Destino da leitura de uma amostra.
+I2CTransfer 		adxl345_status_read;
+I2CTransfer 		adxl345_entry_read;
+
+ADXL345FifoStats 	adxl345_stats;
+RingBuffer 			adxl345_ring;
+uint8_t 			adxl345_storage[ADXL_RING_SIZE];
+xSemaphoreHandle 	adxl345_ready = 0;			//! Liberado a cada esvaziamento.
+I2CClient 			adxl345_client;				//! Cliente do barramento (identificação, configuração e leituras avulsas).
+I2CClient 			adxl345_fifo_client;		//! Cliente de interrupção do esvaziamento.
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Põe a próxima leitura do esvaziamento à espera do barramento. */
+static void prv_drain_wait(void) {
+	adxl345_waiting_since = c_common_perf_cycles();
+	adxl345_waiting 	  = true;
+}
+
+/** \brief Submete a próxima leitura do esvaziamento, se houver uma à espera e o barramento estiver livre.
+ *  Também é o gancho de periférico livre da I2C.
+ */
+static bool prv_drain(void) {
+	if(!adxl345_waiting || c_common_i2c_busy())
+		return false;
+
+	adxl345_waiting = false;
+	if(c_common_i2c_client_submit(&adxl345_fifo_client, adxl345_phase == ADXL_DRAIN_STATUS ? &adxl345_status_read : &adxl345_entry_read,
+			adxl345_waiting_since))
+		return true;
+
+	// barramento preso: as transações das tasks o recuperam, e a leitura segue à espera do gancho. Se
+	// o esvaziamento fosse abandonado, INT1 continuaria ativo sem uma nova borda, e a FIFO não seria lida.
+	adxl345_stats.errors++;
+	adxl345_waiting = true;
+	return false;
+}
+
+/** \brief Inicia um esvaziamento. Chamada com a prioridade de interrupção da I2C. */
+static void prv_drain_begin(void) {
+	adxl345_phase = ADXL_DRAIN_STATUS;
+	prv_drain_wait();
+	prv_drain();
+}
+
+/** \brief Encerra um esvaziamento. Se o nível voltou a ser atingido durante ele, ou segue atingido após
+ *  um erro, não haverá nova borda em INT1: um novo esvaziamento é iniciado.
+ */
+static void prv_drain_end(void) {
+	adxl345_phase = ADXL_DRAIN_IDLE;
+	if(GPIO_ReadInputDataBit(ADXL_INT_PORT, ADXL_INT_PIN))
+		prv_drain_begin();
+}
+
+/** \brief Fim da leitura de FIFO_STATUS (interrupção da I2C). */
+static void prv_status_done(I2CTransfer* transfer) {
+	int entries = adxl345_status & ADXL_ENTRIES_MASK;
+
+	c_common_i2c_client_complete(&adxl345_fifo_client, transfer);
+	if(transfer->result != I2C_RESULT_OK) {
+		adxl345_stats.errors++;
+		prv_drain_end();
+		return;
+	}
+	if(!entries) {
+		adxl345_phase = ADXL_DRAIN_IDLE;
+		return;
+	}
+	if(entries >= ADXL345_FIFO_SIZE)
+		adxl345_stats.overruns++;
+
+	adxl345_remaining 	= entries;
+	adxl345_phase 		= ADXL_DRAIN_ENTRIES;
+	prv_drain_wait(); // submetida pelo gancho, depois dos clientes mais prioritários
+}
+
+/** \brief Fim da leitura de uma amostra (interrupção da I2C). */
+static void prv_entry_done(I2CTransfer* transfer) {
+	portBASE_TYPE woken = pdFALSE;
+
+	c_common_i2c_client_complete(&adxl345_fifo_client, transfer);
+	adxl345_record.timestamp = adxl345_anchor + (int32_t)((int64_t)adxl345_index * 1000000 / (int32_t)adxl345_hz);
+	adxl345_index++;
+
+	if(transfer->result != I2C_RESULT_OK)
+		adxl345_stats.errors++;
+	else if(c_common_ringbuffer_free(&adxl345_ring) < sizeof(ADXLRecord))
+		adxl345_stats.dropped++;
+	else {
+		const uint8_t* bytes = (const uint8_t*)&adxl345_record;
+		for(unsigned int i = 0; i < sizeof(ADXLRecord); i++)
+			c_common_ringbuffer_put(&adxl345_ring, bytes[i]);
+		adxl345_stats.samples++;
+	}
+
+	if(--adxl345_remaining > 0) {
+		prv_drain_wait();
+		return;
+	}
+
+	adxl345_stats.batches++;
+	if(adxl345_ready) {
+		xSemaphoreGiveFromISR(adxl345_ready, &woken);
+		portEND_SWITCHING_ISR(woken);
+	}
+
+	// as amostras do novo esvaziamento, se houver, seguem as já lidas
+	prv_drain_end();
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Identifica e configura o sensor, em modo de medição e com a FIFO desligada (bypass).
+ *
+ * @param address Endereço de 7 bits (0x53 ou 0x1D, conforme o pino SDO/ALT ADDRESS).
+ * @param range Fundo de escala.
+ * @param rate Taxa de saída de dados.
+ * @retval true caso o sensor tenha respondido e sido configurado.
+ */
+bool c_io_adxl345_init(uint8_t address, ADXL345Range range, ADXL345Rate rate) {
+	uint8_t id = 0;
+	I2CTransfer devId = { .device = address, .reg = ADXL_DEVID, .rxData = &id, .rxLength = 1 };
+	I2CInitStep steps[] = {
+		{ address, ADXL_POWER_CTL, 		0, 							0 },	// standby durante a configuração
+		{ address, ADXL_INT_ENABLE, 	0, 							0 },
+		{ address, ADXL_FIFO_CTL, 		0, 							0 },	// bypass
+		{ address, ADXL_DATA_FORMAT, 	ADXL_FULL_RES | range, 		0 },
+		{ address, ADXL_BW_RATE, 		rate, 						0 },	// rajada com POWER_CTL
+		{ address, ADXL_POWER_CTL, 		ADXL_MEASURE, 				0 },
+	};
+	int count = sizeof(steps)/sizeof(steps[0]);
+
+	adxl345_address = 0;
+	c_common_i2c_client_init(&adxl345_client, "adxl345", I2C_PRIORITY_NORMAL);
+	if(c_common_i2c_request(&adxl345_client, &devId) != I2C_RESULT_OK || id != ADXL_ID)
+		return false;
+	if(c_common_i2c_request_sequence(&adxl345_client, steps, count) != count)
+		return false;
+
+	adxl345_hz 		= 100 << (rate - ADXL345_RATE_100HZ);
+	adxl345_address = address;
+	return true;
+}
+
+/** \brief Anexa a leitura do sensor à cadeia de aquisição (ver c_io_sampler_add()).
+ *
+ * @retval Posição dos 6 bytes em SamplerSet.data, a converter com c_io_adxl345_convert(); -1 se o
+ * sensor não foi inicializado ou a cadeia estiver cheia.
+ */
+int c_io_adxl345_attach(void) {
+	if(!adxl345_address)
+		return -1;
+
+	return c_io_sampler_add(adxl345_address, ADXL_DATAX0, ADXL345_READ_LENGTH);
+}
+
+/** \brief Lê e converte uma amostra, aguardando a transação.
+ *
+ * @param sample Destino da amostra (com o instante do fim da leitura).
+ * @retval true caso a leitura tenha sido concluída.
+ */
+bool c_io_adxl345_read(ADXL345Sample* sample) {
+	uint8_t raw[ADXL345_READ_LENGTH];
+	I2CTransfer transfer = { .device = adxl345_address, .reg = ADXL_DATAX0, .rxData = raw, .rxLength = ADXL345_READ_LENGTH };
+
+	if(!adxl345_address || c_common_i2c_request(&adxl345_client, &transfer) != I2C_RESULT_OK)
+		return false;
+
+	c_io_adxl345_convert(raw, sample);
+	sample->timestamp = c_io_sampler_micros();
+	return true;
+}
+
+/** \brief Converte uma leitura bruta (6 bytes, little endian, a partir de DATAX0). Não altera \b timestamp.
+ *
+ * @param raw Bytes lidos.
+ * @param sample Destino da amostra.
+ */
+void c_io_adxl345_convert(const uint8_t* raw, ADXL345Sample* sample) {
+	for(int i = 0; i < 3; i++) {
+		sample->raw[i] = (int16_t)(raw[2*i] | (raw[2*i + 1] << 8));
+		sample->acc[i] = (float)sample->raw[i] * ADXL345_MS2_PER_LSB;
+	}
+}
+
+/** \brief Liga a FIFO em modo stream, com interrupção (INT1) ao atingir \b watermark amostras.
+ *
+ * Configura a interrupção externa do pino INT1 e registra o gancho de esvaziamento na I2C; deve ser
+ * chamada depois de c_io_sampler_init(), se a cadeia de aquisição também for usada, para que ela tenha
+ * preferência no barramento. A base de tempo de \ref Module_IO_Component_Sampler (TIM5) deve estar
+ * inicializada.
+ *
+ * @param watermark Amostras por esvaziamento, de 1 a 31.
+ * @retval true caso o sensor tenha sido configurado.
+ */
+bool c_io_adxl345_fifo_start(uint8_t watermark) {
+	NVIC_InitTypeDef NVIC_InitStructure;
+	EXTI_InitTypeDef EXTI_InitStructure;
+	I2CInitStep steps[] = {
+		{ adxl345_address, ADXL_INT_ENABLE, 	0, 								0 },	// rajada com INT_MAP
+		{ adxl345_address, ADXL_INT_MAP, 		0, 								0 },	// todas em INT1
+		{ adxl345_address, ADXL_FIFO_CTL, 		0, 								0 },	// bypass esvazia a FIFO
+		{ adxl345_address, ADXL_FIFO_CTL, 		ADXL_FIFO_STREAM | watermark, 	0 },
+		{ adxl345_address, ADXL_INT_ENABLE, 	ADXL_INT_WATERMARK, 			0 },
+	};
+	int count = sizeof(steps)/sizeof(steps[0]);
+
+	if(!adxl345_address || !watermark || watermark >= ADXL345_FIFO_SIZE)
+		return false;
+
+	adxl345_watermark 	= watermark;
+	adxl345_phase 		= ADXL_DRAIN_IDLE;
+	adxl345_waiting 	= false;
+	adxl345_stats 		= (ADXL345FifoStats){0};
+	adxl345_status_read = (I2CTransfer){ .device = adxl345_address, .reg = ADXL_FIFO_STATUS,
+										 .rxData = &adxl345_status, .rxLength = 1, .done = prv_status_done };
+	adxl345_entry_read 	= (I2CTransfer){ .device = adxl345_address, .reg = ADXL_DATAX0,
+										 .rxData = adxl345_record.data, .rxLength = ADXL345_READ_LENGTH, .done = prv_entry_done };
+	c_common_ringbuffer_init(&adxl345_ring, adxl345_storage, ADXL_RING_SIZE);
+	if(!adxl345_ready)
+		vSemaphoreCreateBinary(adxl345_ready);
+	if(adxl345_ready)
+		xSemaphoreTake(adxl345_ready, 0);
+	if(!c_common_i2c_client_init(&adxl345_fifo_client, "adxl fifo", I2C_PRIORITY_HIGH) || !c_common_i2c_add_idle_hook(prv_drain))
+		return false;
+
+	/* Pino INT1 como entrada, ligado à interrupção externa */
+	c_common_gpio_init(ADXL_INT_PORT, ADXL_INT_PIN, GPIO_Mode_IN);
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+	SYSCFG_EXTILineConfig(ADXL_EXTI_PORT, ADXL_EXTI_SOURCE);
+
+	EXTI_InitStructure.EXTI_Line = ADXL_EXTI_LINE;
+	EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+	EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising; // INT1 ativo em nível alto
+	EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+	EXTI_Init(&EXTI_InitStructure);
+
+	NVIC_InitStructure.NVIC_IRQChannel = ADXL_EXTI_IRQ;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = I2C_IRQ_PRIORITY; // não interrompe nem é interrompida pela I2C
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	if(c_common_i2c_request_sequence(&adxl345_client, steps, count) != count)
+		return false;
+
+	// o nível pode ter sido atingido antes de a interrupção ser habilitada
+	taskENTER_CRITICAL();
+	if(adxl345_phase == ADXL_DRAIN_IDLE && GPIO_ReadInputDataBit(ADXL_INT_PORT, ADXL_INT_PIN)) {
+		adxl345_anchor = c_io_sampler_micros();
+		adxl345_index  = 1 - adxl345_watermark;
+		prv_drain_begin();
+	}
+	taskEXIT_CRITICAL();
+
+	return true;
+}
+
+/** \brief Retira a amostra mais antiga do modo FIFO, sem bloquear.
+ *
+ * @param sample Destino da amostra.
+ * @retval true caso havia uma amostra disponível.
+ */
+bool c_io_adxl345_fifo_read(ADXL345Sample* sample) {
+	ADXLRecord record;
+
+	if(c_common_ringbuffer_count(&adxl345_ring) < sizeof(ADXLRecord))
+		return false;
+	if(c_common_ringbuffer_read(&adxl345_ring, (uint8_t*)&record, sizeof(ADXLRecord)) != sizeof(ADXLRecord))
+		return false;
+
+	c_io_adxl345_convert(record.data, sample);
+	sample->timestamp = record.timestamp;
+	return true;
+}
+
+/** \brief Retira a amostra mais antiga do modo FIFO, aguardando por até \b ticks o próximo esvaziamento.
+ *
+ * Deve haver um único consumidor.
+ *
+ * @param sample Destino da amostra.
+ * @param ticks Tempo máximo de espera.
+ * @retval true caso uma amostra tenha sido lida.
+ */
+bool c_io_adxl345_fifo_wait(ADXL345Sample* sample, portTickType ticks) {
+	if(c_io_adxl345_fifo_read(sample))
+		return true;
+	if(!adxl345_ready || xSemaphoreTake(adxl345_ready, ticks) != pdTRUE)
+		return false;
+
+	return c_io_adxl345_fifo_read(sample);
+}
+
+/** \brief Retorna os contadores do modo FIFO.
+ *
+ * @retval Cópia dos contadores.
+ */
+ADXL345FifoStats c_io_adxl345_fifo_stats(void) {
+	ADXL345FifoStats stats;
+
+	taskENTER_CRITICAL(); // mascara EXTI e I2C (prioridade abaixo de configMAX_SYSCALL_INTERRUPT_PRIORITY)
+	stats = adxl345_stats;
+	taskEXIT_CRITICAL();
+
+	return stats;
+}
+
+/* IRQ handlers ------------------------------------------------------------- */
+
+void EXTI1_IRQHandler(void) {
+	EXTI_ClearITPendingBit(ADXL_EXTI_LINE);
+
+	if(adxl345_phase != ADXL_DRAIN_IDLE)
+		return; // o esvaziamento em andamento verifica o pino ao terminar
+
+	// a amostra que completou o nível é a deste instante
+	adxl345_anchor = c_io_sampler_micros();
+	adxl345_index  = 1 - adxl345_watermark;
+	prv_drain_begin();
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
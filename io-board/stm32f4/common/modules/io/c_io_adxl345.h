@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_adxl345.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do acelerômetro ADXL345.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_IO_ADXL345_H
+#define C_IO_ADXL345_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "FreeRTOS.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Fundo de escala (DATA_FORMAT). Em resolução plena, a sensibilidade é sempre 3,9 mg/LSB. */
+typedef enum {
+	ADXL345_RANGE_2G = 0,
+	ADXL345_RANGE_4G,
+	ADXL345_RANGE_8G,
+	ADXL345_RANGE_16G
+} ADXL345Range;
+
+/** \brief Taxa de saída de dados (BW_RATE). */
+typedef enum {
+	ADXL345_RATE_100HZ = 0x0A,
+	ADXL345_RATE_200HZ,
+	ADXL345_RATE_400HZ,
+	ADXL345_RATE_800HZ,
+	ADXL345_RATE_1600HZ,
+	ADXL345_RATE_3200HZ
+} ADXL345Rate;
+
+/** \brief Leitura convertida. */
+typedef struct {
+	uint32_t 	timestamp;		//!< Instante da amostra, em us (ver c_io_sampler_micros()); preenchido pelo modo FIFO.
+	float 		acc[3];			//!< Aceleração em X, Y e Z, em m/s^2.
+	int16_t 	raw[3];			//!< Valores brutos de X, Y e Z.
+} ADXL345Sample;
+
+/** \brief Contadores do modo FIFO (ver c_io_adxl345_fifo_stats()). */
+typedef struct {
+	uint32_t 	batches;		//!< Esvaziamentos da FIFO.
+	uint32_t 	samples;		//!< Amostras armazenadas.
+	uint32_t 	overruns;		//!< Esvaziamentos que encontraram a FIFO cheia (amostras antigas perdidas).
+	uint32_t 	dropped;		//!< Amostras descartadas por buffer cheio.
+	uint32_t 	errors;			//!< Leituras com falha.
+} ADXL345FifoStats;
+
+/* Exported constants --------------------------------------------------------*/
+#define ADXL345_READ_LENGTH		6		//!< Bytes de uma leitura: DATAX0 a DATAZ1.
+#define ADXL345_FIFO_SIZE		32		//!< Amostras na FIFO do sensor.
+#define ADXL345_MS2_PER_LSB		(0.0039f * 9.80665f)	//!< Escala nominal (folha de dados): 3,9 mg/LSB em resolução plena.
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+bool c_io_adxl345_init(uint8_t address, ADXL345Range range, ADXL345Rate rate);
+int  c_io_adxl345_attach(void);
+bool c_io_adxl345_read(ADXL345Sample* sample);
+void c_io_adxl345_convert(const uint8_t* raw, ADXL345Sample* sample);
+
+bool c_io_adxl345_fifo_start(uint8_t watermark);
+bool c_io_adxl345_fifo_read(ADXL345Sample* sample);
+bool c_io_adxl345_fifo_wait(ADXL345Sample* sample, portTickType ticks);
+ADXL345FifoStats c_io_adxl345_fifo_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_IO_ADXL345_H
@@ -0,0 +1,584 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_calibration.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Calibração dos sensores da IMU, com coeficientes persistentes em flash.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_io_calibration.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** @addtogroup Module_IO
+  * @{
+  */
+
+/** @addtogroup Module_IO_Component_Calibration
+  *	\brief Calibração do acelerômetro, do giroscópio e do magnetômetro, aplicada às contagens brutas.
+  *
+  * Cada sensor tem um mapa (CalibrationMap) que leva as contagens brutas direto às unidades físicas,
+  * com a escala nominal, o desalinhamento e o bias já combinados: a conversão de uma amostra é
+  * c_io_calibration_apply(), 9 multiplicações-somas fundidas. Sem calibração, o mapa é a escala
+  * nominal informada em c_io_calibration_init().
+  *
+  * Os procedimentos são pedidos por c_io_calibration_begin(), de qualquer task, e alimentados com
+  * c_io_calibration_feed() pela task que lê os sensores; todo o estado da coleta, e os mapas, só são
+  * alterados nela. Os procedimentos são:
+  * - Giroscópio: média de 1000 amostras em repouso; o bias entra no offset.
+  * - Acelerômetro: o sensor é apoiado nas 6 faces (cada eixo para cima e para baixo). A cada 500
+  *   amostras em repouso, a face é reconhecida pelo eixo dominante e a média registrada; com as 6,
+  *   matriz e offset saem de um ajuste por mínimos quadrados às 6 gravidades esperadas (escala,
+  *   desalinhamento e bias).
+  * - Magnetômetro: o sensor é girado em todas as direções; ao menos 600 amostras são ajustadas a um
+  *   elipsoide de eixos alinhados aos do sensor. O centro é o hard iron; as razões entre os raios, o
+  *   soft iron (diagonal), que torna o elipsoide uma esfera de raio igual ao médio.
+  *
+  * Uma coleta em que o sensor se move (desvio padrão acima do limite) é descartada e recomeçada.
+  *
+  * Os coeficientes são gravados por c_io_calibration_save() no setor 11 da flash (128 KB, reservado
+  * em stm32_flash.ld), como um registro acrescentado após os anteriores; o setor só é apagado quando
+  * fica cheio (~780 gravações). Apagar o setor para a CPU por 1 a 2 s, e gravar um registro por ~1 ms
+  * (as leituras da flash esperam): só se deve gravar com o veículo em solo. Na carga, vale o último
+  * registro íntegro, e apenas os mapas feitos com a mesma escala nominal da configuração atual.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+
+/** Registro gravado na flash. */
+typedef struct {
+	uint32_t 		magic;								//!< CAL_MAGIC; gravado por último.
+	uint32_t 		calibrated;							//!< Bits dos mapas calibrados.
+	float 			nominal[CALIBRATION_SENSORS];		//!< Escalas nominais com que os mapas foram feitos.
+	CalibrationMap 	maps[CALIBRATION_SENSORS];
+	uint32_t 		checksum;							//!< Fletcher-32 dos campos anteriores.
+} CalibrationRecord;
+
+/** Acumulador de uma janela de amostras em repouso (inteiro: exato e sem FPU). */
+typedef struct {
+	int32_t 		count;
+	int64_t 		sum[3];
+	int64_t 		squares[3];
+} CalibrationStill;
+
+/** Ação pedida por outra task, executada em c_io_calibration_feed(). */
+typedef enum {
+	CAL_ACTION_NONE = 0,
+	CAL_ACTION_BEGIN,
+	CAL_ACTION_RESET
+} CalibrationAction;
+
+/* Private define ------------------------------------------------------------*/
+
+// Armazenamento (setor 11: os últimos 128 KB; o fim de FLASH em stm32_flash.ld deve coincidir)
+#define CAL_FLASH_SECTOR		FLASH_Sector_11
+#define CAL_FLASH_START			0x080E0000
+#define CAL_FLASH_SIZE			(128 * 1024)
+#define CAL_FLASH_FLAGS			(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+#define CAL_MAGIC				0x314C4143	//!< "CAL1".
+#define CAL_RECORD_WORDS		(sizeof(CalibrationRecord) / sizeof(uint32_t))
+#define CAL_SLOTS				(CAL_FLASH_SIZE / sizeof(CalibrationRecord))
+#define CAL_NOMINAL_TOLERANCE	1e-4f		//!< Diferença relativa máxima entre escalas nominais de um registro e as atuais.
+
+// Coletas
+#define CAL_GYRO_SAMPLES		1000
+#define CAL_GYRO_STILL			0.02f		//!< Desvio padrão máximo em repouso, em rad/s (~1,1 graus/s).
+#define CAL_ACC_SAMPLES			500
+#define CAL_ACC_STILL			0.2f		//!< Desvio padrão máximo em repouso, em m/s^2.
+#define CAL_ACC_POSE			0.9f		//!< Fração mínima da norma no eixo dominante para reconhecer a face.
+#define CAL_ACC_SCALE_ERROR		0.2f		//!< Desvio máximo da escala ajustada em relação à nominal.
+#define CAL_GRAVITY				9.80665f
+#define CAL_MAG_SAMPLES			600
+#define CAL_MAG_NORMALIZE		(1.0f / 512.0f)	//!< Leva as contagens para ~1, condicionando as somas em float.
+#define CAL_MAG_RATIO			2.0f		//!< Razão máxima entre os raios do elipsoide.
+
+#define CAL_MAX_UNKNOWNS		6
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+CalibrationMap 		calibration_maps[CALIBRATION_SENSORS];		//! Mapas em uso.
+float 				calibration_nominal[CALIBRATION_SENSORS];	//! Escalas nominais (unidade por LSB).
+uint8_t 			calibration_calibrated = 0;					//! Bits dos mapas calibrados.
+CalibrationStatus 	calibration_status;							//! Andamento, alterado apenas em c_io_calibration_feed().
+
+volatile CalibrationAction 	calibration_action = CAL_ACTION_NONE;	//! Pedido à espera de c_io_calibration_feed().
+volatile CalibrationSensor 	calibration_action_sensor;
+
+CalibrationStill 	calibration_still;							//! Janela em repouso (acelerômetro e giroscópio).
+float 				calibration_poses[6][3];					//! Médias brutas de cada face do acelerômetro.
+float 				calibration_normal[CAL_MAX_UNKNOWNS][CAL_MAX_UNKNOWNS];	//! Equações normais do magnetômetro.
+float 				calibration_rhs[CAL_MAX_UNKNOWNS];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Mapa nominal: escala na diagonal, sem offset. */
+static void prv_default(CalibrationMap* map, float nominal) {
+	memset(map, 0, sizeof(*map));
+	for(int i = 0; i < 3; i++)
+		map->matrix[i][i] = nominal;
+}
+
+/** \brief Troca o mapa em uso; chamada apenas pela task de c_io_calibration_feed(), ou antes dela existir. */
+static void prv_install(CalibrationSensor sensor, const CalibrationMap* map, bool calibrated) {
+	taskENTER_CRITICAL(); // c_io_calibration_save() pode estar copiando
+	calibration_maps[sensor] = *map;
+	if(calibrated)
+		calibration_calibrated |= 1 << sensor;
+	else
+		calibration_calibrated &= ~(1 << sensor);
+	taskEXIT_CRITICAL();
+}
+
+/** \brief Resolve A x = b (n incógnitas) por eliminação de Gauss com pivoteamento parcial.
+ *  A e b são destruídos; a solução fica em b.
+ *  @retval false se o sistema for (numericamente) singular.
+ */
+static bool prv_solve(float a[][CAL_MAX_UNKNOWNS], float* b, int n) {
+	float scale = 0.0f;
+
+	for(int i = 0; i < n; i++)
+		scale = fmaxf(scale, fabsf(a[i][i]));
+
+	for(int col = 0; col < n; col++) {
+		int pivot = col;
+		for(int row = col + 1; row < n; row++)
+			if(fabsf(a[row][col]) > fabsf(a[pivot][col]))
+				pivot = row;
+		if(fabsf(a[pivot][col]) <= scale * 1e-6f)
+			return false;
+
+		if(pivot != col) {
+			for(int k = 0; k < n; k++) {
+				float t = a[col][k]; a[col][k] = a[pivot][k]; a[pivot][k] = t;
+			}
+			float t = b[col]; b[col] = b[pivot]; b[pivot] = t;
+		}
+
+		for(int row = col + 1; row < n; row++) {
+			float f = a[row][col] / a[col][col];
+			for(int k = col; k < n; k++)
+				a[row][k] = fmaf(-f, a[col][k], a[row][k]);
+			b[row] = fmaf(-f, b[col], b[row]);
+		}
+	}
+
+	for(int row = n - 1; row >= 0; row--) {
+		float x = b[row];
+		for(int k = row + 1; k < n; k++)
+			x = fmaf(-a[row][k], b[k], x);
+		b[row] = x / a[row][row];
+	}
+	return true;
+}
+
+/** \brief Acrescenta uma amostra à janela em repouso.
+ *  @param limit Desvio padrão máximo, em contagens.
+ *  @retval true quando a janela de \b window amostras se completa em repouso; \b mean recebe a média.
+ *  Uma janela completa com movimento é descartada.
+ */
+static bool prv_still_add(const int16_t raw[3], int32_t window, float limit, float mean[3]) {
+	CalibrationStill* still = &calibration_still;
+
+	for(int i = 0; i < 3; i++) {
+		still->sum[i] 	  += raw[i];
+		still->squares[i] += (int32_t)raw[i] * raw[i];
+	}
+	if(++still->count < window)
+		return false;
+
+	bool steady = true;
+	for(int i = 0; i < 3; i++) {
+		// variância * n^2, exata em inteiros
+		int64_t spread = still->squares[i] * window - still->sum[i] * still->sum[i];
+		steady = steady && (float)spread <= limit * limit * (float)window * (float)window;
+		mean[i] = (float)still->sum[i] / (float)window;
+	}
+
+	*still = (CalibrationStill){0};
+	return steady;
+}
+
+/** \brief Bias do giroscópio: o offset passa a anular a média em repouso, com a matriz atual. */
+static void prv_finish_gyro(const float mean[3]) {
+	CalibrationMap map = calibration_maps[CALIBRATION_GYRO];
+
+	for(int i = 0; i < 3; i++)
+		map.offset[i] = -(map.matrix[i][0] * mean[0] + map.matrix[i][1] * mean[1] + map.matrix[i][2] * mean[2]);
+
+	prv_install(CALIBRATION_GYRO, &map, true);
+	calibration_status.state = CALIBRATION_DONE;
+}
+
+/** \brief Ajuste das 6 faces: para cada eixo de saída, [m 1] . [linha offset] = gravidade esperada,
+ *  por mínimos quadrados (as mesmas equações normais 4x4 para os 3 eixos).
+ */
+static void prv_finish_acc(void) {
+	float nominal = calibration_nominal[CALIBRATION_ACC];
+	float normal[4][4] = {{0}};
+	float phi[6][4];
+	CalibrationMap map;
+
+	for(int pose = 0; pose < 6; pose++) {
+		for(int i = 0; i < 3; i++)
+			phi[pose][i] = calibration_poses[pose][i] * nominal;
+		phi[pose][3] = 1.0f;
+		for(int r = 0; r < 4; r++)
+			for(int c = 0; c < 4; c++)
+				normal[r][c] = fmaf(phi[pose][r], phi[pose][c], normal[r][c]);
+	}
+
+	for(int axis = 0; axis < 3; axis++) {
+		float a[CAL_MAX_UNKNOWNS][CAL_MAX_UNKNOWNS];
+		float b[CAL_MAX_UNKNOWNS] = {0};
+
+		for(int r = 0; r < 4; r++) {
+			for(int c = 0; c < 4; c++)
+				a[r][c] = normal[r][c];
+			// faces 2*axis (+) e 2*axis + 1 (-) esperam +g e -g neste eixo; as demais, 0
+			b[r] = CAL_GRAVITY * (phi[2*axis][r] - phi[2*axis + 1][r]);
+		}
+		if(!prv_solve(a, b, 4) || fabsf(b[axis] - 1.0f) > CAL_ACC_SCALE_ERROR) {
+			calibration_status.state = CALIBRATION_FAILED;
+			return;
+		}
+		for(int i = 0; i < 3; i++)
+			map.matrix[axis][i] = b[i] * nominal;
+		map.offset[axis] = b[3];
+	}
+
+	prv_install(CALIBRATION_ACC, &map, true);
+	calibration_status.state = CALIBRATION_DONE;
+}
+
+/** \brief Registra a face do acelerômetro de uma média em repouso, pelo eixo dominante. */
+static void prv_acc_pose(const float mean[3]) {
+	int axis = 0;
+
+	for(int i = 1; i < 3; i++)
+		if(fabsf(mean[i]) > fabsf(mean[axis]))
+			axis = i;
+
+	float norm = sqrtf(mean[0]*mean[0] + mean[1]*mean[1] + mean[2]*mean[2]);
+	if(fabsf(mean[axis]) < CAL_ACC_POSE * norm)
+		return; // inclinado: nenhuma face
+
+	int pose = 2*axis + (mean[axis] < 0.0f);
+	for(int i = 0; i < 3; i++)
+		calibration_poses[pose][i] = mean[i];
+	calibration_status.poses |= 1 << pose;
+
+	if(calibration_status.poses == CALIBRATION_ALL_POSES)
+		prv_finish_acc();
+}
+
+/** \brief Acumula uma amostra do magnetômetro nas equações normais de
+ *  A x^2 + B y^2 + C z^2 + D x + E y + F z = 1.
+ */
+static void prv_mag_add(const int16_t raw[3]) {
+	float phi[CAL_MAX_UNKNOWNS];
+
+	for(int i = 0; i < 3; i++) {
+		phi[3 + i] = (float)raw[i] * CAL_MAG_NORMALIZE;
+		phi[i] 	   = phi[3 + i] * phi[3 + i];
+	}
+	for(int r = 0; r < CAL_MAX_UNKNOWNS; r++) {
+		for(int c = 0; c < CAL_MAX_UNKNOWNS; c++)
+			calibration_normal[r][c] = fmaf(phi[r], phi[c], calibration_normal[r][c]);
+		calibration_rhs[r] += phi[r];
+	}
+}
+
+/** \brief Centro e raios do elipsoide ajustado; o mapa o leva a uma esfera de raio médio. */
+static void prv_finish_mag(void) {
+	float nominal = calibration_nominal[CALIBRATION_MAG];
+	float* p = calibration_rhs;
+	float center[3], radius[3];
+	float g = 1.0f;
+	CalibrationMap map;
+
+	if(!prv_solve(calibration_normal, p, CAL_MAX_UNKNOWNS) || p[0] <= 0.0f || p[1] <= 0.0f || p[2] <= 0.0f) {
+		calibration_status.state = CALIBRATION_FAILED;
+		return;
+	}
+
+	for(int i = 0; i < 3; i++) {
+		center[i] = -p[3 + i] / (2.0f * p[i]);
+		g += p[3 + i] * p[3 + i] / (4.0f * p[i]);
+	}
+	for(int i = 0; i < 3; i++)
+		radius[i] = sqrtf(g / p[i]);
+
+	float smallest = fminf(radius[0], fminf(radius[1], radius[2]));
+	float largest  = fmaxf(radius[0], fmaxf(radius[1], radius[2]));
+	if(largest > CAL_MAG_RATIO * smallest) {
+		calibration_status.state = CALIBRATION_FAILED; // cobertura insuficiente, ou interferência forte
+		return;
+	}
+
+	float mean = (radius[0] + radius[1] + radius[2]) / 3.0f;
+	memset(&map, 0, sizeof(map));
+	for(int i = 0; i < 3; i++) {
+		float scale = nominal * mean / radius[i];
+		map.matrix[i][i] = scale;
+		map.offset[i] 	 = -scale * center[i] / CAL_MAG_NORMALIZE;
+	}
+
+	prv_install(CALIBRATION_MAG, &map, true);
+	calibration_status.state = CALIBRATION_DONE;
+}
+
+/** \brief Executa a ação pedida por outra task, se for para este sensor. */
+static void prv_take_action(CalibrationSensor sensor) {
+	CalibrationAction action;
+
+	taskENTER_CRITICAL();
+	action = calibration_action_sensor == sensor ? calibration_action : CAL_ACTION_NONE;
+	if(action != CAL_ACTION_NONE)
+		calibration_action = CAL_ACTION_NONE;
+	taskEXIT_CRITICAL();
+
+	if(action == CAL_ACTION_RESET) {
+		CalibrationMap map;
+		prv_default(&map, calibration_nominal[sensor]);
+		prv_install(sensor, &map, false);
+	}
+	else if(action == CAL_ACTION_BEGIN) {
+		calibration_still = (CalibrationStill){0};
+		memset(calibration_normal, 0, sizeof(calibration_normal));
+		memset(calibration_rhs, 0, sizeof(calibration_rhs));
+		calibration_status.sensor  = sensor;
+		calibration_status.samples = 0;
+		calibration_status.poses   = 0;
+		calibration_status.state   = CALIBRATION_RUNNING;
+	}
+}
+
+/** \brief Pede uma ação, a ser executada na próxima amostra do sensor. */
+static bool prv_request(CalibrationSensor sensor, CalibrationAction action) {
+	if(sensor >= CALIBRATION_SENSORS)
+		return false;
+
+	taskENTER_CRITICAL();
+	calibration_action_sensor = sensor;
+	calibration_action 		  = action;
+	taskEXIT_CRITICAL();
+	return true;
+}
+
+/** \brief Soma de verificação do registro (Fletcher-32); o periférico CRC é da telemetria. */
+static uint32_t prv_checksum(const CalibrationRecord* record) {
+	const uint16_t* half = (const uint16_t*)record;
+	uint32_t a = 0xFFFF, b = 0xFFFF;
+
+	for(unsigned int i = 0; i < offsetof(CalibrationRecord, checksum) / sizeof(uint16_t); i++) {
+		a = (a + half[i]) % 65535;
+		b = (b + a) % 65535;
+	}
+	return (b << 16) | a;
+}
+
+/** \brief Posição \b slot do setor. */
+static const CalibrationRecord* prv_slot(unsigned int slot) {
+	return (const CalibrationRecord*)(CAL_FLASH_START + slot * sizeof(CalibrationRecord));
+}
+
+/** \brief Verifica se uma posição do setor está apagada (todas as palavras em 0xFFFFFFFF). */
+static bool prv_erased(unsigned int slot) {
+	const uint32_t* word = (const uint32_t*)prv_slot(slot);
+
+	for(unsigned int i = 0; i < CAL_RECORD_WORDS; i++)
+		if(word[i] != 0xFFFFFFFF)
+			return false;
+	return true;
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Inicializa os mapas com as escalas nominais e carrega os coeficientes gravados.
+ *
+ * Deve ser chamada de uma task (usa seções críticas), com os sensores já configurados.
+ *
+ * @param nominal Unidade física por LSB de cada sensor, na configuração atual (ex.:
+ * ADXL345_MS2_PER_LSB, ITG3205_RAD_PER_LSB, c_io_hmc5883l_ut_per_lsb()).
+ */
+void c_io_calibration_init(const float nominal[CALIBRATION_SENSORS]) {
+	calibration_action = CAL_ACTION_NONE;
+	calibration_status = (CalibrationStatus){0};
+	for(int s = 0; s < CALIBRATION_SENSORS; s++) {
+		CalibrationMap map;
+		calibration_nominal[s] = nominal[s];
+		prv_default(&map, nominal[s]);
+		prv_install((CalibrationSensor)s, &map, false);
+	}
+
+	c_io_calibration_load();
+}
+
+/** \brief Mapa em uso de um sensor, para c_io_calibration_apply().
+ *
+ * O endereço é fixo: pode ser guardado pela task que converte as amostras.
+ *
+ * @param sensor Sensor.
+ * @retval Mapa do sensor.
+ */
+const CalibrationMap* c_io_calibration_map(CalibrationSensor sensor) {
+	return &calibration_maps[sensor];
+}
+
+/** \brief Pede o início do procedimento de um sensor (ver \ref Module_IO_Component_Calibration).
+ *
+ * Substitui um procedimento em curso. O andamento é acompanhado por c_io_calibration_status().
+ *
+ * @param sensor Sensor.
+ * @retval false se o sensor for inválido.
+ */
+bool c_io_calibration_begin(CalibrationSensor sensor) {
+	return prv_request(sensor, CAL_ACTION_BEGIN);
+}
+
+/** \brief Pede a volta do mapa de um sensor à escala nominal.
+ *
+ * @param sensor Sensor.
+ * @retval false se o sensor for inválido.
+ */
+bool c_io_calibration_reset(CalibrationSensor sensor) {
+	return prv_request(sensor, CAL_ACTION_RESET);
+}
+
+/** \brief Entrega uma amostra bruta ao procedimento em curso. Deve ser chamada pela task que lê os
+ *  sensores, a cada amostra (amostras com overflow não devem ser entregues).
+ *
+ * @param sensor Sensor da amostra.
+ * @param raw Contagens brutas de X, Y e Z.
+ */
+void c_io_calibration_feed(CalibrationSensor sensor, const int16_t raw[3]) {
+	float mean[3];
+
+	if(calibration_action != CAL_ACTION_NONE)
+		prv_take_action(sensor);
+	if(calibration_status.state != CALIBRATION_RUNNING || calibration_status.sensor != sensor)
+		return;
+
+	switch(sensor) {
+	case CALIBRATION_GYRO:
+		if(prv_still_add(raw, CAL_GYRO_SAMPLES, CAL_GYRO_STILL / calibration_nominal[sensor], mean))
+			prv_finish_gyro(mean);
+		calibration_status.samples = calibration_still.count;
+		break;
+	case CALIBRATION_ACC:
+		if(prv_still_add(raw, CAL_ACC_SAMPLES, CAL_ACC_STILL / calibration_nominal[sensor], mean))
+			prv_acc_pose(mean);
+		calibration_status.samples = calibration_still.count;
+		break;
+	case CALIBRATION_MAG:
+		prv_mag_add(raw);
+		if(++calibration_status.samples >= CAL_MAG_SAMPLES)
+			prv_finish_mag();
+		break;
+	default:
+		break;
+	}
+}
+
+/** \brief Retorna o andamento do procedimento e quais sensores estão calibrados.
+ *
+ * @retval Cópia do andamento.
+ */
+CalibrationStatus c_io_calibration_status(void) {
+	CalibrationStatus status;
+
+	taskENTER_CRITICAL();
+	status = calibration_status;
+	status.calibrated = calibration_calibrated;
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+/** \brief Grava os mapas em uso no setor reservado (ver \ref Module_IO_Component_Calibration).
+ *
+ * Para a CPU enquanto a flash é escrita (e, com o setor cheio, por 1 a 2 s para apagá-lo). Não deve
+ * ser chamada de interrupções.
+ *
+ * @retval true caso o registro tenha sido gravado e conferido.
+ */
+bool c_io_calibration_save(void) {
+	CalibrationRecord record;
+	const uint32_t* words = (const uint32_t*)&record;
+	unsigned int slot = CAL_SLOTS;
+	bool ok = true;
+
+	taskENTER_CRITICAL();
+	memcpy(record.maps, calibration_maps, sizeof(record.maps));
+	record.calibrated = calibration_calibrated;
+	taskEXIT_CRITICAL();
+	record.magic = CAL_MAGIC;
+	memcpy(record.nominal, calibration_nominal, sizeof(record.nominal));
+	record.checksum = prv_checksum(&record);
+
+	// a seguir do último registro escrito
+	while(slot > 0 && prv_erased(slot - 1))
+		slot--;
+
+	FLASH_Unlock();
+	FLASH_ClearFlag(CAL_FLASH_FLAGS);
+	if(slot >= CAL_SLOTS) {
+		ok = FLASH_EraseSector(CAL_FLASH_SECTOR, VoltageRange_3) == FLASH_COMPLETE;
+		slot = 0;
+	}
+
+	// magic por último: um registro interrompido não é reconhecido
+	uint32_t address = (uint32_t)prv_slot(slot);
+	for(unsigned int i = 1; ok && i < CAL_RECORD_WORDS; i++)
+		ok = FLASH_ProgramWord(address + i * sizeof(uint32_t), words[i]) == FLASH_COMPLETE;
+	if(ok)
+		ok = FLASH_ProgramWord(address, words[0]) == FLASH_COMPLETE;
+	FLASH_Lock();
+
+	return ok && memcmp(prv_slot(slot), &record, sizeof(record)) == 0;
+}
+
+/** \brief Carrega o último registro íntegro do setor reservado.
+ *
+ * Os mapas gravados com outra escala nominal (ex.: o fundo de escala mudou) são ignorados.
+ *
+ * @retval true caso algum mapa tenha sido carregado.
+ */
+bool c_io_calibration_load(void) {
+	const CalibrationRecord* latest = 0;
+	bool loaded = false;
+
+	for(unsigned int slot = 0; slot < CAL_SLOTS; slot++) {
+		const CalibrationRecord* record = prv_slot(slot);
+		if(record->magic == CAL_MAGIC && record->checksum == prv_checksum(record))
+			latest = record;
+	}
+	if(!latest)
+		return false;
+
+	for(int s = 0; s < CALIBRATION_SENSORS; s++) {
+		float difference = fabsf(latest->nominal[s] - calibration_nominal[s]);
+		if(!(latest->calibrated & (1 << s)) || difference > CAL_NOMINAL_TOLERANCE * fabsf(calibration_nominal[s]))
+			continue;
+		prv_install((CalibrationSensor)s, &latest->maps[s], true);
+		loaded = true;
+	}
+	return loaded;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_calibration.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Calibração dos sensores da IMU, com coeficientes persistentes em flash.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_IO_CALIBRATION_H
+#define C_IO_CALIBRATION_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Sensores calibrados. */
+typedef enum {
+	CALIBRATION_ACC = 0,			//!< Acelerômetro, em m/s^2: 6 posições.
+	CALIBRATION_GYRO,				//!< Giroscópio, em rad/s: bias em repouso.
+	CALIBRATION_MAG,				//!< Magnetômetro, em uT: hard iron e soft iron.
+	CALIBRATION_SENSORS
+} CalibrationSensor;
+
+/** \brief Estado do procedimento de calibração (ver c_io_calibration_status()). */
+typedef enum {
+	CALIBRATION_IDLE = 0,			//!< Nenhum procedimento pedido.
+	CALIBRATION_RUNNING,			//!< Coletando amostras.
+	CALIBRATION_DONE,				//!< Coeficientes novos em uso (ainda não gravados).
+	CALIBRATION_FAILED				//!< Coleta insuficiente ou ajuste mal condicionado; coeficientes mantidos.
+} CalibrationState;
+
+/** \brief Mapa de contagens brutas para unidades físicas: out = matrix * raw + offset.
+  *
+  * A escala nominal do sensor, o desalinhamento (ou o soft iron) e o bias (ou o hard iron) estão
+  * todos pré-combinados na matriz e no offset.
+  */
+typedef struct {
+	float 	matrix[3][3];
+	float 	offset[3];
+} CalibrationMap;
+
+/** \brief Andamento do procedimento em curso. */
+typedef struct {
+	CalibrationSensor 	sensor;		//!< Sensor do último procedimento pedido.
+	CalibrationState 	state;
+	uint16_t 			samples;	//!< Amostras aceitas na coleta atual.
+	uint8_t 			poses;		//!< Acelerômetro: bits das posições já registradas (+X, -X, +Y, -Y, +Z, -Z).
+	uint8_t 			calibrated;	//!< Bits dos sensores com coeficientes calibrados (e não nominais).
+} CalibrationStatus;
+
+/* Exported constants --------------------------------------------------------*/
+#define CALIBRATION_ALL_POSES		0x3F	//!< Todas as 6 posições do acelerômetro.
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+void c_io_calibration_init(const float nominal[CALIBRATION_SENSORS]);
+const CalibrationMap* c_io_calibration_map(CalibrationSensor sensor);
+bool c_io_calibration_begin(CalibrationSensor sensor);
+bool c_io_calibration_reset(CalibrationSensor sensor);
+void c_io_calibration_feed(CalibrationSensor sensor, const int16_t raw[3]);
+CalibrationStatus c_io_calibration_status(void);
+bool c_io_calibration_save(void);
+bool c_io_calibration_load(void);
+
+/* Header-defined wrapper functions ----------------------------------------- */
+/** @addtogroup Module_IO
+  * @{
+  */
+/** @addtogroup Module_IO_Component_Calibration
+  * @{
+  */
+
+/** \brief Converte uma amostra bruta: 3 conversões e 9 multiplicações-somas fundidas (VFMA).
+ *
+ * @param map Mapa do sensor (c_io_calibration_map()).
+ * @param raw Contagens brutas de X, Y e Z.
+ * @param out Destino, em unidades físicas.
+ */
+static inline void c_io_calibration_apply(const CalibrationMap* map, const int16_t raw[3], float out[3]) {
+	float x = (float)raw[0], y = (float)raw[1], z = (float)raw[2];
+
+	for(int i = 0; i < 3; i++)
+		out[i] = fmaf(map->matrix[i][2], z, fmaf(map->matrix[i][1], y, fmaf(map->matrix[i][0], x, map->offset[i])));
+}
+
+/**
+  * @}
+  */
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_IO_CALIBRATION_H
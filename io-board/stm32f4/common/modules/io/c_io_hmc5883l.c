@@ -0,0 +1,183 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_hmc5883l.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do magnetômetro HMC5883L.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_io_hmc5883l.h"
+
+#include "c_common_i2c.h"
+#include "c_common_i2c_bus.h"
+#include "c_io_sampler.h"
+
+/** @addtogroup Module_IO
+  * @{
+  */
+
+/** @addtogroup Module_IO_Component_HMC5883L
+  *	\brief Componente para o magnetômetro de 3 eixos HMC5883L.
+  *
+  * O sensor é configurado em medição contínua a 75 Hz (a maior taxa desse modo), com média de 8
+  * medidas internas. Cada leitura é uma rajada de 6 bytes, de DATA X MSB a DATA Y LSB; ler os 6
+  * libera os registradores para a medida seguinte.
+  *
+  * A leitura é anexada à cadeia de \ref Module_IO_Component_Sampler com uma divisão de taxa
+  * (c_io_hmc5883l_attach()), de modo que ocupa o barramento apenas uma vez a cada ~14 ms, e não a
+  * cada período do giroscópio:
+  * \code{.c}
+  * c_io_hmc5883l_init(0x1E, HMC5883L_GAIN_1_3GA);
+  * int mag = c_io_hmc5883l_attach(1000);	// a cada 14 conjuntos: 71,4 Hz
+  * ...
+  * if(set.status & 0x02)	// segunda leitura da cadeia: só nos períodos em que foi feita
+  * 	c_io_hmc5883l_convert(&set.data[mag], &sample);
+  * \endcode
+  *
+  * A conversão usa apenas aritmética inteira: o campo sai em nT, por um fator em ponto fixo (Q8)
+  * escolhido na inicialização conforme o ganho. Eixos em overflow (-4096) são sinalizados em
+  * HMC5883LSample.flags e zerados, para não contaminar o campo com um valor espúrio.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+// Registradores
+#define HMC_CRA				0x00
+#define HMC_CRB				0x01
+#define HMC_MODE			0x02
+#define HMC_DATA_X_MSB		0x03
+#define HMC_ID_A			0x0A
+
+#define HMC_ID_LENGTH		3		//!< ID_A a ID_C: "H43".
+#define HMC_AVERAGE_8		0x60	//!< MA = 3: média de 8 medidas por saída.
+#define HMC_RATE_75HZ		0x18	//!< DO = 6: 75 Hz.
+#define HMC_GAIN_SHIFT		5
+#define HMC_CONTINUOUS		0x00
+
+#define HMC_START_MS		7		//!< Primeira medida após entrar no modo contínuo (~1/75 s, menos a espera do I2C).
+
+#define HMC_OVERFLOW		(-4096)	//!< Valor de um eixo em overflow.
+#define HMC_RAW_MIN			(-2048)	//!< Faixa de saída válida.
+#define HMC_RAW_MAX			2047
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+uint8_t hmc5883l_address = 0;	//! Endereço do sensor; 0 antes de c_io_hmc5883l_init().
+int32_t hmc5883l_scale = 0;		//! nT por LSB, em Q8, para o ganho configurado.
+I2CClient hmc5883l_client;		//! Cliente do barramento (transações fora da cadeia de aquisição).
+
+/** nT por LSB, em Q8 (100000 * 256 / LSB por Gauss), para cada ganho. */
+static const int32_t hmc5883l_scales[] = { 18686, 23486, 31220, 38788, 58182, 65641, 77576, 111304 };
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Identifica o sensor e o coloca em medição contínua a 75 Hz.
+ *
+ * @param address Endereço de 7 bits (0x1E).
+ * @param gain Fundo de escala; o campo da Terra (~0,6 Ga) cabe no padrão, HMC5883L_GAIN_1_3GA.
+ * @retval true caso o sensor tenha respondido e sido configurado.
+ */
+bool c_io_hmc5883l_init(uint8_t address, HMC5883LGain gain) {
+	uint8_t id[HMC_ID_LENGTH] = {0};
+	I2CTransfer identify = { .device = address, .reg = HMC_ID_A, .rxData = id, .rxLength = HMC_ID_LENGTH };
+	I2CInitStep steps[] = {
+		{ address, HMC_CRA, 	HMC_AVERAGE_8 | HMC_RATE_75HZ, 		0 },	// rajada até MODE
+		{ address, HMC_CRB, 	gain << HMC_GAIN_SHIFT, 			0 },
+		{ address, HMC_MODE, 	HMC_CONTINUOUS, 					HMC_START_MS },
+	};
+	int count = sizeof(steps)/sizeof(steps[0]);
+
+	hmc5883l_address = 0;
+	c_common_i2c_client_init(&hmc5883l_client, "hmc5883l", I2C_PRIORITY_NORMAL);
+	if(c_common_i2c_request(&hmc5883l_client, &identify) != I2C_RESULT_OK || id[0] != 'H' || id[1] != '4' || id[2] != '3')
+		return false;
+	if(c_common_i2c_request_sequence(&hmc5883l_client, steps, count) != count)
+		return false;
+
+	hmc5883l_scale = hmc5883l_scales[gain];
+	hmc5883l_address = address;
+	return true;
+}
+
+/** \brief Anexa a leitura do sensor à cadeia de aquisição, a cada quantos períodos forem necessários
+ *  para acompanhar os 75 Hz do sensor (ver c_io_sampler_add_every()).
+ *
+ * A divisão é arredondada para cima: a leitura nunca é mais rápida que o sensor, e toda leitura traz
+ * uma medida nova. Arredondada para baixo, a 1 kHz a leitura sairia a 76,9 Hz, e cerca de duas
+ * medidas por segundo seriam repetições entregues como novas; em troca, ocasionalmente uma medida
+ * é lida com um período de atraso, ou descartada.
+ *
+ * @param sampler_hz Taxa da cadeia (a de c_io_sampler_init()).
+ * @retval Posição dos 6 bytes em SamplerSet.data, a converter com c_io_hmc5883l_convert(); -1 se o
+ * sensor não foi inicializado ou a cadeia estiver cheia.
+ */
+int c_io_hmc5883l_attach(uint32_t sampler_hz) {
+	uint32_t every = (sampler_hz + HMC5883L_RATE_HZ - 1) / HMC5883L_RATE_HZ;
+
+	if(!hmc5883l_address)
+		return -1;
+
+	return c_io_sampler_add_every(hmc5883l_address, HMC_DATA_X_MSB, HMC5883L_READ_LENGTH, every ? every : 1);
+}
+
+/** \brief Lê e converte uma amostra, aguardando a transação.
+ *
+ * @param sample Destino da amostra.
+ * @retval true caso a leitura tenha sido concluída (ver também HMC5883LSample.flags).
+ */
+bool c_io_hmc5883l_read(HMC5883LSample* sample) {
+	uint8_t raw[HMC5883L_READ_LENGTH];
+	I2CTransfer transfer = { .device = hmc5883l_address, .reg = HMC_DATA_X_MSB, .rxData = raw, .rxLength = HMC5883L_READ_LENGTH };
+
+	if(!hmc5883l_address || c_common_i2c_request(&hmc5883l_client, &transfer) != I2C_RESULT_OK)
+		return false;
+
+	c_io_hmc5883l_convert(raw, sample);
+	return true;
+}
+
+/** \brief Converte uma leitura bruta (6 bytes, big endian, na ordem X, Z, Y), sem ponto flutuante.
+ *
+ * @param raw Bytes lidos.
+ * @param sample Destino da amostra, com os eixos na ordem X, Y, Z.
+ */
+void c_io_hmc5883l_convert(const uint8_t* raw, HMC5883LSample* sample) {
+	static const uint8_t order[3] = { 0, 2, 1 }; // posição de X, Y e Z na leitura
+
+	sample->flags = 0;
+	for(int i = 0; i < 3; i++) {
+		int16_t value = (int16_t)((raw[2*order[i]] << 8) | raw[2*order[i] + 1]);
+
+		sample->raw[i] = value;
+		if(value == HMC_OVERFLOW) {
+			sample->flags |= HMC5883L_FLAG_OVERFLOW;
+			sample->field[i] = 0;
+			continue;
+		}
+		if(value <= HMC_RAW_MIN || value >= HMC_RAW_MAX)
+			sample->flags |= HMC5883L_FLAG_SATURATED;
+		sample->field[i] = ((int32_t)value * hmc5883l_scale + 128) >> 8; // arredondado
+	}
+}
+
+/** \brief Escala nominal do ganho configurado, para quem converte em ponto flutuante (ex.: \ref Module_IO_Component_Calibration).
+ *
+ * @retval uT por LSB; 0 antes de c_io_hmc5883l_init().
+ */
+float c_io_hmc5883l_ut_per_lsb(void) {
+	return (float)hmc5883l_scale * (1.0f / 256000.0f); // Q8, nT -> uT
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_hmc5883l.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do magnetômetro HMC5883L.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_IO_HMC5883L_H
+#define C_IO_HMC5883L_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Ganho (CRB), pelo fundo de escala em Gauss. */
+typedef enum {
+	HMC5883L_GAIN_0_88GA = 0,		//!< +/- 0,88 Ga, 1370 LSB/Ga.
+	HMC5883L_GAIN_1_3GA,			//!< +/- 1,3 Ga, 1090 LSB/Ga (padrão).
+	HMC5883L_GAIN_1_9GA,			//!< +/- 1,9 Ga, 820 LSB/Ga.
+	HMC5883L_GAIN_2_5GA,			//!< +/- 2,5 Ga, 660 LSB/Ga.
+	HMC5883L_GAIN_4_0GA,			//!< +/- 4,0 Ga, 440 LSB/Ga.
+	HMC5883L_GAIN_4_7GA,			//!< +/- 4,7 Ga, 390 LSB/Ga.
+	HMC5883L_GAIN_5_6GA,			//!< +/- 5,6 Ga, 330 LSB/Ga.
+	HMC5883L_GAIN_8_1GA				//!< +/- 8,1 Ga, 230 LSB/Ga.
+} HMC5883LGain;
+
+/** \brief Leitura convertida, apenas com aritmética inteira. */
+typedef struct {
+	int32_t 	field[3];		//!< Campo em X, Y e Z, em nT (0 nos eixos em overflow).
+	int16_t 	raw[3];			//!< Valores brutos de X, Y e Z (o sensor os envia na ordem X, Z, Y).
+	uint8_t 	flags;			//!< HMC5883L_FLAG_OVERFLOW e/ou HMC5883L_FLAG_SATURATED.
+} HMC5883LSample;
+
+/* Exported constants --------------------------------------------------------*/
+#define HMC5883L_READ_LENGTH		6		//!< Bytes de uma leitura: DATA X MSB a DATA Y LSB.
+#define HMC5883L_RATE_HZ			75		//!< Taxa do modo de medição contínua.
+
+#define HMC5883L_FLAG_OVERFLOW		0x01	//!< Algum eixo em overflow (o sensor retorna -4096): leitura inválida.
+#define HMC5883L_FLAG_SATURATED		0x02	//!< Algum eixo no limite da faixa de saída (-2048 ou 2047): aumentar o ganho.
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+bool c_io_hmc5883l_init(uint8_t address, HMC5883LGain gain);
+int  c_io_hmc5883l_attach(uint32_t sampler_hz);
+bool c_io_hmc5883l_read(HMC5883LSample* sample);
+void c_io_hmc5883l_convert(const uint8_t* raw, HMC5883LSample* sample);
+float c_io_hmc5883l_ut_per_lsb(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_IO_HMC5883L_H
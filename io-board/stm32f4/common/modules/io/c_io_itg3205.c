@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_itg3205.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do giroscópio ITG3205.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_io_itg3205.h"
+
+#include "c_common_i2c.h"
+#include "c_common_i2c_bus.h"
+#include "c_io_sampler.h"
+
+/** @addtogroup Module_IO
+  * @{
+  */
+
+/** @addtogroup Module_IO_Component_ITG3205
+  *	\brief Componente para o giroscópio de 3 eixos ITG3205.
+  *
+  * Configura o fundo de escala (+/- 2000 graus/s, o único suportado), o filtro, a divisão da taxa
+  * de amostragem e o clock (PLL do giro X, mais estável que o oscilador interno). Cada leitura é uma
+  * rajada de 8 bytes, de TEMP_OUT_H a GYRO_ZOUT_L, convertida com fatores de escala constantes.
+  *
+  * Para amostrar a 1 kHz sem ocupar a CPU, a leitura é anexada à cadeia de \ref Module_IO_Component_Sampler
+  * (c_io_itg3205_attach()), e apenas a conversão é feita pela task que consome os conjuntos:
+  * \code{.c}
+  * c_io_itg3205_init(0x68, ITG3205_DLPF_42HZ, 0);	// 1 kHz / (0 + 1)
+  * int gyro = c_io_itg3205_attach();
+  * ...
+  * c_io_itg3205_convert(&set.data[gyro], &sample);
+  * \endcode
+  *
+  * Com c_io_itg3205_enable_data_ready(), o pino INT sinaliza cada amostra nova, e pode disparar a
+  * cadeia no lugar do timer (SAMPLER_TRIGGER_DATA_READY).
+  *
+  * As demais transações (identificação, configuração e c_io_itg3205_read()) são pedidos do cliente
+  * "itg3205" ao gerenciador do barramento (ver \ref Common_Components_I2C_Bus).
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+
+// Registradores
+#define ITG_WHO_AM_I		0x00
+#define ITG_SMPLRT_DIV		0x15
+#define ITG_DLPF_FS			0x16
+#define ITG_INT_CFG			0x17
+#define ITG_INT_STATUS		0x1A
+#define ITG_TEMP_OUT_H		0x1B
+#define ITG_PWR_MGM			0x3E
+
+#define ITG_ID_MASK			0x7E	//!< Bits de identificação em WHO_AM_I.
+#define ITG_ID				0x68
+#define ITG_FS_SEL_2000		0x18	//!< FS_SEL = 3, exigido pelo fabricante.
+#define ITG_H_RESET			0x80
+#define ITG_CLK_PLL_X		0x01
+#define ITG_LATCH_INT_EN	0x20	//!< INT retido até ser limpo (em vez de um pulso de 50 us).
+#define ITG_INT_ANYRD		0x10	//!< Limpo pela leitura de qualquer registrador.
+#define ITG_RAW_RDY_EN		0x01	//!< INT ao haver dado pronto.
+
+#define ITG_RESET_MS		5		//!< Espera após o reset e após a troca de clock (PLL).
+
+// Escala da temperatura (folha de dados): 280 LSB/graus C, com -13200 a 35 graus C
+#define ITG_DEG_C_PER_LSB	(1.0f / 280.0f)
+#define ITG_TEMP_OFFSET		13200
+#define ITG_TEMP_REFERENCE	35.0f
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+uint8_t itg3205_address = 0;	//! Endereço do sensor; 0 antes de c_io_itg3205_init().
+I2CClient itg3205_client;		//! Cliente do barramento (transações fora da cadeia de aquisição).
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Identifica e configura o sensor.
+ *
+ * @param address Endereço de 7 bits (0x68 ou 0x69, conforme o pino AD0).
+ * @param filter Filtro passa-baixas; define também a taxa interna (8 kHz ou 1 kHz).
+ * @param divider Taxa de amostragem = taxa interna / (\b divider + 1).
+ * @retval true caso o sensor tenha respondido e sido configurado.
+ */
+bool c_io_itg3205_init(uint8_t address, ITG3205Filter filter, uint8_t divider) {
+	uint8_t id = 0;
+	I2CTransfer whoAmI = { .device = address, .reg = ITG_WHO_AM_I, .rxData = &id, .rxLength = 1 };
+	I2CInitStep steps[] = {
+		{ address, ITG_PWR_MGM, 	ITG_H_RESET, 					ITG_RESET_MS },
+		{ address, ITG_PWR_MGM, 	ITG_CLK_PLL_X, 					ITG_RESET_MS },
+		{ address, ITG_SMPLRT_DIV, 	divider, 						0 },	// rajada com DLPF_FS
+		{ address, ITG_DLPF_FS, 	ITG_FS_SEL_2000 | filter, 		0 },
+	};
+	int count = sizeof(steps)/sizeof(steps[0]);
+
+	itg3205_address = 0;
+	c_common_i2c_client_init(&itg3205_client, "itg3205", I2C_PRIORITY_NORMAL);
+	if(c_common_i2c_request(&itg3205_client, &whoAmI) != I2C_RESULT_OK || (id & ITG_ID_MASK) != ITG_ID)
+		return false;
+	if(c_common_i2c_request_sequence(&itg3205_client, steps, count) != count)
+		return false;
+
+	itg3205_address = address;
+	return true;
+}
+
+/** \brief Anexa a leitura do sensor à cadeia de aquisição (ver c_io_sampler_add()).
+ *
+ * @retval Posição dos 8 bytes em SamplerSet.data, a converter com c_io_itg3205_convert(); -1 se o
+ * sensor não foi inicializado ou a cadeia estiver cheia.
+ */
+int c_io_itg3205_attach(void) {
+	if(!itg3205_address)
+		return -1;
+
+	return c_io_sampler_add(itg3205_address, ITG_TEMP_OUT_H, ITG3205_READ_LENGTH);
+}
+
+/** \brief Habilita o sinal de dado pronto no pino INT (ativo em nível alto, push-pull).
+ *
+ * O sinal fica retido até a leitura de um registrador, de modo que a própria leitura da amostra o
+ * limpa, e a próxima amostra gera uma nova borda.
+ *
+ * @retval true caso o sensor tenha sido configurado.
+ */
+bool c_io_itg3205_enable_data_ready(void) {
+	uint8_t config = ITG_LATCH_INT_EN | ITG_INT_ANYRD | ITG_RAW_RDY_EN;
+	I2CTransfer transfer = { .device = itg3205_address, .reg = ITG_INT_CFG, .txData = &config, .txLength = 1 };
+
+	return itg3205_address && c_common_i2c_request(&itg3205_client, &transfer) == I2C_RESULT_OK;
+}
+
+/** \brief Lê e converte uma amostra, aguardando a transação.
+ *
+ * @param sample Destino da amostra.
+ * @retval true caso a leitura tenha sido concluída.
+ */
+bool c_io_itg3205_read(ITG3205Sample* sample) {
+	uint8_t raw[ITG3205_READ_LENGTH];
+	I2CTransfer transfer = { .device = itg3205_address, .reg = ITG_TEMP_OUT_H, .rxData = raw, .rxLength = ITG3205_READ_LENGTH };
+
+	if(!itg3205_address || c_common_i2c_request(&itg3205_client, &transfer) != I2C_RESULT_OK)
+		return false;
+
+	c_io_itg3205_convert(raw, sample);
+	return true;
+}
+
+/** \brief Converte uma leitura bruta (8 bytes, big endian, a partir de TEMP_OUT_H).
+ *
+ * @param raw Bytes lidos.
+ * @param sample Destino da amostra.
+ */
+void c_io_itg3205_convert(const uint8_t* raw, ITG3205Sample* sample) {
+	int16_t temperature = (int16_t)((raw[0] << 8) | raw[1]);
+
+	sample->temperature = ITG_TEMP_REFERENCE + (float)(temperature + ITG_TEMP_OFFSET) * ITG_DEG_C_PER_LSB;
+	for(int i = 0; i < 3; i++) {
+		sample->raw[i]  = (int16_t)((raw[2 + 2*i] << 8) | raw[3 + 2*i]);
+		sample->rate[i] = (float)sample->raw[i] * ITG3205_RAD_PER_LSB;
+	}
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
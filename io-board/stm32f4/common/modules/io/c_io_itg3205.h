@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_itg3205.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do giroscópio ITG3205.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_IO_ITG3205_H
+#define C_IO_ITG3205_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Filtro passa-baixas interno (DLPF_CFG) e taxa interna correspondente. */
+typedef enum {
+	ITG3205_DLPF_256HZ = 0,		//!< 256 Hz, taxa interna de 8 kHz.
+	ITG3205_DLPF_188HZ,			//!< 188 Hz, taxa interna de 1 kHz (as demais também).
+	ITG3205_DLPF_98HZ,
+	ITG3205_DLPF_42HZ,
+	ITG3205_DLPF_20HZ,
+	ITG3205_DLPF_10HZ,
+	ITG3205_DLPF_5HZ
+} ITG3205Filter;
+
+/** \brief Leitura convertida. */
+typedef struct {
+	float 		rate[3];		//!< Velocidade angular em X, Y e Z, em rad/s.
+	float 		temperature;	//!< Temperatura do sensor, em graus Celsius.
+	int16_t 	raw[3];			//!< Valores brutos de X, Y e Z.
+} ITG3205Sample;
+
+/* Exported constants --------------------------------------------------------*/
+#define ITG3205_READ_LENGTH		8		//!< Bytes de uma leitura: TEMP_OUT_H a GYRO_ZOUT_L.
+#define ITG3205_RAD_PER_LSB		(0.017453293f / 14.375f)	//!< Escala nominal (folha de dados): 14,375 LSB/(graus/s).
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+bool c_io_itg3205_init(uint8_t address, ITG3205Filter filter, uint8_t divider);
+int  c_io_itg3205_attach(void);
+bool c_io_itg3205_enable_data_ready(void);
+bool c_io_itg3205_read(ITG3205Sample* sample);
+void c_io_itg3205_convert(const uint8_t* raw, ITG3205Sample* sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_IO_ITG3205_H
@@ -12,6 +12,7 @@
 
 #include "c_common_gpio.h"
 #include "c_common_uart.h"
+#include "c_common_perf.h"
 
 #include <math.h>
 
@@ -114,7 +115,8 @@
 #define AX_START                    255
 #define BUFFER_SIZE		  			 64
 #define TIME_OUT                    10
-#define TX_DELAY_TIME		    	 400
+#define FLUSH_TIMEOUT_MS			10	//!< Espera máxima pelo fim do envio de um pacote (e do que estava na fila).
+#define MAX_PARAMS					8	//!< Maior quantidade de parâmetros de uma instrução enviada.
 
 #define PIN_CONTROL_PORT		 	 GPIOC
 #define PIN_CONTROL				 	 GPIO_Pin_0
@@ -123,6 +125,12 @@
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 GPIOPin controlPin;
+PerfProbe rx24f_probe;	//! Comandos enviados aos servos (bytes do pacote, tempo bloqueado até o fim do envio).
+
+/* Pacote em envio, fora da pilha: ver prv_send_packet(). */
+uint8_t rx24f_body[3];					//! ID, tamanho e instrução.
+uint8_t rx24f_params[MAX_PARAMS];		//! Parâmetros.
+uint8_t rx24f_checksum;
 
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
@@ -134,10 +142,64 @@ int prv_read_error() {
 
 	return 0;
 }
+
+/** \brief Envia um pacote de instrução ao barramento e aguarda o fim do envio.
+  *
+  * Cabeçalho, corpo (ID, tamanho e instrução), parâmetros e checksum são enfileirados como segmentos
+  * distintos (ver c_common_usart_queue()) e saem em sequência por DMA, sem serem montados num buffer
+  * contíguo.
+  *
+  * O pino de direção só volta para recepção depois que c_common_usart_flush() vê TC, isto é, após o
+  * stop bit do checksum; antes do envio não há espera, pois o transceptor comuta junto com o pino. A
+  * espera dura no máximo FLUSH_TIMEOUT_MS; esgotada, o pino volta mesmo assim, e o pacote é dado como
+  * não enviado. Por isso corpo, parâmetros e checksum ficam em variáveis do módulo, e não na pilha: o
+  * DMA pode ainda lê-los depois do retorno. As funções do módulo devem ser chamadas de uma única task.
+  *
+  * @param  ID ID do servo.
+  * @param  instruction Instrução (AX_PING, AX_READ_DATA, AX_WRITE_DATA, ...).
+  * @param  params Parâmetros da instrução.
+  * @param  count Quantidade de parâmetros.
+  * @retval \b false se a fila de envio da USART recusou o pacote (nada foi enviado), ou se o envio não
+  * terminou em FLUSH_TIMEOUT_MS.
+  */
+static bool prv_send_packet(unsigned char ID, uint8_t instruction, const uint8_t *params, uint8_t count) {
+	static const uint8_t header[2] = { AX_START, AX_START };
+
+	if(count > MAX_PARAMS)
+		return false;
+
+	rx24f_body[0] = ID;
+	rx24f_body[1] = count + 2;
+	rx24f_body[2] = instruction;
+	unsigned int sum = rx24f_body[0] + rx24f_body[1] + rx24f_body[2];
+	for(int i=0; i<count; i++) {
+		rx24f_params[i] = params[i];
+		sum += params[i];
+	}
+	rx24f_checksum = ~sum & 0xFF;
+
+	USARTTxSegment packet[4];
+	int segments = 0;
+	packet[segments++] = (USARTTxSegment){ header, sizeof(header), 0, 0 };
+	packet[segments++] = (USARTTxSegment){ rx24f_body, sizeof(rx24f_body), 0, 0 };
+	if(count)
+		packet[segments++] = (USARTTxSegment){ rx24f_params, count, 0, 0 };
+	packet[segments++] = (USARTTxSegment){ &rx24f_checksum, 1, 0, 0 };
+
+	PERF_PROBE_BEGIN();
+	c_common_gpio_set(controlPin);
+	bool queued = c_common_usart_queue(RXUSART, packet, segments);
+	bool sent = c_common_usart_flush(RXUSART, FLUSH_TIMEOUT_MS / portTICK_RATE_MS);
+	c_common_gpio_reset(controlPin);
+	PERF_PROBE_END(rx24f_probe, queued ? sizeof(header) + sizeof(rx24f_body) + count + 1 : 0);
+
+	return queued && sent;
+}
 /* Exported functions definitions --------------------------------------------*/
 
 /** \brief Inicializa USART6 conectada ao barramento dos servos e o pino de controle.
-  * Desliga interrupt de recebimento (feito via pooling neste caso).
+  * O recebimento das respostas dos servos é feito por DMA circular, com uma interrupção por
+  * pacote de status (linha ociosa), e não uma por byte.
   *
   * \todo Generalizar a inicialização para qualquer USART.
   *
@@ -146,12 +208,13 @@ int prv_read_error() {
   */
 void c_io_rx24f_init(int baudrate) {
 	c_common_usart6_init(baudrate);
-	c_common_usart_it_set(RXUSART, USART_IT_RXNE, ENABLE);
+	c_common_usart_set_rx_mode(RXUSART, USART_RX_MODE_DMA_IDLE);
 	controlPin = c_common_gpio_init(PIN_CONTROL_PORT, PIN_CONTROL, GPIO_Mode_OUT);
+	c_common_perf_register(&rx24f_probe, "RX24F", "command");
 }
 
 /** \brief Move o servo para posição desejada, em graus.
-  * Retorna \b 1 em caso de sucesso.
+  * Retorna \b 1 em caso de sucesso, e \b 0 se o pacote não pôde ser enviado.
   *
   * @param  ID ID do servo.
   * @param  position Posição alvo em graus.
@@ -159,74 +222,29 @@ void c_io_rx24f_init(int baudrate) {
   */
 int c_io_rx24f_move(unsigned char ID, int position) {
 	int hexPosition = round(map(position,0,300,0,1023));
-    unsigned char Position_H, Position_L;
-    Position_H = hexPosition >> 8;
-    Position_L = 0x00FF & hexPosition;
-
-    unsigned int TChecksum = (ID +
-                             AX_GOAL_LENGTH +
-                             AX_WRITE_DATA +
-                             AX_GOAL_POSITION_L +
-                             Position_L +
-                             Position_H);
-    if ( TChecksum >= 255){
-    	TChecksum = TChecksum & 0xFF;
-    }
-
-    unsigned char checksum = 0xFF - TChecksum;
-
-    c_common_gpio_set(controlPin);
-    c_common_usart_putchar(RXUSART, AX_START);
-    c_common_usart_putchar(RXUSART, AX_START);
-    c_common_usart_putchar(RXUSART, ID);
-    c_common_usart_putchar(RXUSART, AX_GOAL_LENGTH);
-    c_common_usart_putchar(RXUSART, AX_WRITE_DATA);
-    c_common_usart_putchar(RXUSART, AX_GOAL_POSITION_L);
-    c_common_usart_putchar(RXUSART, Position_L);
-    c_common_usart_putchar(RXUSART, Position_H);
-    c_common_usart_putchar(RXUSART, checksum);
-    while( !(RXUSART->SR & 0x00000040) );
-    c_common_gpio_reset(controlPin);
+    uint8_t params[3] = { AX_GOAL_POSITION_L, 0x00FF & hexPosition, hexPosition >> 8 };
+
+    if(!prv_send_packet(ID, AX_WRITE_DATA, params, sizeof(params)))
+        return 0;
     //receive answer...
 
 	return 1;
 }
 
 /** \brief Move o servo para posição desejada, em graus.
-  * Retorna \b 1 em caso de sucesso.
+  * Retorna \b 1 em caso de sucesso, e \b 0 se o pacote não pôde ser enviado.
   *
   * @param  ID ID do servo.
   * @param  position Posição alvo em graus.
   * @retval Status.
   */
 int c_io_rx24f_setLed(unsigned char ID, unsigned char value) {
-    unsigned int TChecksum = (ID +
-                             AX_LED_LENGTH +
-                             AX_WRITE_DATA +
-                             AX_LED +
-                             value);
-    while ( TChecksum >= 255){
-		TChecksum -= 255;
-    }
-
-    unsigned char checksum = 0xFF - TChecksum;
-
-    c_common_gpio_set(controlPin);
-    for(int i=0xFFFF; i>0; i--);
-    c_common_usart_putchar(RXUSART, AX_START);
-    c_common_usart_putchar(RXUSART, AX_START);
-    c_common_usart_putchar(RXUSART, ID);
-    c_common_usart_putchar(RXUSART, AX_LED_LENGTH);
-    c_common_usart_putchar(RXUSART, AX_WRITE_DATA);
-    c_common_usart_putchar(RXUSART, AX_LED);
-    c_common_usart_putchar(RXUSART, value);
-    c_common_usart_putchar(RXUSART, checksum);
-    while( !(RXUSART->SR & 0x00000040) );
-    c_common_gpio_reset(controlPin);
+    uint8_t params[2] = { AX_LED, value };
 
+    if(!prv_send_packet(ID, AX_WRITE_DATA, params, sizeof(params)))
+        return 0;
 
-
-	return 1;
+    return 1;
 }
 
 /** \brief Lê a posição atual do servo, em graus.
@@ -236,29 +254,10 @@ int c_io_rx24f_setLed(unsigned char ID, unsigned char value) {
   * @retval Posicao em graus.
   */
 int  c_io_rx24f_readPosition(unsigned char ID) {
-    unsigned int TChecksum = (ID +
-                              AX_POS_LENGTH  +
-                              AX_READ_DATA +
-                              AX_PRESENT_POSITION_L +
-                              AX_BYTE_READ_POS);
-    while ( TChecksum >= 255){
-		TChecksum -= 255;
-    }
-
-    unsigned char checksum = 0xFF - TChecksum;
-
-    c_common_gpio_set(controlPin);
-    for(int i=0xFFFF; i>0; i--);
-    c_common_usart_putchar(RXUSART, AX_START);
-    c_common_usart_putchar(RXUSART, AX_START);
-    c_common_usart_putchar(RXUSART, ID);
-    c_common_usart_putchar(RXUSART, AX_POS_LENGTH);
-    c_common_usart_putchar(RXUSART, AX_READ_DATA);
-    c_common_usart_putchar(RXUSART, AX_PRESENT_POSITION_L);
-    c_common_usart_putchar(RXUSART, AX_BYTE_READ_POS);
-    c_common_usart_putchar(RXUSART, checksum);
-    while( !(RXUSART->SR & 0x00000040) );
-    c_common_gpio_reset(controlPin);
+    uint8_t params[2] = { AX_PRESENT_POSITION_L, AX_BYTE_READ_POS };
+
+    if(!prv_send_packet(ID, AX_READ_DATA, params, sizeof(params)))
+        return -1;
     //receive answer...
 
 	return 1;
@@ -0,0 +1,389 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_sampler.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Aquisição periódica de sensores I2C, disparada por timer.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_io_sampler.h"
+#include "c_common_i2c.h"
+#include "c_common_i2c_bus.h"
+#include "c_common_ringbuffer.h"
+#include "c_common_perf.h"
+#include "c_common_gpio.h"
+
+/* FreeRTOS kernel includes */
+#include "task.h"
+#include "semphr.h"
+
+/** @addtogroup Module_IO
+  * @{
+  */
+
+/** @addtogroup Module_IO_Component_Sampler
+  * \brief Amostragem dos sensores I2C a uma taxa fixa, sem participação de tasks.
+  *
+  * O TIM3 dispara a cada período; o tratador registra o instante (TIM5, 1 MHz, 32 bits) e submete a
+  * primeira leitura de uma cadeia montada na inicialização (c_io_sampler_add()). Alternativamente
+  * (SAMPLER_TRIGGER_DATA_READY), o disparo é a borda do sinal de dado pronto de um sensor, ligado ao
+  * pino PE2: cada amostra é lida uma única vez, assim que fica pronta, e o instante é o da borda. Nesse
+  * modo o TIM3, com o dobro do período, serve de cão de guarda: se o sinal não vier (ex.: um pulso
+  * retido que não foi limpo por uma leitura com falha), a cadeia é disparada assim mesmo. Cada leitura, ao
+  * terminar, submete a seguinte a partir da interrupção da I2C (ver \ref Common_Components_I2C), de
+  * modo que a cadeia inteira roda de uma vez, pelas interrupções e pelo DMA. Ao fim da cadeia, o
+  * conjunto é copiado num buffer circular, consumido por c_io_sampler_read() ou c_io_sampler_wait().
+  *
+  * \code{.c}
+  * int acc = c_io_sampler_add(0x53, 0x32, 6);	// ADXL345: X, Y, Z
+  * c_io_sampler_init(1000, SAMPLER_TRIGGER_TIMER);
+  * c_io_sampler_start();
+  * ...
+  * SamplerSet set;
+  * while(c_io_sampler_wait(&set, portMAX_DELAY))
+  * 	if(set.status & 1)
+  * 		parse(&set.data[acc]);
+  * \endcode
+  *
+  * Se um disparo encontra o barramento ocupado, ou a cadeia anterior ainda em andamento, a cadeia
+  * começa assim que ele se libera (ver c_common_i2c_add_idle_hook()), com o instante do disparo. Se
+  * encontra outro disparo ainda à espera, este é substituído, e um período é perdido
+  * (SamplerStats.missed, e um salto em SamplerSet.sequence). As transações das tasks continuam possíveis nos intervalos;
+  * c_common_i2c_transfer() aguarda a sua vez. A cadeia é um cliente de interrupção do gerenciador do
+  * barramento (ver \ref Common_Components_I2C_Bus, cliente "sampler"): a latência de cada leitura, do
+  * disparo ao seu fim, é medida e enviada com a telemetria de desempenho.
+  * Entre uma leitura e a seguinte, a interrupção aguarda o fim do STOP, no máximo dois períodos de SCL
+  * (ver c_common_i2c_submit()).
+  *
+  * Sensores mais lentos que a cadeia entram com c_io_sampler_add_every(): a leitura é feita apenas
+  * nos períodos múltiplos da divisão (pela SamplerSet.sequence), e nos demais fica fora do conjunto
+  * (bit em 0 em SamplerSet.status), sem ocupar o barramento.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define SAMPLER_IRQ_PRIORITY	I2C_IRQ_PRIORITY	//!< Igual à da I2C: TIM3, EXTI2 e I2C não se interrompem, e a cadeia não precisa de trava.
+#define SAMPLER_RING_SIZE		2048	//!< Bytes do buffer circular (potência de 2): 51 conjuntos.
+
+// Sinal de dado pronto (pino INT do ITG3205)
+#define SAMPLER_DRDY_PORT		GPIOE
+#define SAMPLER_DRDY_PIN		GPIO_Pin_2
+#define SAMPLER_EXTI_PORT		EXTI_PortSourceGPIOE
+#define SAMPLER_EXTI_SOURCE		EXTI_PinSource2
+#define SAMPLER_EXTI_LINE		EXTI_Line2			// Tem que ser a mesma do pino
+#define SAMPLER_EXTI_IRQ		EXTI2_IRQn
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+I2CTransfer 		sampler_links[SAMPLER_MAX_LINKS];	//! Leituras da cadeia, na ordem de execução.
+uint16_t 			sampler_every[SAMPLER_MAX_LINKS];	//! Divisão da taxa de cada leitura (1: todos os períodos).
+int 				sampler_count = 0;					//! Quantidade de leituras na cadeia.
+int 				sampler_bytes = 0;					//! Bytes já atribuídos em SamplerSet.data.
+volatile int 		sampler_current = -1;				//! Leitura em andamento; -1 com a cadeia parada.
+volatile bool 		sampler_pending = false;			//! Disparo à espera do barramento ou do fim da cadeia anterior.
+uint32_t 			sampler_pending_stamp;				//! Instante do disparo à espera, em us.
+uint32_t 			sampler_pending_cycles;				//! c_common_perf_cycles() no disparo à espera.
+uint16_t 			sampler_pending_sequence;			//! Número do período do disparo à espera.
+SamplerTrigger 		sampler_trigger = SAMPLER_TRIGGER_TIMER;
+SamplerSet 			sampler_set;						//! Conjunto em aquisição (destino do DMA).
+uint32_t 			sampler_started;					//! c_common_perf_cycles() no disparo.
+uint16_t 			sampler_sequence = 0;				//! Número do próximo período.
+SamplerStats 		sampler_stats;						//! Contadores.
+RingBuffer 			sampler_ring;						//! Conjuntos prontos.
+uint8_t 			sampler_storage[SAMPLER_RING_SIZE];
+xSemaphoreHandle 	sampler_ready = 0;					//! Liberado a cada conjunto armazenado.
+PerfProbe 			sampler_probe;						//! Duração de cada cadeia, do disparo ao fim.
+I2CClient 			sampler_client;						//! Cliente do barramento (latência de cada leitura desde o disparo).
+
+/* Private function prototypes -----------------------------------------------*/
+static void prv_link_done(I2CTransfer* transfer);
+
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Armazena o conjunto completo e avisa o consumidor. Chamada na interrupção da I2C. */
+static void prv_store(void) {
+	portBASE_TYPE woken = pdFALSE;
+	const uint8_t* bytes = (const uint8_t*)&sampler_set;
+
+	c_common_perf_probe_add(&sampler_probe, c_common_perf_cycles() - sampler_started, sampler_bytes);
+	PERF_PROBE_FRAME(sampler_probe);
+
+	if(c_common_ringbuffer_free(&sampler_ring) < sizeof(SamplerSet)) {
+		sampler_stats.dropped++;
+		return;
+	}
+	for(unsigned int i = 0; i < sizeof(SamplerSet); i++)
+		c_common_ringbuffer_put(&sampler_ring, bytes[i]);
+	sampler_stats.sets++;
+
+	if(sampler_ready) {
+		xSemaphoreGiveFromISR(sampler_ready, &woken);
+		portEND_SWITCHING_ISR(woken);
+	}
+}
+
+/** \brief Submete as leituras a partir de \b index, até que uma seja aceita; ao fim da cadeia, armazena o conjunto.
+ *  @retval true caso uma leitura tenha sido submetida.
+ */
+static bool prv_next(int index) {
+	for(; index < sampler_count; index++) {
+		if(sampler_set.sequence % sampler_every[index])
+			continue; // leitura decimada, fora deste período
+		sampler_current = index;
+		if(c_common_i2c_client_submit(&sampler_client, &sampler_links[index], sampler_started))
+			return true;
+		sampler_stats.errors++; // barramento preso; as transações das tasks o recuperam
+	}
+
+	sampler_current = -1;
+	prv_store();
+	return false;
+}
+
+/** \brief Inicia a cadeia do disparo à espera, se a anterior terminou e o barramento estiver livre.
+ *  Também é o gancho de periférico livre da I2C.
+ */
+static bool prv_start(void) {
+	if(!sampler_pending || sampler_current >= 0 || c_common_i2c_busy())
+		return false;
+
+	sampler_pending 		= false;
+	sampler_started 		= sampler_pending_cycles;
+	sampler_set.timestamp 	= sampler_pending_stamp;
+	sampler_set.sequence 	= sampler_pending_sequence;
+	sampler_set.status 		= 0;
+	sampler_set.links 		= sampler_count;
+	return prv_next(0);
+}
+
+/** \brief Registra um disparo (TIM3 ou dado pronto) e inicia a cadeia, se possível. */
+static void prv_trigger(void) {
+	if(!sampler_count)
+		return;
+	if(sampler_pending)
+		sampler_stats.missed++; // o disparo anterior não chegou a começar; é substituído
+
+	sampler_pending_cycles 		= c_common_perf_cycles();
+	sampler_pending_stamp 		= c_io_sampler_micros();
+	sampler_pending_sequence 	= sampler_sequence++;
+	sampler_pending 			= true;
+	prv_start();
+}
+
+/** \brief Liga ou desliga a interrupção do sinal de dado pronto. */
+static void prv_data_ready_cmd(FunctionalState state) {
+	EXTI_InitTypeDef EXTI_InitStructure;
+
+	EXTI_InitStructure.EXTI_Line = SAMPLER_EXTI_LINE;
+	EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+	EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising; // Apenas borda de subida
+	EXTI_InitStructure.EXTI_LineCmd = state;
+	EXTI_Init(&EXTI_InitStructure);
+}
+
+/** \brief Fim de uma leitura da cadeia (interrupção da I2C): registra o resultado e segue para a próxima. */
+static void prv_link_done(I2CTransfer* transfer) {
+	int index = sampler_current;
+
+	c_common_i2c_client_complete(&sampler_client, transfer);
+	if(transfer->result == I2C_RESULT_OK)
+		sampler_set.status |= 1 << index;
+	else
+		sampler_stats.errors++;
+
+	prv_next(index + 1);
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Acrescenta uma leitura à cadeia. Deve ser chamada antes de c_io_sampler_start().
+ *
+ * @param device Endereço de 7 bits do dispositivo.
+ * @param reg Primeiro registrador lido.
+ * @param length Quantidade de bytes.
+ * @retval Posição dos bytes em SamplerSet.data (a leitura ocupa o bit de mesmo índice de
+ * SamplerSet.status que a ordem de chamada), ou -1 se a cadeia ou o conjunto estiverem cheios.
+ */
+int c_io_sampler_add(uint8_t device, uint8_t reg, uint16_t length) {
+	return c_io_sampler_add_every(device, reg, length, 1);
+}
+
+/** \brief Acrescenta uma leitura feita apenas a cada \b every períodos (sensores mais lentos que a cadeia).
+ *
+ * A leitura é feita nos conjuntos cuja SamplerSet.sequence é múltipla de \b every; nos demais, o bit
+ * correspondente de SamplerSet.status fica em 0 e os bytes mantêm a leitura anterior.
+ *
+ * @param device Endereço de 7 bits do dispositivo.
+ * @param reg Primeiro registrador lido.
+ * @param length Quantidade de bytes.
+ * @param every Divisão da taxa de amostragem (1: todos os períodos).
+ * @retval Posição dos bytes em SamplerSet.data, ou -1 (ver c_io_sampler_add()).
+ */
+int c_io_sampler_add_every(uint8_t device, uint8_t reg, uint16_t length, uint16_t every) {
+	if(sampler_count >= SAMPLER_MAX_LINKS || !length || !every || sampler_bytes + length > SAMPLER_SET_BYTES)
+		return -1;
+
+	int offset = sampler_bytes;
+	sampler_every[sampler_count] = every;
+	sampler_links[sampler_count++] = (I2CTransfer){ .device = device, .reg = reg,
+													.rxData = &sampler_set.data[offset], .rxLength = length,
+													.done = prv_link_done };
+	sampler_bytes += length;
+
+	return offset;
+}
+
+/** \brief Inicializa a base de tempo (TIM5, 1 MHz) e os disparos, parados.
+ *
+ * A I2C (c_common_i2c_init()) deve estar inicializada antes de c_io_sampler_start(). No modo
+ * SAMPLER_TRIGGER_DATA_READY, o sensor deve ser configurado para gerar o sinal (ex.:
+ * c_io_itg3205_enable_data_ready()), retido até a leitura dos dados.
+ *
+ * @param rate_hz Frequência de amostragem, de 16 Hz a 1 MHz (ex.: 1000); no modo de dado pronto,
+ * a taxa do sensor, de 32 Hz em diante.
+ * @param trigger Origem dos disparos.
+ */
+void c_io_sampler_init(uint32_t rate_hz, SamplerTrigger trigger) {
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	c_common_perf_init();
+	c_common_ringbuffer_init(&sampler_ring, sampler_storage, SAMPLER_RING_SIZE);
+	if(!sampler_ready)
+		vSemaphoreCreateBinary(sampler_ready);
+	if(sampler_ready)
+		xSemaphoreTake(sampler_ready, 0);
+	sampler_stats = (SamplerStats){0};
+	c_common_perf_register(&sampler_probe, "SAMPLER", "chain");
+	c_common_i2c_client_init(&sampler_client, "sampler", I2C_PRIORITY_HIGH);
+	c_common_i2c_add_idle_hook(prv_start);
+	sampler_trigger = trigger;
+
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3 | RCC_APB1Periph_TIM5, ENABLE);
+
+	/* TIM5: contador livre de 32 bits, a cada us */
+	TIM_TimeBaseStructure.TIM_Prescaler = (SystemCoreClock / 2000000) - 1; // a cada us
+	TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFF;
+	TIM_TimeBaseStructure.TIM_ClockDivision = 0;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+	TIM_TimeBaseInit(TIM5, &TIM_TimeBaseStructure);
+	TIM_Cmd(TIM5, ENABLE);
+
+	/* TIM3: atualização a cada período de amostragem (contador de 16 bits, em us), ou a cada dois como cão de guarda */
+	TIM_TimeBaseStructure.TIM_Period = (trigger == SAMPLER_TRIGGER_DATA_READY ? 2000000 : 1000000) / rate_hz - 1;
+	TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+	TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
+	TIM_ITConfig(TIM3, TIM_IT_Update, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = SAMPLER_IRQ_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	if(trigger == SAMPLER_TRIGGER_DATA_READY) {
+		/* Sinal de dado pronto como entrada, ligado à interrupção externa */
+		c_common_gpio_init(SAMPLER_DRDY_PORT, SAMPLER_DRDY_PIN, GPIO_Mode_IN);
+		RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+		SYSCFG_EXTILineConfig(SAMPLER_EXTI_PORT, SAMPLER_EXTI_SOURCE);
+		prv_data_ready_cmd(DISABLE);
+
+		NVIC_InitStructure.NVIC_IRQChannel = SAMPLER_EXTI_IRQ;
+		NVIC_Init(&NVIC_InitStructure);
+	}
+}
+
+/** \brief Inicia os disparos. */
+void c_io_sampler_start(void) {
+	TIM_SetCounter(TIM3, 0);
+	TIM_Cmd(TIM3, ENABLE);
+
+	if(sampler_trigger == SAMPLER_TRIGGER_DATA_READY) {
+		EXTI_ClearITPendingBit(SAMPLER_EXTI_LINE);
+		prv_data_ready_cmd(ENABLE);
+		// um dado já pronto não gera borda: é lido agora, o que libera o sinal
+		taskENTER_CRITICAL();
+		if(GPIO_ReadInputDataBit(SAMPLER_DRDY_PORT, SAMPLER_DRDY_PIN))
+			prv_trigger();
+		taskEXIT_CRITICAL();
+	}
+}
+
+/** \brief Interrompe os disparos. Uma cadeia em andamento é concluída normalmente. */
+void c_io_sampler_stop(void) {
+	TIM_Cmd(TIM3, DISABLE);
+	if(sampler_trigger == SAMPLER_TRIGGER_DATA_READY)
+		prv_data_ready_cmd(DISABLE);
+}
+
+/** \brief Retira o conjunto mais antigo do buffer, sem bloquear.
+ *
+ * @param set Destino do conjunto.
+ * @retval true caso havia um conjunto disponível.
+ */
+bool c_io_sampler_read(SamplerSet* set) {
+	if(c_common_ringbuffer_count(&sampler_ring) < sizeof(SamplerSet))
+		return false;
+
+	return c_common_ringbuffer_read(&sampler_ring, (uint8_t*)set, sizeof(SamplerSet)) == sizeof(SamplerSet);
+}
+
+/** \brief Retira o conjunto mais antigo do buffer, aguardando por até \b ticks que algum fique pronto.
+ *
+ * Deve haver um único consumidor.
+ *
+ * @param set Destino do conjunto.
+ * @param ticks Tempo máximo de espera.
+ * @retval true caso um conjunto tenha sido lido.
+ */
+bool c_io_sampler_wait(SamplerSet* set, portTickType ticks) {
+	if(c_io_sampler_read(set))
+		return true;
+	if(!sampler_ready || xSemaphoreTake(sampler_ready, ticks) != pdTRUE)
+		return false;
+
+	return c_io_sampler_read(set);
+}
+
+/** \brief Retorna os contadores da aquisição.
+ *
+ * @retval Cópia dos contadores.
+ */
+SamplerStats c_io_sampler_stats(void) {
+	SamplerStats stats;
+
+	taskENTER_CRITICAL(); // mascara TIM3, EXTI2 e I2C (prioridade abaixo de configMAX_SYSCALL_INTERRUPT_PRIORITY)
+	stats = sampler_stats;
+	taskEXIT_CRITICAL();
+
+	return stats;
+}
+
+/* IRQ handlers ------------------------------------------------------------- */
+
+void TIM3_IRQHandler(void) {
+	TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
+
+	if(sampler_trigger == SAMPLER_TRIGGER_DATA_READY)
+		sampler_stats.timeouts++;
+	prv_trigger();
+}
+
+void EXTI2_IRQHandler(void) {
+	EXTI_ClearITPendingBit(SAMPLER_EXTI_LINE);
+
+	TIM_SetCounter(TIM3, 0); // rearma o cão de guarda
+	prv_trigger();
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,90 @@
+/**
+  ******************************************************************************
+  * @file    modules/io/c_io_sampler.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Aquisição periódica de sensores I2C, disparada por timer.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_IO_SAMPLER_H
+#define C_IO_SAMPLER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "FreeRTOS.h"
+
+/* Exported types ------------------------------------------------------------*/
+#define SAMPLER_MAX_LINKS	8		//!< Máximo de leituras na cadeia.
+#define SAMPLER_SET_BYTES	32		//!< Bytes de dados por conjunto.
+
+/** \brief Origem dos disparos da cadeia (ver c_io_sampler_init()). */
+typedef enum {
+	SAMPLER_TRIGGER_TIMER = 0,		//!< TIM3, à taxa pedida.
+	SAMPLER_TRIGGER_DATA_READY		//!< Borda de subida do sinal de dado pronto do sensor (EXTI2), com TIM3 como cão de guarda.
+} SamplerTrigger;
+
+/** \brief Conjunto de leituras de um período de amostragem.
+  *
+  * \b data contém os bytes de cada leitura da cadeia, nas posições retornadas por c_io_sampler_add().
+  */
+typedef struct {
+	uint32_t 	timestamp;		//!< Instante do disparo (ou do dado pronto), em us (ver c_io_sampler_micros()).
+	uint16_t 	sequence;		//!< Número do período; saltos indicam períodos perdidos.
+	uint8_t 	status;			//!< Bit \b i em 1: leitura \b i concluída com sucesso neste período.
+	uint8_t 	links;			//!< Quantidade de leituras na cadeia.
+	uint8_t 	data[SAMPLER_SET_BYTES];	//!< Bytes lidos.
+} SamplerSet;
+
+/** \brief Contadores da aquisição (ver c_io_sampler_stats()). */
+typedef struct {
+	uint32_t 	sets;			//!< Conjuntos completos armazenados.
+	uint32_t 	missed;			//!< Períodos perdidos (disparo à espera substituído pelo seguinte).
+	uint32_t 	dropped;		//!< Conjuntos descartados por buffer cheio.
+	uint32_t 	errors;			//!< Leituras com falha.
+	uint32_t 	timeouts;		//!< Disparos do cão de guarda (sinal de dado pronto ausente por dois períodos).
+} SamplerStats;
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+void c_io_sampler_init(uint32_t rate_hz, SamplerTrigger trigger);
+int  c_io_sampler_add(uint8_t device, uint8_t reg, uint16_t length);
+int  c_io_sampler_add_every(uint8_t device, uint8_t reg, uint16_t length, uint16_t every);
+void c_io_sampler_start(void);
+void c_io_sampler_stop(void);
+bool c_io_sampler_read(SamplerSet* set);
+bool c_io_sampler_wait(SamplerSet* set, portTickType ticks);
+SamplerStats c_io_sampler_stats(void);
+
+/* Header-defined wrapper functions ----------------------------------------- */
+/** @addtogroup Module_IO
+  * @{
+  */
+/** @addtogroup Module_IO_Component_Sampler
+  * @{
+  */
+
+/** \brief Base de tempo livre de 32 bits (TIM5), em us. Dá a volta a cada ~71 minutos. */
+static inline uint32_t c_io_sampler_micros(void) { return TIM5->CNT; }
+
+/**
+  * @}
+  */
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_IO_SAMPLER_H
@@ -18,6 +18,11 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "c_io_rx24f.h"
+#include "c_io_sampler.h"
+#include "c_io_itg3205.h"
+#include "c_io_adxl345.h"
+#include "c_io_hmc5883l.h"
+#include "c_io_calibration.h"
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    modules/telemetry/c_telemetry_cobs.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação da codificação COBS.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "c_telemetry_cobs.h"
+
+/** @addtogroup Module_Telemetry
+  * @{
+  */
+
+/** @addtogroup Module_Telemetry_Component_COBS
+  * \brief Remove os bytes 0x00 de um bloco, de forma que 0x00 possa ser usado como delimitador de quadros.
+  *
+  * Cada trecho sem zeros, de até 254 bytes, é precedido por um byte de código com o seu comprimento + 1;
+  * o zero que encerra o trecho fica implícito. O custo é de no máximo 1 byte a cada 254, e um receptor
+  * que perca bytes se ressincroniza no próximo delimitador.
+  *
+  * Não depende do STM32: o mesmo arquivo é compilado pelo decodificador da estação de solo.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Codifica um bloco em COBS. O delimitador não é incluído.
+  *
+  * @param  src Bloco original.
+  * @param  length Tamanho do bloco.
+  * @param  dst Destino, com pelo menos TELEMETRY_COBS_MAX(length) bytes. Não pode sobrepor \b src.
+  * @retval Tamanho do bloco codificado.
+  */
+int c_telemetry_cobs_encode(const uint8_t *src, int length, uint8_t *dst) {
+	int code_pos = 0;	// posição do byte de código do trecho atual
+	int out = 1;
+	uint8_t code = 1;
+
+	for(int i = 0; i < length; i++) {
+		if(src[i] == 0) {
+			dst[code_pos] = code;
+			code_pos = out++;
+			code = 1;
+		}
+		else {
+			dst[out++] = src[i];
+			if(++code == 0xFF) {
+				dst[code_pos] = code;
+				code_pos = out++;
+				code = 1;
+			}
+		}
+	}
+	dst[code_pos] = code;
+
+	return out;
+}
+
+/** \brief Decodifica um bloco COBS (sem o delimitador).
+  *
+  * @param  src Bloco codificado.
+  * @param  length Tamanho do bloco codificado.
+  * @param  dst Destino, com pelo menos \b length bytes. Pode ser o próprio \b src.
+  * @retval Tamanho do bloco original, ou -1 caso o bloco seja inválido.
+  */
+int c_telemetry_cobs_decode(const uint8_t *src, int length, uint8_t *dst) {
+	int in = 0;
+	int out = 0;
+
+	while(in < length) {
+		uint8_t code = src[in++];
+		if(code == 0 || in + code - 1 > length)
+			return -1;
+
+		for(int i = 1; i < code; i++) {
+			if(src[in] == 0)
+				return -1;
+			dst[out++] = src[in++];
+		}
+		// zero implícito, exceto após um trecho cheio e no fim do bloco
+		if(code != 0xFF && in < length)
+			dst[out++] = 0;
+	}
+
+	return out;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
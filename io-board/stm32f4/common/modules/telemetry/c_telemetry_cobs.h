@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    modules/telemetry/c_telemetry_cobs.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Codificação COBS (Consistent Overhead Byte Stuffing) dos quadros de telemetria.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef C_TELEMETRY_COBS_H
+#define C_TELEMETRY_COBS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+int c_telemetry_cobs_encode(const uint8_t *src, int length, uint8_t *dst);
+int c_telemetry_cobs_decode(const uint8_t *src, int length, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //C_TELEMETRY_COBS_H
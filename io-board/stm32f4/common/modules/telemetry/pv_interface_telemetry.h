@@ -0,0 +1,189 @@
+/**
+  ******************************************************************************
+  * @file    modules/telemetry/pv_interface_telemetry.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Definição das mensagens de telemetria, comum ao firmware e à estação de solo.
+  *
+  * Este arquivo não depende de nada específico do STM32, e é incluído também pelo
+  * decodificador em \em ground/telemetry.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_INTERFACE_TELEMETRY_H
+#define PV_INTERFACE_TELEMETRY_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported macro ------------------------------------------------------------*/
+
+/** Estruturas sem preenchimento: o layout em memória é o layout no fio. */
+#define TELEMETRY_PACKED			__attribute__((packed))
+
+/** Verificação, em tempo de compilação, do tamanho de uma mensagem no fio. */
+#define TELEMETRY_CHECK_SIZE(type, size)	typedef char type##_size_check[(sizeof(type) == (size)) ? 1 : -1]
+
+/** Maior tamanho de um bloco de \b n bytes após a codificação COBS (sem o delimitador). */
+#define TELEMETRY_COBS_MAX(n)		((n) + (n)/254 + 1)
+
+/* Exported constants --------------------------------------------------------*/
+
+/** \brief Formato de um quadro, antes da codificação COBS:
+  *
+  * | Campo   | Bytes | Descrição                                                   |
+  * |---------|-------|-------------------------------------------------------------|
+  * | id      | 1     | TelemetryMsgId                                              |
+  * | seq     | 1     | Contador de quadros (módulo 256), para detectar perdas       |
+  * | payload | 0..64 | Estrutura da mensagem, little-endian, sem preenchimento      |
+  * | crc     | 4     | CRC32 (little-endian) de id, seq e payload                   |
+  *
+  * O quadro é codificado em COBS e terminado por um byte 0x00, que portanto só aparece como
+  * delimitador. O CRC é o do periférico do STM32 (ver \ref Common_Components_CRC): polinômio
+  * TELEMETRY_CRC_POLY, valor inicial TELEMETRY_CRC_INIT, palavras little-endian completadas com zeros,
+  * bits processados do mais significativo ao menos significativo, sem XOR final.
+  */
+#define TELEMETRY_HEADER_SIZE		2
+#define TELEMETRY_MAX_PAYLOAD		64			//!< Maior payload de uma mensagem.
+#define TELEMETRY_CRC_SIZE			4
+#define TELEMETRY_MAX_FRAME			(TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + TELEMETRY_CRC_SIZE)
+#define TELEMETRY_MAX_ENCODED		(TELEMETRY_COBS_MAX(TELEMETRY_MAX_FRAME) + 1) //!< Quadro codificado + delimitador.
+#define TELEMETRY_DELIMITER			0x00
+
+#define TELEMETRY_CRC_POLY			((uint32_t)0x04C11DB7)
+#define TELEMETRY_CRC_INIT			((uint32_t)0xFFFFFFFF)
+
+#define TELEMETRY_CPU_HZ			168000000	//!< Clock do núcleo, para converter os ciclos de TelemetryPerf.
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Identificadores das mensagens. */
+typedef enum {
+	TELEMETRY_MSG_HEARTBEAT 	= 0x01,		//!< TelemetryHeartbeat.
+	TELEMETRY_MSG_TEXT 			= 0x02,		//!< Texto livre (payload sem terminador).
+	TELEMETRY_MSG_IMU_RAW 		= 0x10,		//!< TelemetryImuRaw.
+	TELEMETRY_MSG_MAG_RAW 		= 0x11,		//!< TelemetryMagRaw.
+	TELEMETRY_MSG_ATTITUDE 		= 0x12,		//!< TelemetryAttitude.
+	TELEMETRY_MSG_RC 			= 0x20,		//!< TelemetryRc.
+	TELEMETRY_MSG_SERVO 		= 0x30,		//!< TelemetryServo.
+	TELEMETRY_MSG_PERF 			= 0x40,		//!< TelemetryPerf.
+	TELEMETRY_MSG_BAUD_SWITCH 	= 0x50,		//!< TelemetryBaud (placa -> solo): pedido de troca de baudrate.
+	TELEMETRY_MSG_BAUD_ACK 		= 0x51,		//!< TelemetryBaud (solo -> placa): confirmação, no baudrate atual.
+	TELEMETRY_MSG_CALIBRATE 	= 0x60,		//!< TelemetryCalibrate (solo -> placa): comando de calibração.
+	TELEMETRY_MSG_CALIBRATION 	= 0x61		//!< TelemetryCalibration: andamento da calibração.
+} TelemetryMsgId;
+
+/** \brief Estado do enlace, enviado periodicamente. */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	uint32_t frames;			//!< Quadros enviados.
+	uint32_t bytes;				//!< Bytes enviados (quadros codificados).
+	uint32_t dropped;			//!< Quadros descartados por falta de espaço no envio.
+} TelemetryHeartbeat;
+TELEMETRY_CHECK_SIZE(TelemetryHeartbeat, 16);
+
+/** \brief Leituras brutas da IMU. */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	int16_t  acc[3];			//!< Acelerômetro (x, y, z), em unidades do sensor.
+	int16_t  gyro[3];			//!< Giroscópio (x, y, z), em unidades do sensor.
+} TelemetryImuRaw;
+TELEMETRY_CHECK_SIZE(TelemetryImuRaw, 16);
+
+/** \brief Leitura bruta do magnetômetro. */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	int16_t  mag[3];			//!< Magnetômetro (x, y, z), em unidades do sensor.
+	uint8_t  flags;				//!< Overflow (0x01) e saturação (0x02) de algum eixo.
+} TelemetryMagRaw;
+TELEMETRY_CHECK_SIZE(TelemetryMagRaw, 11);
+
+/** \brief Atitude estimada (ver \ref Module_Estimation). */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	int16_t  quat[4];			//!< Quatérnio (w, x, y, z) x 10000.
+	int16_t  euler[3];			//!< Rolagem, arfagem e guinada, em centésimos de grau.
+	int16_t  rate[3];			//!< Velocidade angular do corpo (x, y, z), em mrad/s.
+	uint8_t  flags;				//!< Correção pelo acelerômetro (0x01) e pelo magnetômetro (0x02).
+} TelemetryAttitude;
+TELEMETRY_CHECK_SIZE(TelemetryAttitude, 25);
+
+/** \brief Canais do receiver do rádio controle. */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	uint16_t channel[6];		//!< Largura de pulso de cada canal (us).
+} TelemetryRc;
+TELEMETRY_CHECK_SIZE(TelemetryRc, 16);
+
+/** \brief Estado de um servo. */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	uint8_t  id;				//!< ID do servo no barramento.
+	int16_t  setpoint;			//!< Posição comandada (graus).
+} TelemetryServo;
+TELEMETRY_CHECK_SIZE(TelemetryServo, 7);
+
+/** \brief Contadores de um probe de desempenho dos drivers, acumulados durante \b interval ms.
+  * Dele se obtêm bytes/s (bytes/interval), ciclos por byte (cycles/bytes), execuções por quadro
+  * (count/frames) e o pior tempo de uma execução (max/TELEMETRY_CPU_HZ).
+  */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	uint32_t interval;			//!< Duração do intervalo de medição (ms).
+	char     name[16];			//!< Dono e operação (ex.: "USART2 write"), terminado em zero.
+	uint32_t count;				//!< Execuções (chamadas ou entradas no tratador).
+	uint32_t bytes;				//!< Bytes processados.
+	uint32_t frames;			//!< Quadros, pacotes ou transferências completas.
+	uint32_t cycles;			//!< Ciclos gastos, somados.
+	uint32_t max;				//!< Pior caso de uma execução (ciclos).
+} TelemetryPerf;
+TELEMETRY_CHECK_SIZE(TelemetryPerf, 44);
+
+/** \brief Negociação de baudrate (ver module_telemetry_negotiate()).
+  *
+  * A placa envia TELEMETRY_MSG_BAUD_SWITCH no baudrate atual; o solo responde TELEMETRY_MSG_BAUD_ACK com
+  * o mesmo valor, ainda no baudrate atual, e então troca o seu. A placa troca o seu ao receber a
+  * confirmação e repete o pedido no novo baudrate; sem nova confirmação, ambos voltam ao anterior (o solo
+  * após 2 s sem quadros válidos).
+  */
+typedef struct TELEMETRY_PACKED {
+	uint32_t baudrate;			//!< Baudrate pedido (bit/s).
+} TelemetryBaud;
+TELEMETRY_CHECK_SIZE(TelemetryBaud, 4);
+
+/** \brief Ações de TelemetryCalibrate. */
+typedef enum {
+	TELEMETRY_CALIBRATE_BEGIN = 0,		//!< Inicia o procedimento do sensor.
+	TELEMETRY_CALIBRATE_RESET = 1,		//!< Volta o sensor à escala nominal.
+	TELEMETRY_CALIBRATE_SAVE  = 2		//!< Grava os coeficientes de todos os sensores na flash.
+} TelemetryCalibrateAction;
+
+/** \brief Comando de calibração (ver c_io_calibration). Sensores: 0 acelerômetro, 1 giroscópio, 2 magnetômetro. */
+typedef struct TELEMETRY_PACKED {
+	uint8_t  sensor;			//!< Sensor (ignorado em TELEMETRY_CALIBRATE_SAVE).
+	uint8_t  action;			//!< TelemetryCalibrateAction.
+} TelemetryCalibrate;
+TELEMETRY_CHECK_SIZE(TelemetryCalibrate, 2);
+
+/** \brief Andamento da calibração. */
+typedef struct TELEMETRY_PACKED {
+	uint32_t tick;				//!< Tick do FreeRTOS (ms).
+	uint8_t  sensor;			//!< Sensor do último procedimento.
+	uint8_t  state;				//!< 0 parado, 1 coletando, 2 concluído, 3 falhou.
+	uint16_t samples;			//!< Amostras aceitas na coleta atual.
+	uint8_t  poses;				//!< Faces do acelerômetro já registradas (+X, -X, +Y, -Y, +Z, -Z).
+	uint8_t  calibrated;		//!< Bits dos sensores calibrados.
+	uint8_t  saved;				//!< Resultado da última gravação: 0 nenhuma, 1 gravada, 2 falhou.
+} TelemetryCalibration;
+TELEMETRY_CHECK_SIZE(TelemetryCalibration, 11);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_INTERFACE_TELEMETRY_H
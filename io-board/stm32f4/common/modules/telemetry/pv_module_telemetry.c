@@ -0,0 +1,291 @@
+/**
+  ******************************************************************************
+  * @file    modules/telemetry/pv_module_telemetry.c
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Implementação do módulo de telemetria.
+  ******************************************************************************/
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_module_telemetry.h"
+#include "c_telemetry_cobs.h"
+#include "c_common_crc.h"
+#include "c_common_uart.h"
+
+/* FreeRTOS kernel includes */
+#include "task.h"
+#include "semphr.h"
+
+/** @addtogroup ProVANT_Modules
+  * @{
+  */
+
+/** @addtogroup Module_Telemetry
+  * \brief Envio de telemetria binária pela USART, em substituição às mensagens de texto.
+  *
+  * Cada mensagem (ver pv_interface_telemetry.h) é copiada em um quadro com identificador, número de
+  * sequência e CRC32 calculado pelo periférico CRC, codificada em COBS e enfileirada para envio por DMA
+  * (ver \ref Common_Components_UART). Uma leitura da IMU ocupa 24 bytes no fio, contra ~30 bytes de
+  * texto formatado por \em sprintf, e nenhum custo de formatação.
+  *
+  * Quadros que não cabem inteiros no buffer de envio são descartados (e contados), em vez de serem
+  * truncados. A estação de solo detecta as perdas pelo número de sequência.
+  *
+  * \code{.c}
+  * TelemetryRc rc = { xTaskGetTickCount(), {1500, 1500, 1000, 1500, 1500, 1500} };
+  * module_telemetry_send(TELEMETRY_MSG_RC, &rc, sizeof(rc));
+  * \endcode
+  *
+  * Quadros no sentido contrário (solo -> placa) usam o mesmo formato, e são lidos por
+  * module_telemetry_receive(). Com eles, module_telemetry_negotiate() sobe o baudrate do enlace depois
+  * da inicialização, com retorno ao anterior caso o solo não acompanhe.
+  *
+  * O decodificador de referência está em \em ground/telemetry.
+  * @{
+  */
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define TELEMETRY_BAUD_SETTLE_MS	20		//!< Espera após a troca, para o solo trocar também.
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+USART_TypeDef* 		telemetry_usart = 0;	//! USART usada pelo enlace.
+xSemaphoreHandle 	telemetry_lock;			//! Serializa quadros, buffers e o periférico CRC.
+uint8_t 			telemetry_seq = 0;		//! Número de sequência do próximo quadro.
+TelemetryHeartbeat 	telemetry_stats;		//! Contadores do enlace.
+
+/* Quadros montados em memória estática, e não na pilha das tasks (protegidos por telemetry_lock). */
+uint8_t telemetry_frame[TELEMETRY_MAX_FRAME];
+uint8_t telemetry_encoded[TELEMETRY_MAX_ENCODED];
+
+/* Recebimento: quadro codificado sendo acumulado e quadro decodificado (usados por uma única task). */
+uint8_t telemetry_rx[TELEMETRY_MAX_ENCODED];
+int 	telemetry_rx_length = 0;
+uint8_t telemetry_rx_frame[TELEMETRY_MAX_FRAME];
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/** \brief Valida um quadro codificado (sem o delimitador) e copia o seu conteúdo.
+  * @retval Tamanho do conteúdo, ou -1 caso o quadro seja inválido ou não caiba em \b size.
+  */
+static int prv_unpack(const uint8_t *encoded, int length, TelemetryMsgId *id, void *payload, int size) {
+	if(length > TELEMETRY_COBS_MAX(TELEMETRY_MAX_FRAME))
+		return -1;
+
+	int n = c_telemetry_cobs_decode(encoded, length, telemetry_rx_frame);
+	if(n < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE || n > TELEMETRY_MAX_FRAME)
+		return -1;
+
+	n -= TELEMETRY_CRC_SIZE;
+	uint32_t crc = 0;
+	for(int i = TELEMETRY_CRC_SIZE - 1; i >= 0; i--)
+		crc = (crc << 8) | telemetry_rx_frame[n + i];
+
+	xSemaphoreTake(telemetry_lock, portMAX_DELAY);
+	bool valid = (c_common_crc_compute(telemetry_rx_frame, n) == crc);
+	xSemaphoreGive(telemetry_lock);
+
+	int payload_length = n - TELEMETRY_HEADER_SIZE;
+	if(!valid || payload_length > size)
+		return -1;
+
+	*id = (TelemetryMsgId)telemetry_rx_frame[0];
+	for(int i = 0; i < payload_length; i++)
+		((uint8_t *)payload)[i] = telemetry_rx_frame[TELEMETRY_HEADER_SIZE + i];
+
+	return payload_length;
+}
+
+/** \brief Aguarda a confirmação de um pedido de troca de baudrate. */
+static bool prv_wait_baud_ack(uint32_t baudrate, portTickType ticks) {
+	portTickType start = xTaskGetTickCount();
+	TelemetryMsgId id;
+	TelemetryBaud ack;
+
+	for(portTickType elapsed = 0; elapsed < ticks; elapsed = xTaskGetTickCount() - start) {
+		if(module_telemetry_receive(&id, &ack, sizeof(ack), ticks - elapsed) == sizeof(ack)
+				&& id == TELEMETRY_MSG_BAUD_ACK && ack.baudrate == baudrate)
+			return true;
+	}
+	return false;
+}
+
+/* Exported functions definitions --------------------------------------------*/
+
+/** \brief Inicializa o módulo de telemetria sobre uma USART já inicializada.
+  *
+  * @param  USARTx USART do enlace (ex.: USART2).
+  * @retval None
+  */
+void module_telemetry_init(USART_TypeDef* USARTx) {
+	c_common_crc_init();
+	telemetry_lock = xSemaphoreCreateMutex();
+	telemetry_stats = (TelemetryHeartbeat){0};
+	telemetry_usart = telemetry_lock ? USARTx : 0;
+}
+
+/** \brief Envia uma mensagem, sem bloquear à espera do meio físico.
+  * Pode ser chamada de qualquer task; não pode ser chamada de interrupções.
+  *
+  * @param  id Identificador da mensagem.
+  * @param  payload Conteúdo da mensagem (estrutura definida em pv_interface_telemetry.h).
+  * @param  length Tamanho do conteúdo, até TELEMETRY_MAX_PAYLOAD bytes.
+  * @retval true caso o quadro tenha sido enfileirado por inteiro.
+  */
+bool module_telemetry_send(TelemetryMsgId id, const void *payload, int length) {
+	const uint8_t *bytes = (const uint8_t *)payload;
+	bool sent = false;
+
+	if(!telemetry_usart || length < 0 || length > TELEMETRY_MAX_PAYLOAD)
+		return false;
+
+	xSemaphoreTake(telemetry_lock, portMAX_DELAY);
+
+	int n = 0;
+	telemetry_frame[n++] = (uint8_t)id;
+	telemetry_frame[n++] = telemetry_seq++;
+	for(int i = 0; i < length; i++)
+		telemetry_frame[n++] = bytes[i];
+
+	uint32_t crc = c_common_crc_compute(telemetry_frame, n);
+	for(int i = 0; i < TELEMETRY_CRC_SIZE; i++, crc >>= 8)
+		telemetry_frame[n++] = (uint8_t)crc;
+
+	int e = c_telemetry_cobs_encode(telemetry_frame, n, telemetry_encoded);
+	telemetry_encoded[e++] = TELEMETRY_DELIMITER;
+
+	if(c_common_usart_tx_free(telemetry_usart) >= e) {
+		c_common_usart_write(telemetry_usart, telemetry_encoded, e);
+		telemetry_stats.frames++;
+		telemetry_stats.bytes += e;
+		sent = true;
+	}
+	else {
+		telemetry_stats.dropped++;
+	}
+
+	xSemaphoreGive(telemetry_lock);
+
+	return sent;
+}
+
+/** \brief Envia um texto livre (mensagem TELEMETRY_MSG_TEXT), truncado em TELEMETRY_MAX_PAYLOAD caracteres.
+  *
+  * @param  text String terminada em zero.
+  * @retval true caso o quadro tenha sido enfileirado.
+  */
+bool module_telemetry_send_text(const char *text) {
+	int length = 0;
+	while(text[length] && length < TELEMETRY_MAX_PAYLOAD)
+		length++;
+
+	return module_telemetry_send(TELEMETRY_MSG_TEXT, text, length);
+}
+
+/** \brief Retorna os contadores do enlace, prontos para envio como TELEMETRY_MSG_HEARTBEAT.
+  *
+  * @retval Contadores, com o tick atual.
+  */
+TelemetryHeartbeat module_telemetry_heartbeat(void) {
+	TelemetryHeartbeat hb;
+
+	if(telemetry_lock)
+		xSemaphoreTake(telemetry_lock, portMAX_DELAY);
+	hb = telemetry_stats;
+	if(telemetry_lock)
+		xSemaphoreGive(telemetry_lock);
+
+	hb.tick = xTaskGetTickCount();
+	return hb;
+}
+
+/** \brief Aguarda um quadro vindo do solo.
+  *
+  * Bytes fora de um quadro válido (ruído, quadros truncados ou com CRC errado) são descartados. Quadros
+  * parciais são mantidos entre chamadas. Deve ser chamada de uma única task.
+  *
+  * @param  id Identificador da mensagem recebida.
+  * @param  payload Destino do conteúdo.
+  * @param  size Tamanho de \b payload; quadros maiores são descartados.
+  * @param  ticks Tempo máximo de espera (portMAX_DELAY para esperar indefinidamente).
+  * @retval Tamanho do conteúdo, ou -1 caso nenhum quadro válido tenha chegado a tempo.
+  */
+int module_telemetry_receive(TelemetryMsgId *id, void *payload, int size, portTickType ticks) {
+	portTickType start = xTaskGetTickCount();
+	portTickType elapsed = 0;
+
+	if(!telemetry_usart)
+		return -1;
+
+	c_common_usart_set_rx_terminator(telemetry_usart, TELEMETRY_DELIMITER);
+
+	do {
+		int n = c_common_usart_read_timeout(telemetry_usart, telemetry_rx + telemetry_rx_length,
+				TELEMETRY_MAX_ENCODED - telemetry_rx_length,
+				(ticks == portMAX_DELAY) ? portMAX_DELAY : ticks - elapsed);
+		telemetry_rx_length += n;
+
+		if(telemetry_rx_length && telemetry_rx[telemetry_rx_length - 1] == TELEMETRY_DELIMITER) {
+			int length = telemetry_rx_length - 1;
+			telemetry_rx_length = 0;
+			if(length) {
+				int result = prv_unpack(telemetry_rx, length, id, payload, size);
+				if(result >= 0)
+					return result;
+			}
+		}
+		else if(telemetry_rx_length == TELEMETRY_MAX_ENCODED) {
+			telemetry_rx_length = 0; // sem delimitador: não é um quadro
+		}
+
+		elapsed = xTaskGetTickCount() - start;
+	} while(ticks == portMAX_DELAY || elapsed < ticks);
+
+	return -1;
+}
+
+/** \brief Troca o baudrate do enlace, em acordo com o solo.
+  *
+  * O pedido é enviado no baudrate atual e, após a confirmação, repetido no novo. Se o solo não confirmar
+  * em algum dos passos em até \b ticks, a USART volta (ou permanece) no baudrate anterior. Quadros
+  * enviados por outras tasks durante a troca podem ser perdidos; o solo os descarta pelo CRC.
+  *
+  * @param  baudrate Novo baudrate (ver c_common_usart_set_baudrate() para o alcance de cada USART).
+  * @param  ticks Tempo máximo de espera por cada confirmação.
+  * @retval true caso o enlace esteja operando no novo baudrate.
+  */
+bool module_telemetry_negotiate(uint32_t baudrate, portTickType ticks) {
+	if(!telemetry_usart || !c_common_usart_check_baudrate(telemetry_usart, baudrate))
+		return false;
+
+	uint32_t previous = c_common_usart_get_baudrate(telemetry_usart);
+	TelemetryBaud request = { baudrate };
+
+	module_telemetry_send(TELEMETRY_MSG_BAUD_SWITCH, &request, sizeof(request));
+	if(!prv_wait_baud_ack(baudrate, ticks))
+		return false;
+
+	c_common_usart_set_baudrate(telemetry_usart, baudrate);
+	vTaskDelay(TELEMETRY_BAUD_SETTLE_MS/portTICK_RATE_MS);
+	telemetry_rx_length = 0;
+
+	module_telemetry_send(TELEMETRY_MSG_BAUD_SWITCH, &request, sizeof(request));
+	if(prv_wait_baud_ack(baudrate, ticks))
+		return true;
+
+	c_common_usart_set_baudrate(telemetry_usart, previous);
+	return false;
+}
+
+/* IRQ handlers ------------------------------------------------------------- */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
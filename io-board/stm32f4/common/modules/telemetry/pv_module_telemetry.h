@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    modules/telemetry/pv_module_telemetry.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Módulo de telemetria binária (quadros COBS com CRC32) por USART.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MODULE_TELEMETRY_H
+#define PV_MODULE_TELEMETRY_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_conf.h"
+#include "pv_interface_telemetry.h"
+
+/* FreeRTOS kernel includes */
+#include "FreeRTOS.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+
+/* Exported functions ------------------------------------------------------- */
+void module_telemetry_init(USART_TypeDef* USARTx);
+bool module_telemetry_send(TelemetryMsgId id, const void *payload, int length);
+bool module_telemetry_send_text(const char *text);
+TelemetryHeartbeat module_telemetry_heartbeat(void);
+int  module_telemetry_receive(TelemetryMsgId *id, void *payload, int size, portTickType ticks);
+bool module_telemetry_negotiate(uint32_t baudrate, portTickType ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MODULE_TELEMETRY_H
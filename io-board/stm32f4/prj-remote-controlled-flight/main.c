@@ -16,7 +16,6 @@
 /* Includes ------------------------------------------------------------------*/
 
 /* Std includes */
-#include <stdio.h>
 #include <math.h>
 #include "inttypes.h"
 
@@ -35,12 +34,18 @@
 /* ProVANT Modules */
 #include "pv_module_rc.h"
 #include "pv_module_io.h"
+#include "pv_module_telemetry.h"
+#include "pv_module_estimation.h"
 
 /* Common Components, FOR TESTING */
 #include "c_rc_receiver.h"
 #include "c_common_uart.h"
 #include "c_common_gpio.h"
 #include "c_common_i2c.h"
+#include "c_common_i2c_bus.h"
+#include "c_common_perf.h"
+#include "c_common_format.h"
+#include "pv_math_bench.h"
 
 /** @addtogroup ProVANT_Modules
   * \brief Ponto de entrada do software geral do VANT.
@@ -54,15 +59,24 @@ GPIOPin LED;
 /* Private define ------------------------------------------------------------*/
 #define ITG3205_ADDR 0x68    // The address of ITG3205
 #define ADXL345_ADDR 0x53    // The adress of ADXL345
+#define HMC5883L_ADDR 0x1E   // The address of HMC5883L
 #define ITG3205_X_ADDR 0x1D  // Start address for x-axis
 #define ADXL345_X_ADDR 0x32  // Start address for x-axis
+#define TELEMETRY_BAUDRATE 2000000  // Link speed negotiated with the ground station (starts at 115200)
+#define SAMPLE_RATE 1000     // IMU acquisition rate (Hz), paced by the gyro data-ready line (see c_io_sampler)
+#define IMU_DECIMATION 5     // One IMU_RAW frame every 5 samples (200 Hz)
+#define ATTITUDE_DECIMATION 20  // One ATTITUDE frame every 20 samples (50 Hz)
+#define ACC_FIFO_WATERMARK 16  // Accelerometer samples per FIFO drain (800 Hz / 16 = 50 drains/s)
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 unsigned char ITG3205_ID = 0;
-unsigned char ADXL345_ID = 0;
-uint8_t sensorBuffer[8];
 int accRaw[3], gyroRaw[3];
+int gyroOffset;              // Position of the gyro read in SamplerSet.data
+int magOffset;               // Position of the magnetometer read (second in the chain, every 13 sets)
+float accCal[3], gyroCal[3], magCal[3];  // Calibrated samples, in m/s^2, rad/s and uT (see c_io_calibration)
+float accBody[3];            // Calibrated acceleration in the gyro axes, fed to the attitude estimator
+uint8_t calibrationSaved = 0;  // Result of the last calibration save: 0 none, 1 saved, 2 failed
 
 /* Private function prototypes -----------------------------------------------*/
 void vApplicationTickHook() {};
@@ -99,71 +113,262 @@ void rc_servo_task(void *pvParameters)
     	angle = c_rc_receiver_get_channel(2) - 700;
     	angle = round(map(angle, 0, 1000, 0, 300));
     	c_io_rx24f_move(0x01, angle);
+
+    	TelemetryServo servo = { xTaskGetTickCount(), 0x01, angle };
+    	module_telemetry_send(TELEMETRY_MSG_SERVO, &servo, sizeof(servo));
+
     	vTaskDelay(25/portTICK_RATE_MS);
     }
 }
 
-// Echoes anything received via UART2 using interrupts
+// Echoes lines received via UART2; sleeps until the RX interrupt wakes it up.
+// Reports the wake-up statistics when the line stays idle for 5 s.
 void echo_task(void *pvParameters)
 {
+	uint8_t line[32];
+	int n;
+
+	c_common_usart_set_rx_terminator(USART2, '\r');
+
 	while(1) {
-		while(!c_common_usart_available(USART2)) { vTaskDelay(10/portTICK_RATE_MS); }
-		c_common_usart_puts(USART2, "Got: ");
-		c_common_usart_putchar(USART2, c_common_usart_read(USART2));
-		c_common_usart_puts(USART2, " \n\r");
+		n = c_common_usart_read_timeout(USART2, line, sizeof(line)-1, 5000/portTICK_RATE_MS);
+		if(n) {
+			line[n] = 0;
+			c_common_usart_puts(USART2, "Got: ");
+			c_common_usart_puts(USART2, (char *)line);
+			c_common_usart_puts(USART2, " \n\r");
+		}
+		else {
+			USARTRxStats stats = c_common_usart_rx_stats(USART2);
+			c_common_format_usart(USART2, "RX blocks %u wakeups %u switches %u timeouts %u latency us last %u max %u\n\r",
+					stats.blocks, stats.wakeups, stats.switches, stats.timeouts,
+					c_common_perf_cycles_to_us(stats.latencyLast), c_common_perf_cycles_to_us(stats.latencyMax));
+		}
 	}
 }
 
-// Prints what the receiver gets from the remote
+// Streams what the receiver gets from the remote at 100 Hz, plus a heartbeat every second
 void uart_task(void *pvParameters)
 {
-	char str[32];
+	TelemetryRc rc;
+	TelemetryHeartbeat hb;
+	portTickType lastWake = xTaskGetTickCount();
 
     while(1) {
-    	c_common_usart_puts(USART2, "\n\r---------------------\n\r");
-    	for(int i=0; i<6; i++) {
-    		sprintf(str, "Canal %d : %d\n\r", i, c_rc_receiver_get_channel(i));
-    		c_common_usart_puts(USART2, str);
+    	rc.tick = xTaskGetTickCount();
+    	for(int i=0; i<6; i++)
+    		rc.channel[i] = c_rc_receiver_get_channel(i);
+    	module_telemetry_send(TELEMETRY_MSG_RC, &rc, sizeof(rc));
+
+    	if(rc.tick % 1000 < 10) {
+    		hb = module_telemetry_heartbeat();
+    		module_telemetry_send(TELEMETRY_MSG_HEARTBEAT, &hb, sizeof(hb));
     	}
 
-        vTaskDelay(1000/portTICK_RATE_MS);
+        vTaskDelayUntil(&lastWake, 10/portTICK_RATE_MS);
     }
 }
 
-// Periodically reads the IMU and outputs the raw content via UART2
+// Sets up the IMU, then streams the gyro samples read at each data-ready (see c_io_sampler), together with
+// the latest accelerometer sample from its FIFO, via UART2 at 200 Hz; each new magnetometer read is sent as well.
+// Every sample is also calibrated, and fed to the calibration procedure requested from the ground and to
+// the attitude estimator (see pv_module_estimation), whose estimate is sent at 50 Hz
 void i2c_task(void *pvParameters)
 {
-	char str[64];
-	c_common_i2c_readBytes(ADXL345_ADDR, 0x00, 1, &ADXL345_ID);
+	TelemetryImuRaw imu;
+	SamplerSet set;
+	ITG3205Sample gyro;
+	ADXL345Sample acc;
+	HMC5883LSample magSample;
+	TelemetryMagRaw mag;
+	EstimationAttitude estimate;
+	TelemetryAttitude att;
+
+	// The devices are set up from a task: before the scheduler starts, the I2C interrupts are masked
+	c_io_adxl345_init(ADXL345_ADDR, ADXL345_RANGE_16G, ADXL345_RATE_800HZ);
+	c_io_itg3205_init(ITG3205_ADDR, ITG3205_DLPF_42HZ, 0); // 1 kHz, 42 Hz bandwidth
+	c_io_hmc5883l_init(HMC5883L_ADDR, HMC5883L_GAIN_1_3GA);
+
+	const float nominal[CALIBRATION_SENSORS] = { ADXL345_MS2_PER_LSB, ITG3205_RAD_PER_LSB, c_io_hmc5883l_ut_per_lsb() };
+	c_io_calibration_init(nominal);
+	const CalibrationMap* accMap  = c_io_calibration_map(CALIBRATION_ACC);
+	const CalibrationMap* gyroMap = c_io_calibration_map(CALIBRATION_GYRO);
+	const CalibrationMap* magMap  = c_io_calibration_map(CALIBRATION_MAG);
+
+	c_io_itg3205_enable_data_ready();
+	gyroOffset = c_io_itg3205_attach();
+	magOffset = c_io_hmc5883l_attach(SAMPLE_RATE);
+	c_io_sampler_start();
+	c_io_adxl345_fifo_start(ACC_FIFO_WATERMARK);
+	while(1) {
+		if(!c_io_sampler_wait(&set, 10/portTICK_RATE_MS))
+			continue;
+
+		// Keep the latest acceleration
+		while(c_io_adxl345_fifo_read(&acc)) {
+			c_io_calibration_feed(CALIBRATION_ACC, acc.raw);
+			c_io_calibration_apply(accMap, acc.raw, accCal);
+			accBody[0] = -accCal[0];	// accelerometer X and Y point opposite to the gyro's
+			accBody[1] = -accCal[1];
+			accBody[2] = accCal[2];
+			module_estimation_acc(accBody, acc.timestamp);
+		    accRaw[0] = -acc.raw[0];
+		    accRaw[1] = -acc.raw[1];
+		    accRaw[2] = acc.raw[2];
+		}
+		if(gyroOffset >= 0 && (set.status & 0x01)) {
+			c_io_itg3205_convert(&set.data[gyroOffset], &gyro);
+			c_io_calibration_feed(CALIBRATION_GYRO, gyro.raw);
+			c_io_calibration_apply(gyroMap, gyro.raw, gyroCal);
+			for(int i=0; i<3; i++)
+				gyroRaw[i] = gyro.raw[i];
+		}
+		if(magOffset >= 0 && (set.status & 0x02)) {
+			c_io_hmc5883l_convert(&set.data[magOffset], &magSample);
+			if(!(magSample.flags & HMC5883L_FLAG_OVERFLOW)) {
+				c_io_calibration_feed(CALIBRATION_MAG, magSample.raw);
+				c_io_calibration_apply(magMap, magSample.raw, magCal);
+				module_estimation_mag(magCal, set.timestamp);	// magnetometer axes as the gyro's
+			}
+			mag.tick = xTaskGetTickCount();
+			for(int i=0; i<3; i++)
+				mag.mag[i] = magSample.raw[i];
+			mag.flags = magSample.flags;
+			module_telemetry_send(TELEMETRY_MSG_MAG_RAW, &mag, sizeof(mag));
+		}
+		// One estimator step per gyro sample, after the references of this period
+		if(gyroOffset >= 0 && (set.status & 0x01) && module_estimation_update(gyroCal, set.timestamp)
+				&& set.sequence % ATTITUDE_DECIMATION == 0 && module_estimation_read(&estimate)) {
+			att.tick = xTaskGetTickCount();
+			att.quat[0] = (int16_t)(estimate.attitude.w * 10000.0f);
+			att.quat[1] = (int16_t)(estimate.attitude.x * 10000.0f);
+			att.quat[2] = (int16_t)(estimate.attitude.y * 10000.0f);
+			att.quat[3] = (int16_t)(estimate.attitude.z * 10000.0f);
+			att.euler[0] = (int16_t)(estimate.euler.x * PV_RAD_TO_DEG * 100.0f);
+			att.euler[1] = (int16_t)(estimate.euler.y * PV_RAD_TO_DEG * 100.0f);
+			att.euler[2] = (int16_t)(estimate.euler.z * PV_RAD_TO_DEG * 100.0f);
+			att.rate[0] = (int16_t)(estimate.rate.x * 1000.0f);
+			att.rate[1] = (int16_t)(estimate.rate.y * 1000.0f);
+			att.rate[2] = (int16_t)(estimate.rate.z * 1000.0f);
+			att.flags = estimate.flags;
+			module_telemetry_send(TELEMETRY_MSG_ATTITUDE, &att, sizeof(att));
+		}
+		if(set.sequence % IMU_DECIMATION)
+			continue;
+
+	    imu.tick = xTaskGetTickCount();
+	    for(int i=0; i<3; i++) {
+	    	imu.acc[i]  = accRaw[i];
+	    	imu.gyro[i] = gyroRaw[i];
+	    }
+	    module_telemetry_send(TELEMETRY_MSG_IMU_RAW, &imu, sizeof(imu));
+	}
+}
 
-	// Accelerometer increase G-range (+/- 16G)
-	c_common_i2c_writeByte(ADXL345_ADDR, 0x31, 0b00001011);
 
-    //  ADXL345 POWER_CTL
-    c_common_i2c_writeByte(ADXL345_ADDR, 0x2D, 0);
-    c_common_i2c_writeByte(ADXL345_ADDR, 0x2D, 16);
-    c_common_i2c_writeByte(ADXL345_ADDR, 0x2D, 8);
+// Runs a calibration command from the ground (see c_io_calibration)
+void calibration_command(const TelemetryCalibrate *cmd)
+{
+	CalibrationSensor sensor = (CalibrationSensor)cmd->sensor;
+
+	switch(cmd->action) {
+	case TELEMETRY_CALIBRATE_BEGIN:
+		c_io_calibration_begin(sensor);
+		break;
+	case TELEMETRY_CALIBRATE_RESET:
+		c_io_calibration_reset(sensor);
+		break;
+	case TELEMETRY_CALIBRATE_SAVE:
+		calibrationSaved = c_io_calibration_save() ? 1 : 2; // stalls the CPU while the flash is written
+		break;
+	}
+}
 
-	while(1) {
-	    // Read x, y, z acceleration, pack the data.
-		c_common_i2c_readBytes(ADXL345_ADDR, ADXL345_X_ADDR, 6, sensorBuffer);
-	    accRaw[0] = ((int)sensorBuffer[0] | ((int)sensorBuffer[1] << 8)) * -1;
-	    accRaw[1] = ((int)sensorBuffer[2] | ((int)sensorBuffer[3] << 8)) * -1;
-	    accRaw[2] = (int)sensorBuffer[4] | ((int)sensorBuffer[5] << 8);
+// Raises the telemetry link speed, then sends the driver performance probes and the calibration progress
+// once per second (see c_common_perf), taking calibration commands in between
+void perf_task(void *pvParameters)
+{
+	TelemetryPerf msg;
+	PerfProbe probe;
+	TelemetryMsgId id;
+	TelemetryCalibrate cmd;
+	TelemetryCalibration cal;
+	CalibrationStatus status;
+
+	if(!module_telemetry_negotiate(TELEMETRY_BAUDRATE, 500/portTICK_RATE_MS))
+		module_telemetry_send_text("Baudrate mantido");
 
-	    sprintf(str, "Accel: %d %d %d\n\r", accRaw[0], accRaw[1], accRaw[2]);
-	    c_common_usart_puts(USART2, str);
+	portTickType last = xTaskGetTickCount();
 
-		vTaskDelay(100/portTICK_RATE_MS);
+	while(1) {
+		portTickType start = xTaskGetTickCount(), elapsed;
+		while((elapsed = xTaskGetTickCount() - start) < 1000/portTICK_RATE_MS)
+			if(module_telemetry_receive(&id, &cmd, sizeof(cmd), 1000/portTICK_RATE_MS - elapsed) == sizeof(cmd)
+					&& id == TELEMETRY_MSG_CALIBRATE)
+				calibration_command(&cmd);
+
+		portTickType now = xTaskGetTickCount();
+		for(int i=0; c_common_perf_snapshot(i, &probe, true); i++) {
+			msg.tick     = now;
+			msg.interval = (now - last) * portTICK_RATE_MS;
+			c_common_format(msg.name, sizeof(msg.name), "%s %s", probe.owner, probe.name);
+			msg.count  = probe.count;
+			msg.bytes  = probe.bytes;
+			msg.frames = probe.frames;
+			msg.cycles = probe.cycles;
+			msg.max    = probe.max;
+			module_telemetry_send(TELEMETRY_MSG_PERF, &msg, sizeof(msg));
+
+			// one frame at a time, so that the TX buffer is not overrun
+			vTaskDelay(5/portTICK_RATE_MS);
+		}
+		last = now;
+
+		status = c_io_calibration_status();
+		cal.tick       = now;
+		cal.sensor     = status.sensor;
+		cal.state      = status.state;
+		cal.samples    = status.samples;
+		cal.poses      = status.poses;
+		cal.calibrated = status.calibrated;
+		cal.saved      = calibrationSaved;
+		module_telemetry_send(TELEMETRY_MSG_CALIBRATION, &cal, sizeof(cal));
 	}
 }
 
 
+// Reports, as TEXT frames, the cycles per operation of the math library on the board (see lib/pv_math_bench.h)
+void math_bench_report(const char* name, uint32_t cycles, uint32_t runs)
+{
+	char text[48];
+
+	c_common_format(text, sizeof(text), "math %s %.1q ciclos", name, (int)(cycles*10/runs));
+	module_telemetry_send_text(text);
+	vTaskDelay(5/portTICK_RATE_MS);
+}
+
+void math_bench_task(void *pvParameters)
+{
+	vTaskDelay(2000/portTICK_RATE_MS);	// after the baudrate negotiation
+	pv_math_bench_run(c_common_perf_cycles, math_bench_report);
+	vTaskDelete(NULL);
+}
+
 /* PRV -----------------------------------------------------------------------*/
 void prvHardwareInit()
 {
+	// all preemption bits, as required by FreeRTOS on Cortex-M
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
+	c_common_perf_init();
+
 	c_common_i2c_init();
-	c_common_usart2_init(9600);
+	c_common_i2c_set_device_speed(ADXL345_ADDR, I2C_SPEED_FAST);
+	c_common_i2c_set_device_speed(ITG3205_ADDR, I2C_SPEED_FAST);
+	c_common_i2c_set_device_speed(HMC5883L_ADDR, I2C_SPEED_FAST);
+	c_io_sampler_init(SAMPLE_RATE, SAMPLER_TRIGGER_DATA_READY);
+	c_common_usart2_init(115200);
+	module_telemetry_init(USART2);
+	module_estimation_init(ESTIMATION_ESKF); // attitude and gyro bias, see c_estimation_eskf
 	c_io_rx24f_init(1000000);
 	c_rc_receiver_init();
 	LED = c_common_gpio_init(GPIOC, GPIO_Pin_13, GPIO_Mode_OUT);
@@ -177,7 +382,7 @@ int main(void)
 
 	vTraceInitTraceData();
 
-	c_common_usart_puts(USART2, "Programa iniciado!\n\r");
+	module_telemetry_send_text("Programa iniciado!");
 	vTraceConsoleMessage("Starting application...");
 
 	//sprintf(str, "Line, %d \n\r", __LINE__);
@@ -187,9 +392,12 @@ int main(void)
 		vTraceConsoleMessage("Could not start recorder!");
 
 	/* create tasks */
+	c_common_i2c_bus_init(tskIDLE_PRIORITY+3); // above its clients (the I2C task, through the sensor drivers)
 	xTaskCreate(blink_led_task, (signed char *)"Blink led", configMINIMAL_STACK_SIZE, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
 	//xTaskCreate(echo_task, (signed char *)"Echo task", configMINIMAL_STACK_SIZE, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
-	xTaskCreate(i2c_task,  (signed char *)"I2C task" , configMINIMAL_STACK_SIZE, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
+	xTaskCreate(i2c_task,  (signed char *)"I2C task" , configMINIMAL_STACK_SIZE*4, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
+	xTaskCreate(perf_task, (signed char *)"Perf task", configMINIMAL_STACK_SIZE*3, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
+	//xTaskCreate(math_bench_task, (signed char *)"Math bench", configMINIMAL_STACK_SIZE*2, (void *)NULL, tskIDLE_PRIORITY+2, NULL);
 	//xTaskCreate(uart_task	  , (signed char *)"UART task", configMINIMAL_STACK_SIZE, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
 	//xTaskCreate(rc_servo_task , (signed char *)"Servo task", configMINIMAL_STACK_SIZE, (void *)NULL, tskIDLE_PRIORITY+1, NULL);
 
@@ -0,0 +1,48 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Biblioteca de vetores, matrizes e quatérnios para o Cortex-M4F.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_H
+#define PV_MATH_H
+
+/** @defgroup Lib_Math Math
+  * \brief Vetores de 3 elementos, matrizes 3x3 e 4x4 e quatérnios, apenas em float e só em headers.
+  *
+  * Tudo é \em static \em inline, para que o compilador elimine as cópias e mantenha os operandos nos
+  * registradores da FPU (fpv4-sp-d16: 32 registradores de precisão simples). Vec3 e Quat são
+  * passados por valor: são agregados homogêneos de até 4 floats, que a AAPCS-VFP passa em s0-s3
+  * mesmo sem inline. As matrizes entram por ponteiro e saem por valor.
+  *
+  * Cuidados com a FPU de precisão simples:
+  * - Sem promoção para double: literais com sufixo \b f e funções \em sinf, \em sqrtf etc. (o gate
+  *   firmware compila com -Wdouble-promotion).
+  * - Somas de produtos usam fmaf() explicitamente: VFMA.F32, 1 ciclo e um único arredondamento.
+  *   Com -std=c99 o GCC não contrai a*b+c sozinho (-ffp-contract=off).
+  * - sqrtf() é a instrução VSQRT (14 ciclos) com -fno-math-errno; divisões são VDIV (14 ciclos), e
+  *   por isso as normalizações calculam um inverso e multiplicam.
+  *
+  * Convenções: matrizes por linhas; quatérnios de Hamilton (w escalar), com a atitude levando o
+  * corpo para a Terra; Euler ZYX (rolagem, arfagem, guinada). pv_math_bench.h mede os ciclos por
+  * operação, no host (\em ground/math_benchmark) e na placa.
+  *
+  * \code{.c}
+  * Quat q = pv_quat_identity();
+  * q = pv_quat_integrate(q, pv_vec3_load(gyroCal), 0.001f);
+  * Vec3 down = pv_quat_rotate_inv(q, pv_vec3(0.0f, 0.0f, -1.0f));	// vertical no corpo
+  * \endcode
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math_scalar.h"
+#include "pv_math_vec3.h"
+#include "pv_math_mat3.h"
+#include "pv_math_mat4.h"
+#include "pv_math_quat.h"
+
+#endif //PV_MATH_H
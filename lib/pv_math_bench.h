@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math_bench.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Medida de ciclos por operação da biblioteca de matemática, no host e na placa.
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_BENCH_H
+#define PV_MATH_BENCH_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "pv_math.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Contador de ciclos livre de 32 bits (ex.: c_common_perf_cycles(), ou o TSC no host). */
+typedef uint32_t (*PvBenchClock)(void);
+
+/** \brief Recebe o resultado de uma operação: \b cycles ciclos em \b runs execuções. */
+typedef void (*PvBenchReport)(const char* name, uint32_t cycles, uint32_t runs);
+
+/* Exported constants --------------------------------------------------------*/
+#define PV_BENCH_RUNS		256		//!< Execuções de cada operação.
+
+/* Exported variables --------------------------------------------------------*/
+/* Operandos e resultados voláteis: o compilador não pode tirar as operações do laço nem descartá-las.
+ * As matrizes, grandes demais para cópias voláteis, são publicadas a cada execução pela barreira de
+ * PV_BENCH() (o endereço escapa, e a memória é dada como lida e alterada). */
+static volatile Vec3 pv_bench_va = { 0.3f, -1.2f, 9.7f }, pv_bench_vb = { 0.01f, 0.02f, -0.03f }, pv_bench_vr;
+static volatile Quat pv_bench_qa = { 0.9f, 0.1f, -0.3f, 0.2f }, pv_bench_qb = { 0.7f, -0.5f, 0.1f, 0.4f }, pv_bench_qr;
+static volatile float pv_bench_fr;
+static struct {
+	Mat3 a, b, r;
+	Mat4 c, r4;
+} pv_bench_m = {
+	.a = {{ { 1.0f, 0.1f, 0.2f }, { -0.1f, 2.0f, 0.3f }, { 0.2f, -0.3f, 3.0f } }},
+	.b = {{ { 0.5f, 0.0f, 0.1f }, { 0.0f, 0.5f, 0.0f }, { -0.1f, 0.0f, 0.5f } }},
+	.c = {{ { 1.0f, 0.1f, 0.2f, 0.3f }, { 0.1f, 1.0f, 0.2f, 0.3f }, { 0.1f, 0.2f, 1.0f, 0.3f }, { 0.1f, 0.2f, 0.3f, 1.0f } }},
+};
+
+/* Exported macro ------------------------------------------------------------*/
+
+/** Mede PV_BENCH_RUNS execuções de \b statement, descontado o laço de referência \b base. */
+#define PV_BENCH(name, statement) do {											\
+		uint32_t pv_start = counter();											\
+		for(int pv_i = 0; pv_i < PV_BENCH_RUNS; pv_i++) {						\
+			statement;															\
+			__asm__ __volatile__("" : : "r"(&pv_bench_m) : "memory");			\
+		}																		\
+		uint32_t pv_cycles = counter() - pv_start;								\
+		report(name, pv_cycles > base ? pv_cycles - base : 0, PV_BENCH_RUNS);	\
+	} while(0)
+
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup Lib_Math
+  * @{
+  */
+
+/** \brief Mede as principais operações da biblioteca.
+ *
+ * Cada medida inclui ler os operandos e guardar o resultado (variáveis voláteis), descontado um laço
+ * que apenas copia um Vec3: o resultado aproxima o custo da operação dentro de um cálculo maior.
+ * Interrupções inflam as medidas; na placa, rodar numa task de prioridade alta, ou repetir e ficar
+ * com o menor valor.
+ *
+ * @param counter Contador de ciclos.
+ * @param report Destino de cada resultado.
+ */
+static inline void pv_math_bench_run(PvBenchClock counter, PvBenchReport report) {
+	uint32_t base = 0;
+
+	// Referência: copiar um Vec3
+	uint32_t start = counter();
+	for(int i = 0; i < PV_BENCH_RUNS; i++)
+		pv_bench_vr = pv_bench_va;
+	base = counter() - start;
+	report("baseline", base, PV_BENCH_RUNS);
+
+	PV_BENCH("vec3_add",       pv_bench_vr = pv_vec3_add(pv_bench_va, pv_bench_vb));
+	PV_BENCH("vec3_dot",       pv_bench_fr = pv_vec3_dot(pv_bench_va, pv_bench_vb));
+	PV_BENCH("vec3_cross",     pv_bench_vr = pv_vec3_cross(pv_bench_va, pv_bench_vb));
+	PV_BENCH("vec3_normalize", pv_bench_vr = pv_vec3_normalize(pv_bench_va));
+	PV_BENCH("mat3_mul_vec",   pv_bench_vr = pv_mat3_mul_vec(&pv_bench_m.a, pv_bench_va));
+	PV_BENCH("mat3_mul",       pv_bench_m.r = pv_mat3_mul(&pv_bench_m.a, &pv_bench_m.b));
+	PV_BENCH("mat3_inverse",   (void)pv_mat3_inverse(&pv_bench_m.a, &pv_bench_m.r));
+	PV_BENCH("mat4_mul",       pv_bench_m.r4 = pv_mat4_mul(&pv_bench_m.c, &pv_bench_m.c));
+	PV_BENCH("quat_mul",       pv_bench_qr = pv_quat_mul(pv_bench_qa, pv_bench_qb));
+	PV_BENCH("quat_normalize", pv_bench_qr = pv_quat_normalize(pv_bench_qa));
+	PV_BENCH("quat_rotate",    pv_bench_vr = pv_quat_rotate(pv_bench_qa, pv_bench_va));
+	PV_BENCH("quat_integrate", pv_bench_qr = pv_quat_integrate(pv_bench_qa, pv_bench_vb, 0.002f));
+	PV_BENCH("quat_to_mat3",   pv_bench_m.r = pv_quat_to_mat3(pv_bench_qa));
+	PV_BENCH("quat_to_euler",  pv_bench_vr = pv_quat_to_euler(pv_bench_qa));
+}
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MATH_BENCH_H
@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math_mat3.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Matrizes 3x3 (ver pv_math.h).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_MAT3_H
+#define PV_MATH_MAT3_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math_vec3.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Matriz 3x3, por linhas (m[linha][coluna]). Recebida por ponteiro, retornada por valor. */
+typedef struct {
+	float m[3][3];
+} Mat3;
+
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup Lib_Math
+  * @{
+  */
+
+static inline Mat3 pv_mat3_diag(Vec3 d) {
+	Mat3 r = {{ { d.x, 0.0f, 0.0f }, { 0.0f, d.y, 0.0f }, { 0.0f, 0.0f, d.z } }};
+	return r;
+}
+
+static inline Mat3 pv_mat3_identity(void) {
+	return pv_mat3_diag(pv_vec3(1.0f, 1.0f, 1.0f));
+}
+
+static inline Vec3 pv_mat3_row(const Mat3* a, int i) {
+	return pv_vec3(a->m[i][0], a->m[i][1], a->m[i][2]);
+}
+
+static inline Vec3 pv_mat3_col(const Mat3* a, int j) {
+	return pv_vec3(a->m[0][j], a->m[1][j], a->m[2][j]);
+}
+
+/** \brief A v: 9 multiplicações, 6 delas fundidas às somas. */
+static inline Vec3 pv_mat3_mul_vec(const Mat3* a, Vec3 v) {
+	return pv_vec3(pv_vec3_dot(pv_mat3_row(a, 0), v),
+				   pv_vec3_dot(pv_mat3_row(a, 1), v),
+				   pv_vec3_dot(pv_mat3_row(a, 2), v));
+}
+
+/** \brief A^T v, sem formar a transposta. */
+static inline Vec3 pv_mat3_mul_vec_t(const Mat3* a, Vec3 v) {
+	return pv_vec3(pv_vec3_dot(pv_mat3_col(a, 0), v),
+				   pv_vec3_dot(pv_mat3_col(a, 1), v),
+				   pv_vec3_dot(pv_mat3_col(a, 2), v));
+}
+
+static inline Mat3 pv_mat3_mul(const Mat3* a, const Mat3* b) {
+	Mat3 r;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			r.m[i][j] = fmaf(a->m[i][0], b->m[0][j], fmaf(a->m[i][1], b->m[1][j], a->m[i][2] * b->m[2][j]));
+	return r;
+}
+
+/** \brief A B^T, sem formar a transposta (ex.: P F^T). */
+static inline Mat3 pv_mat3_mul_t(const Mat3* a, const Mat3* b) {
+	Mat3 r;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			r.m[i][j] = fmaf(a->m[i][0], b->m[j][0], fmaf(a->m[i][1], b->m[j][1], a->m[i][2] * b->m[j][2]));
+	return r;
+}
+
+static inline Mat3 pv_mat3_transpose(const Mat3* a) {
+	Mat3 r;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			r.m[i][j] = a->m[j][i];
+	return r;
+}
+
+static inline Mat3 pv_mat3_add(const Mat3* a, const Mat3* b) {
+	Mat3 r;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			r.m[i][j] = a->m[i][j] + b->m[i][j];
+	return r;
+}
+
+static inline Mat3 pv_mat3_sub(const Mat3* a, const Mat3* b) {
+	Mat3 r;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			r.m[i][j] = a->m[i][j] - b->m[i][j];
+	return r;
+}
+
+static inline Mat3 pv_mat3_scale(const Mat3* a, float s) {
+	Mat3 r;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			r.m[i][j] = a->m[i][j] * s;
+	return r;
+}
+
+/** \brief Matriz do produto vetorial: [v]x w = v x w. */
+static inline Mat3 pv_mat3_skew(Vec3 v) {
+	Mat3 r = {{ { 0.0f, -v.z, v.y }, { v.z, 0.0f, -v.x }, { -v.y, v.x, 0.0f } }};
+	return r;
+}
+
+/** \brief Produto externo a b^T. */
+static inline Mat3 pv_mat3_outer(Vec3 a, Vec3 b) {
+	Mat3 r = {{ { a.x * b.x, a.x * b.y, a.x * b.z },
+				{ a.y * b.x, a.y * b.y, a.y * b.z },
+				{ a.z * b.x, a.z * b.y, a.z * b.z } }};
+	return r;
+}
+
+/** \brief (A + A^T) / 2: remove a assimetria acumulada por arredondamento (ex.: covariâncias). */
+static inline Mat3 pv_mat3_symmetrize(const Mat3* a) {
+	Mat3 r = *a;
+	for(int i = 0; i < 3; i++)
+		for(int j = i + 1; j < 3; j++)
+			r.m[i][j] = r.m[j][i] = 0.5f * (a->m[i][j] + a->m[j][i]);
+	return r;
+}
+
+static inline float pv_mat3_det(const Mat3* a) {
+	return pv_vec3_dot(pv_mat3_row(a, 0), pv_vec3_cross(pv_mat3_row(a, 1), pv_mat3_row(a, 2)));
+}
+
+/** \brief Inversa pela adjunta: as colunas da inversa são os produtos vetoriais das linhas de \b a,
+ *  divididos pelo determinante.
+ *
+ * @param a Matriz.
+ * @param inverse Destino da inversa.
+ * @retval false se \b a for singular (\b inverse não é alterada).
+ */
+static inline bool pv_mat3_inverse(const Mat3* a, Mat3* inverse) {
+	Vec3 r0 = pv_mat3_row(a, 0), r1 = pv_mat3_row(a, 1), r2 = pv_mat3_row(a, 2);
+	Vec3 c0 = pv_vec3_cross(r1, r2), c1 = pv_vec3_cross(r2, r0), c2 = pv_vec3_cross(r0, r1);
+	float det = pv_vec3_dot(r0, c0);
+
+	if(det == 0.0f)
+		return false;
+
+	float s = 1.0f / det;
+	Mat3 r = {{ { c0.x * s, c1.x * s, c2.x * s },
+				{ c0.y * s, c1.y * s, c2.y * s },
+				{ c0.z * s, c1.z * s, c2.z * s } }};
+	*inverse = r;
+	return true;
+}
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MATH_MAT3_H
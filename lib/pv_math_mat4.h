@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math_mat4.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Matrizes 4x4 (ver pv_math.h).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_MAT4_H
+#define PV_MATH_MAT4_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math_scalar.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Matriz 4x4, por linhas (m[linha][coluna]). Recebida por ponteiro, retornada por valor. */
+typedef struct {
+	float m[4][4];
+} Mat4;
+
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup Lib_Math
+  * @{
+  */
+
+static inline Mat4 pv_mat4_identity(void) {
+	Mat4 r = {{ { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f },
+				{ 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } }};
+	return r;
+}
+
+/** \brief Produto escalar de 4 elementos, com 3 multiplicações-somas fundidas. */
+static inline float pv_dot4(float a0, float a1, float a2, float a3, float b0, float b1, float b2, float b3) {
+	return fmaf(a0, b0, fmaf(a1, b1, fmaf(a2, b2, a3 * b3)));
+}
+
+/** \brief A v, com \b v e \b out de 4 elementos (podem ser o mesmo vetor). */
+static inline void pv_mat4_mul_vec(const Mat4* a, const float* v, float* out) {
+	float r[4];
+	for(int i = 0; i < 4; i++)
+		r[i] = pv_dot4(a->m[i][0], a->m[i][1], a->m[i][2], a->m[i][3], v[0], v[1], v[2], v[3]);
+	for(int i = 0; i < 4; i++)
+		out[i] = r[i];
+}
+
+static inline Mat4 pv_mat4_mul(const Mat4* a, const Mat4* b) {
+	Mat4 r;
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			r.m[i][j] = pv_dot4(a->m[i][0], a->m[i][1], a->m[i][2], a->m[i][3],
+								b->m[0][j], b->m[1][j], b->m[2][j], b->m[3][j]);
+	return r;
+}
+
+static inline Mat4 pv_mat4_transpose(const Mat4* a) {
+	Mat4 r;
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			r.m[i][j] = a->m[j][i];
+	return r;
+}
+
+static inline Mat4 pv_mat4_add(const Mat4* a, const Mat4* b) {
+	Mat4 r;
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			r.m[i][j] = a->m[i][j] + b->m[i][j];
+	return r;
+}
+
+static inline Mat4 pv_mat4_scale(const Mat4* a, float s) {
+	Mat4 r;
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			r.m[i][j] = a->m[i][j] * s;
+	return r;
+}
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MATH_MAT4_H
@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math_quat.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Quatérnios de rotação (ver pv_math.h).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_QUAT_H
+#define PV_MATH_QUAT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math_vec3.h"
+#include "pv_math_mat3.h"
+#include "pv_math_mat4.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Quatérnio de Hamilton (w escalar). Passado e retornado por valor (registradores s0-s3).
+  *
+  * Uma atitude q leva vetores do corpo para a Terra: v_terra = q v_corpo q*.
+  */
+typedef struct {
+	float w, x, y, z;
+} Quat;
+
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup Lib_Math
+  * @{
+  */
+
+static inline Quat pv_quat(float w, float x, float y, float z) {
+	Quat q = { w, x, y, z };
+	return q;
+}
+
+static inline Quat pv_quat_identity(void) {
+	return pv_quat(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+/** \brief Parte vetorial. */
+static inline Vec3 pv_quat_vec(Quat q) {
+	return pv_vec3(q.x, q.y, q.z);
+}
+
+static inline Quat pv_quat_conj(Quat q) {
+	return pv_quat(q.w, -q.x, -q.y, -q.z);
+}
+
+static inline float pv_quat_dot(Quat a, Quat b) {
+	return pv_dot4(a.w, a.x, a.y, a.z, b.w, b.x, b.y, b.z);
+}
+
+static inline Quat pv_quat_scale(Quat q, float s) {
+	return pv_quat(q.w * s, q.x * s, q.y * s, q.z * s);
+}
+
+/** \brief a + b * s, com 4 multiplicações-somas fundidas. */
+static inline Quat pv_quat_madd(Quat a, Quat b, float s) {
+	return pv_quat(fmaf(b.w, s, a.w), fmaf(b.x, s, a.x), fmaf(b.y, s, a.y), fmaf(b.z, s, a.z));
+}
+
+/** \brief Produto de Hamilton a b (aplica b, depois a). */
+static inline Quat pv_quat_mul(Quat a, Quat b) {
+	return pv_quat(pv_dot4(a.w, -a.x, -a.y, -a.z, b.w, b.x, b.y, b.z),
+				   pv_dot4(a.w,  a.x,  a.y, -a.z, b.x, b.w, b.z, b.y),
+				   pv_dot4(a.w, -a.x,  a.y,  a.z, b.y, b.z, b.w, b.x),
+				   pv_dot4(a.w,  a.x, -a.y,  a.z, b.z, b.y, b.x, b.w));
+}
+
+/** \brief Quatérnio unitário; o nulo vira a identidade. */
+static inline Quat pv_quat_normalize(Quat q) {
+	float n2 = pv_quat_dot(q, q);
+	return n2 > 0.0f ? pv_quat_scale(q, pv_rsqrtf(n2)) : pv_quat_identity();
+}
+
+/** \brief q v q*, sem formar produtos de quatérnios: v + 2w (u x v) + 2 u x (u x v), com u = parte vetorial. */
+static inline Vec3 pv_quat_rotate(Quat q, Vec3 v) {
+	Vec3 u = pv_quat_vec(q);
+	Vec3 t = pv_vec3_scale(pv_vec3_cross(u, v), 2.0f);
+	return pv_vec3_add(pv_vec3_madd(v, t, q.w), pv_vec3_cross(u, t));
+}
+
+/** \brief q* v q: rotação inversa (ex.: um vetor da Terra no referencial do corpo). */
+static inline Vec3 pv_quat_rotate_inv(Quat q, Vec3 v) {
+	return pv_quat_rotate(pv_quat_conj(q), v);
+}
+
+/** \brief Rotação de \b angle radianos em torno do eixo unitário \b axis. */
+static inline Quat pv_quat_from_axis_angle(Vec3 axis, float angle) {
+	float s = sinf(0.5f * angle);
+	return pv_quat(cosf(0.5f * angle), axis.x * s, axis.y * s, axis.z * s);
+}
+
+/** \brief Integra a velocidade angular do corpo \b rate (rad/s) por \b dt segundos, em primeira ordem
+ *  (q + q [0 rate] dt/2), e normaliza.
+ */
+static inline Quat pv_quat_integrate(Quat q, Vec3 rate, float dt) {
+	Quat dq = pv_quat_mul(q, pv_quat(0.0f, rate.x, rate.y, rate.z));
+	return pv_quat_normalize(pv_quat_madd(q, dq, 0.5f * dt));
+}
+
+/** \brief Matriz de rotação (corpo para Terra) equivalente a um quatérnio unitário. */
+static inline Mat3 pv_quat_to_mat3(Quat q) {
+	float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+	Mat3 r = {{ { 1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy) },
+				{ 2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx) },
+				{ 2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy) } }};
+	return r;
+}
+
+/** \brief Ângulos de Euler ZYX (rolagem, arfagem, guinada), em rad. A arfagem é limitada a +/- 90 graus. */
+static inline Vec3 pv_quat_to_euler(Quat q) {
+	float roll  = atan2f(2.0f * fmaf(q.w, q.x, q.y * q.z), 1.0f - 2.0f * fmaf(q.x, q.x, q.y * q.y));
+	float pitch = asinf(pv_clampf(2.0f * fmaf(q.w, q.y, -q.z * q.x), -1.0f, 1.0f));
+	float yaw   = atan2f(2.0f * fmaf(q.w, q.z, q.x * q.y), 1.0f - 2.0f * fmaf(q.y, q.y, q.z * q.z));
+	return pv_vec3(roll, pitch, yaw);
+}
+
+/** \brief Quatérnio dos ângulos de Euler ZYX (rolagem, arfagem, guinada), em rad. */
+static inline Quat pv_quat_from_euler(Vec3 euler) {
+	float cr = cosf(0.5f * euler.x), sr = sinf(0.5f * euler.x);
+	float cp = cosf(0.5f * euler.y), sp = sinf(0.5f * euler.y);
+	float cy = cosf(0.5f * euler.z), sy = sinf(0.5f * euler.z);
+	return pv_quat(cr * cp * cy + sr * sp * sy,
+				   sr * cp * cy - cr * sp * sy,
+				   cr * sp * cy + sr * cp * sy,
+				   cr * cp * sy - sr * sp * cy);
+}
+
+/** \brief Matriz Omega(rate) de dq/dt = Omega q / 2, com q como vetor (w, x, y, z). */
+static inline Mat4 pv_quat_omega(Vec3 rate) {
+	Mat4 r = {{ { 0.0f,   -rate.x, -rate.y, -rate.z },
+				{ rate.x,  0.0f,    rate.z, -rate.y },
+				{ rate.y, -rate.z,  0.0f,    rate.x },
+				{ rate.z,  rate.y, -rate.x,  0.0f   } }};
+	return r;
+}
+
+/** \brief A q, com q como vetor (w, x, y, z). */
+static inline Quat pv_mat4_mul_quat(const Mat4* a, Quat q) {
+	float v[4] = { q.w, q.x, q.y, q.z };
+	pv_mat4_mul_vec(a, v, v);
+	return pv_quat(v[0], v[1], v[2], v[3]);
+}
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MATH_QUAT_H
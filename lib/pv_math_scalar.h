@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math_scalar.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Constantes e funções escalares da biblioteca de matemática (ver pv_math.h).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_SCALAR_H
+#define PV_MATH_SCALAR_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Exported constants --------------------------------------------------------*/
+#define PV_PI			3.14159265f
+#define PV_DEG_TO_RAD	(PV_PI / 180.0f)
+#define PV_RAD_TO_DEG	(180.0f / PV_PI)
+#define PV_GRAVITY		9.80665f		//!< Gravidade padrão, em m/s^2.
+
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup Lib_Math
+  * @{
+  */
+
+/** \brief Inverso da raiz quadrada: VSQRT e VDIV (14 ciclos cada no Cortex-M4F).
+ *
+ * Com -fno-math-errno, sqrtf() vira apenas a instrução; sem ele, o compilador acrescenta o teste de
+ * argumento negativo e a chamada à libm.
+ */
+static inline float pv_rsqrtf(float x) {
+	return 1.0f / sqrtf(x);
+}
+
+/** \brief Limita \b x ao intervalo [\b lo, \b hi]. */
+static inline float pv_clampf(float x, float lo, float hi) {
+	return x < lo ? lo : (x > hi ? hi : x);
+}
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MATH_SCALAR_H
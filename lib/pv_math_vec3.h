@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file    lib/pv_math_vec3.h
+  * @author  Martin Vincent Bloedorn
+  * @version V1.0.0
+  * @date    16-October-2026
+  * @brief   Vetores de 3 elementos (ver pv_math.h).
+  *****************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PV_MATH_VEC3_H
+#define PV_MATH_VEC3_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "pv_math_scalar.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/** \brief Vetor de 3 elementos. Passado e retornado por valor (vai nos registradores s0-s2). */
+typedef struct {
+	float x, y, z;
+} Vec3;
+
+/* Exported functions ------------------------------------------------------- */
+/** @addtogroup Lib_Math
+  * @{
+  */
+
+static inline Vec3 pv_vec3(float x, float y, float z) {
+	Vec3 v = { x, y, z };
+	return v;
+}
+
+/** \brief Vetor a partir de 3 floats consecutivos (ex.: accCal). */
+static inline Vec3 pv_vec3_load(const float* a) {
+	return pv_vec3(a[0], a[1], a[2]);
+}
+
+static inline void pv_vec3_store(Vec3 v, float* a) {
+	a[0] = v.x; a[1] = v.y; a[2] = v.z;
+}
+
+static inline Vec3 pv_vec3_add(Vec3 a, Vec3 b) {
+	return pv_vec3(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+static inline Vec3 pv_vec3_sub(Vec3 a, Vec3 b) {
+	return pv_vec3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static inline Vec3 pv_vec3_neg(Vec3 a) {
+	return pv_vec3(-a.x, -a.y, -a.z);
+}
+
+static inline Vec3 pv_vec3_scale(Vec3 a, float s) {
+	return pv_vec3(a.x * s, a.y * s, a.z * s);
+}
+
+/** \brief a + b * s, com 3 multiplicações-somas fundidas. */
+static inline Vec3 pv_vec3_madd(Vec3 a, Vec3 b, float s) {
+	return pv_vec3(fmaf(b.x, s, a.x), fmaf(b.y, s, a.y), fmaf(b.z, s, a.z));
+}
+
+static inline float pv_vec3_dot(Vec3 a, Vec3 b) {
+	return fmaf(a.x, b.x, fmaf(a.y, b.y, a.z * b.z));
+}
+
+static inline Vec3 pv_vec3_cross(Vec3 a, Vec3 b) {
+	return pv_vec3(fmaf(a.y, b.z, -a.z * b.y),
+				   fmaf(a.z, b.x, -a.x * b.z),
+				   fmaf(a.x, b.y, -a.y * b.x));
+}
+
+static inline float pv_vec3_norm_sq(Vec3 a) {
+	return pv_vec3_dot(a, a);
+}
+
+static inline float pv_vec3_norm(Vec3 a) {
+	return sqrtf(pv_vec3_dot(a, a));
+}
+
+/** \brief Vetor unitário na direção de \b a; o vetor nulo é retornado como está. */
+static inline Vec3 pv_vec3_normalize(Vec3 a) {
+	float n2 = pv_vec3_dot(a, a);
+	return n2 > 0.0f ? pv_vec3_scale(a, pv_rsqrtf(n2)) : a;
+}
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PV_MATH_VEC3_H